@@ -80,14 +80,27 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_hdr);
+EXPORT_SYMBOL_GPL(rohc_compress_meta);
 EXPORT_SYMBOL_GPL(rohc_comp_pad);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
 
+/* sharded compression */
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_new);
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_free);
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_get_shard);
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_select);
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_split_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_sharded_get_general_info);
+
 /* segment */
 EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_feedback_queue);
+EXPORT_SYMBOL_GPL(rohc_comp_push_feedback);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
@@ -109,7 +122,9 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_reorder_ratio);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_traces_level);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
+EXPORT_SYMBOL_GPL(rohc_comp_set_allocator);
 
 /* RTP-specific configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
@@ -123,6 +138,8 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_inplace);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
@@ -145,5 +162,7 @@ EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_level);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
+EXPORT_SYMBOL_GPL(rohc_decomp_reserve_contexts);
 
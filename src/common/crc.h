@@ -52,6 +52,16 @@
 /** The length (in bytes) of the FCS-32 CRC */
 #define CRC_FCS32_LEN  4U
 
+/** The minimal length (in bytes) of data for the CRC-7/8 sliced tables */
+#define CRC_SLICED_MIN_LEN  16U
+
+/**
+ * @brief The maximum length (in bytes) of the headers in the CRC cache
+ *
+ * Every cached copy of headers with its length and CRC takes 128 bytes.
+ */
+#define CRC_HDRS_CACHE_MAX_LEN  126U
+
 /** The different types of CRC used to protect ROHC headers */
 typedef enum
 {
@@ -62,6 +72,28 @@ typedef enum
 } rohc_crc_type_t;
 
 
+/** The last uncompressed headers of one context and their CRC */
+struct crc_hdrs_ref
+{
+	uint8_t hdrs[CRC_HDRS_CACHE_MAX_LEN]; /**< The last uncompressed headers */
+	uint8_t hdrs_len;  /**< The length of the last headers, 0 if none */
+	uint8_t crc;       /**< The CRC over the last headers */
+};
+
+
+/**
+ * @brief The CRCs over the last uncompressed headers of one context
+ *
+ * Used to compute the CRC-3 and CRC-7 over the next headers from the bytes
+ * that changed only, see \ref crc_calc_hdrs
+ */
+struct crc_hdrs_cache
+{
+	struct crc_hdrs_ref crc_3;  /**< The headers of the last CRC-3 */
+	struct crc_hdrs_ref crc_7;  /**< The headers of the last CRC-7 */
+};
+
+
 /** The table to enable fast CRC-7 computation */
 static const uint8_t crc_table_7[256] =
 {
@@ -148,6 +180,23 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const uint32_t init_val)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 
+uint8_t crc_calc_8_sliced(const uint8_t *const buf,
+                          const size_t size,
+                          const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+uint8_t crc_calc_7_sliced(const uint8_t *const buf,
+                          const size_t size,
+                          const uint8_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+
+void crc_hdrs_cache_reset(struct crc_hdrs_cache *const cache)
+	__attribute__((nonnull(1)));
+uint8_t crc_calc_hdrs(struct crc_hdrs_cache *const cache,
+                      const rohc_crc_type_t crc_type,
+                      const uint8_t *const hdrs,
+                      const size_t hdrs_len)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
 uint8_t ip_compute_crc_static(const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                               const rohc_crc_type_t crc_type,
                               const uint8_t init_val)
@@ -260,6 +309,9 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 /**
  * @brief Optimized CRC-8 calculation using a table
  *
+ * Long data, like the whole uncompressed headers, is computed 8 bytes at a
+ * time with \ref crc_calc_8_sliced.
+ *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
  * @param init_val   The initial CRC value
@@ -272,6 +324,11 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 	uint8_t crc = init_val;
 	size_t i;
 
+	if(size >= CRC_SLICED_MIN_LEN)
+	{
+		return crc_calc_8_sliced(buf, size, init_val);
+	}
+
 	for(i = 0; i < size; i++)
 	{
 		crc = crc_table_8[buf[i] ^ crc];
@@ -284,6 +341,9 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 /**
  * @brief Optimized CRC-7 calculation using a table
  *
+ * Long data, like the whole uncompressed headers, is computed 8 bytes at a
+ * time with \ref crc_calc_7_sliced.
+ *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
  * @param init_val   The initial CRC value
@@ -296,6 +356,11 @@ static inline uint8_t crc_calc_7(const uint8_t *const buf,
 	uint8_t crc = init_val;
 	size_t i;
 
+	if(size >= CRC_SLICED_MIN_LEN)
+	{
+		return crc_calc_7_sliced(buf, size, init_val);
+	}
+
 	for(i = 0; i < size; i++)
 	{
 		crc = crc_table_7[buf[i] ^ (crc & 127)];
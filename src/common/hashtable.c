@@ -30,105 +30,575 @@
 #include <string.h>
 #include <assert.h>
 
+#if defined(__SSE2__) && !defined(__KERNEL__)
+#  include <emmintrin.h>
+#endif
 
+
+/** The minimal number of slots of a hash table */
+#define HASHTABLE_MIN_SLOTS  HASHTABLE_GROUP_LEN
+
+
+static bool hashtable_alloc(struct hashtable *const hashtable,
+                            const size_t slots_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool hashtable_grow(struct hashtable *const hashtable)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void hashtable_insert(struct hashtable *const hashtable,
+                             const uint32_t hash,
+                             const uint32_t idx)
+	__attribute__((nonnull(1)));
+
+static bool hashtable_find_slot(const struct hashtable *const hashtable,
+                                const uint32_t hash,
+                                const uint32_t idx,
+                                size_t *const slot)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static inline uint8_t hashtable_tag(const uint32_t hash)
+	__attribute__((warn_unused_result, const));
+
+static inline void hashtable_set_tag(struct hashtable *const hashtable,
+                                     const size_t slot,
+                                     const uint8_t tag)
+	__attribute__((nonnull(1)));
+
+static inline uint32_t hashtable_match(const uint8_t *const tags,
+                                       const uint8_t tag)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static uint64_t hashtable_fasthash(const void *const src,
+                                   const size_t src_len,
+                                   const char key[16])
+	__attribute__((warn_unused_result, nonnull(1, 3), pure));
+
+
+/**
+ * @brief Create a new hash table
+ *
+ * The hash table is sized for \e size elements with a load factor of at most
+ * one half. It grows automatically if more elements are added later.
+ *
+ * @param hashtable   The hash table to initialize
+ * @param key_offset  The offset of the key within the elements (in bytes)
+ * @param size        The number of elements that the table shall hold
+ * @param get_elem    The callback to get one element from its index
+ * @param elem_priv   The private data for the \e get_elem callback
+ * @return            true if the hash table was created, false otherwise
+ */
 bool hashtable_new(struct hashtable *const hashtable,
-                   const size_t key_len,
-                   const size_t size)
+                   const size_t key_offset,
+                   const size_t size,
+                   const hashtable_get_elem_t get_elem,
+                   const void *const elem_priv)
 {
-	hashtable->key_len = key_len;
-	hashtable->full_key_len = key_len;
-	hashtable->mask = size - 1;
+	size_t slots_nr = HASHTABLE_MIN_SLOTS;
 
-	hashtable->table = calloc(size, sizeof(struct hashlist *));
-	if(hashtable->table == NULL)
+	while(slots_nr < (size * 2))
 	{
-		return false;
+		slots_nr <<= 1;
 	}
 
-	return true;
+	hashtable->key_offset = key_offset;
+	hashtable->get_elem = get_elem;
+	hashtable->elem_priv = elem_priv;
+	hashtable->hash_fct = HASHTABLE_HASH_SIPHASH;
+
+	return hashtable_alloc(hashtable, slots_nr);
 }
 
 
 void hashtable_free(struct hashtable *const hashtable)
 {
-	free(hashtable->table);
+	free(hashtable->slots);
+	free(hashtable->tags);
 }
 
 
-void hashtable_add(struct hashtable *const hashtable,
-                   const void *const key,
-                   void *const elem)
+/**
+ * @brief Compute the hash of the given key with the hash function of the table
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to hash
+ * @param key_len    The length of the key (in bytes)
+ * @return           The hash of the key
+ */
+uint64_t hashtable_hash(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
-
-	entry = hashtable->table[hash & hashtable->mask];
-	if(entry == NULL)
+	if(hashtable->hash_fct == HASHTABLE_HASH_FAST)
 	{
-		hashtable->table[hash & hashtable->mask] = elem;
-		((struct hashlist *) elem)->prev = NULL;
+		return hashtable_fasthash(key, key_len, hashtable->key);
 	}
-	else
+	return siphash24(key, key_len, hashtable->key);
+}
+
+
+/**
+ * @brief Add one element to the hash table
+ *
+ * The hash table grows if it is more than 3/4 full.
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ * @return           true if the element was added, false if the hash table
+ *                   failed to grow
+ */
+bool hashtable_add(struct hashtable *const hashtable,
+                   const uint64_t hash,
+                   const uint32_t idx)
+{
+	const size_t slots_nr = hashtable->mask + 1;
+
+	if((hashtable->count + 1) > (slots_nr - slots_nr / 4) &&
+	   !hashtable_grow(hashtable))
 	{
-		while(entry->next != NULL)
-		{
-			entry = entry->next;
-		}
-		entry->next = elem;
-		((struct hashlist *) elem)->prev = entry;
+		return false;
 	}
-	((struct hashlist *) elem)->next = NULL;
+	hashtable_insert(hashtable, hash, idx);
+
+	return true;
 }
 
 
+/**
+ * @brief Get the element with the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param key_len    The length of the key (in bytes)
+ * @param hash       The hash of the key
+ * @return           The element if found, NULL otherwise
+ */
 void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+                     const void *const key,
+                     const size_t key_len,
+                     const uint64_t hash)
+{
+	size_t pos = hash & hashtable->mask;
+	return hashtable_lookup(hashtable, key, key_len, hash, &pos);
+}
+
+
+/**
+ * @brief Search for the next element with the given key
+ *
+ * Elements with the same key are found in the order they were added.
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param key_len    The length of the key (in bytes)
+ * @param hash       The hash of the key
+ * @param pos        IN: the slot to start the search from, the hash masked
+ *                   by the table size for the first search
+ *                   OUT: the slot to continue the search from
+ * @return           The element if found, NULL otherwise
+ */
+void * hashtable_lookup(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len,
+                        const uint64_t hash,
+                        size_t *const pos)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	const uint32_t hash32 = hash;
+	const uint8_t tag = hashtable_tag(hash32);
+	size_t group_pos = (*pos) & hashtable->mask;
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	/* the table is never full, so the search stops on one free slot */
+	while(1)
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		const uint8_t *const group = hashtable->tags + group_pos;
+		const uint32_t frees = hashtable_match(group, 0);
+		uint32_t matches = hashtable_match(group, tag);
+
+		/* ignore the slots behind the first free slot */
+		if(frees != 0)
 		{
-			break;
+			matches &= (frees & (~frees + 1)) - 1;
+		}
+
+		while(matches != 0)
+		{
+			const size_t slot = (group_pos + __builtin_ctz(matches)) & hashtable->mask;
+
+			if(hashtable->slots[slot].hash == hash32)
+			{
+				uint8_t *const elem =
+					hashtable->get_elem(hashtable->elem_priv, hashtable->slots[slot].idx);
+
+				if(memcmp(key, elem + hashtable->key_offset, key_len) == 0)
+				{
+					*pos = (slot + 1) & hashtable->mask;
+					return elem;
+				}
+			}
+			matches &= matches - 1;
+		}
+
+		if(frees != 0)
+		{
+			return NULL;
 		}
+		group_pos = (group_pos + HASHTABLE_GROUP_LEN) & hashtable->mask;
 	}
+}
 
-	return entry;
+
+/**
+ * @brief Whether the given element is in the hash table or not
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ * @return           true if the element is in the hash table, false otherwise
+ */
+bool hashtable_contains(const struct hashtable *const hashtable,
+                        const uint64_t hash,
+                        const uint32_t idx)
+{
+	size_t slot;
+	return hashtable_find_slot(hashtable, hash, idx, &slot);
 }
 
 
+/**
+ * @brief Remove one element from the hash table
+ *
+ * Nothing is done if the element is not in the hash table. The elements that
+ * follow the removed element are shifted back so that no search stops too
+ * early on the freed slot.
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ */
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
+                   const uint64_t hash,
+                   const uint32_t idx)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
+	size_t free_slot;
+	size_t slot;
+
+	if(!hashtable_find_slot(hashtable, hash, idx, &free_slot))
+	{
+		return;
+	}
+	assert(hashtable->count > 0);
+	hashtable->count--;
 
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next)
+	/* shift back the elements that are not at their home slot, stop on the
+	 * first free slot */
+	slot = free_slot;
+	while(1)
 	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
+		size_t home;
+
+		slot = (slot + 1) & hashtable->mask;
+		if(hashtable->tags[slot] == 0)
 		{
-			if(entry->prev == NULL)
-			{
-				hashtable->table[hash & hashtable->mask] = entry->next;
-			}
-			else
+			break;
+		}
+
+		/* the element cannot move if its home slot is between the free slot
+		 * (excluded) and its current slot (included) */
+		home = hashtable->slots[slot].hash & hashtable->mask;
+		if(free_slot <= slot)
+		{
+			if(free_slot < home && home <= slot)
 			{
-				entry->prev->next = entry->next;
+				continue;
 			}
+		}
+		else if(free_slot < home || home <= slot)
+		{
+			continue;
+		}
+
+		hashtable->slots[free_slot] = hashtable->slots[slot];
+		hashtable_set_tag(hashtable, free_slot, hashtable->tags[slot]);
+		free_slot = slot;
+	}
+	hashtable_set_tag(hashtable, free_slot, 0);
+}
+
+
+/**
+ * @brief Allocate the slots and tags of the hash table
+ *
+ * @param hashtable  The hash table
+ * @param slots_nr   The number of slots, a power of 2
+ * @return           true if allocation succeeded, false otherwise
+ */
+static bool hashtable_alloc(struct hashtable *const hashtable,
+                            const size_t slots_nr)
+{
+	assert(slots_nr >= HASHTABLE_MIN_SLOTS);
+	assert((slots_nr & (slots_nr - 1)) == 0);
+
+	hashtable->tags = calloc(slots_nr + HASHTABLE_GROUP_LEN - 1, sizeof(uint8_t));
+	if(hashtable->tags == NULL)
+	{
+		goto error;
+	}
+	hashtable->slots = malloc(slots_nr * sizeof(struct hashtable_slot));
+	if(hashtable->slots == NULL)
+	{
+		goto free_tags;
+	}
+	hashtable->mask = slots_nr - 1;
+	hashtable->count = 0;
 
-			if(entry->next != NULL)
+	return true;
+
+free_tags:
+	free(hashtable->tags);
+	hashtable->tags = NULL;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Double the number of slots of the hash table
+ *
+ * @param hashtable  The hash table
+ * @return           true if the hash table grew, false otherwise
+ */
+static bool hashtable_grow(struct hashtable *const hashtable)
+{
+	uint8_t *const old_tags = hashtable->tags;
+	struct hashtable_slot *const old_slots = hashtable->slots;
+	const size_t old_mask = hashtable->mask;
+	size_t first_slot;
+	size_t i;
+
+	if(!hashtable_alloc(hashtable, (old_mask + 1) * 2))
+	{
+		hashtable->tags = old_tags;
+		hashtable->slots = old_slots;
+		return false;
+	}
+
+	/* re-insert elements starting from one free slot, so that elements with
+	 * the same key keep their order */
+	for(first_slot = 0; old_tags[first_slot] != 0; first_slot++)
+	{
+	}
+	for(i = 1; i <= old_mask; i++)
+	{
+		const size_t slot = (first_slot + i) & old_mask;
+		if(old_tags[slot] != 0)
+		{
+			hashtable_insert(hashtable, old_slots[slot].hash, old_slots[slot].idx);
+		}
+	}
+
+	free(old_slots);
+	free(old_tags);
+
+	return true;
+}
+
+
+/**
+ * @brief Insert one element in the first free slot after its home slot
+ *
+ * @param hashtable  The hash table, with at least one free slot
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ */
+static void hashtable_insert(struct hashtable *const hashtable,
+                             const uint32_t hash,
+                             const uint32_t idx)
+{
+	size_t group_pos = hash & hashtable->mask;
+	uint32_t frees;
+	size_t slot;
+
+	assert(hashtable->count <= hashtable->mask);
+
+	while((frees = hashtable_match(hashtable->tags + group_pos, 0)) == 0)
+	{
+		group_pos = (group_pos + HASHTABLE_GROUP_LEN) & hashtable->mask;
+	}
+	slot = (group_pos + __builtin_ctz(frees)) & hashtable->mask;
+
+	hashtable->slots[slot].hash = hash;
+	hashtable->slots[slot].idx = idx;
+	hashtable_set_tag(hashtable, slot, hashtable_tag(hash));
+	hashtable->count++;
+}
+
+
+/**
+ * @brief Find the slot of the given element
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ * @param slot       OUT: the slot of the element if found
+ * @return           true if the element was found, false otherwise
+ */
+static bool hashtable_find_slot(const struct hashtable *const hashtable,
+                                const uint32_t hash,
+                                const uint32_t idx,
+                                size_t *const slot)
+{
+	const uint8_t tag = hashtable_tag(hash);
+	size_t group_pos = hash & hashtable->mask;
+
+	while(1)
+	{
+		const uint8_t *const group = hashtable->tags + group_pos;
+		const uint32_t frees = hashtable_match(group, 0);
+		uint32_t matches = hashtable_match(group, tag);
+
+		if(frees != 0)
+		{
+			matches &= (frees & (~frees + 1)) - 1;
+		}
+
+		while(matches != 0)
+		{
+			*slot = (group_pos + __builtin_ctz(matches)) & hashtable->mask;
+			if(hashtable->slots[*slot].hash == hash &&
+			   hashtable->slots[*slot].idx == idx)
 			{
-				entry->next->prev = entry->prev;
+				return true;
 			}
+			matches &= matches - 1;
+		}
 
-			break;
+		if(frees != 0)
+		{
+			return false;
 		}
+		group_pos = (group_pos + HASHTABLE_GROUP_LEN) & hashtable->mask;
+	}
+}
+
+
+/**
+ * @brief Compute the tag of a slot from the hash of its element
+ *
+ * The tag uses hash bits that are not used to compute the home slot of small
+ * tables. Free slots use the tag 0.
+ *
+ * @param hash  The hash of the key of the element
+ * @return      The tag, never 0
+ */
+static inline uint8_t hashtable_tag(const uint32_t hash)
+{
+	return (0x80 | (hash >> 25));
+}
+
+
+/**
+ * @brief Set the tag of one slot, and its copy if any
+ *
+ * @param hashtable  The hash table
+ * @param slot       The slot
+ * @param tag        The new tag of the slot
+ */
+static inline void hashtable_set_tag(struct hashtable *const hashtable,
+                                     const size_t slot,
+                                     const uint8_t tag)
+{
+	hashtable->tags[slot] = tag;
+	if(slot < (HASHTABLE_GROUP_LEN - 1))
+	{
+		hashtable->tags[hashtable->mask + 1 + slot] = tag;
+	}
+}
+
+
+/**
+ * @brief Compare one group of tags with the given tag
+ *
+ * @param tags  The group of \ref HASHTABLE_GROUP_LEN tags
+ * @param tag   The tag to search for
+ * @return      The bitmask of the tags that match
+ */
+static inline uint32_t hashtable_match(const uint8_t *const tags,
+                                       const uint8_t tag)
+{
+#if defined(__SSE2__) && !defined(__KERNEL__)
+	const __m128i group = _mm_loadu_si128((const __m128i *) tags);
+	const __m128i cmp = _mm_cmpeq_epi8(group, _mm_set1_epi8((char) tag));
+	return (uint32_t) _mm_movemask_epi8(cmp);
+#else
+	uint32_t matches = 0;
+	size_t i;
+
+	for(i = 0; i < HASHTABLE_GROUP_LEN; i++)
+	{
+		matches |= ((uint32_t) (tags[i] == tag)) << i;
+	}
+
+	return matches;
+#endif
+}
+
+
+/**
+ * @brief Compute a fast non-cryptographic hash of the given key
+ *
+ * The key is consumed 8 bytes at a time with one multiplication per word,
+ * then the result is finalized with the MurmurHash3 64-bit mixer. The random
+ * key of the hash table seeds the hash, but it is not a protection against
+ * hash flooding: use SipHash for untrusted traffic.
+ *
+ * @param src      The key to hash
+ * @param src_len  The length of the key (in bytes)
+ * @param key      The 16-byte random seed of the hash table
+ * @return         The hash of the key
+ */
+static uint64_t hashtable_fasthash(const void *const src,
+                                   const size_t src_len,
+                                   const char key[16])
+{
+	const uint64_t mult = 0x880355f21e6d1965ULL;
+	const uint8_t *data = src;
+	size_t remain_len = src_len;
+	uint64_t seed[2];
+	uint64_t hash;
+
+	memcpy(seed, key, 16);
+	hash = seed[0] ^ (src_len * mult);
+
+	while(remain_len >= 8)
+	{
+		uint64_t word;
+		memcpy(&word, data, 8);
+		word ^= seed[1];
+		word ^= word >> 23;
+		word *= 0x2127599bf4325c37ULL;
+		word ^= word >> 47;
+		hash = (hash ^ word) * mult;
+		data += 8;
+		remain_len -= 8;
+	}
+	if(remain_len > 0)
+	{
+		uint64_t word = 0;
+		memcpy(&word, data, remain_len);
+		word ^= seed[1];
+		word ^= word >> 23;
+		word *= 0x2127599bf4325c37ULL;
+		word ^= word >> 47;
+		hash = (hash ^ word) * mult;
 	}
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
 }
 
@@ -30,48 +30,120 @@
 #include <stdint.h>
 
 
-/** A linked list */
-struct hashlist
+/** The hash functions available for hash tables */
+enum hashtable_hash
 {
-	struct hashlist *prev;
-	struct hashlist *next;
-	struct hashlist *prev_cr;
-	struct hashlist *next_cr;
-	uint8_t key[];
-} __attribute__((packed));
+	/** SipHash-2-4, safe against hash flooding from untrusted traffic */
+	HASHTABLE_HASH_SIPHASH = 0,
+	/** A fast non-cryptographic hash, for trusted traffic only */
+	HASHTABLE_HASH_FAST    = 1,
+};
+
+
+/** The number of tags that are compared at once when probing a hash table */
+#define HASHTABLE_GROUP_LEN  16U
+
+
+/**
+ * @brief The callback to get one element of a hash table from its index
+ *
+ * @param priv  The private data given at hash table creation
+ * @param idx   The index of the element to retrieve
+ * @return      The element at the given index
+ */
+typedef void * (*hashtable_get_elem_t)(const void *const priv,
+                                       const uint32_t idx);
 
 
-/** One hash table */
+/** One slot of a hash table */
+struct hashtable_slot
+{
+	uint32_t hash;  /**< The 32 lower bits of the hash of the element key */
+	uint32_t idx;   /**< The index of the element */
+};
+
+
+/**
+ * @brief One hash table
+ *
+ * The hash table uses open addressing with linear probing. Every slot stores
+ * the hash and the index of one element, so that elements are only accessed
+ * to compare keys once their hashes matched. One 1-byte tag per slot allows
+ * to compare \ref HASHTABLE_GROUP_LEN slots at once; the first tags are
+ * duplicated at the end of the array of tags so that a group of tags may be
+ * loaded from any slot.
+ */
 struct hashtable
 {
-	size_t key_len;
-	size_t full_key_len;
-	uint64_t mask;
-	struct hashlist **table;
-	char key[16];
+	uint8_t *tags;                 /**< The tags of slots, 0 for free slots */
+	struct hashtable_slot *slots;  /**< The slots */
+	size_t mask;                   /**< The number of slots minus one */
+	size_t count;                  /**< The number of elements in the table */
+	size_t key_offset;             /**< The offset of the key in elements */
+	hashtable_get_elem_t get_elem; /**< How to get an element from its index */
+	const void *elem_priv;         /**< The private data for \e get_elem */
+	char key[16];                  /**< The random key of the hash function */
+	enum hashtable_hash hash_fct;  /**< The hash function to use */
 };
 
 
 bool hashtable_new(struct hashtable *const hashtable,
-                   const size_t key_len,
-                   const size_t size)
-	__attribute((warn_unused_result, nonnull(1)));
+                   const size_t key_offset,
+                   const size_t size,
+                   const hashtable_get_elem_t get_elem,
+                   const void *const elem_priv)
+	__attribute((warn_unused_result, nonnull(1, 4, 5)));
 
 void hashtable_free(struct hashtable *const hashtable)
 	__attribute((nonnull(1)));
 
-void hashtable_add(struct hashtable *const hashtable,
-                   const void *const key,
-                   void *const elem)
-	__attribute((nonnull(1, 2, 3)));
+uint64_t hashtable_hash(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len)
+	__attribute((warn_unused_result, nonnull(1, 2)));
+
+bool hashtable_add(struct hashtable *const hashtable,
+                   const uint64_t hash,
+                   const uint32_t idx)
+	__attribute((warn_unused_result, nonnull(1)));
 
 void * hashtable_get(const struct hashtable *const hashtable,
-                     const void *const key)
+                     const void *const key,
+                     const size_t key_len,
+                     const uint64_t hash)
 	__attribute((warn_unused_result, nonnull(1, 2)));
 
+void * hashtable_lookup(const struct hashtable *const hashtable,
+                        const void *const key,
+                        const size_t key_len,
+                        const uint64_t hash,
+                        size_t *const pos)
+	__attribute((warn_unused_result, nonnull(1, 2, 5)));
+
+bool hashtable_contains(const struct hashtable *const hashtable,
+                        const uint64_t hash,
+                        const uint32_t idx)
+	__attribute((warn_unused_result, nonnull(1)));
+
 void hashtable_del(struct hashtable *const hashtable,
-                   const void *const key)
-	__attribute((nonnull(1, 2)));
+                   const uint64_t hash,
+                   const uint32_t idx)
+	__attribute((nonnull(1)));
+
+
+/**
+ * @brief Prefetch the first slots that a search for the given hash reads
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key to search for later
+ */
+static inline void hashtable_prefetch(const struct hashtable *const hashtable,
+                                      const uint64_t hash)
+{
+	const size_t slot = hash & hashtable->mask;
+	__builtin_prefetch(hashtable->tags + slot);
+	__builtin_prefetch(hashtable->slots + slot);
+}
 
 #endif
 
@@ -24,131 +24,108 @@
 
 #include "hashtable_cr.h"
 
-#include "csiphash.h"
-
-#include <stdlib.h>
-#include <string.h>
-#include <assert.h>
-
 
+/**
+ * @brief Create a new hash table for Context Replication
+ *
+ * Several elements may share the same key in the hash table.
+ *
+ * @param hashtable   The hash table to initialize
+ * @param key_offset  The offset of the key within the elements (in bytes)
+ * @param size        The number of elements that the table shall hold
+ * @param get_elem    The callback to get one element from its index
+ * @param elem_priv   The private data for the \e get_elem callback
+ * @return            true if the hash table was created, false otherwise
+ */
 bool hashtable_cr_new(struct hashtable *const hashtable,
-                      const size_t key_len,
-                      const size_t full_key_len,
-                      const size_t size)
+                      const size_t key_offset,
+                      const size_t size,
+                      const hashtable_get_elem_t get_elem,
+                      const void *const elem_priv)
 {
-	hashtable->key_len = key_len;
-	hashtable->full_key_len = full_key_len;
-	hashtable->mask = size - 1;
-
-	hashtable->table = calloc(size, sizeof(struct hashlist *));
-	if(hashtable->table == NULL)
-	{
-		return false;
-	}
-
-	return true;
+	return hashtable_new(hashtable, key_offset, size, get_elem, elem_priv);
 }
 
 
 void hashtable_cr_free(struct hashtable *const hashtable)
 {
-	free(hashtable->table);
+	hashtable_free(hashtable);
 }
 
 
-void hashtable_cr_add(struct hashtable *const hashtable,
-                      const void *const key,
-                      void *const elem)
+/**
+ * @brief Add one element to the hash table if it is not already there
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ * @return           true if the element is in the hash table,
+ *                   false if the hash table failed to grow
+ */
+bool hashtable_cr_add(struct hashtable *const hashtable,
+                      const uint64_t hash,
+                      const uint32_t idx)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
-
-	entry = hashtable->table[hash & hashtable->mask];
-	if(entry == NULL)
+	if(hashtable_contains(hashtable, hash, idx))
 	{
-		hashtable->table[hash & hashtable->mask] = elem;
-		((struct hashlist *) elem)->prev_cr = NULL;
+		return true;
 	}
-	else
-	{
-		while(entry->next_cr != NULL)
-		{
-			entry = entry->next_cr;
-		}
-		entry->next_cr = elem;
-		((struct hashlist *) elem)->prev_cr = entry;
-	}
-	((struct hashlist *) elem)->next_cr = NULL;
+	return hashtable_add(hashtable, hash, idx);
 }
 
 
+/**
+ * @brief Get the first element added with the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param key_len    The length of the key (in bytes)
+ * @param hash       The hash of the key
+ * @param pos        OUT: the position to give to \ref hashtable_cr_get_next
+ * @return           The element if found, NULL otherwise
+ */
 void * hashtable_cr_get_first(const struct hashtable *const hashtable,
-                              const void *const key)
+                              const void *const key,
+                              const size_t key_len,
+                              const uint64_t hash,
+                              size_t *const pos)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
-
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next_cr)
-	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
-		{
-			break;
-		}
-	}
-
-	return entry;
+	*pos = hash & hashtable->mask;
+	return hashtable_lookup(hashtable, key, key_len, hash, pos);
 }
 
 
+/**
+ * @brief Get the next element with the given key
+ *
+ * @param hashtable  The hash table
+ * @param key        The key to search for
+ * @param key_len    The length of the key (in bytes)
+ * @param hash       The hash of the key
+ * @param pos        IN/OUT: the position returned by the previous search
+ * @return           The element if found, NULL otherwise
+ */
 void * hashtable_cr_get_next(const struct hashtable *const hashtable,
                              const void *const key,
-                             void *const pos)
+                             const size_t key_len,
+                             const uint64_t hash,
+                             size_t *const pos)
 {
-	struct hashlist *prev = pos;
-	struct hashlist *entry;
-
-	for(entry = prev->next_cr; entry != NULL; entry = entry->next_cr)
-	{
-		if(memcmp(key, entry->key, hashtable->key_len) == 0)
-		{
-			break;
-		}
-	}
-
-	return entry;
+	return hashtable_lookup(hashtable, key, key_len, hash, pos);
 }
 
 
+/**
+ * @brief Remove one element from the hash table if it is there
+ *
+ * @param hashtable  The hash table
+ * @param hash       The hash of the key of the element
+ * @param idx        The index of the element
+ */
 void hashtable_cr_del(struct hashtable *const hashtable,
-                      const void *const key)
+                      const uint64_t hash,
+                      const uint32_t idx)
 {
-	const uint64_t hash = siphash24(key, hashtable->key_len, hashtable->key);
-	struct hashlist *entry;
-
-	for(entry = hashtable->table[hash & hashtable->mask];
-	    entry != NULL;
-	    entry = entry->next_cr)
-	{
-		if(memcmp(key, entry->key, hashtable->full_key_len) == 0)
-		{
-			if(entry->prev_cr == NULL)
-			{
-				hashtable->table[hash & hashtable->mask] = entry->next_cr;
-			}
-			else
-			{
-				entry->prev_cr->next_cr = entry->next_cr;
-			}
-
-			if(entry->next_cr != NULL)
-			{
-				entry->next_cr->prev_cr = entry->prev_cr;
-			}
-
-			break;
-		}
-	}
+	hashtable_del(hashtable, hash, idx);
 }
 
@@ -32,31 +32,38 @@
 #include <stdint.h>
 
 bool hashtable_cr_new(struct hashtable *const hashtable,
-                      const size_t key_len,
-                      const size_t full_key_len,
-                      const size_t size)
-	__attribute((warn_unused_result, nonnull(1)));
+                      const size_t key_offset,
+                      const size_t size,
+                      const hashtable_get_elem_t get_elem,
+                      const void *const elem_priv)
+	__attribute((warn_unused_result, nonnull(1, 4, 5)));
 
 void hashtable_cr_free(struct hashtable *const hashtable)
 	__attribute((nonnull(1)));
 
-void hashtable_cr_add(struct hashtable *const hashtable,
-                      const void *const key,
-                      void *const elem)
-	__attribute((nonnull(1, 2, 3)));
+bool hashtable_cr_add(struct hashtable *const hashtable,
+                      const uint64_t hash,
+                      const uint32_t idx)
+	__attribute((warn_unused_result, nonnull(1)));
 
 void * hashtable_cr_get_first(const struct hashtable *const hashtable,
-                              const void *const key)
-	__attribute((warn_unused_result, nonnull(1, 2)));
+                              const void *const key,
+                              const size_t key_len,
+                              const uint64_t hash,
+                              size_t *const pos)
+	__attribute((warn_unused_result, nonnull(1, 2, 5)));
 
 void * hashtable_cr_get_next(const struct hashtable *const hashtable,
                              const void *const key,
-                             void *const pos)
-	__attribute((warn_unused_result, nonnull(1, 2, 3)));
+                             const size_t key_len,
+                             const uint64_t hash,
+                             size_t *const pos)
+	__attribute((warn_unused_result, nonnull(1, 2, 5)));
 
 void hashtable_cr_del(struct hashtable *const hashtable,
-                      const void *const key)
-	__attribute((nonnull(1, 2)));
+                      const uint64_t hash,
+                      const uint32_t idx)
+	__attribute((nonnull(1)));
 
 #endif
 
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   ring.c
+ * @brief  Lock-free ring of variable-length records for one producer and one
+ *         consumer
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/**
+ * @brief Create a new ring
+ *
+ * The size shall be a power of two, so that the positions of the producer
+ * and the consumer stay valid when they wrap around.
+ *
+ * @param ring  The ring to initialize
+ * @param size  The size of the buffer of the ring (in bytes), a power of two
+ * @return      true if the ring was created, false otherwise
+ */
+bool ring_new(struct ring *const ring, const size_t size)
+{
+	if(size < RING_REC_HDR_LEN || (size & (size - 1)) != 0)
+	{
+		goto error;
+	}
+
+	ring->data = malloc(size);
+	if(ring->data == NULL)
+	{
+		goto error;
+	}
+	ring->size = size;
+	ring->head = 0;
+	ring->tail = 0;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the given ring
+ *
+ * @param ring  The ring to destroy
+ */
+void ring_free(struct ring *const ring)
+{
+	free(ring->data);
+	ring->data = NULL;
+	ring->size = 0;
+}
+
+
+/**
+ * @brief Push one record in the ring
+ *
+ * Shall only be called by the producer.
+ *
+ * @param ring  The ring
+ * @param data  The bytes of the record
+ * @param len   The length of the record (in bytes)
+ * @return      true if the record was pushed,
+ *              false if it is empty, too large, or if the ring is full
+ */
+bool ring_push(struct ring *const ring,
+               const uint8_t *const data,
+               const size_t len)
+{
+	const size_t rec_len = RING_REC_HDR_LEN + len;
+	const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	size_t head = ring->head;
+	size_t pos = head & (ring->size - 1);
+	const size_t contiguous_len = ring->size - pos;
+	const uint16_t rec_hdr = len;
+
+	if(len == 0 || len > RING_REC_MAX_LEN || rec_len > ring->size)
+	{
+		goto error;
+	}
+
+	/* skip the end of the buffer if the record does not fit before it: the
+	 * skip is published on its own, so that the consumer frees the end of
+	 * the buffer even if the record does not fit in the ring yet */
+	if(contiguous_len < rec_len)
+	{
+		if((ring->size - (head - tail)) < contiguous_len)
+		{
+			goto error;
+		}
+		if(contiguous_len >= RING_REC_HDR_LEN)
+		{
+			memset(ring->data + pos, 0, RING_REC_HDR_LEN);
+		}
+		head += contiguous_len;
+		pos = 0;
+		__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+	}
+	if((ring->size - (head - tail)) < rec_len)
+	{
+		goto error;
+	}
+
+	memcpy(ring->data + pos, &rec_hdr, RING_REC_HDR_LEN);
+	memcpy(ring->data + pos + RING_REC_HDR_LEN, data, len);
+
+	/* publish the record to the consumer */
+	__atomic_store_n(&ring->head, head + rec_len, __ATOMIC_RELEASE);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the oldest record of the ring
+ *
+ * The record stays in the ring until \ref ring_pop is called. Shall only be
+ * called by the consumer.
+ *
+ * @param ring      The ring
+ * @param[out] len  The length of the record (in bytes)
+ * @return          The bytes of the record, NULL if the ring is empty
+ */
+const uint8_t * ring_peek(struct ring *const ring, size_t *const len)
+{
+	const size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	size_t tail = ring->tail;
+
+	while(tail != head)
+	{
+		const size_t pos = tail & (ring->size - 1);
+		const size_t contiguous_len = ring->size - pos;
+		uint16_t rec_hdr;
+
+		/* skip the end of the buffer if the producer did */
+		if(contiguous_len < RING_REC_HDR_LEN)
+		{
+			tail += contiguous_len;
+			continue;
+		}
+		memcpy(&rec_hdr, ring->data + pos, RING_REC_HDR_LEN);
+		if(rec_hdr == 0)
+		{
+			tail += contiguous_len;
+			continue;
+		}
+
+		/* give the skipped bytes back to the producer */
+		if(tail != ring->tail)
+		{
+			__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+		}
+
+		*len = rec_hdr;
+		return ring->data + pos + RING_REC_HDR_LEN;
+	}
+
+	if(tail != ring->tail)
+	{
+		__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Remove the oldest record from the ring
+ *
+ * Shall only be called by the consumer, after \ref ring_peek returned the
+ * record.
+ *
+ * @param ring  The ring
+ * @param len   The length of the record, as returned by \ref ring_peek
+ */
+void ring_pop(struct ring *const ring, const size_t len)
+{
+	assert(len > 0);
+	__atomic_store_n(&ring->tail, ring->tail + RING_REC_HDR_LEN + len,
+	                 __ATOMIC_RELEASE);
+}
+
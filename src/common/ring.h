@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   ring.h
+ * @brief  Lock-free ring of variable-length records for one producer and one
+ *         consumer
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_RING_H
+#define ROHC_RING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/** The length of the header of every record in a ring (in bytes) */
+#define RING_REC_HDR_LEN  2U
+
+/** The max length of one record in a ring (in bytes) */
+#define RING_REC_MAX_LEN  UINT16_MAX
+
+/** The size of a cache line, to keep the producer and consumer apart */
+#define RING_CACHE_LINE_LEN  64U
+
+
+/**
+ * @brief One ring of variable-length records
+ *
+ * One producer thread pushes records while one consumer thread pops them,
+ * without any lock. Every record is stored contiguously behind a 2-byte
+ * header that holds its length. When a record does not fit before the end
+ * of the buffer, the producer skips the end of the buffer, that a zero
+ * length marks if there is room for it.
+ *
+ * The positions of the producer and the consumer grow forever, their
+ * difference is the number of bytes in use. The size of the buffer is a
+ * power of two, so the positions remain valid when they wrap around. Each
+ * of them is only written by its owner and published with release
+ * semantics.
+ */
+struct ring
+{
+	uint8_t *data;     /**< The buffer of the ring */
+	size_t size;       /**< The size of the buffer (in bytes), a power of 2 */
+	size_t head;       /**< The position of the producer */
+	/** Keep the positions of the producer and the consumer in different
+	 *  cache lines to avoid false sharing */
+	uint8_t pad[RING_CACHE_LINE_LEN - sizeof(size_t)];
+	size_t tail;       /**< The position of the consumer */
+};
+
+
+bool ring_new(struct ring *const ring, const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void ring_free(struct ring *const ring)
+	__attribute__((nonnull(1)));
+
+bool ring_push(struct ring *const ring,
+               const uint8_t *const data,
+               const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+const uint8_t * ring_peek(struct ring *const ring, size_t *const len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+void ring_pop(struct ring *const ring, const size_t len)
+	__attribute__((nonnull(1)));
+
+#endif
+
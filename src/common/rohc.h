@@ -210,6 +210,42 @@ typedef enum
 } rohc_reordering_offset_t;
 
 
+/**
+ * @brief The prototype of the callback that reserves memory
+ *
+ * User-defined function that is called by the ROHC library when it needs
+ * more memory for its contexts. The memory shall be suitably aligned for
+ * any kind of variable, as the one returned by malloc().
+ *
+ * @param priv_ctxt  The private context given by the user with the callback,
+ *                   may be NULL
+ * @param size       The number of bytes to reserve
+ * @return           The reserved memory, NULL if no memory is available
+ *
+ * @see rohc_comp_set_allocator
+ * @ingroup rohc
+ */
+typedef void * (*rohc_alloc_cb_t)(void *const priv_ctxt, const size_t size)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The prototype of the callback that releases memory
+ *
+ * User-defined function that is called by the ROHC library to give back
+ * the memory that was reserved by the matching \ref rohc_alloc_cb_t
+ * callback.
+ *
+ * @param priv_ctxt  The private context given by the user with the callback,
+ *                   may be NULL
+ * @param ptr        The memory to release
+ *
+ * @see rohc_comp_set_allocator
+ * @ingroup rohc
+ */
+typedef void (*rohc_free_cb_t)(void *const priv_ctxt, void *const ptr);
+
+
 /*
  * Prototypes of public functions
  */
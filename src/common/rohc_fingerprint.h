@@ -30,6 +30,7 @@
 #include "rohc_profiles.h"
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __KERNEL__
 #  include <endian.h>
@@ -65,11 +66,13 @@ struct rohc_fingerprint_base
 
 /**
  * @brief The unique fingerprint of one compression context or uncompressed packet
+ *
+ * The base part is located at the very end of the fingerprint, so that the
+ * unused IP headers of the base part are at the very end of the fingerprint:
+ * only the first \ref rohc_fingerprint_len bytes are significant.
  */
 struct rohc_fingerprint
 {
-	struct rohc_fingerprint_base base;
-
 	union
 	{
 		struct
@@ -82,7 +85,37 @@ struct rohc_fingerprint
 
 	uint32_t rtp_ssrc;
 
+	struct rohc_fingerprint_base base;
+
 } __attribute__((packed));
 
+
+/**
+ * @brief Get the number of significant bytes in the given base fingerprint
+ *
+ * The IP headers after the \e ip_hdrs_nr first ones are unused and zeroed.
+ *
+ * @param base  The base fingerprint
+ * @return      The length of the base fingerprint without its unused IP headers
+ */
+static inline size_t rohc_fingerprint_base_len(const struct rohc_fingerprint_base *const base)
+{
+	return sizeof(struct rohc_fingerprint_base) -
+	       (ROHC_MAX_IP_HDRS - base->ip_hdrs_nr) * sizeof(struct rohc_fingerprint_ip);
+}
+
+
+/**
+ * @brief Get the number of significant bytes in the given fingerprint
+ *
+ * @param fingerprint  The fingerprint
+ * @return             The length of the fingerprint without its unused IP headers
+ */
+static inline size_t rohc_fingerprint_len(const struct rohc_fingerprint *const fingerprint)
+{
+	return sizeof(struct rohc_fingerprint) - sizeof(struct rohc_fingerprint_base) +
+	       rohc_fingerprint_base_len(&fingerprint->base);
+}
+
 #endif
 
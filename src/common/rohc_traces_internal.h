@@ -50,13 +50,27 @@
 		} \
 	} while(0)
 
+/**
+ * @brief Whether a trace of the given level shall be emitted or not
+ *
+ * Traces are emitted only if a trace callback was defined and if their level
+ * is not lower than the minimum trace level of the given entity. Traces are
+ * disabled most of the time on the datapath, so tell the compiler to optimize
+ * for that case: it avoids formatting arguments for nothing.
+ */
+#define rohc_trace_is_enabled(entity_struct, level) \
+	__builtin_expect((entity_struct)->trace_callback != NULL && \
+	                 (level) >= (entity_struct)->trace_level, 0)
+
 /** Print information depending on the debug level */
 #define rohc_print(entity_struct, level, entity, profile, format, ...) \
 	do { \
-		__rohc_print((entity_struct)->trace_callback, \
-		             (entity_struct)->trace_callback_priv, \
-		             level, entity, profile, \
-		             format, ##__VA_ARGS__); \
+		if(rohc_trace_is_enabled(entity_struct, level)) { \
+			__rohc_print((entity_struct)->trace_callback, \
+			             (entity_struct)->trace_callback_priv, \
+			             level, entity, profile, \
+			             format, ##__VA_ARGS__); \
+		} \
 	} while(0)
 
 /** Print debug messages prefixed with the function name */
@@ -84,6 +98,8 @@
 #define __rohc_print(trace_cb, trace_cb_priv, \
                      level, entity, profile, format, ...) \
 	do { } while(0)
+#define rohc_trace_is_enabled(entity_struct, level) \
+	0
 #define rohc_debug(entity_struct, entity, profile, format, ...) \
 	do { } while(0)
 #define rohc_info(entity_struct, entity, profile, format, ...) \
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   slab.c
+ * @brief  Pool of fixed-length objects that are recycled without the help of
+ *         the system allocator
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "slab.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** The header of one chunk of memory reserved by a slab */
+struct slab_chunk
+{
+	struct slab_chunk *next;  /**< The next chunk of the slab */
+};
+
+
+/** The header of one object of a slab */
+struct slab_obj
+{
+	union
+	{
+		struct slab *slab;      /**< The slab of the object, if in use */
+		struct slab_obj *next;  /**< The next free object, if not in use */
+	} u;
+};
+
+
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(struct slab_chunk) <= SLAB_OBJ_HDR_LEN,
+               "slab_chunk should fit in SLAB_OBJ_HDR_LEN bytes");
+_Static_assert(sizeof(struct slab_obj) <= SLAB_OBJ_HDR_LEN,
+               "slab_obj should fit in the header of the objects");
+#endif
+
+
+static bool slab_grow(struct slab *const slab)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool slab_add_chunk(struct slab *const slab, const size_t objs_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Create a new slab
+ *
+ * No memory is reserved until the first object is allocated.
+ *
+ * @param slab        The slab to initialize
+ * @param obj_len     The length of the objects (in bytes)
+ * @param objs_max    The max number of objects in the slab
+ * @param alloc_cb    The function that reserves the chunks of the slab,
+ *                    NULL to use malloc()
+ * @param free_cb     The function that releases the chunks of the slab,
+ *                    NULL to use free()
+ * @param alloc_priv  The private context given to the allocator, may be NULL
+ */
+void slab_new(struct slab *const slab,
+              const size_t obj_len,
+              const size_t objs_max,
+              const rohc_alloc_cb_t alloc_cb,
+              const rohc_free_cb_t free_cb,
+              void *const alloc_priv)
+{
+	assert(obj_len > 0);
+	assert((alloc_cb == NULL) == (free_cb == NULL));
+
+	slab->alloc_cb = alloc_cb;
+	slab->free_cb = free_cb;
+	slab->alloc_priv = alloc_priv;
+
+	slab->obj_len = obj_len;
+	slab->slot_len = SLAB_OBJ_HDR_LEN +
+		((obj_len + SLAB_OBJ_ALIGN - 1) / SLAB_OBJ_ALIGN) * SLAB_OBJ_ALIGN;
+	slab->objs_max = objs_max;
+	slab->objs_nr = 0;
+	slab->used_nr = 0;
+
+	slab->free_objs = NULL;
+	slab->chunks = NULL;
+}
+
+
+/**
+ * @brief Destroy the given slab
+ *
+ * All the chunks of the slab are given back to the allocator. No object of
+ * the slab shall be in use anymore.
+ *
+ * @param slab  The slab to destroy
+ */
+void slab_free(struct slab *const slab)
+{
+	assert(slab->used_nr == 0);
+
+	while(slab->chunks != NULL)
+	{
+		struct slab_chunk *const chunk = slab->chunks;
+
+		slab->chunks = chunk->next;
+		if(slab->free_cb != NULL)
+		{
+			slab->free_cb(slab->alloc_priv, chunk);
+		}
+		else
+		{
+			free(chunk);
+		}
+	}
+	slab->free_objs = NULL;
+	slab->objs_nr = 0;
+}
+
+
+/**
+ * @brief Reserve all the objects of the given slab at once
+ *
+ * The objects that were not reserved yet are reserved in one single chunk,
+ * so that they are contiguous in memory and that the slab never calls the
+ * allocator again.
+ *
+ * @param slab  The slab to fill
+ * @return      true if all the objects are reserved, false if no memory is
+ *              available
+ */
+bool slab_reserve(struct slab *const slab)
+{
+	return slab_reserve_nr(slab, slab->objs_max);
+}
+
+
+/**
+ * @brief Reserve objects at once until the slab holds the given number
+ *
+ * The objects that are missing are reserved in one single chunk, so that the
+ * slab does not call the allocator again until more objects are in use. The
+ * slab never holds more than its max number of objects.
+ *
+ * @param slab     The slab to fill
+ * @param objs_nr  The number of objects that the slab shall hold
+ * @return         true if the objects are reserved, false if no memory is
+ *                 available
+ */
+bool slab_reserve_nr(struct slab *const slab, const size_t objs_nr)
+{
+	const size_t target_nr = (objs_nr < slab->objs_max ? objs_nr : slab->objs_max);
+
+	if(slab->objs_nr >= target_nr)
+	{
+		return true;
+	}
+	return slab_add_chunk(slab, target_nr - slab->objs_nr);
+}
+
+
+/**
+ * @brief Allocate one object from the given slab
+ *
+ * A released object is re-used if any, otherwise a new chunk of objects is
+ * reserved. The object is zeroed.
+ *
+ * @param slab  The slab to allocate the object from
+ * @return      The object, NULL if the slab is exhausted or no memory is
+ *              available
+ */
+void * slab_alloc(struct slab *const slab)
+{
+	struct slab_obj *obj;
+
+	if(slab->free_objs == NULL && !slab_grow(slab))
+	{
+		goto error;
+	}
+
+	obj = slab->free_objs;
+	slab->free_objs = obj->u.next;
+	obj->u.slab = slab;
+	slab->used_nr++;
+
+	memset(((uint8_t *) obj) + SLAB_OBJ_HDR_LEN, 0, slab->obj_len);
+
+	return ((uint8_t *) obj) + SLAB_OBJ_HDR_LEN;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Give one object back to its slab
+ *
+ * @param obj  The object to release, NULL to do nothing
+ */
+void slab_release(void *const obj)
+{
+	if(obj != NULL)
+	{
+		struct slab_obj *const hdr =
+			(struct slab_obj *) (((uint8_t *) obj) - SLAB_OBJ_HDR_LEN);
+		struct slab *const slab = hdr->u.slab;
+
+		assert(slab->used_nr > 0);
+		slab->used_nr--;
+		hdr->u.next = slab->free_objs;
+		slab->free_objs = hdr;
+	}
+}
+
+
+/**
+ * @brief Reserve one new chunk of objects for the given slab
+ *
+ * The chunk holds as many objects as \ref SLAB_CHUNK_LEN bytes allow, at
+ * least one, without exceeding the max number of objects of the slab.
+ *
+ * @param slab  The slab to grow
+ * @return      true if new objects are available, false otherwise
+ */
+static bool slab_grow(struct slab *const slab)
+{
+	size_t objs_nr;
+
+	if(slab->objs_nr >= slab->objs_max)
+	{
+		return false;
+	}
+
+	objs_nr = (SLAB_CHUNK_LEN - SLAB_OBJ_HDR_LEN) / slab->slot_len;
+	if(objs_nr == 0)
+	{
+		objs_nr = 1;
+	}
+	else if(objs_nr > (slab->objs_max - slab->objs_nr))
+	{
+		objs_nr = slab->objs_max - slab->objs_nr;
+	}
+
+	return slab_add_chunk(slab, objs_nr);
+}
+
+
+/**
+ * @brief Reserve one new chunk of the given number of objects
+ *
+ * The header of the chunk is padded to \ref SLAB_OBJ_HDR_LEN bytes to keep
+ * the objects aligned.
+ *
+ * @param slab     The slab to grow
+ * @param objs_nr  The number of objects in the new chunk
+ * @return         true if new objects are available, false otherwise
+ */
+static bool slab_add_chunk(struct slab *const slab, const size_t objs_nr)
+{
+	struct slab_chunk *chunk;
+	size_t i;
+
+	assert(objs_nr > 0);
+	assert(objs_nr <= (slab->objs_max - slab->objs_nr));
+
+	if(slab->alloc_cb != NULL)
+	{
+		chunk = slab->alloc_cb(slab->alloc_priv,
+		                       SLAB_OBJ_HDR_LEN + objs_nr * slab->slot_len);
+	}
+	else
+	{
+		chunk = malloc(SLAB_OBJ_HDR_LEN + objs_nr * slab->slot_len);
+	}
+	if(chunk == NULL)
+	{
+		goto error;
+	}
+	chunk->next = slab->chunks;
+	slab->chunks = chunk;
+
+	/* chain the new objects in the list of free objects */
+	for(i = objs_nr; i > 0; i--)
+	{
+		struct slab_obj *const obj = (struct slab_obj *)
+			(((uint8_t *) chunk) + SLAB_OBJ_HDR_LEN + (i - 1) * slab->slot_len);
+
+		obj->u.next = slab->free_objs;
+		slab->free_objs = obj;
+	}
+	slab->objs_nr += objs_nr;
+
+	return true;
+
+error:
+	return false;
+}
+
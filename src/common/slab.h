@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   slab.h
+ * @brief  Pool of fixed-length objects that are recycled without the help of
+ *         the system allocator
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#ifndef ROHC_SLAB_H
+#define ROHC_SLAB_H
+
+#include "rohc.h"
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/** The alignment of the objects of a slab (in bytes) */
+#define SLAB_OBJ_ALIGN  16U
+
+/** The length of the header in front of every object of a slab (in bytes) */
+#define SLAB_OBJ_HDR_LEN  SLAB_OBJ_ALIGN
+
+/** The length of the chunks of memory that a slab reserves (in bytes) */
+#define SLAB_CHUNK_LEN  65536U
+
+
+struct slab_chunk;
+struct slab_obj;
+
+
+/**
+ * @brief One pool of fixed-length objects
+ *
+ * The objects are carved in chunks of memory that the slab reserves when
+ * no released object is available, until the max number of objects is
+ * reached. Released objects are chained in a list of free objects, they
+ * are given back to the allocator only when the slab is destroyed.
+ *
+ * Every object is stored behind a header that points to its slab, so that
+ * an object may be released without knowing its length nor its slab.
+ */
+struct slab
+{
+	rohc_alloc_cb_t alloc_cb;  /**< The function that reserves the chunks */
+	rohc_free_cb_t free_cb;    /**< The function that releases the chunks */
+	void *alloc_priv;          /**< The private context of the allocator */
+
+	size_t obj_len;     /**< The length of the objects (in bytes) */
+	size_t slot_len;    /**< The length of the objects and their header */
+	size_t objs_max;    /**< The max number of objects in the slab */
+	size_t objs_nr;     /**< The number of objects reserved so far */
+	size_t used_nr;     /**< The number of objects in use */
+
+	struct slab_obj *free_objs;   /**< The objects that are not in use */
+	struct slab_chunk *chunks;    /**< The chunks reserved so far */
+};
+
+
+void slab_new(struct slab *const slab,
+              const size_t obj_len,
+              const size_t objs_max,
+              const rohc_alloc_cb_t alloc_cb,
+              const rohc_free_cb_t free_cb,
+              void *const alloc_priv)
+	__attribute__((nonnull(1)));
+
+void slab_free(struct slab *const slab)
+	__attribute__((nonnull(1)));
+
+bool slab_reserve(struct slab *const slab)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+bool slab_reserve_nr(struct slab *const slab, const size_t objs_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void * slab_alloc(struct slab *const slab)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void slab_release(void *const obj);
+
+#endif
+
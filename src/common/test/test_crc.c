@@ -0,0 +1,222 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc.c
+ * @brief   Test the CRC routines against a bit-by-bit computation
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The table, sliced and hardware CRC routines shall give the same CRCs as
+ * a computation bit after bit, whatever the length and the alignment of the
+ * data. The CRCs updated from the changed bytes of headers shall be the same
+ * as the CRCs computed over all the bytes.
+ */
+
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The maximum length of the tested data */
+#define DATA_MAX_LEN  1500U
+
+
+static uint32_t test_crc_bitwise(const uint8_t *const data,
+                                 const size_t length,
+                                 const uint32_t init_val,
+                                 const uint32_t poly)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint32_t test_rand(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test the CRC routines
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	/* the bit-reflected polynomials of the CRC-3, CRC-7, CRC-8 and FCS-32 */
+	const uint32_t poly_3 = 0x6;
+	const uint32_t poly_7 = 0x79;
+	const uint32_t poly_8 = 0xe0;
+	const uint32_t poly_fcs32 = 0xedb88320;
+	const uint8_t check_data[] = "123456789";
+	uint8_t data[DATA_MAX_LEN + 8];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the CRC routines against a bit-by-bit computation\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* the check values of the catalogue of parametrised CRC algorithms */
+	CHECK(crc_calculate(ROHC_CRC_TYPE_3, check_data, 9, CRC_INIT_3) == 0x6);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_7, check_data, 9, CRC_INIT_7) == 0x53);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_8, check_data, 9, CRC_INIT_8) == 0xd0);
+	CHECK(~crc_calc_fcs32(check_data, 9, CRC_INIT_FCS32) == 0xcbf43926);
+	CHECK(crc_calculate(ROHC_CRC_TYPE_NONE, check_data, 9, 0) == 0);
+
+	for(size_t i = 0; i < sizeof(data); i++)
+	{
+		data[i] = test_rand();
+	}
+
+	/* every length up to a few hundred bytes, then random lengths, at every
+	 * alignment and from random initial values */
+	for(size_t n = 0; n < 3000; n++)
+	{
+		const size_t len = (n < 600 ? (n / 2) : (test_rand() % DATA_MAX_LEN));
+		const uint8_t *const buf = data + (n % 8);
+		const uint32_t init_val = (n % 2 ? test_rand() : CRC_INIT_FCS32);
+
+		trace(verbose, "%zu bytes at offset %zu\n", len, n % 8);
+		CHECK(crc_calculate(ROHC_CRC_TYPE_3, buf, len, init_val & 0x7) ==
+		      test_crc_bitwise(buf, len, init_val & 0x7, poly_3));
+		CHECK(crc_calculate(ROHC_CRC_TYPE_7, buf, len, init_val & 0x7f) ==
+		      test_crc_bitwise(buf, len, init_val & 0x7f, poly_7));
+		CHECK(crc_calculate(ROHC_CRC_TYPE_8, buf, len, init_val & 0xff) ==
+		      test_crc_bitwise(buf, len, init_val & 0xff, poly_8));
+		CHECK(crc_calc_fcs32(buf, len, init_val) ==
+		      test_crc_bitwise(buf, len, init_val, poly_fcs32));
+	}
+
+	/* headers of one flow: a few bytes change from one packet to the next,
+	 * the length changes from time to time */
+	{
+		struct crc_hdrs_cache cache;
+		uint8_t hdrs[CRC_HDRS_CACHE_MAX_LEN + 8];
+		size_t hdrs_len = 60;
+
+		memcpy(hdrs, data, sizeof(hdrs));
+		crc_hdrs_cache_reset(&cache);
+		for(size_t n = 0; n < 20000; n++)
+		{
+			const rohc_crc_type_t crc_type =
+				((test_rand() % 3) == 0 ? ROHC_CRC_TYPE_3 : ROHC_CRC_TYPE_7);
+			const size_t changes_nr = test_rand() % 6;
+
+			if((n % 500) == 0)
+			{
+				hdrs_len = 1 + (test_rand() % sizeof(hdrs));
+			}
+			for(size_t i = 0; i < changes_nr; i++)
+			{
+				hdrs[test_rand() % hdrs_len] = test_rand();
+			}
+
+			trace(verbose, "CRC-%d over %zu-byte headers with %zu changes\n",
+			      crc_type, hdrs_len, changes_nr);
+			CHECK(crc_calc_hdrs(&cache, crc_type, hdrs, hdrs_len) ==
+			      crc_calculate(crc_type, hdrs, hdrs_len,
+			                    crc_type == ROHC_CRC_TYPE_3 ? CRC_INIT_3 : CRC_INIT_7));
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compute a bit-reflected CRC bit after bit
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @param poly      The bit-reflected polynomial of the CRC
+ * @return          The CRC
+ */
+static uint32_t test_crc_bitwise(const uint8_t *const data,
+                                 const size_t length,
+                                 const uint32_t init_val,
+                                 const uint32_t poly)
+{
+	uint32_t crc = init_val;
+
+	for(size_t i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for(size_t bit = 0; bit < 8; bit++)
+		{
+			crc = ((crc & 1) ? ((crc >> 1) ^ poly) : (crc >> 1));
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Get the next pseudo-random number
+ *
+ * @return  The next pseudo-random number
+ */
+static uint32_t test_rand(void)
+{
+	static uint32_t state = 0x2545f491;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return state;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_hashtable.c
+ * @brief   Test the hash tables used to find compression contexts
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "hashtable.h"
+#include "hashtable_cr.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The number of elements used for tests */
+#define ELEMS_NR  500U
+
+
+/** One element of the hash tables under test */
+struct elem
+{
+	uint32_t idx;
+	uint32_t key;
+};
+
+
+/**
+ * @brief Get one element from its index
+ *
+ * @param priv  The array of elements
+ * @param idx   The index of the element
+ * @return      The element
+ */
+static void * get_elem(const void *const priv, const uint32_t idx)
+{
+	return &(((struct elem *) priv)[idx]);
+}
+
+
+/**
+ * @brief Test the hash tables used to find compression contexts
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static struct elem elems[ELEMS_NR];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the hash tables used to find compression contexts\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(uint32_t i = 0; i < ELEMS_NR; i++)
+	{
+		elems[i].idx = i;
+		elems[i].key = i * 7;
+	}
+
+	/* hashtable_add() / hashtable_get() / hashtable_del() with real hashes,
+	 * the table is created too small to check that it grows */
+	for(int hash_fct = HASHTABLE_HASH_SIPHASH; hash_fct <= HASHTABLE_HASH_FAST;
+	    hash_fct++)
+	{
+		struct hashtable ht;
+
+		CHECK(hashtable_new(&ht, offsetof(struct elem, key), 2, get_elem, elems));
+		memset(ht.key, 0x42, sizeof(ht.key));
+		ht.hash_fct = hash_fct;
+
+		for(uint32_t i = 0; i < ELEMS_NR; i++)
+		{
+			const uint64_t hash = hashtable_hash(&ht, &elems[i].key, sizeof(uint32_t));
+			CHECK(hashtable_get(&ht, &elems[i].key, sizeof(uint32_t), hash) == NULL);
+			CHECK(hashtable_add(&ht, hash, i));
+			CHECK(hashtable_get(&ht, &elems[i].key, sizeof(uint32_t), hash) == &elems[i]);
+		}
+		CHECK(ht.count == ELEMS_NR);
+		CHECK((ht.mask + 1) >= (ELEMS_NR + ELEMS_NR / 3));
+
+		/* remove one element out of three */
+		for(uint32_t i = 0; i < ELEMS_NR; i += 3)
+		{
+			const uint64_t hash = hashtable_hash(&ht, &elems[i].key, sizeof(uint32_t));
+			CHECK(hashtable_contains(&ht, hash, i));
+			hashtable_del(&ht, hash, i);
+			CHECK(!hashtable_contains(&ht, hash, i));
+			hashtable_del(&ht, hash, i);
+		}
+		for(uint32_t i = 0; i < ELEMS_NR; i++)
+		{
+			const uint64_t hash = hashtable_hash(&ht, &elems[i].key, sizeof(uint32_t));
+			const void *const exp_elem = ((i % 3) == 0 ? NULL : &elems[i]);
+			CHECK(hashtable_get(&ht, &elems[i].key, sizeof(uint32_t), hash) == exp_elem);
+		}
+
+		hashtable_free(&ht);
+	}
+
+	/* hashtable_del() shall shift back the elements of a long run of
+	 * colliding hashes, including the runs that wrap around the table */
+	{
+		struct hashtable ht;
+
+		CHECK(hashtable_new(&ht, offsetof(struct elem, key), 64, get_elem, elems));
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			/* 4 home slots only, the last one at the end of the table */
+			const uint64_t hash = (i % 4 == 3 ? ht.mask : (i % 4) * 5);
+			CHECK(hashtable_add(&ht, hash, i));
+		}
+		for(uint32_t i = 0; i < 64; i += 2)
+		{
+			const uint64_t hash = (i % 4 == 3 ? ht.mask : (i % 4) * 5);
+			hashtable_del(&ht, hash, i);
+		}
+		for(uint32_t i = 0; i < 64; i++)
+		{
+			const uint64_t hash = (i % 4 == 3 ? ht.mask : (i % 4) * 5);
+			const void *const exp_elem = ((i % 2) == 0 ? NULL : &elems[i]);
+			CHECK(hashtable_contains(&ht, hash, i) == (exp_elem != NULL));
+			CHECK(hashtable_get(&ht, &elems[i].key, sizeof(uint32_t), hash) == exp_elem);
+		}
+		CHECK(ht.count == 32);
+		hashtable_free(&ht);
+	}
+
+	/* hashtable_cr_get_first() / hashtable_cr_get_next() shall return all the
+	 * elements that share one key in the order they were added */
+	{
+		const uint32_t shared_key = 0xdeadbeef;
+		struct hashtable ht;
+		uint64_t hash;
+		struct elem *elem;
+		uint32_t next_idx;
+		size_t pos;
+
+		CHECK(hashtable_cr_new(&ht, offsetof(struct elem, key), 8, get_elem, elems));
+		hash = hashtable_hash(&ht, &shared_key, sizeof(uint32_t));
+		for(uint32_t i = 0; i < 40; i++)
+		{
+			if((i % 2) == 0)
+			{
+				elems[i].key = shared_key;
+				CHECK(hashtable_cr_add(&ht, hash, i));
+				CHECK(hashtable_cr_add(&ht, hash, i));
+			}
+			else
+			{
+				CHECK(hashtable_cr_add(&ht, hash ^ 0x100, i));
+			}
+		}
+		CHECK(ht.count == 40);
+		hashtable_cr_del(&ht, hash, 10);
+		hashtable_cr_del(&ht, hash, 10);
+
+		next_idx = 0;
+		for(elem = hashtable_cr_get_first(&ht, &shared_key, sizeof(uint32_t), hash, &pos);
+		    elem != NULL;
+		    elem = hashtable_cr_get_next(&ht, &shared_key, sizeof(uint32_t), hash, &pos))
+		{
+			CHECK(elem->idx == next_idx);
+			next_idx += (next_idx == 8 ? 4 : 2);
+		}
+		CHECK(next_idx == 40);
+		hashtable_cr_free(&ht);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
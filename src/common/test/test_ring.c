@@ -0,0 +1,231 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_ring.c
+ * @brief   Test the ring used to queue feedback between threads
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "ring.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The size of the ring used for tests */
+#define RING_SIZE  64U
+
+/** The number of records pushed in the ring during the stress test */
+#define RECS_NR  5000U
+
+
+/**
+ * @brief Test the ring used to queue feedback between threads
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	uint8_t rec[RING_SIZE];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the ring used to queue feedback between threads\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(size_t i = 0; i < RING_SIZE; i++)
+	{
+		rec[i] = i;
+	}
+
+	/* invalid sizes and records */
+	{
+		struct ring ring;
+		size_t len;
+
+		CHECK(!ring_new(&ring, 1));
+		CHECK(!ring_new(&ring, RING_SIZE - 1));
+		CHECK(!ring_new(&ring, RING_SIZE + RING_SIZE / 2));
+		CHECK(ring_new(&ring, RING_SIZE));
+		CHECK(ring_peek(&ring, &len) == NULL);
+		CHECK(!ring_push(&ring, rec, 0));
+		CHECK(!ring_push(&ring, rec, RING_SIZE - RING_REC_HDR_LEN + 1));
+		CHECK(ring_push(&ring, rec, RING_SIZE - RING_REC_HDR_LEN));
+		CHECK(!ring_push(&ring, rec, 1));
+		CHECK(ring_peek(&ring, &len) == ring.data + RING_REC_HDR_LEN);
+		CHECK(len == (RING_SIZE - RING_REC_HDR_LEN));
+		ring_pop(&ring, len);
+		CHECK(ring_peek(&ring, &len) == NULL);
+		ring_free(&ring);
+	}
+
+	/* records are popped in the order they were pushed, the ring is full
+	 * when the records do not fit anymore */
+	{
+		struct ring ring;
+		const uint8_t *data;
+		size_t len;
+
+		CHECK(ring_new(&ring, RING_SIZE));
+		for(size_t i = 0; i < 4; i++)
+		{
+			CHECK(ring_push(&ring, rec + i, 14));
+		}
+		CHECK(!ring_push(&ring, rec, 1));
+		for(size_t i = 0; i < 4; i++)
+		{
+			data = ring_peek(&ring, &len);
+			CHECK(data != NULL);
+			CHECK(len == 14);
+			CHECK(memcmp(data, rec + i, 14) == 0);
+			ring_pop(&ring, len);
+		}
+		CHECK(ring_peek(&ring, &len) == NULL);
+		ring_free(&ring);
+	}
+
+	/* records that do not fit before the end of the buffer are stored at
+	 * its beginning, with or without room for the marker at the end */
+	for(size_t end_len = 0; end_len < 4; end_len++)
+	{
+		struct ring ring;
+		const uint8_t *data;
+		size_t len;
+
+		CHECK(ring_new(&ring, RING_SIZE));
+		CHECK(ring_push(&ring, rec, RING_SIZE - RING_REC_HDR_LEN - end_len));
+		data = ring_peek(&ring, &len);
+		CHECK(data != NULL);
+		ring_pop(&ring, len);
+
+		/* the record does not fit at the end, but in the empty ring */
+		CHECK(ring_push(&ring, rec + 1, 10));
+		data = ring_peek(&ring, &len);
+		CHECK(data == ring.data + RING_REC_HDR_LEN);
+		CHECK(len == 10);
+		CHECK(memcmp(data, rec + 1, 10) == 0);
+		ring_pop(&ring, len);
+		CHECK(ring_peek(&ring, &len) == NULL);
+		CHECK(ring.head == ring.tail);
+		ring_free(&ring);
+	}
+
+	/* a large record that does not fit at the end of the buffer is pushed
+	 * once the consumer skipped the end of the buffer */
+	{
+		struct ring ring;
+		const uint8_t *data;
+		size_t len;
+
+		CHECK(ring_new(&ring, RING_SIZE));
+		CHECK(ring_push(&ring, rec, 30));
+		data = ring_peek(&ring, &len);
+		CHECK(data != NULL);
+		ring_pop(&ring, len);
+		CHECK(!ring_push(&ring, rec, 40));
+		CHECK(ring_peek(&ring, &len) == NULL);
+		CHECK(ring_push(&ring, rec, 40));
+		data = ring_peek(&ring, &len);
+		CHECK(data == ring.data + RING_REC_HDR_LEN);
+		CHECK(len == 40);
+		ring_pop(&ring, len);
+		ring_free(&ring);
+	}
+
+	/* many records of various lengths, the consumer lags behind */
+	{
+		struct ring ring;
+		size_t pushed_nr = 0;
+		size_t popped_nr = 0;
+
+		CHECK(ring_new(&ring, RING_SIZE));
+		while(popped_nr < RECS_NR)
+		{
+			const uint8_t *data;
+			size_t len;
+
+			/* push records until the ring is full */
+			while(pushed_nr < RECS_NR &&
+			      ring_push(&ring, rec + (pushed_nr % 7), 1 + (pushed_nr % 23)))
+			{
+				pushed_nr++;
+			}
+
+			/* pop some of them */
+			for(size_t i = 0; i < 2; i++)
+			{
+				data = ring_peek(&ring, &len);
+				if(data != NULL)
+				{
+					CHECK(len == (1 + (popped_nr % 23)));
+					CHECK(memcmp(data, rec + (popped_nr % 7), len) == 0);
+					ring_pop(&ring, len);
+					popped_nr++;
+				}
+			}
+			CHECK((ring.head - ring.tail) <= RING_SIZE);
+		}
+		CHECK(pushed_nr == RECS_NR);
+		ring_free(&ring);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_slab.c
+ * @brief   Test the slabs used to recycle the memory of contexts
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ */
+
+#include "slab.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/** The max number of objects in the slabs used for tests */
+#define OBJS_MAX  300U
+
+
+static void * test_alloc(void *const priv_ctxt, const size_t size)
+	__attribute__((warn_unused_result));
+
+static void test_free(void *const priv_ctxt, void *const ptr);
+
+
+/**
+ * @brief Test the slabs used to recycle the memory of contexts
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const size_t obj_lens[] = { 1, 6, 16, 264, 2304, SLAB_CHUNK_LEN + 1 };
+	uint8_t *objs[OBJS_MAX];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the slabs used to recycle the memory of contexts\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* objects are aligned, zeroed and distinct, the slab does not hold more
+	 * than the max number of objects */
+	for(size_t i = 0; i < (sizeof(obj_lens) / sizeof(obj_lens[0])); i++)
+	{
+		const size_t objs_max = (obj_lens[i] > SLAB_CHUNK_LEN ? 3 : OBJS_MAX);
+		size_t chunks_nr = 0;
+		struct slab slab;
+
+		trace(verbose, "test slab of %zu-byte objects\n", obj_lens[i]);
+
+		slab_new(&slab, obj_lens[i], objs_max, test_alloc, test_free, &chunks_nr);
+		CHECK(chunks_nr == 0);
+		for(size_t j = 0; j < objs_max; j++)
+		{
+			objs[j] = slab_alloc(&slab);
+			CHECK(objs[j] != NULL);
+			CHECK((((uintptr_t) objs[j]) % SLAB_OBJ_ALIGN) == 0);
+			for(size_t k = 0; k < obj_lens[i]; k++)
+			{
+				CHECK(objs[j][k] == 0);
+			}
+			memset(objs[j], 0xff, obj_lens[i]);
+		}
+		CHECK(slab.used_nr == objs_max);
+		CHECK(slab.objs_nr == objs_max);
+		CHECK(chunks_nr > 0);
+		CHECK(slab_alloc(&slab) == NULL);
+
+		/* released objects are re-used without any new chunk */
+		{
+			const size_t prev_chunks_nr = chunks_nr;
+
+			slab_release(objs[1]);
+			slab_release(objs[0]);
+			slab_release(NULL);
+			CHECK(slab.used_nr == (objs_max - 2));
+			objs[0] = slab_alloc(&slab);
+			objs[1] = slab_alloc(&slab);
+			CHECK(objs[0] != NULL);
+			CHECK(objs[1] != NULL);
+			CHECK(objs[0][0] == 0);
+			CHECK(objs[1][obj_lens[i] - 1] == 0);
+			CHECK(slab_alloc(&slab) == NULL);
+			CHECK(chunks_nr == prev_chunks_nr);
+		}
+
+		/* the chunks are given back when the slab is destroyed */
+		for(size_t j = 0; j < objs_max; j++)
+		{
+			slab_release(objs[j]);
+		}
+		CHECK(slab.used_nr == 0);
+		slab_free(&slab);
+		CHECK(chunks_nr == 0);
+	}
+
+	/* all the objects of a slab reserved at once are contiguous, the slab does
+	 * not reserve any other chunk */
+	{
+		size_t chunks_nr = 0;
+		struct slab slab;
+
+		slab_new(&slab, 392, OBJS_MAX, test_alloc, test_free, &chunks_nr);
+		CHECK(slab_reserve(&slab));
+		CHECK(chunks_nr == 1);
+		CHECK(slab.objs_nr == OBJS_MAX);
+		CHECK(slab_reserve(&slab));
+		CHECK(chunks_nr == 1);
+		for(size_t j = 0; j < OBJS_MAX; j++)
+		{
+			objs[j] = slab_alloc(&slab);
+			CHECK(objs[j] != NULL);
+			if(j > 0)
+			{
+				CHECK(objs[j] == (objs[j - 1] + slab.slot_len));
+			}
+		}
+		CHECK(slab_alloc(&slab) == NULL);
+		CHECK(chunks_nr == 1);
+		for(size_t j = 0; j < OBJS_MAX; j++)
+		{
+			slab_release(objs[j]);
+		}
+		slab_free(&slab);
+		CHECK(chunks_nr == 0);
+	}
+
+	/* a partial reservation is done in one chunk and never exceeds the max
+	 * number of objects of the slab */
+	{
+		size_t chunks_nr = 0;
+		struct slab slab;
+
+		slab_new(&slab, 392, OBJS_MAX, test_alloc, test_free, &chunks_nr);
+		CHECK(slab_reserve_nr(&slab, 2));
+		CHECK(chunks_nr == 1);
+		CHECK(slab.objs_nr == 2);
+		CHECK(slab_reserve_nr(&slab, 1));
+		CHECK(chunks_nr == 1);
+		CHECK(slab_reserve_nr(&slab, OBJS_MAX * 2));
+		CHECK(chunks_nr == 2);
+		CHECK(slab.objs_nr == OBJS_MAX);
+		slab_free(&slab);
+		CHECK(chunks_nr == 0);
+	}
+
+	/* slabs with the default allocator */
+	{
+		struct slab slab;
+
+		slab_new(&slab, 100, 2, NULL, NULL, NULL);
+		objs[0] = slab_alloc(&slab);
+		objs[1] = slab_alloc(&slab);
+		CHECK(objs[0] != NULL);
+		CHECK(objs[1] != NULL);
+		CHECK(objs[0] != objs[1]);
+		CHECK(slab_alloc(&slab) == NULL);
+		slab_release(objs[0]);
+		slab_release(objs[1]);
+		slab_free(&slab);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Reserve memory and count the reserved chunks
+ *
+ * @param priv_ctxt  The number of reserved chunks
+ * @param size       The number of bytes to reserve
+ * @return           The reserved memory
+ */
+static void * test_alloc(void *const priv_ctxt, const size_t size)
+{
+	size_t *const chunks_nr = priv_ctxt;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		(*chunks_nr)++;
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Release memory and count the reserved chunks
+ *
+ * @param priv_ctxt  The number of reserved chunks
+ * @param ptr        The memory to release
+ */
+static void test_free(void *const priv_ctxt, void *const ptr)
+{
+	size_t *const chunks_nr = priv_ctxt;
+
+	assert(*chunks_nr > 0);
+	(*chunks_nr)--;
+	free(ptr);
+}
@@ -57,10 +57,11 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 
 static int c_rtp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *const context);
 static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *const context);
@@ -134,7 +135,7 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
+	rtp_context = rohc_comp_ctxt_zalloc(context, sizeof(struct sc_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -157,7 +158,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	if(!c_create_sc(&rtp_context->ts_sc,
 	                context->compressor->oa_repetitions_nr,
 	                context->compressor->trace_callback,
-	                context->compressor->trace_callback_priv))
+	                context->compressor->trace_callback_priv,
+	                context->compressor->trace_level))
 	{
 		rohc_comp_warn(context, "cannot create scaled RTP Timestamp encoding");
 		goto clean;
@@ -647,6 +649,7 @@ static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *const cont
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -655,6 +658,7 @@ static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *const cont
  */
 static int c_rtp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
@@ -673,7 +677,7 @@ static int c_rtp_encode(struct rohc_comp_ctxt *const context,
 	rtp_changed_rtp_dynamic(context, udp, rtp);
 
 	/* encode the IP packet */
-	size = rohc_comp_rfc3095_encode(context, uncomp_pkt_hdrs,
+	size = rohc_comp_rfc3095_encode(context, uncomp_pkt_hdrs, tmp_vars,
 	                                rohc_pkt, rohc_pkt_max_len, packet_type);
 	if(size < 0)
 	{
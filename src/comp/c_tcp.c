@@ -65,6 +65,34 @@
 	rohc_comp_debug(context, "Compressed format choice LINE %d", __LINE__ )
 
 
+/**
+ * @brief The offsets of the new TCP/IP values against their W-LSB windows
+ *
+ * Every W-LSB window is scanned once per packet, then the different numbers
+ * of LSB that the candidate packet types transmit are checked in constant
+ * time.
+ */
+struct tcp_wlsb_offsets
+{
+	struct c_wlsb_offsets msn;         /**< The offsets of the MSN */
+	struct c_wlsb_offsets ip_id;       /**< The offsets of the innermost IP-ID */
+	struct c_wlsb_offsets ttl_hopl;    /**< The offsets of the innermost TTL/HL */
+	struct c_wlsb_offsets seq;         /**< The offsets of the sequence number */
+	struct c_wlsb_offsets seq_scaled;  /**< The offsets of the scaled seq number */
+	struct c_wlsb_offsets ack;         /**< The offsets of the ACK number */
+	struct c_wlsb_offsets ack_scaled;  /**< The offsets of the scaled ACK number */
+	struct c_wlsb_offsets window;      /**< The offsets of the TCP window */
+};
+
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(struct tcp_tmp_variables) <= ROHC_COMP_TMP_VARS_MAX_LEN,
+               "tcp_tmp_variables should fit in the shared room");
+#endif
+
+
 /*
  * Private function prototypes.
  */
@@ -86,10 +114,11 @@ static bool c_tcp_is_cr_possible(const struct rohc_comp_ctxt *const ctxt,
 
 static int c_tcp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -129,13 +158,15 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
+                                                 const struct tcp_wlsb_offsets *const offsets,
                                                  const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
+                                                 const struct tcp_wlsb_offsets *const offsets,
                                                  const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 /* IR and CO packets */
 static int code_IR_packet(struct rohc_comp_ctxt *const context,
@@ -409,7 +440,7 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	bool is_ok;
 
 	/* create the TCP part of the profile context */
-	tcp_ctxt = malloc(sizeof(struct sc_tcp_context));
+	tcp_ctxt = rohc_comp_ctxt_zalloc(ctxt, sizeof(struct sc_tcp_context));
 	if(tcp_ctxt == NULL)
 	{
 		rohc_error(ctxt->compressor, ROHC_TRACE_COMP, ctxt->profile->id,
@@ -419,6 +450,9 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	ctxt->specific = tcp_ctxt;
 	memcpy(ctxt->specific, base_ctxt->specific, sizeof(struct sc_tcp_context));
 
+	/* the static chain of the base context does not match the new context */
+	tcp_ctxt->static_chain.len = 0;
+
 	/* keep the counter of compressed packets from the base context,
 	 * since it is used to init some compression algorithms and we
 	 * don't want the initialization to restart */
@@ -538,7 +572,7 @@ free_wlsb_ip_id:
 free_wlsb_msn:
 	wlsb_free(&tcp_ctxt->msn_wlsb);
 free_context:
-	free(tcp_ctxt);
+	rohc_comp_ctxt_free(tcp_ctxt);
 error:
 	return false;
 }
@@ -570,7 +604,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	assert(uncomp_pkt_hdrs->tcp != NULL);
 
 	/* create the TCP part of the profile context */
-	tcp_context = calloc(1, sizeof(struct sc_tcp_context));
+	tcp_context = rohc_comp_ctxt_zalloc(context, sizeof(struct sc_tcp_context));
 	if(tcp_context == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -772,7 +806,7 @@ free_wlsb_ip_id:
 free_wlsb_msn:
 	wlsb_free(&tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	rohc_comp_ctxt_free(tcp_context);
 error:
 	return false;
 }
@@ -797,7 +831,7 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	wlsb_free(&tcp_context->ip_id_wlsb);
 	wlsb_free(&tcp_context->ttl_hopl_wlsb);
 	wlsb_free(&tcp_context->msn_wlsb);
-	free(tcp_context);
+	rohc_comp_ctxt_free(tcp_context);
 }
 
 
@@ -859,6 +893,7 @@ static bool c_tcp_is_cr_possible(const struct rohc_comp_ctxt *const ctxt,
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -870,6 +905,7 @@ static bool c_tcp_is_cr_possible(const struct rohc_comp_ctxt *const ctxt,
  */
 static int c_tcp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
@@ -880,16 +916,16 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	ip_context_t *const ip_inner_context =
 		&(tcp_context->ip_contexts[uncomp_pkt_hdrs->ip_hdrs_nr - 1]);
-	struct tcp_tmp_variables tmp;
+	struct tcp_tmp_variables *const tmp = tmp_vars;
 	size_t ip_hdr_pos;
 	int counter;
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
 	/* detect changes between new uncompressed packet and context */
-	tcp_detect_changes(context, ip_inner_context, uncomp_pkt_hdrs, &tmp);
+	tcp_detect_changes(context, ip_inner_context, uncomp_pkt_hdrs, tmp);
 
-	if(tmp.tcp_opts.do_list_static_changed)
+	if(tmp->tcp_opts.do_list_static_changed)
 	{
 		tcp_context->tcp_opts_list_static_trans_nr = 0;
 	}
@@ -897,11 +933,11 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	{
 		rohc_comp_debug(context, "some static TCP options changed in the last "
 		                "few packets");
-		tmp.tcp_opts.do_list_static_changed = true;
+		tmp->tcp_opts.do_list_static_changed = true;
 	}
 
 	/* decide which packet to send */
-	*packet_type = tcp_decide_packet(context, uncomp_pkt_hdrs, &tmp);
+	*packet_type = tcp_decide_packet(context, uncomp_pkt_hdrs, tmp);
 
 	/* does the packet update the decompressor context? */
 	if(rohc_packet_carry_crc_7_or_8(*packet_type))
@@ -920,7 +956,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	        (*packet_type) != ROHC_PACKET_IR_DYN)
 	{
 		/* co_common, seq_X, or rnd_X */
-		counter = code_CO_packet(context, uncomp_pkt_hdrs, &tmp,
+		counter = code_CO_packet(context, uncomp_pkt_hdrs, tmp,
 		                         rohc_pkt, rohc_pkt_max_len, *packet_type);
 		if(counter < 0)
 		{
@@ -934,7 +970,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		       (*packet_type) == ROHC_PACKET_IR_CR ||
 		       (*packet_type) == ROHC_PACKET_IR_DYN);
 
-		counter = code_IR_packet(context, uncomp_pkt_hdrs, &tmp,
+		counter = code_IR_packet(context, uncomp_pkt_hdrs, tmp,
 		                         rohc_pkt, rohc_pkt_max_len, *packet_type);
 		if(counter < 0)
 		{
@@ -947,8 +983,8 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "update context:");
 
 	/* update the context with the new TCP header */
-	tcp_context->seq_num = tmp.seq_num;
-	tcp_context->ack_num = tmp.ack_num;
+	tcp_context->seq_num = tmp->seq_num;
+	tcp_context->ack_num = tmp->ack_num;
 	tcp_context->res_flags = tcp->res_flags;
 	tcp_context->urg_flag = tcp->urg_flag;
 	tcp_context->ack_flag = tcp->ack_flag;
@@ -965,7 +1001,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 			&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
 		ip_context_t *const ip_ctxt = &(tcp_context->ip_contexts[ip_hdr_pos]);
 
-		ip_ctxt->ip_id_behavior = tmp.ip_id_behaviors[ip_hdr_pos];
+		ip_ctxt->ip_id_behavior = tmp->ip_id_behaviors[ip_hdr_pos];
 
 		tcp_context->ip_contexts[ip_hdr_pos].opts_nr =
 			uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].exts_nr;
@@ -975,7 +1011,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	/* add the new innermost IP-ID / SN delta to the W-LSB encoding object */
 	if(uncomp_pkt_hdrs->innermost_ip_hdr->version == IPV4)
 	{
-		c_add_wlsb(&tcp_context->ip_id_wlsb, tcp_context->msn, tmp.ip_id_delta);
+		c_add_wlsb(&tcp_context->ip_id_wlsb, tcp_context->msn, tmp->ip_id_delta);
 	}
 	/* add the new innermost TTL/Hop Limit to the W-LSB encoding object */
 	c_add_wlsb(&tcp_context->ttl_hopl_wlsb, tcp_context->msn,
@@ -1022,10 +1058,10 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	c_add_wlsb(&tcp_context->window_wlsb, tcp_context->msn, rohc_ntoh16(tcp->window));
 
 	/* TCP Timestamp option */
-	if(tmp.tcp_opts.opt_ts_present)
+	if(tmp->tcp_opts.opt_ts_present)
 	{
-		c_add_wlsb(&tcp_opts->ts_req_wlsb, tcp_context->msn, tmp.tcp_opts.ts_req);
-		c_add_wlsb(&tcp_opts->ts_reply_wlsb, tcp_context->msn, tmp.tcp_opts.ts_reply);
+		c_add_wlsb(&tcp_opts->ts_req_wlsb, tcp_context->msn, tmp->tcp_opts.ts_req);
+		c_add_wlsb(&tcp_opts->ts_reply_wlsb, tcp_context->msn, tmp->tcp_opts.ts_reply);
 	}
 
 	/* update transmission counters */
@@ -1181,8 +1217,37 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 		/* add static chain for IR packet only */
 		if(packet_type == ROHC_PACKET_IR)
 		{
-			ret = tcp_code_static_part(context, uncomp_pkt_hdrs,
-			                           rohc_remain_data, rohc_remain_len);
+			struct sc_tcp_context *const tcp_context = context->specific;
+			bool is_static_chain_cacheable = true;
+			size_t ip_hdr_pos;
+
+			/* the static chain is encoded once for all the IR packets of the
+			 * context, but the static parts of the IPv6 extension headers are not
+			 * part of the context fingerprint, so they are always encoded */
+			for(ip_hdr_pos = 0; ip_hdr_pos < uncomp_pkt_hdrs->ip_hdrs_nr; ip_hdr_pos++)
+			{
+				if(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].exts_nr > 0)
+				{
+					is_static_chain_cacheable = false;
+				}
+			}
+
+			ret = 0;
+			if(is_static_chain_cacheable)
+			{
+				ret = rohc_comp_copy_static_chain(context, &tcp_context->static_chain,
+				                                  rohc_remain_data, rohc_remain_len);
+			}
+			if(ret == 0)
+			{
+				ret = tcp_code_static_part(context, uncomp_pkt_hdrs,
+				                           rohc_remain_data, rohc_remain_len);
+				if(ret > 0 && is_static_chain_cacheable)
+				{
+					rohc_comp_cache_static_chain(context, &tcp_context->static_chain,
+					                             rohc_remain_data, ret);
+				}
+			}
 			if(ret < 0)
 			{
 				rohc_comp_warn(context, "failed to build the static chain of the "
@@ -1387,16 +1452,16 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_7);
+			crc_calc_hdrs(&tcp_context->crc_cache, ROHC_CRC_TYPE_7, uncomp_data,
+			              uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_data, uncomp_pkt_hdrs->all_hdrs_len,
-			              CRC_INIT_3);
+			crc_calc_hdrs(&tcp_context->crc_cache, ROHC_CRC_TYPE_3, uncomp_data,
+			              uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -3803,8 +3868,23 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
+	struct tcp_wlsb_offsets offsets;
 	rohc_packet_t packet_type;
 
+	/* scan every W-LSB window only once */
+	wlsb_get_offsets_16bits(&tcp_context->msn_wlsb, tcp_context->msn, &offsets.msn);
+	wlsb_get_offsets_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta, &offsets.ip_id);
+	wlsb_get_offsets_8bits(&tcp_context->ttl_hopl_wlsb,
+	                       uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl, &offsets.ttl_hopl);
+	wlsb_get_offsets_32bits(&tcp_context->seq_wlsb, tmp->seq_num, &offsets.seq);
+	wlsb_get_offsets_32bits(&tcp_context->seq_scaled_wlsb, tcp_context->seq_num_scaled,
+	                        &offsets.seq_scaled);
+	wlsb_get_offsets_32bits(&tcp_context->ack_wlsb, tmp->ack_num, &offsets.ack);
+	wlsb_get_offsets_32bits(&tcp_context->ack_scaled_wlsb, tcp_context->ack_num_scaled,
+	                        &offsets.ack_scaled);
+	wlsb_get_offsets_16bits(&tcp_context->window_wlsb, rohc_ntoh16(tcp->window),
+	                        &offsets.window);
+
 	if(tmp->is_ipv6_exts_list_static_changed)
 	{
 		rohc_comp_debug(context, "force packet IR because at least one IPv6 option "
@@ -3823,8 +3903,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		                "IP-ID changed its behavior");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(!wlsb_is_kp_possible_16bits(&tcp_context->msn_wlsb, tcp_context->msn, 4,
-	                                    ROHC_LSB_SHIFT_TCP_SN))
+	else if(!wlsb_is_kp_possible_offsets(&offsets.msn, 4, ROHC_LSB_SHIFT_TCP_SN))
 	{
 		rohc_comp_debug(context, "force packet IR-DYN because the MSN changed "
 		                "too much");
@@ -3860,12 +3939,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		 *  - use common if too many LSB of innermost TTL/Hop Limit are required
 		 *  - use common if window changed */
 		if(tmp->innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb, tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		   wlsb_is_kp_possible_offsets(&offsets.ip_id, 4, 3) &&
+		   wlsb_is_kp_possible_offsets(&offsets.seq, 14, 8191) &&
+		   wlsb_is_kp_possible_offsets(&offsets.ack, 15, 8191) &&
+		   wlsb_is_kp_possible_offsets(&offsets.ttl_hopl, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		   !tmp->tcp_window_changed)
 		{
 			/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP */
@@ -3873,11 +3950,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
 		}
 		else if(tmp->innermost_ip_id_behavior > ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		        wlsb_is_kp_possible_offsets(&offsets.seq, 16, 65535) &&
+		        wlsb_is_kp_possible_offsets(&offsets.ack, 16, 16383) &&
+		        wlsb_is_kp_possible_offsets(&offsets.ttl_hopl, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		        !tmp->tcp_window_changed)
 		{
 			TRACE_GOTO_CHOICE;
@@ -3894,7 +3969,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP:
 		 * co_common or seq_X packet types */
 		packet_type = tcp_decide_FO_SO_packet_seq(context, uncomp_pkt_hdrs, tmp,
-		                                          crc7_at_least);
+		                                          &offsets, crc7_at_least);
 	}
 	else if(tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND ||
 	        tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_ZERO)
@@ -3902,7 +3977,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		/* ROHC_IP_ID_BEHAVIOR_RAND or ROHC_IP_ID_BEHAVIOR_ZERO:
 		 * co_common or rnd_X packet types */
 		packet_type = tcp_decide_FO_SO_packet_rnd(context, uncomp_pkt_hdrs, tmp,
-		                                          crc7_at_least);
+		                                          &offsets, crc7_at_least);
 	}
 	else
 	{
@@ -3928,6 +4003,7 @@ error:
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
+ * @param offsets           The offsets of the new values against the W-LSB windows
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
  *                          than 8 bits are allowed or not
  * @return                  \li The packet type among ROHC_PACKET_TCP_SEQ_[1-8]
@@ -3937,6 +4013,7 @@ error:
 static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
+                                                 const struct tcp_wlsb_offsets *const offsets,
                                                  const bool crc7_at_least)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
@@ -3951,12 +4028,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	   !tmp->tcp_window_changed &&
 	   (tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged) &&
 	   !crc7_at_least &&
-	   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-	                              tmp->ip_id_delta, 7, 3) &&
+	   wlsb_is_kp_possible_offsets(&offsets->ip_id, 7, 3) &&
 	   tcp_context->seq_num_factor > 0 &&
 	   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-	   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-	                              tcp_context->seq_num_scaled, 4, 7))
+	   wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7))
 	{
 		/* seq_2 is possible */
 		TRACE_GOTO_CHOICE;
@@ -3976,13 +4051,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 		 *  - at most 15 LSB of the TCP ACK number are required,
 		 *  - at most 4 LSBs of IP-ID must be transmitted
 		 * otherwise use co_common packet */
-		if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		if(wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3) &&
+		   wlsb_is_kp_possible_offsets(&offsets->seq, 14, 8191) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ttl_hopl, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		   !tmp->tcp_window_changed)
 		{
 			/* seq_8 is possible */
@@ -3999,11 +4071,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_7 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->window_wlsb,
-		                              rohc_ntoh16(tcp->window), 15, 16383) &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 5, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 32767) &&
+		   wlsb_is_kp_possible_offsets(&offsets->window, 15, 16383) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ip_id, 5, 3) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ack, 16, 32767) &&
 		   tmp->tcp_seq_num_unchanged)
 		{
 			/* seq_7 is possible */
@@ -4021,12 +4091,10 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_2, seq_1 or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 7, 3) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ip_id, 7, 3) &&
 		   tcp_context->seq_num_factor > 0 &&
 		   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                              tcp_context->seq_num_scaled, 4, 7))
+		   wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7))
 		{
 			/* seq_2 is possible */
 			TRACE_GOTO_CHOICE;
@@ -4034,19 +4102,17 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_SEQ_2;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 32767))
+		        wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3) &&
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 16, 32767))
 		{
 			/* seq_1 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_1;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3) &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 14, 8191) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4061,30 +4127,26 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* seq_4, seq_3, or co_common */
 		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                              tmp->ip_id_delta, 3, 1) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ip_id, 3, 1) &&
 		   tcp_is_ack_scaled_possible(tcp_context->ack_stride,
 		                              tcp_context->ack_num_scaling_nr,
 		                              oa_repetitions_nr) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_scaled_wlsb,
-		                              tcp_context->ack_num_scaled, 4, 3))
+		   wlsb_is_kp_possible_offsets(&offsets->ack_scaled, 4, 3))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_4;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_3;
 		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
+		else if(wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3) &&
 		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 14, 8191) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_8;
@@ -4095,34 +4157,30 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_CO_COMMON;
 		}
 	}
-	else if(wlsb_is_kp_possible_16bits(&tcp_context->ip_id_wlsb,
-	                                   tmp->ip_id_delta, 4, 3))
+	else if(wlsb_is_kp_possible_offsets(&offsets->ip_id, 4, 3))
 	{
 		/* sequence and acknowledgment numbers changed:
 		 * seq_6, seq_5, seq_8 or co_common */
 		if(!crc7_at_least &&
 		   tcp_context->seq_num_factor > 0 &&
 		   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                              tcp_context->seq_num_scaled, 4, 7) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		   wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			assert(uncomp_pkt_hdrs->payload_len > 0);
 			packet_type = ROHC_PACKET_TCP_SEQ_6;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 32767))
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383) &&
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 16, 32767))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_SEQ_5;
 		}
-		else if(wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		        wlsb_is_kp_possible_8bits(&tcp_context->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
+		else if(wlsb_is_kp_possible_offsets(&offsets->seq, 14, 8191) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ttl_hopl, 3, ROHC_LSB_SHIFT_TCP_TTL) &&
 		        !tmp->tcp_window_changed)
 		{
 			TRACE_GOTO_CHOICE;
@@ -4155,6 +4213,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param tmp               The temporary state for the compressed packet
+ * @param offsets           The offsets of the new values against the W-LSB windows
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
  *                          than 8 bits are allowed or not
  * @return                  \li The packet type among ROHC_PACKET_TCP_SEQ_[1-8]
@@ -4164,6 +4223,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                  const struct tcp_tmp_variables *const tmp,
+                                                 const struct tcp_wlsb_offsets *const offsets,
                                                  const bool crc7_at_least)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
@@ -4181,8 +4241,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	   uncomp_pkt_hdrs->payload_len > 0 &&
 	   tcp_context->seq_num_factor > 0 &&
 	   tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-	   wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-	                              tcp_context->seq_num_scaled, 4, 7))
+	   wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7))
 	{
 		/* rnd_2 is possible */
 		assert(uncomp_pkt_hdrs->payload_len > 0);
@@ -4195,8 +4254,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	        tmp->tcp_opts.opt_ts_do_transmit_item)
 	{
 		if(!tmp->tcp_window_changed &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		   wlsb_is_kp_possible_offsets(&offsets->seq, 16, 65535) &&
+		   wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383))
 		{
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_8;
@@ -4213,7 +4272,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		{
 			if(!crc7_at_least &&
 			   tmp->tcp_seq_num_unchanged &&
-			   wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 18, 65535))
+			   wlsb_is_kp_possible_offsets(&offsets->ack, 18, 65535))
 			{
 				/* rnd_7 is possible */
 				TRACE_GOTO_CHOICE;
@@ -4231,8 +4290,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        uncomp_pkt_hdrs->payload_len > 0 &&
 		        tcp_context->seq_num_factor > 0 &&
 		        tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                                   tcp_context->seq_num_scaled, 4, 7))
+		        wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7))
 		{
 			/* rnd_2 is possible */
 			assert(uncomp_pkt_hdrs->payload_len > 0);
@@ -4244,8 +4302,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        tcp_is_ack_scaled_possible(tcp_context->ack_stride,
 		                                   tcp_context->ack_num_scaling_nr,
 		                                   oa_repetitions_nr) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_scaled_wlsb,
-		                                   tcp_context->ack_num_scaled, 4, 3) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack_scaled, 4, 3) &&
 		        tmp->tcp_seq_num_unchanged)
 		{
 			/* rnd_4 is possible */
@@ -4255,14 +4312,14 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		else if(!crc7_at_least &&
 		        tcp->ack_flag != 0 &&
 		        tmp->tcp_seq_num_unchanged &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191))
 		{
 			/* rnd_3 is possible */
 			TRACE_GOTO_CHOICE;
 			packet_type = ROHC_PACKET_TCP_RND_3;
 		}
 		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 18, 65535) &&
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 18, 65535) &&
 		        tmp->tcp_ack_num_unchanged)
 		{
 			/* rnd_1 is possible */
@@ -4273,9 +4330,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		        tcp->ack_flag != 0 &&
 		        tcp_context->seq_num_factor > 0 &&
 		        tcp_context->seq_num_scaling_nr >= oa_repetitions_nr &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_scaled_wlsb,
-		                                   tcp_context->seq_num_scaled, 4, 7) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_is_kp_possible_offsets(&offsets->seq_scaled, 4, 7) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383))
 		{
 			/* ACK number present */
 			/* rnd_6 is possible */
@@ -4285,8 +4341,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 		}
 		else if(!crc7_at_least &&
 		        tcp->ack_flag != 0 &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 15, 8191))
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 14, 8191) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 15, 8191))
 		{
 			/* ACK number present */
 			/* rnd_5 is possible */
@@ -4294,8 +4350,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 			packet_type = ROHC_PACKET_TCP_RND_5;
 		}
 		else if(/* !tmp->tcp_window_changed && */
-		        wlsb_is_kp_possible_32bits(&tcp_context->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_context->ack_wlsb, tmp->ack_num, 16, 16383))
+		        wlsb_is_kp_possible_offsets(&offsets->seq, 16, 65535) &&
+		        wlsb_is_kp_possible_offsets(&offsets->ack, 16, 16383))
 		{
 			/* fallback on rnd_8 */
 			TRACE_GOTO_CHOICE;
@@ -33,14 +33,15 @@
 #include "protocols/tcp.h"
 #include "schemes/ip_ctxt.h"
 #include "c_tcp_opts_list.h"
+#include "crc.h"
 
 
 /**
- * @brief Define the TCP-specific temporary variables in the profile
- *        compression context.
+ * @brief Define the TCP-specific temporary variables used while encoding
+ *        one single packet.
  *
- * This object must be used by the TCP-specific compression context
- * sc_tcp_context.
+ * The variables are stored in the room that the compressor shares between
+ * all its contexts, see \ref ROHC_COMP_TMP_VARS_MAX_LEN.
  *
  * @see sc_tcp_context
  */
@@ -169,6 +170,13 @@ struct sc_tcp_context
 
 	uint8_t ip_contexts_nr;
 	ip_context_t ip_contexts[ROHC_MAX_IP_HDRS];
+
+	/** The CRCs over the last uncompressed headers */
+	struct crc_hdrs_cache crc_cache;
+
+	/** The static chain encoded once for all the IR packets, only cached
+	 *  without IPv6 extension headers */
+	struct rohc_comp_static_chain static_chain;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -87,10 +87,11 @@ static rohc_packet_t c_udp_decide_SO_packet(const struct rohc_comp_ctxt *const c
 
 static int c_udp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static size_t udp_code_dynamic_udp_part(const struct rohc_comp_ctxt *const context,
                                         const uint8_t *const next_header,
@@ -139,7 +140,7 @@ static bool c_udp_create(struct rohc_comp_ctxt *const context,
 	                rfc3095_ctxt->sn);
 
 	/* create the UDP part of the profile context */
-	udp_context = malloc(sizeof(struct sc_udp_context));
+	udp_context = rohc_comp_ctxt_zalloc(context, sizeof(struct sc_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -180,6 +181,7 @@ quit:
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -188,6 +190,7 @@ quit:
  */
 static int c_udp_encode(struct rohc_comp_ctxt *const context,
                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                        void *const tmp_vars,
                         uint8_t *const rohc_pkt,
                         const size_t rohc_pkt_max_len,
                         rohc_packet_t *const packet_type)
@@ -203,7 +206,7 @@ static int c_udp_encode(struct rohc_comp_ctxt *const context,
 	udp_detect_udp_changes(context, uncomp_pkt_hdrs->udp, &udp_context->tmp);
 
 	/* encode the IP packet */
-	size = rohc_comp_rfc3095_encode(context, uncomp_pkt_hdrs,
+	size = rohc_comp_rfc3095_encode(context, uncomp_pkt_hdrs, tmp_vars,
 	                                rohc_pkt, rohc_pkt_max_len, packet_type);
 	if(size < 0)
 	{
@@ -48,10 +48,11 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 /* encode uncompressed packets */
 static int c_uncompressed_encode(struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                 void *const tmp_vars,
                                  uint8_t *const rohc_pkt,
                                  const size_t rohc_pkt_max_len,
                                  rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 static int uncompressed_code_packet(struct rohc_comp_ctxt *const context,
                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                     uint8_t *const rohc_pkt,
@@ -130,6 +131,7 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -138,6 +140,7 @@ static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
  */
 static int c_uncompressed_encode(struct rohc_comp_ctxt *const context,
                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                 void *const tmp_vars __attribute__((unused)),
                                  uint8_t *const rohc_pkt,
                                  const size_t rohc_pkt_max_len,
                                  rohc_packet_t *const packet_type)
@@ -44,8 +44,11 @@
 
 
 /**
- * @brief Define the RFC5225-specific temporary variables in the profile
- *        compression context
+ * @brief Define the RFC5225-specific temporary variables used while
+ *        encoding one single packet
+ *
+ * The variables are stored in the room that the compressor shares between
+ * all its contexts, see \ref ROHC_COMP_TMP_VARS_MAX_LEN.
  */
 struct comp_rfc5225_tmp_variables
 {
@@ -90,6 +93,14 @@ struct comp_rfc5225_tmp_variables
 	uint8_t innermost_tos_tc;
 };
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(struct comp_rfc5225_tmp_variables) <= ROHC_COMP_TMP_VARS_MAX_LEN,
+               "comp_rfc5225_tmp_variables should fit in the shared room");
+#endif
+
 
 /** Define the ROHCv2 IP-only part of the profile compression context */
 struct rohc_comp_rfc5225_ip_ctxt
@@ -136,7 +147,11 @@ struct rohc_comp_rfc5225_ip_ctxt
 	/** The number of innermost TTL/HL transmissions since last change */
 	uint8_t innermost_ttl_hopl_trans_nr;
 
-	struct comp_rfc5225_tmp_variables tmp;
+	/** The CRCs over the last uncompressed headers */
+	struct crc_hdrs_cache crc_cache;
+
+	/** The static chain encoded once for all the IR packets */
+	struct rohc_comp_static_chain static_chain;
 };
 
 
@@ -154,19 +169,22 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 /* encode ROHCv2 IP-only packets */
 static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       void *const tmp_vars,
                                        uint8_t *const rohc_pkt,
                                        const size_t rohc_pkt_max_len,
                                        rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const context,
+                                                struct comp_rfc5225_tmp_variables *const tmp,
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 static void rohc_comp_rfc5225_ip_detect_changes_ipv4(struct rohc_comp_ctxt *const ctxt,
+                                                     struct comp_rfc5225_tmp_variables *const tmp,
                                                      ip_context_t *const ip_ctxt,
                                                      const struct ipv4_hdr *const ipv4,
                                                      const bool is_innermost)
-	__attribute__((nonnull(1, 2, 3)));
+	__attribute__((nonnull(1, 2, 3, 4)));
 
 static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *const ctxt,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -181,11 +199,12 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                            const struct comp_rfc5225_tmp_variables *const tmp,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len,
                                             const rohc_packet_t packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 static int rohc_comp_rfc5225_ip_build_pt_0_crc3_pkt(const struct rohc_comp_ctxt *const context,
                                                     const uint8_t crc,
@@ -200,22 +219,25 @@ static int rohc_comp_rfc5225_ip_build_pt_0_crc7_pkt(const struct rohc_comp_ctxt
 	__attribute__((nonnull(1, 3), warn_unused_result));
 
 static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                      const struct comp_rfc5225_tmp_variables *const tmp,
                                                       const uint8_t crc,
                                                       uint8_t *const rohc_data,
                                                       const size_t rohc_max_len)
-	__attribute__((nonnull(1, 3), warn_unused_result));
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
 
 static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                      const struct comp_rfc5225_tmp_variables *const tmp,
                                                       const uint8_t crc,
                                                       uint8_t *const rohc_data,
                                                       const size_t rohc_max_len)
-	__attribute__((nonnull(1, 3), warn_unused_result));
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
 
 static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const uint8_t crc,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
-	__attribute__((nonnull(1, 3), warn_unused_result));
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
 
 /* static chain */
 static int rohc_comp_rfc5225_ip_static_chain(const struct rohc_comp_ctxt *const ctxt,
@@ -259,24 +281,27 @@ static int rohc_comp_rfc5225_ip_dyn_ipv6_part(const struct rohc_comp_ctxt *const
 
 /* irregular chain */
 static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                            const struct comp_rfc5225_tmp_variables *const tmp,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3)));
+        __attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                const struct comp_rfc5225_tmp_variables *const tmp,
                                                 const ip_context_t *const ip_ctxt,
                                                 const struct ipv4_hdr *const ipv4,
                                                 const bool is_innermost,
                                                 uint8_t *const rohc_data,
                                                 const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                const struct comp_rfc5225_tmp_variables *const tmp,
                                                 const ip_context_t *const ip_ctxt,
                                                 const struct ipv6_hdr *const ipv6,
                                                 const bool is_innermost,
                                                 uint8_t *const rohc_data,
                                                 const size_t rohc_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+        __attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 /* deliver feedbacks */
 static bool rohc_comp_rfc5225_ip_feedback(struct rohc_comp_ctxt *const ctxt,
@@ -299,21 +324,24 @@ static void rohc_comp_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const ctxt,
 	__attribute__((nonnull(1)));
 
 /* decide packet */
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context,
+                                                     const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                        const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                        const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                           const struct comp_rfc5225_tmp_variables *const tmp,
                                                            const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_offsets *const offsets,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -353,7 +381,8 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 	bool is_ok;
 
 	/* create the ROHCv2 IP-only part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
+	rfc5225_ctxt =
+		rohc_comp_ctxt_zalloc(context, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -430,7 +459,7 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_comp_ctxt_free(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -450,7 +479,7 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_comp_ctxt_free(rfc5225_ctxt);
 }
 
 
@@ -467,6 +496,7 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -475,12 +505,14 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
  */
 static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       void *const tmp_vars,
                                        uint8_t *const rohc_pkt,
                                        const size_t rohc_pkt_max_len,
                                        rohc_packet_t *const packet_type)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	struct comp_rfc5225_tmp_variables *const tmp = tmp_vars;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
@@ -492,15 +524,15 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
 	/* STEP 0: detect changes between new uncompressed packet and context */
-	rohc_comp_rfc5225_ip_detect_changes(context, uncomp_pkt_hdrs);
+	rohc_comp_rfc5225_ip_detect_changes(context, tmp, uncomp_pkt_hdrs);
 
 	/* STEP 1: decide packet type */
-	*packet_type = rohc_comp_rfc5225_ip_decide_pkt(context);
+	*packet_type = rohc_comp_rfc5225_ip_decide_pkt(context, tmp);
 
 	/* the outer_ip_flag may be set to 1 only for co_common */
-	if(rfc5225_ctxt->tmp.outer_ip_flag && (*packet_type) != ROHC_PACKET_CO_COMMON)
+	if(tmp->outer_ip_flag && (*packet_type) != ROHC_PACKET_CO_COMMON)
 	{
-		rfc5225_ctxt->tmp.outer_ip_flag = false;
+		tmp->outer_ip_flag = false;
 	}
 
 	/* does the packet update the decompressor context? */
@@ -534,7 +566,7 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
 	}
 	else /* other CO packets */
 	{
-		ret = rohc_comp_rfc5225_ip_code_CO_pkt(context, uncomp_pkt_hdrs,
+		ret = rohc_comp_rfc5225_ip_code_CO_pkt(context, tmp, uncomp_pkt_hdrs,
 		                                       rohc_remain_data, rohc_remain_len,
 		                                       *packet_type);
 		if(ret < 0)
@@ -570,8 +602,8 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
 			if((ip_hdr_pos + 1) == rfc5225_ctxt->ip_contexts_nr)
 			{
 				c_add_wlsb(&rfc5225_ctxt->innermost_ip_id_offset_wlsb, rfc5225_ctxt->msn,
-				           rfc5225_ctxt->tmp.innermost_ip_id_offset);
-				rfc5225_ctxt->innermost_ip_id_offset = rfc5225_ctxt->tmp.innermost_ip_id_offset;
+				           tmp->innermost_ip_id_offset);
+				rfc5225_ctxt->innermost_ip_id_offset = tmp->innermost_ip_id_offset;
 			}
 			ip_ctxt->df = ip_hdr->ipv4->df;
 		}
@@ -635,9 +667,11 @@ error:
  * @brief Detect changes between packet and context
  *
  * @param context          The compression context to compare
+ * @param tmp              The temporary variables for the current packet
  * @param uncomp_pkt_hdrs  The uncompressed headers to compare
  */
 static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const context,
+                                                struct comp_rfc5225_tmp_variables *const tmp,
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
@@ -648,17 +682,17 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 	/* detect changes in all the IP headers */
 	rohc_comp_debug(context, "detect changes the IP packet");
 	assert(rfc5225_ctxt->ip_contexts_nr > 0);
-	rfc5225_ctxt->tmp.outer_df_changed = false;
-	rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = false;
-	rfc5225_ctxt->tmp.outer_ip_flag = false;
-	rfc5225_ctxt->tmp.innermost_df_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_id_offset_changed = false;
-	rfc5225_ctxt->tmp.innermost_tos_tc_changed = false;
-	rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_flag = false;
-	rfc5225_ctxt->tmp.at_least_one_df_changed = false;
-	rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = false;
+	tmp->outer_df_changed = false;
+	tmp->outer_ip_id_behavior_changed = false;
+	tmp->outer_ip_flag = false;
+	tmp->innermost_df_changed = false;
+	tmp->innermost_ip_id_behavior_changed = false;
+	tmp->innermost_ip_id_offset_changed = false;
+	tmp->innermost_tos_tc_changed = false;
+	tmp->innermost_ttl_hopl_changed = false;
+	tmp->innermost_ip_flag = false;
+	tmp->at_least_one_df_changed = false;
+	tmp->at_least_one_ip_id_behavior_changed = false;
 	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_contexts_nr; ip_hdr_pos++)
 	{
 		ip_context_t *const ip_ctxt = &(rfc5225_ctxt->ip_contexts[ip_hdr_pos]);
@@ -677,21 +711,21 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 			{
 				rohc_comp_debug(context, "    TOS/TC (0x%02x -> 0x%02x) changed",
 				                ip_ctxt->tos_tc, ip_hdr->tos_tc);
-				rfc5225_ctxt->tmp.innermost_tos_tc_changed = true;
-				rfc5225_ctxt->tmp.innermost_ip_flag = true;
+				tmp->innermost_tos_tc_changed = true;
+				tmp->innermost_ip_flag = true;
 			}
 			/* innermost TTL changed? */
 			if(ip_ctxt->ttl_hopl != ip_hdr->ttl_hl)
 			{
 				rohc_comp_debug(context, "    TTL (%u -> %u) changed",
 				                ip_ctxt->ttl_hopl, ip_hdr->ttl_hl);
-				rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = true;
-				rfc5225_ctxt->tmp.innermost_ip_flag = true;
+				tmp->innermost_ttl_hopl_changed = true;
+				tmp->innermost_ip_flag = true;
 			}
 			/* save the new values of innermost TOS and TTL to easily retrieve them
 			 * during packet creation */
-			rfc5225_ctxt->tmp.innermost_tos_tc = ip_hdr->tos_tc;
-			rfc5225_ctxt->tmp.innermost_ttl_hopl = ip_hdr->ttl_hl;
+			tmp->innermost_tos_tc = ip_hdr->tos_tc;
+			tmp->innermost_ttl_hopl = ip_hdr->ttl_hl;
 		}
 		else
 		{
@@ -701,14 +735,14 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 				rohc_comp_debug(context, "    TOS/TC (%02x -> %02x) or TTL/HL (%u -> %u) "
 				                "changed", ip_ctxt->tos_tc, ip_hdr->tos_tc,
 				                ip_ctxt->ttl_hopl, ip_hdr->ttl_hl);
-				rfc5225_ctxt->tmp.outer_ip_flag = true;
+				tmp->outer_ip_flag = true;
 			}
 		}
 
 		if(ip_hdr->version == IPV4)
 		{
 			/* detect changes in the IPv4 header */
-			rohc_comp_rfc5225_ip_detect_changes_ipv4(context, ip_ctxt,
+			rohc_comp_rfc5225_ip_detect_changes_ipv4(context, tmp, ip_ctxt,
 			                                         ip_hdr->ipv4, is_innermost);
 		}
 		else /* IPv6 */
@@ -717,7 +751,7 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 			 * packet creation */
 			if(is_innermost)
 			{
-				rfc5225_ctxt->tmp.innermost_df = 0; /* no DF, dont_fragment() uses 0 */
+				tmp->innermost_df = 0; /* no DF, dont_fragment() uses 0 */
 			}
 
 			/* TODO: handle IPv6 extension headers */
@@ -731,14 +765,14 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 	rfc5225_ctxt->msn++; /* wraparound on overflow is expected */
 	rohc_comp_debug(context, "MSN = 0x%04x / %u", rfc5225_ctxt->msn, rfc5225_ctxt->msn);
 	/* MSN offset is always 1 */
-	rfc5225_ctxt->tmp.msn_offset = 1;
-	rohc_comp_debug(context, "MSN offset = %d", rfc5225_ctxt->tmp.msn_offset);
+	tmp->msn_offset = 1;
+	rohc_comp_debug(context, "MSN offset = %d", tmp->msn_offset);
 
 	/* now that the MSN was updated with the new received IP packet,
 	 * compute the new IP-ID / MSN offset for the innermost IP header */
 	if(innermost_ip_ctxt->version == IPV4)
 	{
-		const uint16_t ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
+		const uint16_t ip_id = tmp->innermost_ip_id;
 		const uint16_t last_ip_id = innermost_ip_ctxt->last_ip_id;
 		const rohc_ip_id_behavior_t last_ip_id_behavior =
 			innermost_ip_ctxt->ip_id_behavior;
@@ -757,7 +791,7 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		{
 			ip_id_behavior =
 				rohc_comp_detect_ip_id_behavior(last_ip_id, ip_id,
-				                                rfc5225_ctxt->tmp.msn_offset, 19);
+				                                tmp->msn_offset, 19);
 		}
 		/* TODO: avoid changing context here */
 		innermost_ip_ctxt->ip_id_behavior = ip_id_behavior;
@@ -765,34 +799,34 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		                rohc_ip_id_behavior_get_descr(ip_id_behavior));
 		if(last_ip_id_behavior != ip_id_behavior)
 		{
-			rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
-			rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = true;
+			tmp->at_least_one_ip_id_behavior_changed = true;
+			tmp->innermost_ip_id_behavior_changed = true;
 		}
 
 		if(innermost_ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
 		{
 			/* specific case of IP-ID delta for sequential swapped behavior */
-			rfc5225_ctxt->tmp.innermost_ip_id_offset =
-				swab16(rfc5225_ctxt->tmp.innermost_ip_id) - rfc5225_ctxt->msn;
+			tmp->innermost_ip_id_offset =
+				swab16(tmp->innermost_ip_id) - rfc5225_ctxt->msn;
 		}
 		else
 		{
 			/* compute delta the same way for sequential, zero or random: it is
 			 * important to always compute the IP-ID delta and record it in W-LSB,
 			 * so that the IP-ID deltas of next packets may be correctly encoded */
-			rfc5225_ctxt->tmp.innermost_ip_id_offset =
-				rfc5225_ctxt->tmp.innermost_ip_id - rfc5225_ctxt->msn;
+			tmp->innermost_ip_id_offset =
+				tmp->innermost_ip_id - rfc5225_ctxt->msn;
 		}
 		rohc_comp_debug(context, "new IP-ID offset = 0x%x / %u",
-		                rfc5225_ctxt->tmp.innermost_ip_id_offset,
-		                rfc5225_ctxt->tmp.innermost_ip_id_offset);
+		                tmp->innermost_ip_id_offset,
+		                tmp->innermost_ip_id_offset);
 
-		rfc5225_ctxt->tmp.innermost_ip_id_offset_changed =
-			!!(rfc5225_ctxt->innermost_ip_id_offset != rfc5225_ctxt->tmp.innermost_ip_id_offset);
+		tmp->innermost_ip_id_offset_changed =
+			!!(rfc5225_ctxt->innermost_ip_id_offset != tmp->innermost_ip_id_offset);
 	}
 
 	/* any DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.at_least_one_df_changed)
+	if(tmp->at_least_one_df_changed)
 	{
 		rohc_comp_debug(context, "at least one DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -803,10 +837,10 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "at least one DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->all_df_trans_nr);
-		rfc5225_ctxt->tmp.at_least_one_df_changed = true;
+		tmp->at_least_one_df_changed = true;
 	}
 	/* the innermost DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_df_changed)
+	if(tmp->innermost_df_changed)
 	{
 		rohc_comp_debug(context, "innermost DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -817,10 +851,10 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_df_trans_nr);
-		rfc5225_ctxt->tmp.innermost_df_changed = true;
+		tmp->innermost_df_changed = true;
 	}
 	/* any outer DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_df_changed)
+	if(tmp->outer_df_changed)
 	{
 		rohc_comp_debug(context, "at least one outer DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -831,11 +865,11 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "at least one outer DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_df_trans_nr);
-		rfc5225_ctxt->tmp.outer_df_changed = true;
+		tmp->outer_df_changed = true;
 	}
 
 	/* any IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	if(tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "at least one IP-ID behavior changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -846,10 +880,10 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "at least one IP-ID behavior changed in last "
 		                "packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->all_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
+		tmp->at_least_one_ip_id_behavior_changed = true;
 	}
 	/* innermost IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed)
+	if(tmp->innermost_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "innermost IP-ID behavior changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -860,11 +894,11 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost IP-ID behavior changed in last packets, "
 		                "it shall be transmitted %u times more", oa_repetitions_nr -
 		                rfc5225_ctxt->innermost_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = true;
+		tmp->innermost_ip_id_behavior_changed = true;
 	}
 	/* innermost IP-ID offset that changes shall be transmitted several times
 	 * before being inferred */
-	if(rfc5225_ctxt->tmp.innermost_ip_id_offset_changed)
+	if(tmp->innermost_ip_id_offset_changed)
 	{
 		rohc_comp_debug(context, "innermost IP-ID offset changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -875,10 +909,10 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost IP-ID offset changed in last packets, "
 		                "it shall be transmitted %u times more", oa_repetitions_nr -
 		                rfc5225_ctxt->innermost_ip_id_offset_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_id_offset_changed = true;
+		tmp->innermost_ip_id_offset_changed = true;
 	}
 	/* any outer IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
+	if(tmp->outer_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "at least one outer IP-ID behavior changed in "
 		                "current packet, it shall be transmitted %u times",
@@ -890,11 +924,11 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "at least one outer IP-ID behavior changed in "
 		                "last packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = true;
+		tmp->outer_ip_id_behavior_changed = true;
 	}
 
 	/* innermost IP flag that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ip_flag)
+	if(tmp->innermost_ip_flag)
 	{
 		rohc_comp_debug(context, "innermost IP flag changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -905,10 +939,10 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost IP flag changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_ip_flag_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_flag = true;
+		tmp->innermost_ip_flag = true;
 	}
 	/* any outer IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_ip_flag)
+	if(tmp->outer_ip_flag)
 	{
 		rohc_comp_debug(context, "at least one outer IP flag changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -919,11 +953,11 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "at least one outer IP flag changed in last "
 		                "packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_ip_flag_trans_nr);
-		rfc5225_ctxt->tmp.outer_ip_flag = true;
+		tmp->outer_ip_flag = true;
 	}
 
 	/* innermost TOS/TC that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_tos_tc_changed)
+	if(tmp->innermost_tos_tc_changed)
 	{
 		rohc_comp_debug(context, "innermost TOS/TC changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -934,11 +968,11 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost TOS/TC changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_tos_tc_trans_nr);
-		rfc5225_ctxt->tmp.innermost_tos_tc_changed = true;
+		tmp->innermost_tos_tc_changed = true;
 	}
 
 	/* innermost TTL/HL that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ttl_hopl_changed)
+	if(tmp->innermost_ttl_hopl_changed)
 	{
 		rohc_comp_debug(context, "innermost TTL/HL changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -949,7 +983,7 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
 		rohc_comp_debug(context, "innermost TTL/HL changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_ttl_hopl_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = true;
+		tmp->innermost_ttl_hopl_changed = true;
 	}
 }
 
@@ -958,37 +992,38 @@ static void rohc_comp_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const con
  * @brief Detect changes for the given IPv4 header between packet and context
  *
  * @param ctxt          The compression context
+ * @param tmp           The temporary variables for the current packet
  * @param ip_ctxt       The IPv4 context to compare
  * @param ipv4          The IPv4 header to compare
  * @param is_innermost  Whether the IPv4 header is the innermost of all IP headers
  */
 static void rohc_comp_rfc5225_ip_detect_changes_ipv4(struct rohc_comp_ctxt *const ctxt,
+                                                    struct comp_rfc5225_tmp_variables *const tmp,
                                                     ip_context_t *const ip_ctxt,
                                                     const struct ipv4_hdr *const ipv4,
                                                     const bool is_innermost)
 {
 	/* TODO: parameter ip_ctxt should be const */
-	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
 
 	/* IPv4 DF changed? */
 	if(ip_ctxt->df != ipv4->df)
 	{
 		rohc_comp_debug(ctxt, "    DF (%u -> %u) changed", ip_ctxt->df, ipv4->df);
-		rfc5225_ctxt->tmp.at_least_one_df_changed = true;
+		tmp->at_least_one_df_changed = true;
 		if(is_innermost)
 		{
-			rfc5225_ctxt->tmp.innermost_df_changed = true;
+			tmp->innermost_df_changed = true;
 		}
 		else
 		{
-			rfc5225_ctxt->tmp.outer_df_changed = true;
+			tmp->outer_df_changed = true;
 		}
 	}
 	/* save the new value of the innermost DF to easily retrieve them during
 	 * packet creation */
 	if(is_innermost)
 	{
-		rfc5225_ctxt->tmp.innermost_df = ipv4->df;
+		tmp->innermost_df = ipv4->df;
 	}
 
 	/* determine the IP-ID behavior of the IPv4 header */
@@ -1027,13 +1062,13 @@ static void rohc_comp_rfc5225_ip_detect_changes_ipv4(struct rohc_comp_ctxt *cons
 		                rohc_ip_id_behavior_get_descr(ip_id_behavior));
 		if(last_ip_id_behavior != ip_id_behavior)
 		{
-			rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
-			rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = true;
+			tmp->at_least_one_ip_id_behavior_changed = true;
+			tmp->outer_ip_id_behavior_changed = true;
 		}
 	}
 	else
 	{
-		rfc5225_ctxt->tmp.innermost_ip_id = rohc_ntoh16(ipv4->id);
+		tmp->innermost_ip_id = rohc_ntoh16(ipv4->id);
 	}
 }
 
@@ -1316,6 +1351,7 @@ static void rohc_comp_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const ctxt,
  * @brief Decide which packet to send when in the different states
  *
  * @param context           The compression context
+ * @param tmp               The temporary variables for the current packet
  * @return                  \li The packet type among ROHC_PACKET_IR,
  *                              ROHC_PACKET_PT_0_CRC3,
  *                              ROHC_PACKET_NORTP_PT_0_CRC7,
@@ -1324,7 +1360,8 @@ static void rohc_comp_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const ctxt,
  *                              in case of success
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context)
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context,
+                                                     const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	rohc_packet_t packet_type;
 
@@ -1335,10 +1372,10 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *cons
 			packet_type = ROHC_PACKET_IR;
 			break;
 		case ROHC_COMP_STATE_FO:
-			packet_type = rohc_comp_rfc5225_ip_decide_FO_pkt(context);
+			packet_type = rohc_comp_rfc5225_ip_decide_FO_pkt(context, tmp);
 			break;
 		case ROHC_COMP_STATE_SO:
-			packet_type = rohc_comp_rfc5225_ip_decide_SO_pkt(context);
+			packet_type = rohc_comp_rfc5225_ip_decide_SO_pkt(context, tmp);
 			break;
 		case ROHC_COMP_STATE_UNKNOWN:
 		default:
@@ -1357,6 +1394,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *cons
  * @brief Decide which packet to send when in FO state
  *
  * @param ctxt  The compression context
+ * @param tmp   The temporary variables for the current packet
  * @return      \li The packet type among ROHC_PACKET_IR,
  *                  ROHC_PACKET_CO_REPAIR,
  *                  ROHC_PACKET_CO_COMMON,
@@ -1365,11 +1403,12 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *cons
  *                  in case of success
  *              \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt)
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                        const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = true;
 	const rohc_packet_t packet_type =
-		rohc_comp_rfc5225_ip_decide_FO_SO_pkt(ctxt, crc7_at_least);
+		rohc_comp_rfc5225_ip_decide_FO_SO_pkt(ctxt, tmp, crc7_at_least);
 
 	assert(packet_type != ROHC_PACKET_PT_0_CRC3);
 	assert(packet_type != ROHC_PACKET_NORTP_PT_1_SEQ_ID);
@@ -1382,6 +1421,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_c
  * @brief Decide which packet to send when in SO state
  *
  * @param ctxt  The compression context
+ * @param tmp   The temporary variables for the current packet
  * @return      \li The packet type among ROHC_PACKET_IR,
  *                  ROHC_PACKET_CO_REPAIR,
  *                  ROHC_PACKET_CO_COMMON,
@@ -1392,10 +1432,11 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_pkt(const struct rohc_comp_c
  *                  in case of success
  *              \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt)
+static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                        const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = false;
-	return rohc_comp_rfc5225_ip_decide_FO_SO_pkt(ctxt, crc7_at_least);
+	return rohc_comp_rfc5225_ip_decide_FO_SO_pkt(ctxt, tmp, crc7_at_least);
 }
 
 
@@ -1403,6 +1444,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_c
  * @brief Decide which packet to send when in FO or SO state
  *
  * @param ctxt           The compression context
+ * @param tmp            The temporary variables for the current packet
  * @param crc7_at_least  Whether packet types with CRC strictly smaller
  *                       than 7 bits are allowed or not
  * @return               \li The packet type among ROHC_PACKET_IR,
@@ -1416,6 +1458,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_c
  *                       \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                           const struct comp_rfc5225_tmp_variables *const tmp,
                                                            const bool crc7_at_least)
 {
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
@@ -1423,13 +1466,30 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	const rohc_reordering_offset_t reorder_ratio = ctxt->compressor->reorder_ratio;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
-	const uint16_t innermost_ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
+	const uint16_t innermost_ip_id = tmp->innermost_ip_id;
 	const uint8_t innermost_ip_id_offset_trans_nr =
 		rfc5225_ctxt->innermost_ip_id_offset_trans_nr;
 	const rohc_ip_id_behavior_t innermost_ip_id_behavior =
 		innermost_ip_ctxt->ip_id_behavior;
+	struct c_wlsb_offsets msn_offsets;
+	bool ip_id_offset_4bits_possible = false;
+	bool ip_id_offset_6bits_possible = false;
 	rohc_packet_t packet_type;
 
+	/* scan the W-LSB windows only once */
+	wlsb_get_offsets_16bits(&rfc5225_ctxt->msn_wlsb, rfc5225_ctxt->msn, &msn_offsets);
+	if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior))
+	{
+		struct c_wlsb_offsets ip_id_offsets;
+
+		wlsb_get_offsets_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+		                        tmp->innermost_ip_id_offset, &ip_id_offsets);
+		ip_id_offset_4bits_possible =
+			wlsb_is_kp_possible_offsets(&ip_id_offsets, 4, rohc_interval_get_rfc5225_id_id_p(4));
+		ip_id_offset_6bits_possible =
+			wlsb_is_kp_possible_offsets(&ip_id_offsets, 6, rohc_interval_get_rfc5225_id_id_p(6));
+	}
+
 	/* use pt_0_crc3 only if:
 	 *  - CRC-3 is enough to protect the compression
 	 *  - 4 MSN bits are enough
@@ -1441,17 +1501,16 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	if(!crc7_at_least &&
-	   rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                         rfc5225_ctxt->msn, reorder_ratio, 4) &&
+	   rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 4) &&
 	   (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	    rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                           innermost_ip_id_offset_trans_nr,
 	                                           oa_repetitions_nr,
 	                                           innermost_ip_id)) &&
-	   !rfc5225_ctxt->tmp.outer_ip_flag &&
-	   !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	   !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	   !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	   !tmp->outer_ip_flag &&
+	   !tmp->innermost_ip_flag &&
+	   !tmp->at_least_one_df_changed &&
+	   !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_0_crc3 packet");
 		packet_type = ROHC_PACKET_PT_0_CRC3;
@@ -1465,18 +1524,16 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	 *  - the TOS/TC fields of all IP headers shall not be changing
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 6) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                innermost_ip_id_offset_trans_nr,
 	                                                oa_repetitions_nr,
 	                                                innermost_ip_id)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_0_crc7 packet");
 		packet_type = ROHC_PACKET_NORTP_PT_0_CRC7;
@@ -1490,17 +1547,13 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 6) &&
 	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        ip_id_offset_4bits_possible &&
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		assert(innermost_ip_ctxt->version == IPV4);
 		rohc_comp_debug(ctxt, "code pt_1_seq_id packet");
@@ -1514,16 +1567,12 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        ip_id_offset_6bits_possible &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 8) &&
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_2_seq_id packet");
 		packet_type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
@@ -1533,11 +1582,9 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 	 *  - the DF fields of all outer IP headers shall not be changing
 	 *  - the behavior of the outer IP-IDs shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_df_changed &&
-	        !rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 8) &&
+	        !tmp->outer_df_changed &&
+	        !tmp->outer_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code co_common packet");
 		packet_type = ROHC_PACKET_CO_COMMON;
@@ -1558,21 +1605,19 @@ static rohc_packet_t rohc_comp_rfc5225_ip_decide_FO_SO_pkt(const struct rohc_com
 /**
  * @brief Define according to computed shift parameter if msn_lsb() is possible
  *
- * @param wlsb           The W-LSB object
- * @param value          The value to encode using the LSB algorithm
+ * @param offsets        The offsets of the value against the W-LSB window
  * @param reorder_ratio  The reordering ratio
  * @param k              The number of bits for encoding
  * @return               true if msn_lsb is possible or not
  */
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-		                                            const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_offsets *const offsets,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 {
 	/* compute p according to reorder ratio  */
 	rohc_lsb_shift_t p_computed = rohc_interval_get_rfc5225_msn_p(k, reorder_ratio);
 
-	return wlsb_is_kp_possible_16bits(wlsb, value, k, p_computed);
+	return wlsb_is_kp_possible_offsets(offsets, k, p_computed);
 }
 
 
@@ -1657,6 +1702,7 @@ static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *context
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len)
 {
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
@@ -1715,9 +1761,19 @@ static int rohc_comp_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *context
 	rohc_remain_len--;
 	rohc_hdr_len++;
 
-	/* add static chain */
-	ret = rohc_comp_rfc5225_ip_static_chain(context, uncomp_pkt_hdrs,
-	                                        rohc_remain_data, rohc_remain_len);
+	/* add static chain, encoded once for all the IR packets of the context */
+	ret = rohc_comp_copy_static_chain(context, &rfc5225_ctxt->static_chain,
+	                                  rohc_remain_data, rohc_remain_len);
+	if(ret == 0)
+	{
+		ret = rohc_comp_rfc5225_ip_static_chain(context, uncomp_pkt_hdrs,
+		                                        rohc_remain_data, rohc_remain_len);
+		if(ret > 0)
+		{
+			rohc_comp_cache_static_chain(context, &rfc5225_ctxt->static_chain,
+			                             rohc_remain_data, ret);
+		}
+	}
 	if(ret < 0)
 	{
 		rohc_comp_warn(context, "failed to build the static chain of the IR packet");
@@ -1799,7 +1855,7 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
                                                    uint8_t *const rohc_pkt,
                                                    const size_t rohc_pkt_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
@@ -1852,8 +1908,8 @@ static int rohc_comp_rfc5225_ip_code_co_repair_pkt(const struct rohc_comp_ctxt *
 		co_repair_crc->r1 = 0;
 		/* CRC-7 over uncompressed headers */
 		co_repair_crc->header_crc =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, co_repair_crc->header_crc);
 
@@ -1924,6 +1980,7 @@ error:
  * @brief Encode an IP packet as CO packet
  *
  * @param context           The compression context
+ * @param tmp               The temporary variables for the current packet
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
@@ -1932,11 +1989,13 @@ error:
  *                          -1 otherwise
  */
 static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                            const struct comp_rfc5225_tmp_variables *const tmp,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len,
                                             const rohc_packet_t packet_type)
 {
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	uint8_t crc_computed;
@@ -1950,16 +2009,16 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_3,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -2026,7 +2085,7 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	else if(packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		/* build the pt_1_seq_id ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(context, crc_computed,
+		ret = rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(context, tmp, crc_computed,
 		                                                 rohc_remain_data,
 		                                                 rohc_remain_len);
 		if(ret < 0)
@@ -2040,7 +2099,7 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	else if(packet_type == ROHC_PACKET_NORTP_PT_2_SEQ_ID)
 	{
 		/* build the pt_2_seq_id ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(context, crc_computed,
+		ret = rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(context, tmp, crc_computed,
 		                                                 rohc_remain_data,
 		                                                 rohc_remain_len);
 		if(ret < 0)
@@ -2054,7 +2113,7 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	else if(packet_type == ROHC_PACKET_CO_COMMON)
 	{
 		/* build the co_common ROHC header */
-		ret = rohc_comp_rfc5225_ip_build_co_common_pkt(context, crc_computed,
+		ret = rohc_comp_rfc5225_ip_build_co_common_pkt(context, tmp, crc_computed,
 		                                               rohc_remain_data,
 		                                               rohc_remain_len);
 		if(ret < 0)
@@ -2079,7 +2138,7 @@ static int rohc_comp_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const c
 	}
 
 	/* add the irregular chain at the very end of the CO header */
-	ret = rohc_comp_rfc5225_ip_irreg_chain(context, uncomp_pkt_hdrs,
+	ret = rohc_comp_rfc5225_ip_irreg_chain(context, tmp, uncomp_pkt_hdrs,
 	                                       rohc_remain_data, rohc_remain_len);
 	if(ret < 0)
 	{
@@ -2576,6 +2635,7 @@ error:
  * @brief Code the irregular chain of a ROHCv2 IP-only IR packet
  *
  * @param ctxt              The compression context
+ * @param tmp               The temporary variables for the current packet
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
@@ -2583,6 +2643,7 @@ error:
  *                          -1 otherwise
  */
 static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                            const struct comp_rfc5225_tmp_variables *const tmp,
                                             const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                             uint8_t *const rohc_pkt,
                                             const size_t rohc_pkt_max_len)
@@ -2610,7 +2671,7 @@ static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const c
 
 		if(ip_hdr->version == IPV4)
 		{
-			ret = rohc_comp_rfc5225_ip_irreg_ipv4_part(ctxt, ip_ctxt, ip_hdr->ipv4, is_innermost,
+			ret = rohc_comp_rfc5225_ip_irreg_ipv4_part(ctxt, tmp, ip_ctxt, ip_hdr->ipv4, is_innermost,
 			                                           rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
@@ -2623,7 +2684,7 @@ static int rohc_comp_rfc5225_ip_irreg_chain(const struct rohc_comp_ctxt *const c
 		}
 		else /* IPv6 */
 		{
-			ret = rohc_comp_rfc5225_ip_irreg_ipv6_part(ctxt, ip_ctxt, ip_hdr->ipv6, is_innermost,
+			ret = rohc_comp_rfc5225_ip_irreg_ipv6_part(ctxt, tmp, ip_ctxt, ip_hdr->ipv6, is_innermost,
 			                                           rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
@@ -2649,6 +2710,7 @@ error:
  * @brief Build the irregular part of the IPv4 header
  *
  * @param ctxt            The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param ip_ctxt         The specific IP compression context
  * @param ipv4            The IPv4 header
  * @param is_innermost    true if the IP header is the innermost of the packet,
@@ -2659,13 +2721,13 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                const struct comp_rfc5225_tmp_variables *const tmp,
                                                 const ip_context_t *const ip_ctxt,
                                                 const struct ipv4_hdr *const ipv4,
                                                 const bool is_innermost,
                                                 uint8_t *const rohc_data,
                                                 const size_t rohc_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
 	uint8_t *rohc_remain_data = rohc_data;
 	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv4_irreg_len = 0;
@@ -2691,7 +2753,7 @@ static int rohc_comp_rfc5225_ip_irreg_ipv4_part(const struct rohc_comp_ctxt *con
 	}
 
 	/* TOS and TTL for outer IP headers */
-	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
+	if(!is_innermost && tmp->outer_ip_flag)
 	{
 		const size_t tos_ttl_req_len = 2;
 
@@ -2725,6 +2787,7 @@ error:
  * @brief Build the irregular part of the IPv6 header
  *
  * @param ctxt            The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param ip_ctxt         The specific IP compression context
  * @param ipv6            The IPv6 header
  * @param is_innermost    true if the IP header is the innermost of the packet,
@@ -2735,13 +2798,13 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                const struct comp_rfc5225_tmp_variables *const tmp,
                                                 const ip_context_t *const ip_ctxt,
                                                 const struct ipv6_hdr *const ipv6,
                                                 const bool is_innermost,
                                                 uint8_t *const rohc_data,
                                                 const size_t rohc_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = ctxt->specific;
 	uint8_t *rohc_remain_data = rohc_data;
 	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv6_irreg_len = 0;
@@ -2749,7 +2812,7 @@ static int rohc_comp_rfc5225_ip_irreg_ipv6_part(const struct rohc_comp_ctxt *con
 	assert(ip_ctxt->version == IPV6);
 
 	/* TOS and TTL for outer IP headers */
-	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
+	if(!is_innermost && tmp->outer_ip_flag)
 	{
 		const size_t tc_hl_req_len = 2;
 
@@ -2858,6 +2921,7 @@ error:
  * @brief Build a ROHCv2 pt_1_seq_id packet
  *
  * @param context         The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
  * @param rohc_max_len    The max remaining length in the ROHC buffer
@@ -2865,6 +2929,7 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                      const struct comp_rfc5225_tmp_variables *const tmp,
                                                       const uint8_t crc,
                                                       uint8_t *const rohc_data,
                                                       const size_t rohc_max_len)
@@ -2884,7 +2949,7 @@ static int rohc_comp_rfc5225_ip_build_pt_1_seq_id_pkt(const struct rohc_comp_ctx
 	pt_1_seq_id->header_crc = crc;
 	pt_1_seq_id->msn_1 = (rfc5225_ctxt->msn >> 4) & 0x03;
 	pt_1_seq_id->msn_2 = rfc5225_ctxt->msn & 0x0f;
-	pt_1_seq_id->ip_id = rfc5225_ctxt->tmp.innermost_ip_id_offset & 0x0f;
+	pt_1_seq_id->ip_id = tmp->innermost_ip_id_offset & 0x0f;
 
 	return sizeof(pt_1_seq_id_t);
 
@@ -2897,6 +2962,7 @@ error:
  * @brief Build a ROHCv2 pt_2_seq_id packet
  *
  * @param context         The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
  * @param rohc_max_len    The max remaining length in the ROHC buffer
@@ -2904,6 +2970,7 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctxt *const context,
+                                                      const struct comp_rfc5225_tmp_variables *const tmp,
                                                       const uint8_t crc,
                                                       uint8_t *const rohc_data,
                                                       const size_t rohc_max_len)
@@ -2920,8 +2987,8 @@ static int rohc_comp_rfc5225_ip_build_pt_2_seq_id_pkt(const struct rohc_comp_ctx
 	}
 
 	pt_2_seq_id->discriminator = 0x6;
-	pt_2_seq_id->ip_id_1 = (rfc5225_ctxt->tmp.innermost_ip_id_offset >> 1) & 0x1f;
-	pt_2_seq_id->ip_id_2 = rfc5225_ctxt->tmp.innermost_ip_id_offset & 0x01;
+	pt_2_seq_id->ip_id_1 = (tmp->innermost_ip_id_offset >> 1) & 0x1f;
+	pt_2_seq_id->ip_id_2 = tmp->innermost_ip_id_offset & 0x01;
 	pt_2_seq_id->header_crc = crc;
 	pt_2_seq_id->msn = rfc5225_ctxt->msn & 0xff;
 
@@ -2936,6 +3003,7 @@ error:
  * @brief Build a ROHCv2 co_common packet
  *
  * @param context         The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param crc             The CRC on the uncompressed headers
  * @param[out] rohc_data  The ROHC packet being built
  * @param rohc_max_len    The max remaining length in the ROHC buffer
@@ -2943,6 +3011,7 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt *const context,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const uint8_t crc,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
@@ -2967,9 +3036,9 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 	co_common->discriminator = 0xfa; /* '11111010' */
 	/* ip_id_indicator is set later in the function */
 	co_common->header_crc = crc;
-	if(rfc5225_ctxt->tmp.innermost_df_changed ||
-		rfc5225_ctxt->tmp.outer_ip_flag ||
-		rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed)
+	if(tmp->innermost_df_changed ||
+		tmp->outer_ip_flag ||
+		tmp->innermost_ip_id_behavior_changed)
 	{
 		co_common->flags_ind = 1;
 	}
@@ -2977,8 +3046,8 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 	{
 		co_common->flags_ind = 0;
 	}
-	co_common->ttl_hopl_ind = rfc5225_ctxt->tmp.innermost_ttl_hopl_changed;
-	co_common->tos_tc_ind = rfc5225_ctxt->tmp.innermost_tos_tc_changed;
+	co_common->ttl_hopl_ind = tmp->innermost_ttl_hopl_changed;
+	co_common->tos_tc_ind = tmp->innermost_tos_tc_changed;
 	co_common->reorder_ratio = context->compressor->reorder_ratio;
 
 	/* CRC-3 over control fields */
@@ -3037,8 +3106,8 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 			goto error;
 		}
 
-		profile_2_3_4_flags->ip_outer_indicator = rfc5225_ctxt->tmp.outer_ip_flag;
-		profile_2_3_4_flags->df = rfc5225_ctxt->tmp.innermost_df;
+		profile_2_3_4_flags->ip_outer_indicator = tmp->outer_ip_flag;
+		profile_2_3_4_flags->df = tmp->innermost_df;
 		assert(innermost_ip_id_behavior == (innermost_ip_id_behavior & 0x03));
 		profile_2_3_4_flags->ip_id_behavior = innermost_ip_id_behavior;
 		profile_2_3_4_flags->reserved = 0;
@@ -3059,7 +3128,7 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 			               "%zu bytes available", rohc_remain_len);
 			goto error;
 		}
-		rohc_remain_data[0] = rfc5225_ctxt->tmp.innermost_tos_tc;
+		rohc_remain_data[0] = tmp->innermost_tos_tc;
 		rohc_remain_data++;
 		rohc_remain_len--;
 		co_common_hdr_len++;
@@ -3076,7 +3145,7 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 			               "%zu bytes available", rohc_remain_len);
 			goto error;
 		}
-		rohc_remain_data[0] = rfc5225_ctxt->tmp.innermost_ttl_hopl;
+		rohc_remain_data[0] = tmp->innermost_ttl_hopl;
 		rohc_remain_data++;
 		rohc_remain_len--;
 		co_common_hdr_len++;
@@ -3102,8 +3171,8 @@ static int rohc_comp_rfc5225_ip_build_co_common_pkt(const struct rohc_comp_ctxt
 		int ret;
 
 		ret = c_optional_ip_id_lsb(innermost_ip_id_behavior,
-		                           rohc_hton16(rfc5225_ctxt->tmp.innermost_ip_id),
-		                           rfc5225_ctxt->tmp.innermost_ip_id_offset,
+		                           rohc_hton16(tmp->innermost_ip_id),
+		                           tmp->innermost_ip_id_offset,
 		                           &rfc5225_ctxt->innermost_ip_id_offset_wlsb,
 		                           rohc_interval_get_rfc5225_id_id_p(8),
 		                           rohc_remain_data, rohc_remain_len, &indicator);
@@ -44,8 +44,11 @@
 
 
 /**
- * @brief Define the RFC5225-specific temporary variables in the profile
- *        compression context
+ * @brief Define the RFC5225-specific temporary variables used while
+ *        encoding one single packet
+ *
+ * The variables are stored in the room that the compressor shares between
+ * all its contexts, see \ref ROHC_COMP_TMP_VARS_MAX_LEN.
  */
 struct comp_rfc5225_tmp_variables
 {
@@ -95,6 +98,14 @@ struct comp_rfc5225_tmp_variables
 	bool udp_checksum_used_changed;
 };
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(sizeof(struct comp_rfc5225_tmp_variables) <= ROHC_COMP_TMP_VARS_MAX_LEN,
+               "comp_rfc5225_tmp_variables should fit in the shared room");
+#endif
+
 
 /** Define the ROHCv2 IP/UDP/RTP part of the profile compression context */
 struct rohc_comp_rfc5225_ip_udp_rtp_ctxt
@@ -141,8 +152,6 @@ struct rohc_comp_rfc5225_ip_udp_rtp_ctxt
 	/** The number of innermost TTL/HL transmissions since last change */
 	uint8_t innermost_ttl_hopl_trans_nr;
 
-	struct comp_rfc5225_tmp_variables tmp;
-
 	/** The UDP Source port */
 	uint16_t udp_sport;
 	/** The UDP Destination port */
@@ -154,6 +163,12 @@ struct rohc_comp_rfc5225_ip_udp_rtp_ctxt
 
 	/** The RTP SSRC field */
 	uint32_t rtp_ssrc;
+
+	/** The CRCs over the last uncompressed headers */
+	struct crc_hdrs_cache crc_cache;
+
+	/** The static chain encoded once for all the IR packets */
+	struct rohc_comp_static_chain static_chain;
 };
 
 
@@ -171,19 +186,22 @@ static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const co
 /* encode ROHCv2 IP/UDP/RTP packets */
 static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const context,
                                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                               void *const tmp_vars,
                                                uint8_t *const rohc_pkt,
                                                const size_t rohc_pkt_max_len,
                                                rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *const context,
+                                                        struct comp_rfc5225_tmp_variables *const tmp,
                                                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
-	__attribute__((nonnull(1, 2)));
+	__attribute__((nonnull(1, 2, 3)));
 static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes_ipv4(struct rohc_comp_ctxt *const ctxt,
+                                                             struct comp_rfc5225_tmp_variables *const tmp,
                                                              ip_context_t *const ip_ctxt,
                                                              const struct ipv4_hdr *const ipv4,
                                                              const bool is_innermost)
-	__attribute__((nonnull(1, 2, 3)));
+	__attribute__((nonnull(1, 2, 3, 4)));
 
 static int rohc_comp_rfc5225_ip_udp_rtp_code_IR_pkt(const struct rohc_comp_ctxt *const ctxt,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
@@ -198,11 +216,12 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_co_repair_pkt(const struct rohc_com
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static int rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                     uint8_t *const rohc_pkt,
                                                     const size_t rohc_pkt_max_len,
                                                     const rohc_packet_t packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 /* static chain */
 static int rohc_comp_rfc5225_ip_udp_rtp_static_chain(const struct rohc_comp_ctxt *const ctxt,
@@ -264,24 +283,27 @@ static int rohc_comp_rfc5225_ip_udp_rtp_dyn_rtp_part(const struct rohc_comp_ctxt
 
 /* irregular chain */
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                     uint8_t *const rohc_pkt,
                                                     const size_t rohc_pkt_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3)));
+        __attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const ip_context_t *const ip_ctxt,
                                                     const struct ipv4_hdr *const ipv4,
                                                     const bool is_innermost,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const ip_context_t *const ip_ctxt,
                                                     const struct ipv6_hdr *const ipv6,
                                                     const bool is_innermost,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
-        __attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+        __attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_udp_part(const struct rohc_comp_ctxt *const ctxt,
                                                    const struct udphdr *const udp,
                                                    uint8_t *const rohc_data,
@@ -309,21 +331,24 @@ static void rohc_comp_rfc5225_ip_udp_rtp_feedback_ack(struct rohc_comp_ctxt *con
 	__attribute__((nonnull(1)));
 
 /* decide packet */
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ctxt *const context)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ctxt *const context,
+                                                             const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                                const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt)
-	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                                const struct comp_rfc5225_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                               const struct comp_rfc5225_tmp_variables *const tmp,
                                                                const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_offsets *const offsets,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 	__attribute__((warn_unused_result, nonnull(1)));
@@ -367,7 +392,8 @@ static bool rohc_comp_rfc5225_ip_udp_rtp_create(struct rohc_comp_ctxt *const con
 	assert(uncomp_pkt_hdrs->rtp != NULL);
 
 	/* create the ROHCv2 IP/UDP/RTP part of the profile context */
-	rfc5225_ctxt = calloc(1, sizeof(struct rohc_comp_rfc5225_ip_udp_rtp_ctxt));
+	rfc5225_ctxt =
+		rohc_comp_ctxt_zalloc(context, sizeof(struct rohc_comp_rfc5225_ip_udp_rtp_ctxt));
 	if(rfc5225_ctxt == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -452,7 +478,7 @@ static bool rohc_comp_rfc5225_ip_udp_rtp_create(struct rohc_comp_ctxt *const con
 free_wlsb_msn:
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
 free_context:
-	free(rfc5225_ctxt);
+	rohc_comp_ctxt_free(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -472,7 +498,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const co
 
 	wlsb_free(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
 	wlsb_free(&rfc5225_ctxt->msn_wlsb);
-	free(rfc5225_ctxt);
+	rohc_comp_ctxt_free(rfc5225_ctxt);
 }
 
 
@@ -490,6 +516,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const co
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -498,12 +525,14 @@ static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const co
  */
 static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const context,
                                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                               void *const tmp_vars,
                                                uint8_t *const rohc_pkt,
                                                const size_t rohc_pkt_max_len,
                                                rohc_packet_t *const packet_type)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
+	struct comp_rfc5225_tmp_variables *const tmp = tmp_vars;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
@@ -515,15 +544,15 @@ static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const cont
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
 	/* STEP 0: detect changes between new uncompressed packet and context */
-	rohc_comp_rfc5225_ip_udp_rtp_detect_changes(context, uncomp_pkt_hdrs);
+	rohc_comp_rfc5225_ip_udp_rtp_detect_changes(context, tmp, uncomp_pkt_hdrs);
 
 	/* STEP 1: decide packet type */
-	*packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(context);
+	*packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(context, tmp);
 
 	/* the outer_ip_flag may be set to 1 only for co_common */
-	if(rfc5225_ctxt->tmp.outer_ip_flag && (*packet_type) != ROHC_PACKET_CO_COMMON)
+	if(tmp->outer_ip_flag && (*packet_type) != ROHC_PACKET_CO_COMMON)
 	{
-		rfc5225_ctxt->tmp.outer_ip_flag = false;
+		tmp->outer_ip_flag = false;
 	}
 
 	/* does the packet update the decompressor context? */
@@ -557,7 +586,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const cont
 	}
 	else /* other CO packets */
 	{
-		ret = rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(context, uncomp_pkt_hdrs,
+		ret = rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(context, tmp, uncomp_pkt_hdrs,
 		                                               rohc_remain_data, rohc_remain_len,
 		                                               *packet_type);
 		if(ret < 0)
@@ -593,8 +622,8 @@ static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const cont
 			if((ip_hdr_pos + 1) == rfc5225_ctxt->ip_contexts_nr)
 			{
 				c_add_wlsb(&rfc5225_ctxt->innermost_ip_id_offset_wlsb, rfc5225_ctxt->msn,
-				           rfc5225_ctxt->tmp.innermost_ip_id_offset);
-				rfc5225_ctxt->innermost_ip_id_offset = rfc5225_ctxt->tmp.innermost_ip_id_offset;
+				           tmp->innermost_ip_id_offset);
+				rfc5225_ctxt->innermost_ip_id_offset = tmp->innermost_ip_id_offset;
 			}
 			ip_ctxt->df = ip_hdr->ipv4->df;
 		}
@@ -602,7 +631,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const cont
 		/* TODO: handle IPv6 extension headers */
 	}
 	/* update context for the UDP header */
-	rfc5225_ctxt->udp_checksum_used = rfc5225_ctxt->tmp.new_udp_checksum_used;
+	rfc5225_ctxt->udp_checksum_used = tmp->new_udp_checksum_used;
 	/* update transmission counters */
 	if(rfc5225_ctxt->all_df_trans_nr < oa_repetitions_nr)
 	{
@@ -664,9 +693,11 @@ error:
  * @brief Detect changes between packet and context
  *
  * @param context          The compression context to compare
+ * @param tmp              The temporary variables for the current packet
  * @param uncomp_pkt_hdrs  The uncompressed headers to compare
  */
 static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *const context,
+                                                        struct comp_rfc5225_tmp_variables *const tmp,
                                                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 {
 	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
@@ -677,17 +708,17 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 	/* detect changes in all the IP headers */
 	rohc_comp_debug(context, "detect changes the IP packet");
 	assert(rfc5225_ctxt->ip_contexts_nr > 0);
-	rfc5225_ctxt->tmp.outer_df_changed = false;
-	rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = false;
-	rfc5225_ctxt->tmp.outer_ip_flag = false;
-	rfc5225_ctxt->tmp.innermost_df_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_id_offset_changed = false;
-	rfc5225_ctxt->tmp.innermost_tos_tc_changed = false;
-	rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = false;
-	rfc5225_ctxt->tmp.innermost_ip_flag = false;
-	rfc5225_ctxt->tmp.at_least_one_df_changed = false;
-	rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = false;
+	tmp->outer_df_changed = false;
+	tmp->outer_ip_id_behavior_changed = false;
+	tmp->outer_ip_flag = false;
+	tmp->innermost_df_changed = false;
+	tmp->innermost_ip_id_behavior_changed = false;
+	tmp->innermost_ip_id_offset_changed = false;
+	tmp->innermost_tos_tc_changed = false;
+	tmp->innermost_ttl_hopl_changed = false;
+	tmp->innermost_ip_flag = false;
+	tmp->at_least_one_df_changed = false;
+	tmp->at_least_one_ip_id_behavior_changed = false;
 	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_contexts_nr; ip_hdr_pos++)
 	{
 		ip_context_t *const ip_ctxt = &(rfc5225_ctxt->ip_contexts[ip_hdr_pos]);
@@ -706,21 +737,21 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 			{
 				rohc_comp_debug(context, "    TOS/HL (0x%02x -> 0x%02x) changed",
 				                ip_ctxt->tos_tc, ip_hdr->tos_tc);
-				rfc5225_ctxt->tmp.innermost_tos_tc_changed = true;
-				rfc5225_ctxt->tmp.innermost_ip_flag = true;
+				tmp->innermost_tos_tc_changed = true;
+				tmp->innermost_ip_flag = true;
 			}
 			/* innermost TTL/HL changed? */
 			if(ip_ctxt->ttl_hopl != ip_hdr->ttl_hl)
 			{
 				rohc_comp_debug(context, "    TTL/HL (%u -> %u) changed",
 				                ip_ctxt->ttl_hopl, ip_hdr->ttl_hl);
-				rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = true;
-				rfc5225_ctxt->tmp.innermost_ip_flag = true;
+				tmp->innermost_ttl_hopl_changed = true;
+				tmp->innermost_ip_flag = true;
 			}
 			/* save the new values of innermost TOS/HL and TTL/HL to easily retrieve them
 			 * during packet creation */
-			rfc5225_ctxt->tmp.innermost_tos_tc = ip_hdr->tos_tc;
-			rfc5225_ctxt->tmp.innermost_ttl_hopl = ip_hdr->ttl_hl;
+			tmp->innermost_tos_tc = ip_hdr->tos_tc;
+			tmp->innermost_ttl_hopl = ip_hdr->ttl_hl;
 		}
 		else
 		{
@@ -730,14 +761,14 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 				rohc_comp_debug(context, "    TOS/HL (%02x -> %02x) or TTL/HL (%u -> %u) "
 				                "changed", ip_ctxt->tos_tc, ip_hdr->tos_tc,
 				                ip_ctxt->ttl_hopl, ip_hdr->ttl_hl);
-				rfc5225_ctxt->tmp.outer_ip_flag = true;
+				tmp->outer_ip_flag = true;
 			}
 		}
 
 		if(ip_hdr->version == IPV4)
 		{
 			/* detect changes in the IPv4 header */
-			rohc_comp_rfc5225_ip_udp_rtp_detect_changes_ipv4(context, ip_ctxt,
+			rohc_comp_rfc5225_ip_udp_rtp_detect_changes_ipv4(context, tmp, ip_ctxt,
 			                                                 ip_hdr->ipv4, is_innermost);
 		}
 		else /* IPv6 */
@@ -746,7 +777,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 			 * packet creation */
 			if(is_innermost)
 			{
-				rfc5225_ctxt->tmp.innermost_df = 0; /* no DF, dont_fragment() uses 0 */
+				tmp->innermost_df = 0; /* no DF, dont_fragment() uses 0 */
 			}
 
 			/* TODO: handle IPv6 extension headers */
@@ -757,17 +788,17 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 	}
 
 	/* detect changes in UDP header */
-	rfc5225_ctxt->tmp.new_udp_checksum_used = !!(uncomp_pkt_hdrs->udp->check != 0);
-	if(rfc5225_ctxt->tmp.new_udp_checksum_used != rfc5225_ctxt->udp_checksum_used)
+	tmp->new_udp_checksum_used = !!(uncomp_pkt_hdrs->udp->check != 0);
+	if(tmp->new_udp_checksum_used != rfc5225_ctxt->udp_checksum_used)
 	{
 		rohc_comp_debug(context, "UDP checksum used changed (%d -> %d)",
 		                rfc5225_ctxt->udp_checksum_used,
-		                rfc5225_ctxt->tmp.new_udp_checksum_used);
-		rfc5225_ctxt->tmp.udp_checksum_used_changed = true;
+		                tmp->new_udp_checksum_used);
+		tmp->udp_checksum_used_changed = true;
 	}
 	else
 	{
-		rfc5225_ctxt->tmp.udp_checksum_used_changed = false;
+		tmp->udp_checksum_used_changed = false;
 	}
 
 	/* detect changes in RTP header */
@@ -778,16 +809,16 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rfc5225_ctxt->msn = rohc_ntoh16(uncomp_pkt_hdrs->rtp->sn);
 		rohc_comp_debug(context, "MSN = 0x%04x / %u", rfc5225_ctxt->msn, rfc5225_ctxt->msn);
 		/* compute the MSN offset */
-		rfc5225_ctxt->tmp.msn_offset = rfc5225_ctxt->msn - old_msn;
+		tmp->msn_offset = rfc5225_ctxt->msn - old_msn;
 		rohc_comp_debug(context, "MSN offset = %d (%u -> %u)",
-		                rfc5225_ctxt->tmp.msn_offset, old_msn, rfc5225_ctxt->msn);
+		                tmp->msn_offset, old_msn, rfc5225_ctxt->msn);
 	}
 
 	/* now that the MSN was updated with the new received IP/UDP/RTP packet,
 	 * compute the new IP-ID / MSN offset for the innermost IP header */
 	if(innermost_ip_ctxt->version == IPV4)
 	{
-		const uint16_t ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
+		const uint16_t ip_id = tmp->innermost_ip_id;
 		const uint16_t last_ip_id = innermost_ip_ctxt->last_ip_id;
 		const rohc_ip_id_behavior_t last_ip_id_behavior =
 			innermost_ip_ctxt->ip_id_behavior;
@@ -806,7 +837,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		{
 			ip_id_behavior =
 				rohc_comp_detect_ip_id_behavior(last_ip_id, ip_id,
-				                                rfc5225_ctxt->tmp.msn_offset, 19);
+				                                tmp->msn_offset, 19);
 		}
 		/* TODO: avoid changing context here */
 		innermost_ip_ctxt->ip_id_behavior = ip_id_behavior;
@@ -814,34 +845,34 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		                rohc_ip_id_behavior_get_descr(ip_id_behavior));
 		if(last_ip_id_behavior != ip_id_behavior)
 		{
-			rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
-			rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = true;
+			tmp->at_least_one_ip_id_behavior_changed = true;
+			tmp->innermost_ip_id_behavior_changed = true;
 		}
 
 		if(innermost_ip_ctxt->ip_id_behavior == ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
 		{
 			/* specific case of IP-ID delta for sequential swapped behavior */
-			rfc5225_ctxt->tmp.innermost_ip_id_offset =
-				swab16(rfc5225_ctxt->tmp.innermost_ip_id) - rfc5225_ctxt->msn;
+			tmp->innermost_ip_id_offset =
+				swab16(tmp->innermost_ip_id) - rfc5225_ctxt->msn;
 		}
 		else
 		{
 			/* compute delta the same way for sequential, zero or random: it is
 			 * important to always compute the IP-ID delta and record it in W-LSB,
 			 * so that the IP-ID deltas of next packets may be correctly encoded */
-			rfc5225_ctxt->tmp.innermost_ip_id_offset =
-				rfc5225_ctxt->tmp.innermost_ip_id - rfc5225_ctxt->msn;
+			tmp->innermost_ip_id_offset =
+				tmp->innermost_ip_id - rfc5225_ctxt->msn;
 		}
 		rohc_comp_debug(context, "new IP-ID offset = 0x%x / %u",
-		                rfc5225_ctxt->tmp.innermost_ip_id_offset,
-		                rfc5225_ctxt->tmp.innermost_ip_id_offset);
+		                tmp->innermost_ip_id_offset,
+		                tmp->innermost_ip_id_offset);
 
-		rfc5225_ctxt->tmp.innermost_ip_id_offset_changed =
-			!!(rfc5225_ctxt->innermost_ip_id_offset != rfc5225_ctxt->tmp.innermost_ip_id_offset);
+		tmp->innermost_ip_id_offset_changed =
+			!!(rfc5225_ctxt->innermost_ip_id_offset != tmp->innermost_ip_id_offset);
 	}
 
 	/* any DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.at_least_one_df_changed)
+	if(tmp->at_least_one_df_changed)
 	{
 		rohc_comp_debug(context, "at least one DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -852,10 +883,10 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "at least one DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->all_df_trans_nr);
-		rfc5225_ctxt->tmp.at_least_one_df_changed = true;
+		tmp->at_least_one_df_changed = true;
 	}
 	/* the innermost DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_df_changed)
+	if(tmp->innermost_df_changed)
 	{
 		rohc_comp_debug(context, "innermost DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -866,10 +897,10 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_df_trans_nr);
-		rfc5225_ctxt->tmp.innermost_df_changed = true;
+		tmp->innermost_df_changed = true;
 	}
 	/* any outer DF that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_df_changed)
+	if(tmp->outer_df_changed)
 	{
 		rohc_comp_debug(context, "at least one outer DF changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -880,11 +911,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "at least one outer DF changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_df_trans_nr);
-		rfc5225_ctxt->tmp.outer_df_changed = true;
+		tmp->outer_df_changed = true;
 	}
 
 	/* any IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	if(tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "at least one IP-ID behavior changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -895,10 +926,10 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "at least one IP-ID behavior changed in last "
 		                "packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->all_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
+		tmp->at_least_one_ip_id_behavior_changed = true;
 	}
 	/* innermost IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed)
+	if(tmp->innermost_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "innermost IP-ID behavior changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -909,11 +940,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost IP-ID behavior changed in last packets, "
 		                "it shall be transmitted %u times more", oa_repetitions_nr -
 		                rfc5225_ctxt->innermost_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_id_behavior_changed = true;
+		tmp->innermost_ip_id_behavior_changed = true;
 	}
 	/* innermost IP-ID offset that changes shall be transmitted several times
 	 * before being inferred */
-	if(rfc5225_ctxt->tmp.innermost_ip_id_offset_changed)
+	if(tmp->innermost_ip_id_offset_changed)
 	{
 		rohc_comp_debug(context, "innermost IP-ID offset changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -924,10 +955,10 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost IP-ID offset changed in last packets, "
 		                "it shall be transmitted %u times more", oa_repetitions_nr -
 		                rfc5225_ctxt->innermost_ip_id_offset_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_id_offset_changed = true;
+		tmp->innermost_ip_id_offset_changed = true;
 	}
 	/* any outer IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
+	if(tmp->outer_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(context, "at least one outer IP-ID behavior changed in "
 		                "current packet, it shall be transmitted %u times",
@@ -939,11 +970,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "at least one outer IP-ID behavior changed in "
 		                "last packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_ip_id_behavior_trans_nr);
-		rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = true;
+		tmp->outer_ip_id_behavior_changed = true;
 	}
 
 	/* innermost IP flag that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ip_flag)
+	if(tmp->innermost_ip_flag)
 	{
 		rohc_comp_debug(context, "innermost IP flag changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -954,10 +985,10 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost IP flag changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_ip_flag_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ip_flag = true;
+		tmp->innermost_ip_flag = true;
 	}
 	/* any outer IP-ID behavior that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.outer_ip_flag)
+	if(tmp->outer_ip_flag)
 	{
 		rohc_comp_debug(context, "at least one outer IP flag changed in current "
 		                "packet, it shall be transmitted %u times", oa_repetitions_nr);
@@ -968,11 +999,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "at least one outer IP flag changed in last "
 		                "packets, it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->outer_ip_flag_trans_nr);
-		rfc5225_ctxt->tmp.outer_ip_flag = true;
+		tmp->outer_ip_flag = true;
 	}
 
 	/* innermost TOS/TC that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_tos_tc_changed)
+	if(tmp->innermost_tos_tc_changed)
 	{
 		rohc_comp_debug(context, "innermost TOS/TC changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -983,11 +1014,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost TOS/TC changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_tos_tc_trans_nr);
-		rfc5225_ctxt->tmp.innermost_tos_tc_changed = true;
+		tmp->innermost_tos_tc_changed = true;
 	}
 
 	/* innermost TTL/HL that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.innermost_ttl_hopl_changed)
+	if(tmp->innermost_ttl_hopl_changed)
 	{
 		rohc_comp_debug(context, "innermost TTL/HL changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -998,11 +1029,11 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "innermost TTL/HL changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->innermost_ttl_hopl_trans_nr);
-		rfc5225_ctxt->tmp.innermost_ttl_hopl_changed = true;
+		tmp->innermost_ttl_hopl_changed = true;
 	}
 
 	/* 'UDP checksum used' that changes shall be transmitted several times */
-	if(rfc5225_ctxt->tmp.udp_checksum_used_changed)
+	if(tmp->udp_checksum_used_changed)
 	{
 		rohc_comp_debug(context, "'UDP checksum used' changed in current packet, "
 		                "it shall be transmitted %u times", oa_repetitions_nr);
@@ -1013,7 +1044,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
 		rohc_comp_debug(context, "'UDP checksum used' changed in last packets, "
 		                "it shall be transmitted %u times more",
 		                oa_repetitions_nr - rfc5225_ctxt->udp_checksum_used_trans_nr);
-		rfc5225_ctxt->tmp.udp_checksum_used_changed = true;
+		tmp->udp_checksum_used_changed = true;
 	}
 }
 
@@ -1022,37 +1053,38 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(struct rohc_comp_ctxt *c
  * @brief Detect changes for the given IPv4 header between packet and context
  *
  * @param ctxt          The compression context
+ * @param tmp           The temporary variables for the current packet
  * @param ip_ctxt       The IPv4 context to compare
  * @param ipv4          The IPv4 header to compare
  * @param is_innermost  Whether the IPv4 header is the innermost of all IP headers
  */
 static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes_ipv4(struct rohc_comp_ctxt *const ctxt,
+                                                             struct comp_rfc5225_tmp_variables *const tmp,
                                                              ip_context_t *const ip_ctxt,
                                                              const struct ipv4_hdr *const ipv4,
                                                              const bool is_innermost)
 {
 	/* TODO: parameter ip_ctxt should be const */
-	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = ctxt->specific;
 
 	/* IPv4 DF changed? */
 	if(ip_ctxt->df != ipv4->df)
 	{
 		rohc_comp_debug(ctxt, "    DF (%u -> %u) changed", ip_ctxt->df, ipv4->df);
-		rfc5225_ctxt->tmp.at_least_one_df_changed = true;
+		tmp->at_least_one_df_changed = true;
 		if(is_innermost)
 		{
-			rfc5225_ctxt->tmp.innermost_df_changed = true;
+			tmp->innermost_df_changed = true;
 		}
 		else
 		{
-			rfc5225_ctxt->tmp.outer_df_changed = true;
+			tmp->outer_df_changed = true;
 		}
 	}
 	/* save the new value of the innermost DF to easily retrieve them during
 	 * packet creation */
 	if(is_innermost)
 	{
-		rfc5225_ctxt->tmp.innermost_df = ipv4->df;
+		tmp->innermost_df = ipv4->df;
 	}
 
 	/* determine the IP-ID behavior of the IPv4 header */
@@ -1091,13 +1123,13 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes_ipv4(struct rohc_comp_ct
 		                rohc_ip_id_behavior_get_descr(ip_id_behavior));
 		if(last_ip_id_behavior != ip_id_behavior)
 		{
-			rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed = true;
-			rfc5225_ctxt->tmp.outer_ip_id_behavior_changed = true;
+			tmp->at_least_one_ip_id_behavior_changed = true;
+			tmp->outer_ip_id_behavior_changed = true;
 		}
 	}
 	else
 	{
-		rfc5225_ctxt->tmp.innermost_ip_id = rohc_ntoh16(ipv4->id);
+		tmp->innermost_ip_id = rohc_ntoh16(ipv4->id);
 	}
 }
 
@@ -1381,6 +1413,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_feedback_ack(struct rohc_comp_ctxt *con
  * @brief Decide which packet to send when in the different states
  *
  * @param context           The compression context
+ * @param tmp               The temporary variables for the current packet
  * @return                  \li The packet type among ROHC_PACKET_IR,
  *                              ROHC_PACKET_PT_0_CRC3,
  *                              ROHC_PACKET_NORTP_PT_0_CRC7,
@@ -1389,7 +1422,8 @@ static void rohc_comp_rfc5225_ip_udp_rtp_feedback_ack(struct rohc_comp_ctxt *con
  *                              in case of success
  *                          \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ctxt *const context)
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ctxt *const context,
+                                                             const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	rohc_packet_t packet_type;
 
@@ -1401,10 +1435,10 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ct
 			packet_type = ROHC_PACKET_IR;
 			break;
 		case ROHC_COMP_STATE_FO:
-			packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(context);
+			packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(context, tmp);
 			break;
 		case ROHC_COMP_STATE_SO:
-			packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(context);
+			packet_type = rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(context, tmp);
 			break;
 		case ROHC_COMP_STATE_UNKNOWN:
 		default:
@@ -1428,6 +1462,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ct
  * @brief Decide which packet to send when in FO state
  *
  * @param ctxt  The compression context
+ * @param tmp   The temporary variables for the current packet
  * @return      \li The packet type among ROHC_PACKET_IR,
  *                  ROHC_PACKET_CO_REPAIR,
  *                  ROHC_PACKET_CO_COMMON,
@@ -1436,11 +1471,12 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_pkt(struct rohc_comp_ct
  *                  in case of success
  *              \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt)
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                                const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = true;
 	const rohc_packet_t packet_type =
-		rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(ctxt, crc7_at_least);
+		rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(ctxt, tmp, crc7_at_least);
 
 	assert(packet_type != ROHC_PACKET_PT_0_CRC3);
 	assert(packet_type != ROHC_PACKET_NORTP_PT_1_SEQ_ID);
@@ -1453,6 +1489,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct roh
  * @brief Decide which packet to send when in SO state
  *
  * @param ctxt  The compression context
+ * @param tmp   The temporary variables for the current packet
  * @return      \li The packet type among ROHC_PACKET_IR,
  *                  ROHC_PACKET_CO_REPAIR,
  *                  ROHC_PACKET_CO_COMMON,
@@ -1463,10 +1500,11 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_pkt(const struct roh
  *                  in case of success
  *              \li ROHC_PACKET_UNKNOWN in case of failure
  */
-static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt)
+static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                                const struct comp_rfc5225_tmp_variables *const tmp)
 {
 	const bool crc7_at_least = false;
-	return rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(ctxt, crc7_at_least);
+	return rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(ctxt, tmp, crc7_at_least);
 }
 
 
@@ -1474,6 +1512,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct roh
  * @brief Decide which packet to send when in FO or SO state
  *
  * @param ctxt           The compression context
+ * @param tmp            The temporary variables for the current packet
  * @param crc7_at_least  Whether packet types with CRC strictly smaller
  *                       than 7 bits are allowed or not
  * @return               \li The packet type among ROHC_PACKET_IR,
@@ -1487,23 +1526,41 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_SO_pkt(const struct roh
  *                       \li ROHC_PACKET_UNKNOWN in case of failure
  */
 static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct rohc_comp_ctxt *const ctxt,
+                                                               const struct comp_rfc5225_tmp_variables *const tmp,
                                                                const bool crc7_at_least)
 {
 	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = ctxt->specific;
-	const int16_t msn_offset = rfc5225_ctxt->tmp.msn_offset;
+	const int16_t msn_offset = tmp->msn_offset;
 	const uint8_t oa_repetitions_nr = ctxt->compressor->oa_repetitions_nr;
 	const rohc_reordering_offset_t reorder_ratio = ctxt->compressor->reorder_ratio;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
-	const uint16_t innermost_ip_id = rfc5225_ctxt->tmp.innermost_ip_id;
+	const uint16_t innermost_ip_id = tmp->innermost_ip_id;
 	const uint8_t innermost_ip_id_offset_trans_nr =
 		rfc5225_ctxt->innermost_ip_id_offset_trans_nr;
 	const rohc_ip_id_behavior_t innermost_ip_id_behavior =
 		innermost_ip_ctxt->ip_id_behavior;
+	struct c_wlsb_offsets msn_offsets;
+	bool ip_id_offset_4bits_possible = false;
+	bool ip_id_offset_6bits_possible = false;
 	rohc_packet_t packet_type;
 
+	/* scan the W-LSB windows only once */
+	wlsb_get_offsets_16bits(&rfc5225_ctxt->msn_wlsb, rfc5225_ctxt->msn, &msn_offsets);
+	if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior))
+	{
+		struct c_wlsb_offsets ip_id_offsets;
+
+		wlsb_get_offsets_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+		                        tmp->innermost_ip_id_offset, &ip_id_offsets);
+		ip_id_offset_4bits_possible =
+			wlsb_is_kp_possible_offsets(&ip_id_offsets, 4, rohc_interval_get_rfc5225_id_id_p(4));
+		ip_id_offset_6bits_possible =
+			wlsb_is_kp_possible_offsets(&ip_id_offsets, 6, rohc_interval_get_rfc5225_id_id_p(6));
+	}
+
 	/* use co_repair if 'UDP checksum used' changed */
-	if(rfc5225_ctxt->tmp.udp_checksum_used_changed)
+	if(tmp->udp_checksum_used_changed)
 	{
 		rohc_comp_debug(ctxt, "code co_repair packet because 'UDP checksum used' "
 		                "changed");
@@ -1520,17 +1577,16 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn, reorder_ratio, 4) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 4) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                innermost_ip_id_offset_trans_nr,
 	                                                oa_repetitions_nr,
 	                                                innermost_ip_id, msn_offset)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_0_crc3 packet");
 		packet_type = ROHC_PACKET_PT_0_CRC3;
@@ -1544,18 +1600,16 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 	 *  - the TOS/TC fields of all IP headers shall not be changing
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 6) &&
 	        (!rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) ||
 	         rohc_comp_rfc5225_is_seq_ipid_inferred(innermost_ip_ctxt,
 	                                                innermost_ip_id_offset_trans_nr,
 	                                                oa_repetitions_nr,
 	                                                innermost_ip_id, msn_offset)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_0_crc7 packet");
 		packet_type = ROHC_PACKET_NORTP_PT_0_CRC7;
@@ -1569,17 +1623,13 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(!crc7_at_least &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 6) &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 6) &&
 	        rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 4,
-	                                   rohc_interval_get_rfc5225_id_id_p(4)) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        ip_id_offset_4bits_possible &&
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		assert(innermost_ip_ctxt->version == IPV4);
 		rohc_comp_debug(ctxt, "code pt_1_seq_id packet");
@@ -1593,16 +1643,12 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 	 *  - the behavior of the innermost IP-ID shall not be changing
 	 */
 	else if(rohc_comp_rfc5225_is_ipid_sequential(innermost_ip_id_behavior) &&
-	        wlsb_is_kp_possible_16bits(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                                   rfc5225_ctxt->tmp.innermost_ip_id_offset, 6,
-	                                   rohc_interval_get_rfc5225_id_id_p(6)) &&
-	        rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_ip_flag &&
-	        !rfc5225_ctxt->tmp.innermost_ip_flag &&
-	        !rfc5225_ctxt->tmp.at_least_one_df_changed &&
-	        !rfc5225_ctxt->tmp.at_least_one_ip_id_behavior_changed)
+	        ip_id_offset_6bits_possible &&
+	        rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 8) &&
+	        !tmp->outer_ip_flag &&
+	        !tmp->innermost_ip_flag &&
+	        !tmp->at_least_one_df_changed &&
+	        !tmp->at_least_one_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code pt_2_seq_id packet");
 		packet_type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
@@ -1612,11 +1658,9 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 	 *  - the DF fields of all outer IP headers shall not be changing
 	 *  - the behavior of the outer IP-IDs shall not be changing
 	 */
-	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&rfc5225_ctxt->msn_wlsb,
-	                                              rfc5225_ctxt->msn,
-	                                              reorder_ratio, 8) &&
-	        !rfc5225_ctxt->tmp.outer_df_changed &&
-	        !rfc5225_ctxt->tmp.outer_ip_id_behavior_changed)
+	else if(rohc_comp_rfc5225_is_msn_lsb_possible(&msn_offsets, reorder_ratio, 8) &&
+	        !tmp->outer_df_changed &&
+	        !tmp->outer_ip_id_behavior_changed)
 	{
 		rohc_comp_debug(ctxt, "code co_common packet");
 		packet_type = ROHC_PACKET_CO_COMMON;
@@ -1637,21 +1681,19 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 /**
  * @brief Define according to computed shift parameter if msn_lsb() is possible
  *
- * @param wlsb           The W-LSB object
- * @param value          The value to encode using the LSB algorithm
+ * @param offsets        The offsets of the value against the W-LSB window
  * @param reorder_ratio  The reordering ratio
  * @param k              The number of bits for encoding
  * @return               true if msn_lsb is possible or not
  */
-static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb *const wlsb,
-                                                  const uint16_t value,
+static bool rohc_comp_rfc5225_is_msn_lsb_possible(const struct c_wlsb_offsets *const offsets,
                                                   const rohc_reordering_offset_t reorder_ratio,
                                                   const size_t k)
 {
 	/* compute p according to reorder ratio  */
 	rohc_lsb_shift_t p_computed = rohc_interval_get_rfc5225_msn_p(k, reorder_ratio);
 
-	return wlsb_is_kp_possible_16bits(wlsb, value, k, p_computed);
+	return wlsb_is_kp_possible_offsets(offsets, k, p_computed);
 }
 
 
@@ -1735,6 +1777,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_IR_pkt(const struct rohc_comp_ctxt
                                                     uint8_t *const rohc_pkt,
                                                     const size_t rohc_pkt_max_len)
 {
+	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
@@ -1793,10 +1836,20 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_IR_pkt(const struct rohc_comp_ctxt
 	rohc_remain_len--;
 	rohc_hdr_len++;
 
-	/* add static chain */
-	ret = rohc_comp_rfc5225_ip_udp_rtp_static_chain(context, uncomp_pkt_hdrs,
-	                                                rohc_remain_data,
-	                                                rohc_remain_len);
+	/* add static chain, encoded once for all the IR packets of the context */
+	ret = rohc_comp_copy_static_chain(context, &rfc5225_ctxt->static_chain,
+	                                  rohc_remain_data, rohc_remain_len);
+	if(ret == 0)
+	{
+		ret = rohc_comp_rfc5225_ip_udp_rtp_static_chain(context, uncomp_pkt_hdrs,
+		                                                rohc_remain_data,
+		                                                rohc_remain_len);
+		if(ret > 0)
+		{
+			rohc_comp_cache_static_chain(context, &rfc5225_ctxt->static_chain,
+			                             rohc_remain_data, ret);
+		}
+	}
 	if(ret < 0)
 	{
 		rohc_comp_warn(context, "failed to build the static chain of the IR packet");
@@ -1878,7 +1931,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_co_repair_pkt(const struct rohc_com
                                                            uint8_t *const rohc_pkt,
                                                            const size_t rohc_pkt_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
+	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
@@ -1931,8 +1984,8 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_co_repair_pkt(const struct rohc_com
 		co_repair_crc->r1 = 0;
 		/* CRC-7 over uncompressed headers */
 		co_repair_crc->header_crc =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, co_repair_crc->header_crc);
 
@@ -2003,6 +2056,7 @@ error:
  * @brief Encode an IP packet as CO packet
  *
  * @param context           The compression context
+ * @param tmp               The temporary variables for the current packet
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
@@ -2011,11 +2065,13 @@ error:
  *                          -1 otherwise
  */
 static int rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                     uint8_t *const rohc_pkt,
                                                     const size_t rohc_pkt_max_len,
                                                     const rohc_packet_t packet_type)
 {
+	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	uint8_t crc_computed;
@@ -2031,16 +2087,16 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(const struct rohc_comp_ctxt
 	   packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_3);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_3,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-3 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
 	else
 	{
 		crc_computed =
-			crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt_hdrs->all_hdrs,
-			              uncomp_pkt_hdrs->all_hdrs_len, CRC_INIT_7);
+			crc_calc_hdrs(&rfc5225_ctxt->crc_cache, ROHC_CRC_TYPE_7,
+			              uncomp_pkt_hdrs->all_hdrs, uncomp_pkt_hdrs->all_hdrs_len);
 		rohc_comp_debug(context, "CRC-7 on %u-byte uncompressed header = 0x%x",
 		                uncomp_pkt_hdrs->all_hdrs_len, crc_computed);
 	}
@@ -2093,7 +2149,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_code_CO_pkt(const struct rohc_comp_ctxt
 	}
 
 	/* add the irregular chain at the very end of the CO header */
-	ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(context, uncomp_pkt_hdrs,
+	ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(context, tmp, uncomp_pkt_hdrs,
 	                                               rohc_remain_data,
 	                                               rohc_remain_len);
 	if(ret < 0)
@@ -2719,6 +2775,7 @@ error:
  * @brief Code the irregular chain of a ROHCv2 IP/UDP/RTP IR packet
  *
  * @param ctxt              The compression context
+ * @param tmp               The temporary variables for the current packet
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
@@ -2726,6 +2783,7 @@ error:
  *                          -1 otherwise
  */
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                     uint8_t *const rohc_pkt,
                                                     const size_t rohc_pkt_max_len)
@@ -2753,7 +2811,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(const struct rohc_comp_ctxt
 
 		if(ip_hdr->version == IPV4)
 		{
-			ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv4_part(ctxt, ip_ctxt, ip_hdr->ipv4, is_innermost,
+			ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv4_part(ctxt, tmp, ip_ctxt, ip_hdr->ipv4, is_innermost,
 			                                               rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
@@ -2766,7 +2824,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_irreg_chain(const struct rohc_comp_ctxt
 		}
 		else /* IPv6 */
 		{
-			ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv6_part(ctxt, ip_ctxt, ip_hdr->ipv6, is_innermost,
+			ret = rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv6_part(ctxt, tmp, ip_ctxt, ip_hdr->ipv6, is_innermost,
 			                                               rohc_remain_data, rohc_remain_len);
 			if(ret < 0)
 			{
@@ -2808,6 +2866,7 @@ error:
  * @brief Build the irregular part of the IPv4 header
  *
  * @param ctxt            The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param ip_ctxt         The specific IP compression context
  * @param ipv4            The IPv4 header
  * @param is_innermost    true if the IP header is the innermost of the packet,
@@ -2818,13 +2877,13 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv4_part(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const ip_context_t *const ip_ctxt,
                                                     const struct ipv4_hdr *const ipv4,
                                                     const bool is_innermost,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = ctxt->specific;
 	uint8_t *rohc_remain_data = rohc_data;
 	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv4_irreg_len = 0;
@@ -2850,7 +2909,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv4_part(const struct rohc_comp_c
 	}
 
 	/* TOS and TTL for outer IP headers */
-	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
+	if(!is_innermost && tmp->outer_ip_flag)
 	{
 		const size_t tos_ttl_req_len = 2;
 
@@ -2884,6 +2943,7 @@ error:
  * @brief Build the irregular part of the IPv6 header
  *
  * @param ctxt            The compression context
+ * @param tmp             The temporary variables for the current packet
  * @param ip_ctxt         The specific IP compression context
  * @param ipv6            The IPv6 header
  * @param is_innermost    true if the IP header is the innermost of the packet,
@@ -2894,13 +2954,13 @@ error:
  *                        -1 in case of error
  */
 static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv6_part(const struct rohc_comp_ctxt *const ctxt,
+                                                    const struct comp_rfc5225_tmp_variables *const tmp,
                                                     const ip_context_t *const ip_ctxt,
                                                     const struct ipv6_hdr *const ipv6,
                                                     const bool is_innermost,
                                                     uint8_t *const rohc_data,
                                                     const size_t rohc_max_len)
 {
-	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = ctxt->specific;
 	uint8_t *rohc_remain_data = rohc_data;
 	size_t rohc_remain_len = rohc_max_len;
 	size_t ipv6_irreg_len = 0;
@@ -2908,7 +2968,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_irreg_ipv6_part(const struct rohc_comp_c
 	assert(ip_ctxt->version == IPV6);
 
 	/* TOS and TTL for outer IP headers */
-	if(!is_innermost && rfc5225_ctxt->tmp.outer_ip_flag)
+	if(!is_innermost && tmp->outer_ip_flag)
 	{
 		const size_t tc_hl_req_len = 2;
 
@@ -125,15 +125,85 @@ static const struct rohc_comp_profile *const
 
 
 
+/*
+ * Prototypes of private functions related to packet compression
+ */
+
+static bool rohc_comp_check_bufs(const struct rohc_comp *const comp,
+                                 const struct rohc_buf *const uncomp_packet,
+                                 const struct rohc_buf *const rohc_packet)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+
+static bool rohc_comp_classify(const struct rohc_comp *const comp,
+                               const struct rohc_buf *const uncomp_packet,
+                               const rohc_comp_pkt_meta_t *const meta,
+                               struct rohc_comp_pkt *const pkt)
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
+
+static void rohc_comp_hash_pkt(const struct rohc_comp *const comp,
+                               struct rohc_comp_pkt *const pkt)
+	__attribute__((nonnull(1, 2)));
+
+static uint32_t rohc_comp_flow_key(const struct rohc_buf *const packet,
+                                   const uint32_t seed)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static inline uint32_t rohc_comp_flow_key_mix(const uint32_t key,
+                                              const uint8_t *const data)
+	__attribute__((nonnull(2), warn_unused_result, pure));
+
+static bool rohc_comp_flow_cache_probe(const struct rohc_comp *const comp,
+                                       const struct rohc_buf *const uncomp_packet,
+                                       const rohc_comp_pkt_meta_t *const meta,
+                                       struct rohc_comp_pkt *const pkt)
+	__attribute__((nonnull(1, 2, 4)));
+
+static struct rohc_comp_ctxt *
+	rohc_comp_flow_cache_get(struct rohc_comp *const comp,
+	                         const struct rohc_buf *const uncomp_packet,
+	                         const rohc_comp_pkt_meta_t *const meta,
+	                         struct rohc_comp_pkt *const pkt)
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
+
+static bool rohc_comp_flow_cache_check(const struct rohc_comp *const comp,
+                                       const struct rohc_buf *const packet,
+                                       const struct rohc_comp_flow_cache_entry *const entry,
+                                       const rohc_comp_pkt_meta_t *const meta,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+	__attribute__((nonnull(1, 2, 3, 5), warn_unused_result));
+
+static void rohc_comp_flow_cache_put(struct rohc_comp *const comp,
+                                     const struct rohc_comp_pkt *const pkt,
+                                     struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2, 3)));
+
+
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf *const uncomp_packet,
+                                            const rohc_comp_pkt_meta_t *const meta,
+                                            struct rohc_comp_pkt *const pkt,
+                                            struct rohc_buf *const rohc_packet,
+                                            const bool copy_payload)
+	__attribute__((nonnull(1, 2, 4, 5), warn_unused_result));
+
+static rohc_status_t rohc_comp_encode(struct rohc_comp *const comp,
+                                      struct rohc_comp_ctxt *const c,
+                                      const struct rohc_buf *const uncomp_packet,
+                                      struct rohc_comp_pkt *const pkt,
+                                      struct rohc_buf *const rohc_packet,
+                                      const bool copy_payload)
+	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
+
+
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
 
 static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
+                                            const rohc_comp_pkt_meta_t *const meta,
                                             struct rohc_fingerprint *const fingerprint,
                                             struct rohc_pkt_hdrs *const pkt_hdrs)
-	__attribute__((nonnull(1, 2, 3, 4), warn_unused_result));
+	__attribute__((nonnull(1, 2, 4, 5), warn_unused_result));
 
 static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
                                             const uint8_t *const packet,
@@ -144,6 +214,16 @@ static bool rohc_comp_are_ip_hdrs_supported(const struct rohc_comp *const comp,
                                             size_t *const all_ipv6_exts_len)
 	__attribute__((nonnull(1, 2, 4, 5, 6, 7), warn_unused_result));
 
+static bool rohc_comp_are_meta_ip_hdrs_supported(const struct rohc_comp *const comp,
+                                                 const uint8_t *const packet,
+                                                 const size_t packet_len,
+                                                 const rohc_comp_pkt_meta_t *const meta,
+                                                 struct rohc_fingerprint *const fingerprint,
+                                                 struct rohc_pkt_hdrs *const pkt_hdrs,
+                                                 size_t *const all_ip_hdrs_len,
+                                                 size_t *const all_ipv6_exts_len)
+	__attribute__((nonnull(1, 2, 4, 5, 6, 7, 8), warn_unused_result));
+
 static rohc_profile_t rohc_comp_get_profile_l4(const struct rohc_comp *const comp,
                                                const struct rohc_buf *const packet,
                                                const rohc_profile_t l3_profile,
@@ -179,26 +259,58 @@ static bool rohc_comp_profile_enabled_nocheck(const struct rohc_comp *const comp
 
 static bool c_create_contexts(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result, nonnull(1)));
+static void c_init_free_contexts(struct rohc_comp *const comp,
+                                 const size_t shard_idx,
+                                 const size_t shards_nr)
+	__attribute__((nonnull(1)));
 static void c_destroy_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
+static inline struct rohc_comp_ctxt *
+	c_get_ctxt_slot(const struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static struct rohc_comp_ctxt * c_new_ctxt_slot(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline size_t c_get_ctxt_page_len(const struct rohc_comp *const comp,
+                                         const size_t page_idx)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static inline size_t c_get_cid_slot(const struct rohc_comp *const comp,
+                                    const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void c_push_free_slot(struct rohc_comp *const comp, const size_t slot)
+	__attribute__((nonnull(1)));
+static size_t c_pop_free_slot(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static struct rohc_comp_ctxt *
 	c_create_context(struct rohc_comp *const comp,
 	                 const struct rohc_comp_profile *const profile,
 	                 const struct rohc_fingerprint *const fingerprint,
+	                 const uint64_t fingerprint_hash,
 	                 const struct rohc_pkt_hdrs *const pkt_hdrs,
 	                 const struct rohc_ts pkt_time)
-	__attribute__((nonnull(1, 2, 3, 4), warn_unused_result));
+	__attribute__((nonnull(1, 2, 3, 5), warn_unused_result));
 static struct rohc_comp_ctxt *
 	rohc_comp_find_ctxt(struct rohc_comp *const comp,
 	                    const struct rohc_comp_profile *const profile,
 	                    const struct rohc_buf *const packet,
 	                    const struct rohc_fingerprint *const pkt_fingerprint,
+	                    const uint64_t fingerprint_hash,
 	                    const struct rohc_pkt_hdrs *const pkt_hdrs)
-	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
+	__attribute__((nonnull(1, 2, 3, 4, 6), warn_unused_result));
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static void * c_get_ctxt_by_cid(const void *const comp, const uint32_t cid)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_lru_append(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
+static void c_lru_unlink(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1, 2)));
 
 static rohc_ctxt_affinity_t
 	rohc_comp_get_ctxt_affinity(const struct rohc_comp_ctxt *const ctxt,
@@ -229,6 +341,9 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static void rohc_comp_drain_feedbacks(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
 static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          const uint8_t *const feedback,
                                          const size_t feedback_len,
@@ -378,6 +493,8 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	comp->total_compressed_size = 0;
 	comp->total_uncompressed_size = 0;
 	comp->last_context = NULL;
+	comp->flow_cache_lookups_nr = 0;
+	comp->flow_cache_hits_nr = 0;
 
 	/* set the default number of repetitions for Optimistic Approach */
 	is_fine = rohc_comp_set_optimistic_approach(comp, oa_repetitions_nr);
@@ -409,15 +526,16 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
-	/* create the MAX_CID + 1 contexts */
+	/* create the table of the MAX_CID + 1 contexts */
 	if(!c_create_contexts(comp))
 	{
 		goto destroy_comp;
 	}
 	{
-		const unsigned int max_ctxts = max_cid + 1;
-		const size_t items_nr = 1 << (32 - __builtin_clz(max_ctxts - 1));
-		const size_t hashtable_size = items_nr << 5;
+		/* the hash tables grow with the number of contexts, so do not size
+		 * them for all the CIDs at once */
+		const size_t max_ctxts = rohc_min(((size_t) max_cid) + 1,
+		                                  ROHC_COMP_CTXT_PAGE_LEN);
 		size_t i;
 
 		/* create hash table for finding contexts by their fingerprint */
@@ -427,7 +545,8 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
 		if(!hashtable_new(&comp->contexts_by_fingerprint,
-		                  sizeof(struct rohc_fingerprint), hashtable_size))
+		                  offsetof(struct rohc_comp_ctxt, fingerprint), max_ctxts,
+		                  c_get_ctxt_by_cid, comp))
 		{
 			goto destroy_contexts;
 		}
@@ -440,8 +559,9 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 				comp->random_cb(comp, comp->random_cb_ctxt) & 0xff;
 		}
 		if(!hashtable_cr_new(&comp->contexts_cr,
-		                     sizeof(struct rohc_fingerprint_base),
-		                     sizeof(struct rohc_fingerprint), hashtable_size))
+		                     offsetof(struct rohc_comp_ctxt, fingerprint) +
+		                     offsetof(struct rohc_fingerprint, base), max_ctxts,
+		                     c_get_ctxt_by_cid, comp))
 		{
 			goto free_hashtable;
 		}
@@ -487,6 +607,8 @@ void rohc_comp_free(struct rohc_comp *const comp)
 {
 	if(comp != NULL)
 	{
+		size_t i;
+
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "free ROHC compressor");
 
@@ -495,6 +617,18 @@ void rohc_comp_free(struct rohc_comp *const comp)
 		hashtable_free(&comp->contexts_by_fingerprint);
 		c_destroy_contexts(comp);
 
+		/* free the memory of the profile-specific parts of contexts */
+		for(i = 0; i < comp->ctxt_slabs_nr; i++)
+		{
+			slab_free(&comp->ctxt_slabs[i]);
+		}
+
+		/* free the queue of feedback */
+		if(comp->feedbacks.data != NULL)
+		{
+			ring_free(&comp->feedbacks);
+		}
+
 		/* free RRU buffer */
 		if(comp->rru != NULL)
 		{
@@ -580,11 +714,68 @@ error:
 }
 
 
+/**
+ * @brief Set the minimum level of the traces in compressor
+ *
+ * Traces with a level lower than the given one are not passed to the
+ * callback function defined with \ref rohc_comp_set_traces_cb2. They are
+ * discarded before being formatted, so that a compressor with a callback
+ * that is only interested in warnings and errors does not spend time on the
+ * many debug traces emitted for every packet.
+ *
+ * The default level is \ref ROHC_TRACE_DEBUG, ie. all the traces are passed
+ * to the callback function.
+ *
+ * @warning The level can not be modified after library initialization
+ *
+ * @param comp   The ROHC compressor
+ * @param level  The minimum level of the traces to pass to the callback
+ * @return       true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_traces_level(struct rohc_comp *const comp,
+                                const rohc_trace_level_t level)
+{
+	/* check compressor validity */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* refuse to set a new trace level if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
+
+	/* check the trace level */
+	if(level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unknown trace "
+		           "level %d", level);
+		goto error;
+	}
+
+	comp->trace_level = level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the best compression profile for the given network packet
  *
  * @param comp              The ROHC compressor to compress the packet with
  * @param packet            The packet to search the best compression profile for
+ * @param meta              The metadata given by the application for the IP
+ *                          headers of the packet, NULL to parse them
  * @param[out] fingerprint  The computed fingerprint of the packet to later help
  *                          finding the best compression context
  * @param[out] pkt_hdrs     The information collected about the packet headers,
@@ -596,6 +787,7 @@ error:
  */
 static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
                                             const struct rohc_buf *const packet,
+                                            const rohc_comp_pkt_meta_t *const meta,
                                             struct rohc_fingerprint *const fingerprint,
                                             struct rohc_pkt_hdrs *const pkt_hdrs)
 {
@@ -632,10 +824,22 @@ static rohc_profile_t rohc_comp_get_profile(const struct rohc_comp *const comp,
 		pkt_hdrs->payload = remain_data;
 	}
 
-	/* check that the IP headers are supported by the ROHC profiles */
-	if(!rohc_comp_are_ip_hdrs_supported(comp, remain_data, remain_len,
-	                                    fingerprint, pkt_hdrs,
-	                                    &all_ip_hdrs_len, &all_ipv6_exts_len))
+	/* check that the IP headers are supported by the ROHC profiles, trust the
+	 * metadata of the application if any */
+	if(meta != NULL)
+	{
+		if(!rohc_comp_are_meta_ip_hdrs_supported(comp, remain_data, remain_len, meta,
+		                                         fingerprint, pkt_hdrs,
+		                                         &all_ip_hdrs_len, &all_ipv6_exts_len))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported IP headers or inconsistent metadata");
+			goto unsupported_ip_hdr;
+		}
+	}
+	else if(!rohc_comp_are_ip_hdrs_supported(comp, remain_data, remain_len,
+	                                         fingerprint, pkt_hdrs,
+	                                         &all_ip_hdrs_len, &all_ipv6_exts_len))
 	{
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "unsupported IP headers");
@@ -1161,6 +1365,221 @@ unsupported_ip_hdr:
 }
 
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(ROHC_COMP_META_MAX_IP_HDRS == ROHC_MAX_IP_HDRS,
+               "packet metadata shall describe as many IP headers as supported");
+#endif
+
+/**
+ * @brief Are the IP headers described by the application metadata supported?
+ *
+ * The IP headers are not parsed, the metadata given by the application is
+ * trusted instead. Only the cheap checks are done: the ones that ensure that
+ * the metadata matches the packet and the ones on the fields that the ROHC
+ * profiles infer. The IPv4 checksums are not verified. The IPv6 extension
+ * headers are parsed only if the metadata says that there are some.
+ *
+ * @param comp                    The ROHC compressor to compress the packet with
+ * @param packet                  The packet to search the best compression profile
+ *                                for
+ * @param packet_len              The length (in bytes) of the uncompressed packet
+ * @param meta                    The metadata given by the application for the
+ *                                packet
+ * @param[out] fingerprint        The fingerprint computed on the packet to later
+ *                                help finding the best compression context
+ * @param[out] pkt_hdrs           The information collected about the packet
+ *                                headers, may be used later during the detection
+ *                                of changes with the compression context, thus
+ *                                avoiding another packet parsing
+ * @param[out] all_ip_hdrs_len    The length (in bytes) of the IP headers
+ * @param[out] all_ipv6_exts_len  The length (in bytes) of the IP extension
+ *                                headers
+ * @return                        true if the IP headers are supported and match
+ *                                the metadata, false otherwise
+ */
+static bool rohc_comp_are_meta_ip_hdrs_supported(const struct rohc_comp *const comp,
+                                                 const uint8_t *const packet,
+                                                 const size_t packet_len,
+                                                 const rohc_comp_pkt_meta_t *const meta,
+                                                 struct rohc_fingerprint *const fingerprint,
+                                                 struct rohc_pkt_hdrs *const pkt_hdrs,
+                                                 size_t *const all_ip_hdrs_len,
+                                                 size_t *const all_ipv6_exts_len)
+{
+	bool are_ip_hdrs_supported = false;
+	size_t ip_hdrs_nr;
+
+	if(meta->ip_hdrs_nr == 0 || meta->ip_hdrs_nr > ROHC_MAX_IP_HDRS)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "metadata gives %u IP headers while 1 to %u are supported",
+		           meta->ip_hdrs_nr, ROHC_MAX_IP_HDRS);
+		goto unsupported_ip_hdr;
+	}
+	if(meta->ip_offsets[0] != 0)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "metadata gives offset %u for the first IP header while the "
+		           "packet shall start with it", meta->ip_offsets[0]);
+		goto unsupported_ip_hdr;
+	}
+
+	for(ip_hdrs_nr = 0; ip_hdrs_nr < meta->ip_hdrs_nr; ip_hdrs_nr++)
+	{
+		struct rohc_pkt_ip_hdr *const pkt_ip_hdr = &(pkt_hdrs->ip_hdrs[ip_hdrs_nr]);
+		struct rohc_fingerprint_ip *const ip_fingerprint =
+			&(fingerprint->base.ip_hdrs[ip_hdrs_nr]);
+		const bool is_innermost = ((ip_hdrs_nr + 1) == meta->ip_hdrs_nr);
+		const size_t ip_offset = meta->ip_offsets[ip_hdrs_nr];
+		const size_t next_offset =
+			(is_innermost ? meta->l4_offset : meta->ip_offsets[ip_hdrs_nr + 1]);
+		const uint8_t version = meta->ip_versions[ip_hdrs_nr];
+		uint8_t next_proto;
+
+		/* the IP header shall be located in the packet before the next header */
+		if(ip_offset >= next_offset || next_offset > packet_len)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "metadata gives out-of-packet offsets %zu and %zu for IP "
+			           "header #%zu and its next header", ip_offset, next_offset,
+			           ip_hdrs_nr + 1);
+			goto unsupported_ip_hdr;
+		}
+		pkt_ip_hdr->data = packet + ip_offset;
+		pkt_ip_hdr->tot_len = packet_len - ip_offset;
+		pkt_ip_hdr->version = version;
+
+		if(version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = pkt_ip_hdr->ipv4;
+
+			/* IPv4 options are not supported by the TCP profile */
+			if((next_offset - ip_offset) != sizeof(struct ipv4_hdr) ||
+			   ipv4->version != IPV4 ||
+			   ipv4->ihl != (sizeof(struct ipv4_hdr) / sizeof(uint32_t)))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IP packet #%zu is not supported: IP options are not "
+				           "accepted or metadata is wrong", ip_hdrs_nr + 1);
+				goto unsupported_ip_hdr;
+			}
+
+			/* IPv4 total length shall be correct and the IPv4 header shall not
+			 * be a fragment */
+			if(rohc_ntoh16(ipv4->tot_len) != pkt_ip_hdr->tot_len ||
+			   ipv4_is_fragment(ipv4))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IP packet #%zu is not supported: total length is "
+				           "wrong or header is fragmented", ip_hdrs_nr + 1);
+				goto unsupported_ip_hdr;
+			}
+
+			next_proto = ipv4->protocol;
+			pkt_ip_hdr->tos_tc = ipv4->tos;
+			pkt_ip_hdr->ttl_hl = ipv4->ttl;
+			pkt_ip_hdr->exts_len = 0;
+			pkt_ip_hdr->exts_nr = 0;
+			ip_fingerprint->saddr.u32[0] = ipv4->saddr;
+			ip_fingerprint->daddr.u32[0] = ipv4->daddr;
+		}
+		else if(version == IPV6)
+		{
+			const struct ipv6_hdr *const ipv6 = pkt_ip_hdr->ipv6;
+			size_t exts_len;
+
+			if((next_offset - ip_offset) < sizeof(struct ipv6_hdr) ||
+			   ipv6->version != IPV6)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IP packet #%zu is not supported: metadata is wrong",
+				           ip_hdrs_nr + 1);
+				goto unsupported_ip_hdr;
+			}
+
+			/* payload length shall be correct */
+			if(rohc_ntoh16(ipv6->plen) != (pkt_ip_hdr->tot_len - sizeof(struct ipv6_hdr)))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IP packet #%zu is not supported: payload length is "
+				           "wrong", ip_hdrs_nr + 1);
+				goto unsupported_ip_hdr;
+			}
+
+			/* parse the IPv6 extension headers only if there are some */
+			next_proto = ipv6->nh;
+			exts_len = next_offset - ip_offset - sizeof(struct ipv6_hdr);
+			if(exts_len == 0)
+			{
+				if(rohc_is_ipv6_opt(next_proto))
+				{
+					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+					           "IP packet #%zu is not supported: metadata omits "
+					           "IPv6 extension headers", ip_hdrs_nr + 1);
+					goto unsupported_ip_hdr;
+				}
+				pkt_ip_hdr->exts_len = 0;
+				pkt_ip_hdr->exts_nr = 0;
+			}
+			else if(!rohc_comp_ipv6_exts_are_acceptable(comp, &next_proto,
+			                                            pkt_ip_hdr->data +
+			                                            sizeof(struct ipv6_hdr),
+			                                            exts_len, pkt_ip_hdr) ||
+			        pkt_ip_hdr->exts_len != exts_len)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IP packet #%zu is not supported: malformed or incompatible "
+				           "IPv6 extension headers detected", ip_hdrs_nr + 1);
+				goto unsupported_ip_hdr;
+			}
+			(*all_ipv6_exts_len) += exts_len;
+
+			pkt_ip_hdr->tos_tc = ipv6_get_tc(ipv6);
+			pkt_ip_hdr->ttl_hl = ipv6->hl;
+			memcpy(&ip_fingerprint->saddr.u8, &ipv6->saddr, sizeof(struct ipv6_addr));
+			memcpy(&ip_fingerprint->daddr.u8, &ipv6->daddr, sizeof(struct ipv6_addr));
+			ip_fingerprint->flow_label = ipv6_get_flow_label(ipv6);
+		}
+		else
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "metadata gives unsupported version %u for header #%zu",
+			           version, ip_hdrs_nr + 1);
+			goto unsupported_ip_hdr;
+		}
+
+		/* the next header shall be the one given by the metadata */
+		if((is_innermost && next_proto != meta->l4_proto) ||
+		   (!is_innermost && !rohc_is_tunneling(next_proto)))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "IP packet #%zu is not supported: next protocol %u does not "
+			           "match metadata", ip_hdrs_nr + 1, next_proto);
+			goto unsupported_ip_hdr;
+		}
+
+		ip_fingerprint->version = version;
+		ip_fingerprint->next_proto = next_proto;
+		pkt_ip_hdr->next_proto = next_proto;
+		fingerprint->base.ip_hdrs_nr++;
+	}
+
+	/* remember the number of IP headers and the innermost IP header */
+	pkt_hdrs->ip_hdrs_nr = ip_hdrs_nr;
+	pkt_hdrs->innermost_ip_hdr = &(pkt_hdrs->ip_hdrs[ip_hdrs_nr - 1]);
+
+	/* IP headers are supported */
+	(*all_ip_hdrs_len) = meta->l4_offset;
+	are_ip_hdrs_supported = true;
+
+unsupported_ip_hdr:
+	return are_ip_hdrs_supported;
+}
+
+
 /**
  * @brief Is the given TCP header supported?
  *
@@ -1371,64 +1790,434 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
                              const struct rohc_buf uncomp_packet,
                              struct rohc_buf *const rohc_packet)
 {
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
+	struct rohc_comp_pkt pkt;
 
-	const struct rohc_comp_profile *profile;
-	rohc_profile_t profile_id;
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_check_bufs(comp, &uncomp_packet, rohc_packet))
+	{
+		goto error;
+	}
 
-	struct rohc_fingerprint fingerprint;
-	struct rohc_pkt_hdrs pkt_hdrs;
+	rohc_comp_drain_feedbacks(comp);
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	return rohc_comp_compress_pkt(comp, &uncomp_packet, NULL, &pkt, rohc_packet, true);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the headers of the given packet, leave its payload in place
+ *
+ * Compress the headers of the given uncompressed packet into a ROHC header,
+ * as \ref rohc_compress4 would do, but do not copy the payload behind the
+ * ROHC header. The payload is referenced in the uncompressed packet instead:
+ * the full ROHC packet is made of the \e rohc_hdr bytes followed by the
+ * \e payload_len bytes located at \e payload_offset in \e uncomp_packet.
+ *
+ * Only the ROHC header is written in \e rohc_hdr, so a small buffer is
+ * enough, for example the headroom of the buffer that will be sent. The two
+ * parts of the ROHC packet may then be given as two I/O vectors to a network
+ * interface with scatter-gather capabilities, without the payload being
+ * touched by the library.
+ *
+ * Notes:
+ *   \li ROHC segmentation:
+ *       The payload is never copied, so ROHC segmentation is never used by
+ *       this function. If the ROHC packet is too large for the link, use
+ *       \ref rohc_compress4 instead.
+ *   \li Uncompressed profile:
+ *       The ROHC header of a Normal packet includes the first byte of the
+ *       uncompressed packet, so the payload starts at the second byte.
+ *
+ * @param comp                 The ROHC compressor
+ * @param uncomp_packet        The uncompressed packet to compress
+ * @param[out] rohc_hdr        The resulting ROHC header
+ * @param[out] payload_offset  The offset of the payload in \e uncomp_packet
+ * @param[out] payload_len     The length of the payload in \e uncomp_packet
+ * @return                     Possible return values:
+ *                             \li \ref ROHC_STATUS_OK if a ROHC header is
+ *                                 returned
+ *                             \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                                 output buffer is too small for the ROHC
+ *                                 header
+ *                             \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_hdr(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                struct rohc_buf *const rohc_hdr,
+                                size_t *const payload_offset,
+                                size_t *const payload_len)
+{
+	struct rohc_comp_pkt pkt;
+	rohc_status_t status;
 
 	/* check inputs validity */
 	if(comp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(uncomp_packet))
+	if(!rohc_comp_check_bufs(comp, &uncomp_packet, rohc_hdr))
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
 		goto error;
 	}
-	if(rohc_buf_is_empty(uncomp_packet))
+	if(payload_offset == NULL || payload_len == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is empty");
+		             "given payload_offset or payload_len is NULL");
 		goto error;
 	}
-	if(rohc_packet == NULL)
+
+	rohc_comp_drain_feedbacks(comp);
+
+	status = rohc_comp_compress_pkt(comp, &uncomp_packet, NULL, &pkt, rohc_hdr, false);
+	if(status == ROHC_STATUS_OK)
+	{
+		*payload_offset = pkt.pkt_hdrs.all_hdrs_len;
+		*payload_len = pkt.pkt_hdrs.payload_len;
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet classified by the application
+ *
+ * Compress the given uncompressed packet into a ROHC packet, as
+ * \ref rohc_compress4 would do, but trust the metadata given by the
+ * application about the packet headers instead of parsing them: the offsets
+ * and the versions of the IP headers, the offset and the protocol of the
+ * layer-4 header, and optionally a hash of the flow.
+ *
+ * Only cheap sanity checks are done on the IP headers: the ones that ensure
+ * that the metadata matches the packet and the ones on the fields that the
+ * ROHC profiles infer, like the lengths and the fragmentation. The IPv4
+ * header checksums are not verified, so the application shall give packets
+ * that were already validated, by the NIC for example. The layer-4 header is
+ * handled as \ref rohc_compress4 does, because the TCP profile requires the
+ * parsed TCP options and because the RTP detection callback is called.
+ *
+ * Notes:
+ *   \li Flow hash:
+ *       If \e meta->has_flow_hash is set, the given flow hash replaces the
+ *       hash of the raw packet bytes as the key of the cache of the last
+ *       contexts used. It is only a hint: the context found in the cache is
+ *       always checked against the packet headers, and the context is
+ *       searched for with the packet headers otherwise. Packets of one flow
+ *       may thus be compressed with this function and with
+ *       \ref rohc_compress4 in any order, they share the same context.
+ *   \li Invalid metadata:
+ *       If the metadata does not match the packet, \ref ROHC_STATUS_ERROR is
+ *       returned unless the Uncompressed profile is enabled.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param meta              The metadata of the uncompressed packet
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  The same values as \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
+ */
+rohc_status_t rohc_compress_meta(struct rohc_comp *const comp,
+                                 const struct rohc_buf uncomp_packet,
+                                 const rohc_comp_pkt_meta_t *const meta,
+                                 struct rohc_buf *const rohc_packet)
+{
+	struct rohc_comp_pkt pkt;
+
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is NULL");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*rohc_packet))
+	if(!rohc_comp_check_bufs(comp, &uncomp_packet, rohc_packet))
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*rohc_packet))
+	if(meta == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is not empty");
+		             "given meta is NULL");
 		goto error;
 	}
 
-	/* print uncompressed bytes */
-	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	rohc_comp_drain_feedbacks(comp);
+
+	return rohc_comp_compress_pkt(comp, &uncomp_packet, meta, &pkt, rohc_packet, true);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress a burst of packets
+ *
+ * Compress the given uncompressed packets one after the other, as
+ * \ref rohc_compress4 would do, but share the validation of parameters among
+ * the packets of the burst. While one packet is being compressed, the
+ * contexts of the next packets are prefetched from the cache of the latest
+ * flows, or the headers of the next packets are parsed and the hash table
+ * slots of their contexts are prefetched. Successive packets of the same
+ * flow are checked against their context without being classified again.
+ *
+ * The compression status of every packet is returned in \e statuses, with the
+ * same values as \ref rohc_compress4.
+ *
+ * Notes:
+ *   \li ROHC segmentation:
+ *       The burst stops after the first packet that requires ROHC segmentation,
+ *       so that the ROHC segments may be retrieved with
+ *       \ref rohc_comp_get_segment2 before the remaining packets are
+ *       compressed with another call.
+ *
+ * @param comp               The ROHC compressor
+ * @param uncomp_packets     The uncompressed packets to compress
+ * @param[out] rohc_packets  The resulting compressed ROHC packets
+ * @param[out] statuses      The compression status of every packet
+ * @param packets_nr         The number of packets in the burst, at least one
+ * @return                   The number of packets handled, their status is
+ *                           set in \e statuses ; 0 if one parameter is
+ *                           invalid, an empty burst being invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
+ */
+size_t rohc_compress_burst(struct rohc_comp *const comp,
+                           const struct rohc_buf *const uncomp_packets,
+                           struct rohc_buf *const rohc_packets,
+                           rohc_status_t *const statuses,
+                           const size_t packets_nr)
+{
+	struct rohc_comp_pkt *pkts;
+	bool pkts_ok[ROHC_COMP_BURST_STAGES];
+	size_t i;
+
+	/* check inputs validity */
+	if(comp == NULL)
 	{
-		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
-		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
-		                 "uncompressed data, max 100 bytes", uncomp_packet);
+		goto error;
+	}
+	if(uncomp_packets == NULL || rohc_packets == NULL || statuses == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packets, rohc_packets or statuses is NULL");
+		goto error;
 	}
+	if(packets_nr == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given burst is empty");
+		goto error;
+	}
+	pkts = comp->burst_pkts;
+
+	rohc_comp_drain_feedbacks(comp);
+
+	/* parse the first packets of the burst in advance, unless their contexts
+	 * are probably in the flow cache */
+	for(i = 0; i < packets_nr && i < (ROHC_COMP_BURST_STAGES - 1); i++)
+	{
+		pkts_ok[i] = rohc_comp_check_bufs(comp, &uncomp_packets[i], &rohc_packets[i]);
+		if(pkts_ok[i] &&
+		   !rohc_comp_flow_cache_probe(comp, &uncomp_packets[i], NULL, &pkts[i]))
+		{
+			pkts_ok[i] = rohc_comp_classify(comp, &uncomp_packets[i], NULL, &pkts[i]);
+			if(pkts_ok[i])
+			{
+				rohc_comp_hash_pkt(comp, &pkts[i]);
+			}
+		}
+	}
+
+	for(i = 0; i < packets_nr; i++)
+	{
+		const struct rohc_buf *const uncomp_packet = &uncomp_packets[i];
+		struct rohc_comp_pkt *const pkt = &pkts[i % ROHC_COMP_BURST_STAGES];
+		struct rohc_comp_ctxt *c;
+
+		/* prefetch the context of one next packet from the flow cache, or parse
+		 * its headers and prefetch the hash table slots of its context, so that
+		 * they are in cache when the packet is compressed two packets later */
+		if((i + ROHC_COMP_BURST_STAGES - 1) < packets_nr)
+		{
+			const size_t j = i + ROHC_COMP_BURST_STAGES - 1;
+			struct rohc_comp_pkt *const next_pkt = &pkts[j % ROHC_COMP_BURST_STAGES];
+			bool *const next_pkt_ok = &pkts_ok[j % ROHC_COMP_BURST_STAGES];
+
+			*next_pkt_ok = rohc_comp_check_bufs(comp, &uncomp_packets[j], &rohc_packets[j]);
+			if((*next_pkt_ok) &&
+			   !rohc_comp_flow_cache_probe(comp, &uncomp_packets[j], NULL, next_pkt))
+			{
+				*next_pkt_ok = rohc_comp_classify(comp, &uncomp_packets[j], NULL, next_pkt);
+				if(*next_pkt_ok)
+				{
+					rohc_comp_hash_pkt(comp, next_pkt);
+					hashtable_prefetch(&comp->contexts_by_fingerprint,
+					                   next_pkt->fingerprint_hash);
+				}
+			}
+			if((j + 1) < packets_nr)
+			{
+				__builtin_prefetch(rohc_buf_data(uncomp_packets[j + 1]));
+			}
+		}
+
+		if(!pkts_ok[i % ROHC_COMP_BURST_STAGES])
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+			continue;
+		}
+
+		/* print uncompressed bytes */
+		if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0 &&
+		   rohc_trace_is_enabled(comp, ROHC_TRACE_DEBUG))
+		{
+			rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+			                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+			                 "uncompressed data, max 100 bytes", *uncomp_packet);
+		}
+
+		/* packets of the same flow often come in a row: search for the context
+		 * in the flow cache before classifying the packet and searching the
+		 * hash table */
+		c = rohc_comp_flow_cache_get(comp, uncomp_packet, NULL, pkt);
+		if(c == NULL)
+		{
+			if(!pkt->is_classified)
+			{
+				if(!rohc_comp_classify(comp, uncomp_packet, NULL, pkt))
+				{
+					statuses[i] = ROHC_STATUS_ERROR;
+					continue;
+				}
+				rohc_comp_hash_pkt(comp, pkt);
+			}
+			c = rohc_comp_find_ctxt(comp, pkt->profile, uncomp_packet,
+			                        &pkt->fingerprint, pkt->fingerprint_hash,
+			                        &pkt->pkt_hdrs);
+			if(c == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to find a matching context or to create a new "
+				             "context");
+				statuses[i] = ROHC_STATUS_ERROR;
+				continue;
+			}
+			rohc_comp_flow_cache_put(comp, pkt, c);
+		}
+
+		/* compress the packet with the context */
+		statuses[i] = rohc_comp_encode(comp, c, uncomp_packet, pkt, &rohc_packets[i],
+		                               true);
+		if(statuses[i] == ROHC_STATUS_SEGMENT)
+		{
+			/* give the application a chance to retrieve the ROHC segments */
+			i++;
+			break;
+		}
+	}
+
+	return i;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Check the validity of the buffers given for one packet to compress
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param rohc_packet    The buffer for the compressed ROHC packet
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_comp_check_bufs(const struct rohc_comp *const comp,
+                                 const struct rohc_buf *const uncomp_packet,
+                                 const struct rohc_buf *const rohc_packet)
+{
+	if(rohc_buf_is_malformed(*uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(*uncomp_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is empty");
+		goto error;
+	}
+	if(rohc_packet == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*rohc_packet))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is not empty");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Find the best profile for one uncompressed packet
+ *
+ * Parse the headers of the packet, find the best profile to compress them,
+ * and compute the fingerprint of the packet.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param meta           The metadata given by the application for the packet,
+ *                       NULL to parse the packet headers
+ * @param[out] pkt       The information collected about the packet
+ * @return               true if a profile was found, false otherwise
+ */
+static bool rohc_comp_classify(const struct rohc_comp *const comp,
+                               const struct rohc_buf *const uncomp_packet,
+                               const rohc_comp_pkt_meta_t *const meta,
+                               struct rohc_comp_pkt *const pkt)
+{
+	rohc_profile_t profile_id;
+
+	pkt->is_classified = true;
 
 	/* what ROHC profile fits the uncompressed packet best? */
-	profile_id = rohc_comp_get_profile(comp, &uncomp_packet, &fingerprint, &pkt_hdrs);
+	profile_id = rohc_comp_get_profile(comp, uncomp_packet, meta, &pkt->fingerprint,
+	                                   &pkt->pkt_hdrs);
 	if(profile_id == ROHC_PROFILE_MAX)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1441,8 +2230,8 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	{
 		const uint8_t profile_major = (profile_id >> 8) & 0xff;
 		const uint8_t profile_minor = profile_id & 0xff;
-		profile = rohc_comp_profiles[profile_major][profile_minor];
-		if(profile == NULL)
+		pkt->profile = rohc_comp_profiles[profile_major][profile_minor];
+		if(pkt->profile == NULL)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "profile '%s' (0x%04x) is not implemented yet",
@@ -1451,18 +2240,629 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		}
 	}
 
-	/* find the best profile context for the packet */
-	c = rohc_comp_find_ctxt(comp, profile, &uncomp_packet, &fingerprint, &pkt_hdrs);
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Hash the fingerprint of one uncompressed packet
+ *
+ * The hash is used to search for the context of the packet in the hash table
+ * of contexts. There is only one context for the Uncompressed profile.
+ *
+ * @param comp         The ROHC compressor
+ * @param[in,out] pkt  The information collected about the packet
+ */
+static void rohc_comp_hash_pkt(const struct rohc_comp *const comp,
+                               struct rohc_comp_pkt *const pkt)
+{
+	if(pkt->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		pkt->fingerprint_hash = 0;
+	}
+	else
+	{
+		pkt->fingerprint_hash =
+			hashtable_hash(&comp->contexts_by_fingerprint, &pkt->fingerprint,
+			               rohc_fingerprint_len(&pkt->fingerprint));
+	}
+}
+
+
+/**
+ * @brief Compute the key of the flow of the given packet from its raw bytes
+ *
+ * The key is a cheap hash of the version, the addresses and the protocol of
+ * the outer IP header, and of the 4 first bytes of the UDP, TCP or ESP header
+ * if it directly follows the outer IP header: the ports or the SPI. All the
+ * packets of one flow get the same key.
+ *
+ * The headers are read directly from the packet, they are not validated:
+ * the key only helps to find the context of the packet, the packet shall
+ * still be checked against the context. No compressor state is
+ * used, so the key may be computed by any thread.
+ *
+ * @param packet  The uncompressed packet
+ * @param seed    The seed of the hash
+ * @return        The key of the flow of the packet
+ */
+static uint32_t rohc_comp_flow_key(const struct rohc_buf *const packet,
+                                   const uint32_t seed)
+{
+	const uint8_t *const data = rohc_buf_data(*packet);
+	uint32_t key = seed;
+	size_t addrs_offset;
+	size_t addrs_len;
+	size_t l4_offset;
+	uint8_t proto;
+	size_t i;
+
+	if(packet->len >= 20 && (data[0] >> 4) == 4)
+	{
+		/* IPv4: the addresses, then the ports if the packet is not a fragment */
+		addrs_offset = 12;
+		addrs_len = 8;
+		proto = data[9];
+		l4_offset = (data[0] & 0x0f) * 4U;
+		if((data[6] & 0x3f) != 0 || data[7] != 0)
+		{
+			l4_offset = packet->len;
+		}
+	}
+	else if(packet->len >= 40 && (data[0] >> 4) == 6)
+	{
+		/* IPv6: the addresses, then the ports if there is no extension header */
+		addrs_offset = 8;
+		addrs_len = 32;
+		proto = data[6];
+		l4_offset = 40;
+	}
+	else
+	{
+		/* not an IP packet: all of them share the same key */
+		return key;
+	}
+
+	key ^= ((((uint32_t) data[0]) >> 4) << 8) | proto;
+	for(i = 0; i < addrs_len; i += sizeof(uint32_t))
+	{
+		key = rohc_comp_flow_key_mix(key, data + addrs_offset + i);
+	}
+	if((proto == ROHC_IPPROTO_UDP || proto == ROHC_IPPROTO_TCP ||
+	    proto == ROHC_IPPROTO_ESP) && (l4_offset + sizeof(uint32_t)) <= packet->len)
+	{
+		key = rohc_comp_flow_key_mix(key, data + l4_offset);
+	}
+
+	/* mix the bits of the key, so that its lower bits index the flow cache */
+	key ^= key >> 16;
+	key *= 0x85ebca6bU;
+	key ^= key >> 13;
+
+	return key;
+}
+
+
+/**
+ * @brief Mix 4 bytes of a packet into the key of its flow
+ *
+ * @param key   The key of the flow computed so far
+ * @param data  The 4 bytes to mix into the key
+ * @return      The new key of the flow
+ */
+static inline uint32_t rohc_comp_flow_key_mix(const uint32_t key,
+                                              const uint8_t *const data)
+{
+	uint32_t word;
+
+	memcpy(&word, data, sizeof(uint32_t));
+	return (key ^ word) * 0x9e3779b1U;
+}
+
+
+/**
+ * @brief Compute the key of the flow of one packet and probe the flow cache
+ *
+ * The key is computed from the raw bytes of the packet, or the flow hash
+ * given by the application is taken instead. If the flow cache holds a
+ * context for the key, the context is prefetched, so that it is already in
+ * cache when the packet is checked against it.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param meta           The metadata given by the application for the packet,
+ *                       NULL if none
+ * @param[out] pkt       The information collected about the packet
+ * @return               true if the flow cache probably holds the context of
+ *                       the packet, false if the packet shall be classified
+ */
+static bool rohc_comp_flow_cache_probe(const struct rohc_comp *const comp,
+                                       const struct rohc_buf *const uncomp_packet,
+                                       const rohc_comp_pkt_meta_t *const meta,
+                                       struct rohc_comp_pkt *const pkt)
+{
+	const struct rohc_comp_flow_cache_entry *entry;
+
+	pkt->is_classified = false;
+	if(meta != NULL && meta->has_flow_hash)
+	{
+		pkt->flow_key = meta->flow_hash;
+	}
+	else
+	{
+		pkt->flow_key = rohc_comp_flow_key(uncomp_packet, 0);
+	}
+
+	entry = &(comp->flow_cache[pkt->flow_key & (ROHC_COMP_FLOW_CACHE_SIZE - 1)]);
+	if(entry->flow_key != pkt->flow_key || entry->ctxt == NULL)
+	{
+		return false;
+	}
+	__builtin_prefetch(entry->ctxt);
+
+	return true;
+}
+
+
+/**
+ * @brief Search for the context of the given packet in the flow cache
+ *
+ * Real traffic is bursty: successive packets often belong to the same flow.
+ * The flow cache remembers the contexts that compressed the latest packets,
+ * indexed by the key of their flow, and the layout of their headers. The
+ * packet is not classified: its headers are collected at the offsets of the
+ * layout, and their static fields are checked against the context. The
+ * context is then found without building nor hashing the packet fingerprint,
+ * and without searching the hash table of contexts.
+ *
+ * Stale entries of the cache and flows that share the same key are harmless:
+ * the context is not found if the packet does not match it, the packet is
+ * then classified. The context is not found if Context Replication is in
+ * action because the base context shall be checked again. The use of the
+ * context found is recorded.
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param meta           The metadata given by the application for the packet,
+ *                       NULL if none
+ * @param[in,out] pkt    The information collected about the packet: the key
+ *                       of its flow as input, its profile and its headers as
+ *                       output if the context is found
+ * @return               The context of the packet, NULL if not found in the
+ *                       cache
+ */
+static struct rohc_comp_ctxt *
+	rohc_comp_flow_cache_get(struct rohc_comp *const comp,
+	                         const struct rohc_buf *const uncomp_packet,
+	                         const rohc_comp_pkt_meta_t *const meta,
+	                         struct rohc_comp_pkt *const pkt)
+{
+	const struct rohc_comp_flow_cache_entry *entry;
+	struct rohc_comp_ctxt *ctxt;
+
+	comp->flow_cache_lookups_nr++;
+
+	entry = &(comp->flow_cache[pkt->flow_key & (ROHC_COMP_FLOW_CACHE_SIZE - 1)]);
+	if(entry->flow_key != pkt->flow_key)
+	{
+		return NULL;
+	}
+	ctxt = entry->ctxt;
+	if(ctxt == NULL || !ctxt->used ||
+	   (ctxt->do_ctxt_replication && ctxt->state == ROHC_COMP_STATE_CR) ||
+	   !rohc_comp_flow_cache_check(comp, uncomp_packet, entry, meta, &pkt->pkt_hdrs))
+	{
+		return NULL;
+	}
+	pkt->profile = ctxt->profile;
+	comp->flow_cache_hits_nr++;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "re-using context CID %u found in the flow cache", ctxt->cid);
+	ctxt->latest_used = uncomp_packet->time.sec;
+	if(comp->ctxts_lru_newest != ctxt)
+	{
+		c_lru_unlink(comp, ctxt);
+		c_lru_append(comp, ctxt);
+	}
+
+	return ctxt;
+}
+
+
+/**
+ * @brief Check that a packet belongs to the flow of a context of the flow cache
+ *
+ * The headers of the packet are collected at the offsets given by the layout
+ * of the cache entry, the way \ref rohc_comp_are_meta_ip_hdrs_supported does
+ * with the metadata of the application. If the application gave metadata,
+ * its layout is checked instead and, as with metadata, the IPv4 checksums
+ * are not verified. The static fields of the headers are compared
+ * with the fingerprint of the context, and the fields that the profile of
+ * the context infers are checked. The packet shall be classified with the
+ * profile of the context, so the IP-only profiles are accepted only if no
+ * transport header may be compressed, and the IP/UDP profiles only if the
+ * packet is not an RTP packet that an IP/UDP/RTP profile could compress.
+ *
+ * @param comp           The ROHC compressor
+ * @param packet         The uncompressed packet to compress
+ * @param entry          The entry of the flow cache for the packet
+ * @param meta           The metadata given by the application for the packet,
+ *                       NULL if none
+ * @param[out] pkt_hdrs  The information collected about the packet headers
+ * @return               true if the packet belongs to the flow of the context,
+ *                       false if it shall be classified
+ */
+static bool rohc_comp_flow_cache_check(const struct rohc_comp *const comp,
+                                       const struct rohc_buf *const packet,
+                                       const struct rohc_comp_flow_cache_entry *const entry,
+                                       const rohc_comp_pkt_meta_t *const meta,
+                                       struct rohc_pkt_hdrs *const pkt_hdrs)
+{
+	const struct rohc_fingerprint *const fingerprint = &(entry->ctxt->fingerprint);
+	const rohc_profile_t profile_id = entry->ctxt->profile->id;
+	const rohc_comp_pkt_meta_t *const layout = (meta != NULL ? meta : &(entry->layout));
+	const uint8_t *const data = rohc_buf_data(*packet);
+	const size_t l4_offset = layout->l4_offset;
+	const uint8_t *l4_data;
+	size_t l4_len;
+	size_t hdrs_len;
+	size_t i;
+
+	if(packet->len > UINT16_MAX || l4_offset > packet->len ||
+	   layout->ip_hdrs_nr != fingerprint->base.ip_hdrs_nr || layout->ip_offsets[0] != 0)
+	{
+		goto mismatch;
+	}
+	pkt_hdrs->all_hdrs = data;
+
+	/* the IP headers, at the offsets of the layout */
+	for(i = 0; i < layout->ip_hdrs_nr; i++)
+	{
+		const struct rohc_fingerprint_ip *const ip_fingerprint =
+			&(fingerprint->base.ip_hdrs[i]);
+		struct rohc_pkt_ip_hdr *const pkt_ip_hdr = &(pkt_hdrs->ip_hdrs[i]);
+		const bool is_innermost = ((i + 1) == layout->ip_hdrs_nr);
+		const size_t ip_offset = layout->ip_offsets[i];
+		const size_t next_offset = (is_innermost ? l4_offset : layout->ip_offsets[i + 1]);
+		uint8_t next_proto;
+
+		if(layout->ip_versions[i] != ip_fingerprint->version ||
+		   ip_offset >= next_offset || (data[ip_offset] >> 4) != ip_fingerprint->version)
+		{
+			goto mismatch;
+		}
+		pkt_ip_hdr->data = data + ip_offset;
+		pkt_ip_hdr->tot_len = packet->len - ip_offset;
+		pkt_ip_hdr->version = ip_fingerprint->version;
+
+		if(ip_fingerprint->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = pkt_ip_hdr->ipv4;
+
+			if((next_offset - ip_offset) != sizeof(struct ipv4_hdr) ||
+			   ipv4->ihl != (sizeof(struct ipv4_hdr) / sizeof(uint32_t)) ||
+			   rohc_ntoh16(ipv4->tot_len) != pkt_ip_hdr->tot_len ||
+			   ipv4_is_fragment(ipv4) ||
+			   ipv4->saddr != ip_fingerprint->saddr.u32[0] ||
+			   ipv4->daddr != ip_fingerprint->daddr.u32[0])
+			{
+				goto mismatch;
+			}
+			if(meta == NULL && (comp->features & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
+			   ip_fast_csum(pkt_ip_hdr->data, sizeof(struct ipv4_hdr) / sizeof(uint32_t)) != 0)
+			{
+				goto mismatch;
+			}
+			next_proto = ipv4->protocol;
+			pkt_ip_hdr->tos_tc = ipv4->tos;
+			pkt_ip_hdr->ttl_hl = ipv4->ttl;
+			pkt_ip_hdr->exts_len = 0;
+			pkt_ip_hdr->exts_nr = 0;
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = pkt_ip_hdr->ipv6;
+			size_t exts_len;
+
+			if((next_offset - ip_offset) < sizeof(struct ipv6_hdr) ||
+			   rohc_ntoh16(ipv6->plen) != (pkt_ip_hdr->tot_len - sizeof(struct ipv6_hdr)) ||
+			   memcmp(&ipv6->saddr, &ip_fingerprint->saddr, sizeof(struct ipv6_addr)) != 0 ||
+			   memcmp(&ipv6->daddr, &ip_fingerprint->daddr, sizeof(struct ipv6_addr)) != 0 ||
+			   ipv6_get_flow_label(ipv6) != ip_fingerprint->flow_label)
+			{
+				goto mismatch;
+			}
+
+			/* parse the IPv6 extension headers only if there are some */
+			next_proto = ipv6->nh;
+			exts_len = next_offset - ip_offset - sizeof(struct ipv6_hdr);
+			if(exts_len == 0)
+			{
+				if(rohc_is_ipv6_opt(next_proto))
+				{
+					goto mismatch;
+				}
+				pkt_ip_hdr->exts_len = 0;
+				pkt_ip_hdr->exts_nr = 0;
+			}
+			else if(!rohc_comp_ipv6_exts_are_acceptable(comp, &next_proto,
+			                                            pkt_ip_hdr->data +
+			                                            sizeof(struct ipv6_hdr),
+			                                            exts_len, pkt_ip_hdr) ||
+			        pkt_ip_hdr->exts_len != exts_len)
+			{
+				goto mismatch;
+			}
+			pkt_ip_hdr->tos_tc = ipv6_get_tc(ipv6);
+			pkt_ip_hdr->ttl_hl = ipv6->hl;
+		}
+
+		if(next_proto != ip_fingerprint->next_proto ||
+		   (is_innermost && next_proto != layout->l4_proto))
+		{
+			goto mismatch;
+		}
+		pkt_ip_hdr->next_proto = next_proto;
+	}
+	pkt_hdrs->ip_hdrs_nr = layout->ip_hdrs_nr;
+	pkt_hdrs->innermost_ip_hdr = &(pkt_hdrs->ip_hdrs[layout->ip_hdrs_nr - 1]);
+
+	/* the transport header expected by the profile of the context */
+	l4_data = data + l4_offset;
+	l4_len = packet->len - l4_offset;
+	hdrs_len = l4_offset;
+	switch(profile_id)
+	{
+		case ROHCv1_PROFILE_IP:
+		case ROHCv2_PROFILE_IP:
+		{
+			const uint8_t l4_proto = pkt_hdrs->innermost_ip_hdr->next_proto;
+
+			if(l4_proto == ROHC_IPPROTO_TCP || l4_proto == ROHC_IPPROTO_UDP ||
+			   l4_proto == ROHC_IPPROTO_ESP)
+			{
+				goto mismatch;
+			}
+			break;
+		}
+		case ROHCv1_PROFILE_IP_TCP:
+		{
+			size_t tcp_hdr_full_len;
+
+			if(!rohc_comp_is_tcp_hdr_supported(comp, l4_data, l4_len, pkt_hdrs,
+			                                   &tcp_hdr_full_len))
+			{
+				goto mismatch;
+			}
+			pkt_hdrs->tcp = (const struct tcphdr *) l4_data;
+			if(rohc_ntoh16(pkt_hdrs->tcp->src_port) != fingerprint->src_port ||
+			   rohc_ntoh16(pkt_hdrs->tcp->dst_port) != fingerprint->dst_port)
+			{
+				goto mismatch;
+			}
+			hdrs_len += tcp_hdr_full_len;
+			break;
+		}
+		case ROHCv1_PROFILE_IP_UDP:
+		case ROHCv2_PROFILE_IP_UDP:
+		case ROHCv1_PROFILE_IP_UDP_RTP:
+		case ROHCv2_PROFILE_IP_UDP_RTP:
+		{
+			const bool is_rtp_ctxt =
+				(profile_id == ROHCv1_PROFILE_IP_UDP_RTP ||
+				 profile_id == ROHCv2_PROFILE_IP_UDP_RTP);
+
+			if(l4_len < sizeof(struct udphdr))
+			{
+				goto mismatch;
+			}
+			pkt_hdrs->udp = (const struct udphdr *) l4_data;
+			if(rohc_ntoh16(pkt_hdrs->udp->len) != l4_len ||
+			   rohc_ntoh16(pkt_hdrs->udp->source) != fingerprint->src_port ||
+			   rohc_ntoh16(pkt_hdrs->udp->dest) != fingerprint->dst_port)
+			{
+				goto mismatch;
+			}
+			hdrs_len += sizeof(struct udphdr);
+
+			/* an IP/UDP/RTP profile compresses the RTP packets */
+			if(is_rtp_ctxt ||
+			   rohc_comp_profile_enabled_nocheck(comp, ROHCv1_PROFILE_IP_UDP_RTP) ||
+			   rohc_comp_profile_enabled_nocheck(comp, ROHCv2_PROFILE_IP_UDP_RTP))
+			{
+				const bool is_rtp =
+					rohc_comp_is_rtp_hdr_supported(comp, l4_data + sizeof(struct udphdr),
+					                               l4_len - sizeof(struct udphdr),
+					                               pkt_hdrs);
+				if(is_rtp != is_rtp_ctxt)
+				{
+					goto mismatch;
+				}
+			}
+			if(is_rtp_ctxt)
+			{
+				pkt_hdrs->rtp = (const struct rtphdr *) (l4_data + sizeof(struct udphdr));
+				if(rohc_ntoh32(pkt_hdrs->rtp->ssrc) != fingerprint->rtp_ssrc ||
+				   (profile_id == ROHCv2_PROFILE_IP_UDP_RTP &&
+				    pkt_hdrs->rtp->version != 2))
+				{
+					goto mismatch;
+				}
+				hdrs_len += sizeof(struct rtphdr);
+			}
+			break;
+		}
+		case ROHCv1_PROFILE_IP_ESP:
+		case ROHCv2_PROFILE_IP_ESP:
+		{
+			if(l4_len < sizeof(struct esphdr))
+			{
+				goto mismatch;
+			}
+			pkt_hdrs->esp = (const struct esphdr *) l4_data;
+			if(rohc_ntoh32(pkt_hdrs->esp->spi) != fingerprint->esp_spi)
+			{
+				goto mismatch;
+			}
+			hdrs_len += sizeof(struct esphdr);
+			break;
+		}
+		default:
+			goto mismatch;
+	}
+
+	pkt_hdrs->all_hdrs_len = hdrs_len;
+	pkt_hdrs->payload_len = packet->len - hdrs_len;
+	pkt_hdrs->payload = data + hdrs_len;
+
+	return true;
+
+mismatch:
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "packet does not match the context CID %u found in the flow cache",
+	           entry->ctxt->cid);
+	return false;
+}
+
+
+/**
+ * @brief Remember the context of the given packet in the flow cache
+ *
+ * The layout of the packet headers is remembered too, so that the next
+ * packets of the flow are checked against the context at the same offsets.
+ *
+ * @param comp  The ROHC compressor
+ * @param pkt   The information collected about the packet
+ * @param ctxt  The context of the packet
+ */
+static void rohc_comp_flow_cache_put(struct rohc_comp *const comp,
+                                     const struct rohc_comp_pkt *const pkt,
+                                     struct rohc_comp_ctxt *const ctxt)
+{
+	if(pkt->profile->id != ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		const struct rohc_pkt_hdrs *const pkt_hdrs = &(pkt->pkt_hdrs);
+		const struct rohc_pkt_ip_hdr *const innermost = pkt_hdrs->innermost_ip_hdr;
+		struct rohc_comp_flow_cache_entry *const entry =
+			&(comp->flow_cache[pkt->flow_key & (ROHC_COMP_FLOW_CACHE_SIZE - 1)]);
+		size_t i;
+
+		entry->flow_key = pkt->flow_key;
+		entry->ctxt = ctxt;
+		entry->layout.ip_hdrs_nr = pkt_hdrs->ip_hdrs_nr;
+		for(i = 0; i < pkt_hdrs->ip_hdrs_nr; i++)
+		{
+			entry->layout.ip_versions[i] = pkt_hdrs->ip_hdrs[i].version;
+			entry->layout.ip_offsets[i] = pkt_hdrs->ip_hdrs[i].data - pkt_hdrs->all_hdrs;
+		}
+		entry->layout.l4_offset = innermost->data - pkt_hdrs->all_hdrs;
+		if(innermost->version == IPV4)
+		{
+			entry->layout.l4_offset += sizeof(struct ipv4_hdr);
+		}
+		else
+		{
+			entry->layout.l4_offset += sizeof(struct ipv6_hdr) + innermost->exts_len;
+		}
+		entry->layout.l4_proto = innermost->next_proto;
+	}
+}
+
+
+/**
+ * @brief Compress one packet once the parameters were checked
+ *
+ * @param comp               The ROHC compressor
+ * @param uncomp_packet      The uncompressed packet to compress
+ * @param meta               The metadata given by the application for the
+ *                           packet, NULL to parse the packet headers
+ * @param[out] pkt           The information collected about the packet
+ * @param[out] rohc_packet   The resulting compressed ROHC packet
+ * @param copy_payload       Whether to copy the payload behind the ROHC header
+ *                           or to leave it in the uncompressed packet
+ * @return                   The same values as \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_compress_pkt(struct rohc_comp *const comp,
+                                            const struct rohc_buf *const uncomp_packet,
+                                            const rohc_comp_pkt_meta_t *const meta,
+                                            struct rohc_comp_pkt *const pkt,
+                                            struct rohc_buf *const rohc_packet,
+                                            const bool copy_payload)
+{
+	struct rohc_comp_ctxt *c;
+
+	/* print uncompressed bytes */
+	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0 &&
+	   rohc_trace_is_enabled(comp, ROHC_TRACE_DEBUG))
+	{
+		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
+		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
+		                 "uncompressed data, max 100 bytes", *uncomp_packet);
+	}
+
+	/* find the best profile context for the packet: packets of the same flow
+	 * often come in a row, so search in the flow cache first, then classify
+	 * the packet and search the hash table of contexts */
+	rohc_comp_flow_cache_probe(comp, uncomp_packet, meta, pkt);
+	c = rohc_comp_flow_cache_get(comp, uncomp_packet, meta, pkt);
 	if(c == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to find a matching context or to create a new "
-		             "context");
-		goto error;
+		if(!rohc_comp_classify(comp, uncomp_packet, meta, pkt))
+		{
+			goto error;
+		}
+		rohc_comp_hash_pkt(comp, pkt);
+		c = rohc_comp_find_ctxt(comp, pkt->profile, uncomp_packet, &pkt->fingerprint,
+		                        pkt->fingerprint_hash, &pkt->pkt_hdrs);
+		if(c == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to find a matching context or to create a new "
+			             "context");
+			goto error;
+		}
+		rohc_comp_flow_cache_put(comp, pkt, c);
 	}
 
+	/* compress the packet with the context */
+	return rohc_comp_encode(comp, c, uncomp_packet, pkt, rohc_packet, copy_payload);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress one packet with the given context
+ *
+ * @param comp               The ROHC compressor
+ * @param c                  The compression context for the packet
+ * @param uncomp_packet      The uncompressed packet to compress
+ * @param pkt                The information collected about the packet
+ * @param[out] rohc_packet   The resulting compressed ROHC packet
+ * @param copy_payload       Whether to copy the payload behind the ROHC header
+ *                           or to leave it in the uncompressed packet
+ * @return                   The same values as \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_encode(struct rohc_comp *const comp,
+                                      struct rohc_comp_ctxt *const c,
+                                      const struct rohc_buf *const uncomp_packet,
+                                      struct rohc_comp_pkt *const pkt,
+                                      struct rohc_buf *const rohc_packet,
+                                      const bool copy_payload)
+{
+	const rohc_profile_t profile_id = pkt->profile->id;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t rohc_pkt_len;
+	rohc_status_t status;
+
 	/* decide the next state to go */
-	rohc_comp_decide_state(c, uncomp_packet.time);
+	rohc_comp_decide_state(c, uncomp_packet->time);
 
 	/* create the ROHC packet: */
 	rohc_packet->len = 0;
@@ -1470,7 +2870,8 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	/* use profile to compress packet */
 	rohc_comp_debug(c, "compress the packet #%d", comp->num_packets + 1);
 	rohc_hdr_size =
-		c->profile->encode(c, &pkt_hdrs, rohc_buf_data(*rohc_packet),
+		c->profile->encode(c, &pkt->pkt_hdrs, comp->tmp_vars,
+		                   rohc_buf_data(*rohc_packet),
 		                   rohc_buf_avail_len(*rohc_packet),
 		                   &packet_type);
 	if(rohc_hdr_size < 0)
@@ -1485,8 +2886,8 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	if(profile_id == ROHCv1_PROFILE_UNCOMPRESSED &&
 	   packet_type == ROHC_PACKET_NORMAL)
 	{
-		pkt_hdrs.all_hdrs_len++;
-		pkt_hdrs.payload_len--;
+		pkt->pkt_hdrs.all_hdrs_len++;
+		pkt->pkt_hdrs.payload_len--;
 	}
 
 	/* increment the number of packets that were emitted in the current
@@ -1501,9 +2902,22 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	/* the payload starts after the header, skip it */
 	rohc_buf_pull(rohc_packet, rohc_hdr_size);
 
-	/* is packet too large for output buffer? */
-	if(pkt_hdrs.payload_len > rohc_buf_avail_len(*rohc_packet))
+	if(!copy_payload)
 	{
+		/* leave the payload in the uncompressed packet */
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		rohc_pkt_len = rohc_hdr_size + pkt->pkt_hdrs.payload_len;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zu bytes (header = %d, payload = %u), payload "
+		           "not copied", rohc_pkt_len, rohc_hdr_size,
+		           pkt->pkt_hdrs.payload_len);
+
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
+	else if(pkt->pkt_hdrs.payload_len > rohc_buf_avail_len(*rohc_packet))
+	{
+		/* is packet too large for output buffer? */
 		const size_t max_rohc_buf_len =
 			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
 		uint32_t rru_crc;
@@ -1514,20 +2928,20 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		          "try to segment it (input size = %zd, maximum output "
 		          "size = %zd, required output size = %d + %u = %u, "
 		          "MRRU = %zd)", rohc_get_packet_descr(packet_type),
-		          uncomp_packet.len, max_rohc_buf_len, rohc_hdr_size,
-		          pkt_hdrs.payload_len, rohc_hdr_size + pkt_hdrs.payload_len,
+		          uncomp_packet->len, max_rohc_buf_len, rohc_hdr_size,
+		          pkt->pkt_hdrs.payload_len, rohc_hdr_size + pkt->pkt_hdrs.payload_len,
 		          comp->mrru);
 
 		/* in order to be segmented, a ROHC packet shall be <= MRRU
 		 * (remember that MRRU includes the CRC length) */
-		if((pkt_hdrs.payload_len + CRC_FCS32_LEN) > comp->mrru)
+		if((pkt->pkt_hdrs.payload_len + CRC_FCS32_LEN) > comp->mrru)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "%s ROHC packet cannot be segmented: too large (%d + "
 			             "%u + %u = %u bytes) for MRRU (%zu bytes)",
 			             rohc_get_packet_descr(packet_type), rohc_hdr_size,
-			             pkt_hdrs.payload_len, CRC_FCS32_LEN, rohc_hdr_size +
-			             pkt_hdrs.payload_len + CRC_FCS32_LEN, comp->mrru);
+			             pkt->pkt_hdrs.payload_len, CRC_FCS32_LEN, rohc_hdr_size +
+			             pkt->pkt_hdrs.payload_len + CRC_FCS32_LEN, comp->mrru);
 			goto error_free_new_context;
 		}
 		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1555,9 +2969,9 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		comp->rru_len += rohc_hdr_size;
 		/* ROHC payload */
 		memcpy(comp->rru + comp->rru_off + comp->rru_len,
-		       rohc_buf_data_at(uncomp_packet, pkt_hdrs.all_hdrs_len),
-		       pkt_hdrs.payload_len);
-		comp->rru_len += pkt_hdrs.payload_len;
+		       rohc_buf_data_at(*uncomp_packet, pkt->pkt_hdrs.all_hdrs_len),
+		       pkt->pkt_hdrs.payload_len);
+		comp->rru_len += pkt->pkt_hdrs.payload_len;
 		/* compute FCS-32 CRC over header and payload (optional feedbacks and
 		   the CRC field itself are excluded) */
 		rru_crc = crc_calc_fcs32(comp->rru + comp->rru_off, comp->rru_len,
@@ -1572,6 +2986,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* reset the length of the ROHC packet: it shall be 0 for users */
 		rohc_packet->len = 0;
+		rohc_pkt_len = 0;
 
 		/* report to users that segmentation is possible */
 		status = ROHC_STATUS_SEGMENT;
@@ -1580,17 +2995,18 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	{
 		/* copy full payload after ROHC header */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "copy full %u-byte payload", pkt_hdrs.payload_len);
+		           "copy full %u-byte payload", pkt->pkt_hdrs.payload_len);
 		rohc_buf_append(rohc_packet,
-		                rohc_buf_data_at(uncomp_packet, pkt_hdrs.all_hdrs_len),
-		                pkt_hdrs.payload_len);
+		                rohc_buf_data_at(*uncomp_packet, pkt->pkt_hdrs.all_hdrs_len),
+		                pkt->pkt_hdrs.payload_len);
 
 		/* unhide the ROHC header */
 		rohc_buf_push(rohc_packet, rohc_hdr_size);
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "ROHC size = %zd bytes (header = %d, payload = %u), output "
 		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
-		           pkt_hdrs.payload_len, rohc_buf_avail_len(*rohc_packet));
+		           pkt->pkt_hdrs.payload_len, rohc_buf_avail_len(*rohc_packet));
+		rohc_pkt_len = rohc_packet->len;
 
 		/* report to user that compression was successful */
 		status = ROHC_STATUS_OK;
@@ -1600,21 +3016,21 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	 *  - compressor statistics
 	 *  - context statistics (global + last packet + last 16 packets) */
 	comp->num_packets++;
-	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
+	comp->total_uncompressed_size += uncomp_packet->len;
+	comp->total_compressed_size += rohc_pkt_len;
 	comp->last_context = c;
 
 	c->packet_type = packet_type;
 
-	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
-	c->header_uncompressed_size += pkt_hdrs.all_hdrs_len;
+	c->total_uncompressed_size += uncomp_packet->len;
+	c->total_compressed_size += rohc_pkt_len;
+	c->header_uncompressed_size += pkt->pkt_hdrs.all_hdrs_len;
 	c->header_compressed_size += rohc_hdr_size;
 	c->num_sent_packets++;
 
-	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
-	c->header_last_uncompressed_size = pkt_hdrs.all_hdrs_len;
+	c->total_last_uncompressed_size = uncomp_packet->len;
+	c->total_last_compressed_size = rohc_pkt_len;
+	c->header_last_uncompressed_size = pkt->pkt_hdrs.all_hdrs_len;
 	c->header_last_compressed_size = rohc_hdr_size;
 
 	/* compression is successful */
@@ -1624,25 +3040,8 @@ error_free_new_context:
 	/* free context if it was just created */
 	if(c->num_sent_packets <= 1)
 	{
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
-		{
-			comp->uncompressed_ctxt = NULL;
-		}
-		else
-		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
-		}
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		c_release_context(comp, c);
 	}
-error:
 	return ROHC_STATUS_ERROR;
 }
 
@@ -1915,7 +3314,7 @@ error:
  */
 bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 {
-	rohc_cid_t i;
+	size_t slot;
 
 	if(comp == NULL)
 	{
@@ -1926,14 +3325,18 @@ bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	          "force re-initialization for all %u contexts",
 	          comp->num_contexts_used);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	for(slot = 0; slot < comp->ctxts_next_slot; slot++)
 	{
-		if(comp->contexts[i].used)
+		struct rohc_comp_ctxt *const context =
+			&(comp->ctxt_pages[slot / ROHC_COMP_CTXT_PAGE_LEN][slot % ROHC_COMP_CTXT_PAGE_LEN]);
+
+		if(context->used)
 		{
-			if(!rohc_comp_reinit_context(&(comp->contexts[i])))
+			if(!rohc_comp_reinit_context(context))
 			{
 				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				             "failed to force re-initialization for CID %u", i);
+				             "failed to force re-initialization for CID %u",
+				             context->cid);
 				goto error;
 			}
 		}
@@ -2334,6 +3737,78 @@ bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
 }
 
 
+/**
+ * @brief Set the callback functions that reserve and release memory
+ *
+ * The profile-specific parts of the compression contexts are taken from
+ * slabs of the compressor: the memory of the contexts is recycled when
+ * contexts are destroyed, and given back only when the compressor is
+ * destroyed. The slabs grow by chunks of memory, as new contexts are
+ * created, until they hold one object per context.
+ *
+ * The chunks are never given back while the compressor lives: the memory
+ * reserved for the peak number of contexts stays reserved until
+ * \ref rohc_comp_free is called, even if most contexts are destroyed later.
+ *
+ * Set or replace the callback functions that the ROHC library calls to
+ * reserve and release these chunks of memory. Special value NULL for both
+ * functions restores the default functions malloc() and free().
+ *
+ * @warning The callbacks can not be modified once contexts were created
+ *
+ * @param comp       The ROHC compressor
+ * @param alloc_cb   The callback function that reserves memory,
+ *                   NULL to use malloc()
+ * @param free_cb    The callback function that releases memory,
+ *                   NULL to use free()
+ * @param priv_ctxt  An optional private context given to the callbacks,
+ *                   may be NULL
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_alloc_cb_t
+ * @see rohc_free_cb_t
+ */
+bool rohc_comp_set_allocator(struct rohc_comp *const comp,
+                             rohc_alloc_cb_t alloc_cb,
+                             rohc_free_cb_t free_cb,
+                             void *const priv_ctxt)
+{
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* both callbacks or none */
+	if((alloc_cb == NULL) != (free_cb == NULL))
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "the callbacks "
+		           "that reserve and release memory shall be both set or both "
+		           "NULL");
+		goto error;
+	}
+
+	/* refuse to set new callbacks if memory was already reserved */
+	if(comp->ctxt_slabs_nr > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the memory callbacks once contexts were created");
+		goto error;
+	}
+
+	comp->alloc_cb = alloc_cb;
+	comp->free_cb = free_cb;
+	comp->alloc_priv = priv_ctxt;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Is the given compression profile enabled for a compressor?
  *
@@ -2481,6 +3956,8 @@ bool rohc_comp_enable_profile(struct rohc_comp *const comp,
 
 	/* mark the profile as enabled */
 	comp->enabled_profiles[profile_major][profile_minor] = true;
+	/* the contexts of the flow cache were selected with the former profiles */
+	memset(comp->flow_cache, 0, sizeof(comp->flow_cache));
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = 0x%04x) enabled", profile);
 
@@ -2535,6 +4012,8 @@ bool rohc_comp_disable_profile(struct rohc_comp *const comp,
 
 	/* mark the profile as disabled */
 	comp->enabled_profiles[profile_major][profile_minor] = false;
+	/* the contexts of the flow cache were selected with the former profiles */
+	memset(comp->flow_cache, 0, sizeof(comp->flow_cache));
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	          "ROHC compression profile (ID = 0x%04x) disabled", profile);
 
@@ -2939,7 +4418,9 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 	const rohc_comp_features_t all_features =
 		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
 		ROHC_COMP_FEATURE_DUMP_PACKETS |
-		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES;
+		ROHC_COMP_FEATURE_TIME_BASED_REFRESHES |
+		ROHC_COMP_FEATURE_FAST_HASH;
+	enum hashtable_hash hash_fct;
 
 	/* compressor must be valid */
 	if(comp == NULL)
@@ -2957,8 +4438,27 @@ bool rohc_comp_set_features(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* the hash function cannot change once contexts were hashed */
+	if(((features ^ comp->features) & ROHC_COMP_FEATURE_FAST_HASH) != 0 &&
+	   comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "change the hash function after initialization");
+		goto error;
+	}
+
 	/* record new feature set */
 	comp->features = features;
+	if((features & ROHC_COMP_FEATURE_FAST_HASH) != 0)
+	{
+		hash_fct = HASHTABLE_HASH_FAST;
+	}
+	else
+	{
+		hash_fct = HASHTABLE_HASH_SIPHASH;
+	}
+	comp->contexts_by_fingerprint.hash_fct = hash_fct;
+	comp->contexts_cr.hash_fct = hash_fct;
 
 	return true;
 
@@ -3119,35 +4619,129 @@ bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
 		           "feedback found (header = %zu bytes, data = %zu bytes)",
 		           feedback_hdr_len, feedback_data_len);
 
-		/* reject feedback item if it doesn't fit in the available data */
-		if(feedback_len > remain_data.len)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "the %zu-byte feedback is too large for the %zu-byte "
-			             "remaining ROHC data", feedback_len, remain_data.len);
-			goto error;
-		}
+		/* reject feedback item if it doesn't fit in the available data */
+		if(feedback_len > remain_data.len)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "the %zu-byte feedback is too large for the %zu-byte "
+			             "remaining ROHC data", feedback_len, remain_data.len);
+			goto error;
+		}
+
+		/* skip the feedback header */
+		rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+		/* deliver the feedback data to the compressor */
+		if(!__rohc_comp_deliver_feedback(comp, rohc_buf_data(remain_data),
+		                                 feedback_data_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback item #%zu", feedbacks_nr);
+			nr_failures++;
+		}
+
+		/* skip the feedback data */
+		rohc_buf_pull(&remain_data, feedback_data_len);
+	}
+
+	return (nr_failures == 0);
+
+ignore:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create the queue of feedback delivered from other threads
+ *
+ * Feedback is usually received by a decompressor that runs on another thread
+ * or core than the compressor. Instead of calling
+ * \ref rohc_comp_deliver_feedback2 on the thread of the compressor, the
+ * decompressor thread may push the feedback into the queue with
+ * \ref rohc_comp_push_feedback. The compressor takes the queued feedback
+ * into account at the beginning of \ref rohc_compress4,
+ * \ref rohc_compress_hdr, and \ref rohc_compress_burst.
+ *
+ * The queue is a lock-free ring for one producer thread. Several producer
+ * threads shall be serialized by the application.
+ *
+ * The function shall be called once, before any feedback is pushed.
+ *
+ * @param comp       The ROHC compressor
+ * @param queue_len  The size of the queue (in bytes), a power of two, every
+ *                   feedback data uses 2 more bytes in the queue
+ * @return           true if the queue was created, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_push_feedback
+ */
+bool rohc_comp_set_feedback_queue(struct rohc_comp *const comp,
+                                  const size_t queue_len)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(comp->feedbacks.data != NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "the queue of feedback was already created");
+		goto error;
+	}
+	if(!ring_new(&comp->feedbacks, queue_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to create a %zu-byte queue of feedback", queue_len);
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu-byte queue of feedback created", queue_len);
+
+	return true;
 
-		/* skip the feedback header */
-		rohc_buf_pull(&remain_data, feedback_hdr_len);
+error:
+	return false;
+}
 
-		/* deliver the feedback data to the compressor */
-		if(!__rohc_comp_deliver_feedback(comp, rohc_buf_data(remain_data),
-		                                 feedback_data_len))
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to deliver feedback item #%zu", feedbacks_nr);
-			nr_failures++;
-		}
 
-		/* skip the feedback data */
-		rohc_buf_pull(&remain_data, feedback_data_len);
+/**
+ * @brief Push feedback data into the queue of the compressor
+ *
+ * The feedback data is copied into the queue created by
+ * \ref rohc_comp_set_feedback_queue, it is delivered to the compressor the
+ * next time it compresses packets. The function may be called by another
+ * thread than the one that uses the compressor, it does not emit any trace.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data, as received by a decompressor
+ * @return          true if the feedback data was queued,
+ *                  false if the queue is full or if parameters are invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_feedback_queue
+ */
+bool rohc_comp_push_feedback(struct rohc_comp *const comp,
+                             const struct rohc_buf feedback)
+{
+	if(comp == NULL || comp->feedbacks.data == NULL ||
+	   rohc_buf_is_malformed(feedback))
+	{
+		goto error;
 	}
 
-	return (nr_failures == 0);
+	/* there is nothing to queue if feedback contains no byte at all */
+	if(rohc_buf_is_empty(feedback))
+	{
+		return true;
+	}
 
-ignore:
-	return true;
+	return ring_push(&comp->feedbacks, rohc_buf_data(feedback), feedback.len);
 
 error:
 	return false;
@@ -3246,6 +4840,7 @@ error:
  * \ref rohc_comp_general_info_t structure with the \e version_major and
  * \e version_minor fields set to one of the following supported versions:
  *  - Major 0, minor 0
+ *  - Major 0, minor 1
  *
  * See the \ref rohc_comp_general_info_t structure for details about fields
  * that are supported in the above versions.
@@ -3283,13 +4878,20 @@ bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
 		info->comp_bytes_nr = comp->total_compressed_size;
 
 		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		if(info->version_minor > 1)
 		{
 			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "unsupported minor version (%u) of the structure for "
 			           "general information", info->version_minor);
 			goto error;
 		}
+
+		/* new fields in 0.1 */
+		if(info->version_minor >= 1)
+		{
+			info->flow_cache_lookups_nr = comp->flow_cache_lookups_nr;
+			info->flow_cache_hits_nr = comp->flow_cache_hits_nr;
+		}
 	}
 	else
 	{
@@ -3340,6 +4942,364 @@ const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
 }
 
 
+/**
+ * @brief Create a new sharded ROHC compressor
+ *
+ * A sharded compressor is one ROHC channel whose compression work is split
+ * among several shards, typically one per core of a multi-core datapath.
+ * Every shard is a complete ROHC compressor that compresses its own flows
+ * with its own contexts, so the shards may compress packets at the same time
+ * without any lock.
+ *
+ * The shards share the CID space of the channel: the shard \e i uses only
+ * the CIDs that are equal to \e i modulo \e shards_nr. When all its CIDs are
+ * in use, a shard recycles its least recently used context, never a context
+ * of another shard.
+ *
+ * To use it:
+ *  - get every shard with \ref rohc_comp_sharded_get_shard and configure it
+ *    as a regular compressor; all the shards shall be configured the same
+ *    way,
+ *  - select the shard of every packet with \ref rohc_comp_sharded_select,
+ *    then compress the packet with the selected shard, with
+ *    \ref rohc_compress4 or \ref rohc_compress_burst for example,
+ *  - dispatch the received feedback to the shards with
+ *    \ref rohc_comp_sharded_split_feedback, then deliver it to every shard
+ *    with \ref rohc_comp_deliver_feedback2.
+ *
+ * The library does not create any thread nor use any lock: one shard shall
+ * be used by one thread at a time. The packets of one flow are always
+ * selected for the same shard, so the application may steer packets to the
+ * thread of their shard as a NIC would do with RSS.
+ *
+ * @param cid_type   The type of Context IDs (CID) that the ROHC compressor
+ *                   shall operate with, see \ref rohc_comp_new2
+ * @param max_cid    The maximum value that the ROHC compressor should use for
+ *                   context IDs (CID), see \ref rohc_comp_new2
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param rand_cb    The random callback to set, it is given the shard
+ * @param rand_priv  Private data that will be given to the callback, may be
+ *                   used as a context by user
+ * @return           The created sharded compressor if successful,
+ *                   NULL if creation failed
+ *
+ * @warning Don't forget to free compressor memory with
+ *          \ref rohc_comp_sharded_free if \e rohc_comp_sharded_new
+ *          succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sharded_free
+ * @see rohc_comp_sharded_get_shard
+ * @see rohc_comp_sharded_select
+ * @see rohc_comp_sharded_split_feedback
+ * @see rohc_comp_sharded_get_general_info
+ */
+struct rohc_comp_sharded * rohc_comp_sharded_new(const rohc_cid_type_t cid_type,
+                                                 const rohc_cid_t max_cid,
+                                                 const size_t shards_nr,
+                                                 const rohc_comp_random_cb_t rand_cb,
+                                                 void *const rand_priv)
+{
+	struct rohc_comp_sharded *sc;
+	size_t i;
+
+	/* every shard shall own at least one CID */
+	if(shards_nr == 0 || shards_nr > (((size_t) max_cid) + 1))
+	{
+		goto error;
+	}
+
+	sc = calloc(1, sizeof(struct rohc_comp_sharded));
+	if(sc == NULL)
+	{
+		goto error;
+	}
+	sc->shards = calloc(shards_nr, sizeof(struct rohc_comp *));
+	if(sc->shards == NULL)
+	{
+		goto free_sharded;
+	}
+	sc->shards_nr = shards_nr;
+
+	/* create the shards, each of them with its own CIDs */
+	for(i = 0; i < shards_nr; i++)
+	{
+		sc->shards[i] = rohc_comp_new2(cid_type, max_cid, rand_cb, rand_priv);
+		if(sc->shards[i] == NULL)
+		{
+			goto free_shards;
+		}
+		c_init_free_contexts(sc->shards[i], i, shards_nr);
+	}
+
+	/* the seed of the keys of flows that select the shards */
+	for(i = 0; i < sizeof(uint32_t); i++)
+	{
+		sc->flow_key_seed <<= 8;
+		sc->flow_key_seed |= rand_cb(sc->shards[0], rand_priv) & 0xff;
+	}
+
+	return sc;
+
+free_shards:
+	rohc_comp_sharded_free(sc);
+	goto error;
+free_sharded:
+	zfree(sc);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given sharded ROHC compressor
+ *
+ * Destroy a sharded ROHC compressor that was successfully created with
+ * \ref rohc_comp_sharded_new, and all its shards.
+ *
+ * @param sc  The sharded ROHC compressor to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sharded_new
+ */
+void rohc_comp_sharded_free(struct rohc_comp_sharded *const sc)
+{
+	if(sc != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < sc->shards_nr; i++)
+		{
+			rohc_comp_free(sc->shards[i]);
+		}
+		free(sc->shards);
+		free(sc);
+	}
+}
+
+
+/**
+ * @brief Get one shard of the given sharded ROHC compressor
+ *
+ * The shard is a regular ROHC compressor that may be configured and used
+ * with all the functions of the compression API. It shall not be freed with
+ * \ref rohc_comp_free, \ref rohc_comp_sharded_free does it.
+ *
+ * @param sc         The sharded ROHC compressor
+ * @param shard_idx  The index of the shard, in range [0, number of shards)
+ * @return           The shard if successful, NULL if the index is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sharded_new
+ * @see rohc_comp_sharded_select
+ */
+struct rohc_comp * rohc_comp_sharded_get_shard(const struct rohc_comp_sharded *const sc,
+                                               const size_t shard_idx)
+{
+	if(sc == NULL || shard_idx >= sc->shards_nr)
+	{
+		return NULL;
+	}
+	return sc->shards[shard_idx];
+}
+
+
+/**
+ * @brief Select the shard that shall compress the given packet
+ *
+ * The shard is selected from the key of the flow of the packet, that is
+ * computed from the raw bytes of the outer IP header and of the ports or SPI
+ * behind it, so all the packets of one flow are selected for the same shard.
+ *
+ * The function uses neither the shards nor their traces: it may be called by
+ * a dispatching thread while the shards compress packets.
+ *
+ * @param sc              The sharded ROHC compressor
+ * @param uncomp_packet   The uncompressed packet to select a shard for
+ * @param[out] shard_idx  The index of the shard that shall compress the
+ *                        packet
+ * @return                true if a shard was selected, false if the given
+ *                        parameters are invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sharded_get_shard
+ */
+bool rohc_comp_sharded_select(const struct rohc_comp_sharded *const sc,
+                              const struct rohc_buf uncomp_packet,
+                              size_t *const shard_idx)
+{
+	uint32_t flow_key;
+
+	if(sc == NULL || shard_idx == NULL || rohc_buf_is_malformed(uncomp_packet))
+	{
+		goto error;
+	}
+
+	flow_key = rohc_comp_flow_key(&uncomp_packet, sc->flow_key_seed);
+	*shard_idx = (((uint64_t) flow_key) * sc->shards_nr) >> 32;
+	assert((*shard_idx) < sc->shards_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Dispatch feedback data to the shards that own its contexts
+ *
+ * Every feedback item of the given feedback data is appended to the buffer
+ * of the shard that owns its CID. The feedback data of every shard shall
+ * then be delivered to the shard with \ref rohc_comp_deliver_feedback2, by
+ * the thread that uses the shard.
+ *
+ * @param sc                       The sharded ROHC compressor
+ * @param feedback                 The feedback data
+ * @param[in,out] shard_feedbacks  The feedback data of the shards, one buffer
+ *                                 per shard, feedback items are appended
+ * @return                         true if all the feedback items were
+ *                                 dispatched, false if one feedback item is
+ *                                 malformed or does not fit in the buffer of
+ *                                 its shard
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_deliver_feedback2
+ */
+bool rohc_comp_sharded_split_feedback(const struct rohc_comp_sharded *const sc,
+                                      const struct rohc_buf feedback,
+                                      struct rohc_buf *const shard_feedbacks)
+{
+	struct rohc_buf remain_data = feedback;
+	size_t i;
+
+	/* sanity checks */
+	if(sc == NULL || shard_feedbacks == NULL || rohc_buf_is_malformed(feedback))
+	{
+		goto error;
+	}
+	for(i = 0; i < sc->shards_nr; i++)
+	{
+		if(rohc_buf_is_malformed(shard_feedbacks[i]))
+		{
+			goto error;
+		}
+	}
+
+	/* dispatch as much feedback data as possible */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		struct rohc_buf *shard_feedback;
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		size_t feedback_len;
+		rohc_cid_t cid;
+		size_t cid_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len))
+		{
+			goto error;
+		}
+		feedback_len = feedback_hdr_len + feedback_data_len;
+		if(feedback_len > remain_data.len || feedback_data_len == 0)
+		{
+			goto error;
+		}
+
+		/* the shard that owns the CID of the feedback item */
+		if(!rohc_comp_feedback_parse_cid(sc->shards[0],
+		                                 rohc_buf_data_at(remain_data, feedback_hdr_len),
+		                                 feedback_data_len, &cid, &cid_len))
+		{
+			goto error;
+		}
+		shard_feedback = &shard_feedbacks[cid % sc->shards_nr];
+
+		/* copy the whole feedback item for the shard */
+		if((shard_feedback->len + feedback_len) > rohc_buf_avail_len(*shard_feedback))
+		{
+			goto error;
+		}
+		rohc_buf_append(shard_feedback, rohc_buf_data(remain_data), feedback_len);
+		rohc_buf_pull(&remain_data, feedback_len);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the sharded compressor
+ *
+ * The statistics of all the shards are summed. Every shard updates its own
+ * statistics, so compressing does not require any synchronization between
+ * the shards. The statistics read while the shards compress packets may
+ * thus miss the latest packets.
+ *
+ * See \ref rohc_comp_get_general_info for the supported versions of the
+ * \ref rohc_comp_general_info_t structure.
+ *
+ * @param sc            The sharded ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_general_info
+ */
+bool rohc_comp_sharded_get_general_info(const struct rohc_comp_sharded *const sc,
+                                        rohc_comp_general_info_t *const info)
+{
+	rohc_comp_general_info_t shard_info;
+	size_t i;
+
+	if(sc == NULL || info == NULL)
+	{
+		goto error;
+	}
+
+	shard_info.version_major = info->version_major;
+	shard_info.version_minor = info->version_minor;
+	if(!rohc_comp_get_general_info(sc->shards[0], &shard_info))
+	{
+		goto error;
+	}
+	*info = shard_info;
+
+	for(i = 1; i < sc->shards_nr; i++)
+	{
+		if(!rohc_comp_get_general_info(sc->shards[i], &shard_info))
+		{
+			goto error;
+		}
+		info->contexts_nr += shard_info.contexts_nr;
+		info->packets_nr += shard_info.packets_nr;
+		info->uncomp_bytes_nr += shard_info.uncomp_bytes_nr;
+		info->comp_bytes_nr += shard_info.comp_bytes_nr;
+		if(info->version_minor >= 1)
+		{
+			info->flow_cache_lookups_nr += shard_info.flow_cache_lookups_nr;
+			info->flow_cache_hits_nr += shard_info.flow_cache_hits_nr;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /*
  * Definitions of private functions
  */
@@ -3359,99 +5319,79 @@ static struct rohc_comp_ctxt *
 	c_create_context(struct rohc_comp *const comp,
 	                 const struct rohc_comp_profile *const profile,
 	                 const struct rohc_fingerprint *const fingerprint,
+	                 const uint64_t fingerprint_hash,
 	                 const struct rohc_pkt_hdrs *const pkt_hdrs,
 	                 const struct rohc_ts pkt_time)
 {
 	const struct rohc_comp_ctxt *base_ctxt = NULL;
+	uint64_t fingerprint_hash_cr = 0;
 	struct rohc_comp_ctxt *c;
 	rohc_cid_t cid_to_use;
 
-	cid_to_use = 0;
-
-	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
-	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
+	/* if all the contexts are used:
+	 *   => recycle the least recently used context to make room
+	 * if at least one context was released:
+	 *   => pick the released context with the lowest CID
+	 * if at least one CID was never used:
+	 *   => pick the context of the next unused CID
+	 * released CIDs are always lower than the CIDs never used, so the lowest
+	 * unused CID is always picked
 	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
+	if(comp->ctxts_free_nr == 0 && comp->ctxts_next_slot >= comp->ctxts_nr)
 	{
-		/* all the contexts in the array were used, recycle the oldest context
+		/* all the contexts were used, recycle the least recently used context
 		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].latest_used < oldest)
-			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
-			}
-		}
-		c = &comp->contexts[cid_to_use];
+		c = comp->ctxts_lru_oldest;
+		assert(c != NULL);
+		assert(comp->num_contexts_used == comp->ctxts_nr);
 
 		/* destroy the oldest context before replacing it with a new one */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "recycle oldest context (CID %u with profile 0x%04x)",
-		           cid_to_use, c->profile->id);
-		if(c->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
-		{
-			comp->uncompressed_ctxt = NULL;
-		}
-		else
-		{
-			hashtable_del(&comp->contexts_by_fingerprint, &c->fingerprint);
-			/* TODO: replace TCP by CR capacity */
-			if(c->profile->id == ROHCv1_PROFILE_IP_TCP)
-			{
-				hashtable_cr_del(&comp->contexts_cr, &c->fingerprint);
-			}
-		}
-		c->profile->destroy(&comp->contexts[cid_to_use]);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		           c->cid, c->profile->id);
+		c_release_context(comp, c);
 	}
-	else
+	if(comp->ctxts_free_nr > 0)
 	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
+		const size_t slot = c_pop_free_slot(comp);
 
-		rohc_cid_t i;
-
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
+		c = &(comp->ctxt_pages[slot / ROHC_COMP_CTXT_PAGE_LEN][slot % ROHC_COMP_CTXT_PAGE_LEN]);
+	}
+	else
+	{
+		c = c_new_ctxt_slot(comp);
+		if(c == NULL)
 		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot allocate memory for a new page of contexts");
+			return NULL;
 		}
-		c = &comp->contexts[cid_to_use];
-
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID %u)", cid_to_use);
 	}
+	assert(c->used == 0);
+	cid_to_use = c->cid;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "take the first unused context (CID %u)", cid_to_use);
 
 	/* search for a possible base context if Context Replication is possible */
 	/* TODO: replace TCP by CR capacity */
 	if(profile->id == ROHCv1_PROFILE_IP_TCP)
 	{
+		const size_t base_len = rohc_fingerprint_base_len(&fingerprint->base);
 		size_t best_ctxt_affinity = ROHC_AFFINITY_NONE;
 		struct rohc_comp_ctxt *candidate;
+		size_t pos;
 
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "search a base context for Context Replication");
 
 		/* search for a base context that we may clone the new context from */
-		for(candidate = hashtable_cr_get_first(&comp->contexts_cr, fingerprint);
+		fingerprint_hash_cr =
+			hashtable_hash(&comp->contexts_cr, &fingerprint->base, base_len);
+		for(candidate = hashtable_cr_get_first(&comp->contexts_cr, &fingerprint->base,
+		                                       base_len, fingerprint_hash_cr, &pos);
 		    candidate != NULL;
-		    candidate = hashtable_cr_get_next(&comp->contexts_cr, fingerprint,
-		                                      candidate))
+		    candidate = hashtable_cr_get_next(&comp->contexts_cr, &fingerprint->base,
+		                                      base_len, fingerprint_hash_cr, &pos))
 		{
 			/* context partially matches the fingerprint of the packet */
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -3539,6 +5479,8 @@ static struct rohc_comp_ctxt *
 	}
 
 	memcpy(&c->fingerprint, fingerprint, sizeof(struct rohc_fingerprint));
+	c->fingerprint_hash = fingerprint_hash;
+	c->fingerprint_hash_cr = fingerprint_hash_cr;
 
 	c->state_oa_repeat_nr = 0;
 	c->go_back_fo_count = 0;
@@ -3570,38 +5512,55 @@ static struct rohc_comp_ctxt *
 	{
 		if(!profile->clone(c, base_ctxt))
 		{
-			return NULL;
+			goto error;
 		}
 	}
 	else
 	{
 		if(!profile->create(c, pkt_hdrs))
 		{
-			return NULL;
+			goto error;
 		}
 	}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->latest_used = pkt_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
-
 	/* insert the context in the hash table of contexts to efficiently find it
 	 * again through its fingerprint */
 	if(profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
 	{
 		comp->uncompressed_ctxt = c;
 	}
-	else
+	else if(!hashtable_add(&comp->contexts_by_fingerprint, fingerprint_hash,
+	                       cid_to_use))
 	{
-		hashtable_add(&comp->contexts_by_fingerprint, &(c->fingerprint), c);
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to add context with CID %u in the hash table",
+		             cid_to_use);
+		goto destroy_profile_ctxt;
 	}
 
+	/* if creation is successful, mark the context as used */
+	c->used = 1;
+	c->latest_used = pkt_time.sec;
+	c_lru_append(comp, c);
+	assert(comp->num_contexts_used < comp->ctxts_nr);
+	comp->num_contexts_used++;
+
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "context (CID %u) created at %" PRIu64 " seconds (num_used = %u)",
 	           c->cid, c->latest_used, comp->num_contexts_used);
 	return c;
+
+destroy_profile_ctxt:
+	profile->destroy(c);
+error:
+	/* give the context back to the released contexts, the context may have
+	 * been overwritten by the base context in case of replication */
+	c->used = 0;
+	c->cid = cid_to_use;
+	c->lru_prev = NULL;
+	c->lru_next = NULL;
+	c_push_free_slot(comp, c_get_cid_slot(comp, cid_to_use));
+	return NULL;
 }
 
 
@@ -3676,6 +5635,7 @@ static struct rohc_comp_ctxt *
 	                    const struct rohc_comp_profile *const profile,
 	                    const struct rohc_buf *const packet,
 	                    const struct rohc_fingerprint *const pkt_fingerprint,
+	                    const uint64_t fingerprint_hash,
 	                    const struct rohc_pkt_hdrs *const pkt_hdrs)
 {
 	struct rohc_comp_ctxt *context;
@@ -3690,7 +5650,9 @@ static struct rohc_comp_ctxt *
 	else /* non-Uncompressed profiles */
 	{
 		/* search for an existing context matching the packet fingerprint */
-		context = hashtable_get(&comp->contexts_by_fingerprint, pkt_fingerprint);
+		context = hashtable_get(&comp->contexts_by_fingerprint, pkt_fingerprint,
+		                        rohc_fingerprint_len(pkt_fingerprint),
+		                        fingerprint_hash);
 
 		/* hmmm, looks like we could re-use that context ; if Context Replication
 		 * is in action, check that the base context didn't change too much */
@@ -3703,7 +5665,7 @@ static struct rohc_comp_ctxt *
 			/* Context Replication is in action, so check whether the base context
 			 * changed too much to be re-used or not */
 			const struct rohc_comp_ctxt *const base_ctxt =
-				&(comp->contexts[context->cr_base_cid]);
+				c_get_ctxt_slot(comp, context->cr_base_cid);
 			rohc_ctxt_affinity_t base_ctxt_affinity;
 
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -3733,12 +5695,7 @@ static struct rohc_comp_ctxt *
 				           base_ctxt->cid);
 
 				/* destroy that half-opened context */
-				hashtable_del(&comp->contexts_by_fingerprint, &context->fingerprint);
-				hashtable_cr_del(&comp->contexts_cr, &context->fingerprint);
-				profile->destroy(context);
-				context->used = 0;
-				assert(comp->num_contexts_used > 0);
-				comp->num_contexts_used--;
+				c_release_context(comp, context);
 
 				/* no context found */
 				context = NULL;
@@ -3752,6 +5709,8 @@ static struct rohc_comp_ctxt *
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "re-using context CID %u", context->cid);
 		context->latest_used = packet->time.sec;
+		c_lru_unlink(comp, context);
+		c_lru_append(comp, context);
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "context (CID %u) used at %" PRIu64 " seconds",
 		           context->cid, context->latest_used);
@@ -3763,7 +5722,8 @@ static struct rohc_comp_ctxt *
 
 		/* create the new context from packet (and from the base context if
 		 * Context Replication is possible) */
-		context = c_create_context(comp, profile, pkt_fingerprint, pkt_hdrs, packet->time);
+		context = c_create_context(comp, profile, pkt_fingerprint, fingerprint_hash,
+		                           pkt_hdrs, packet->time);
 		if(context == NULL)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -3785,19 +5745,25 @@ static struct rohc_comp_ctxt *
 static struct rohc_comp_ctxt *
 	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
 {
-	/* the CID must not be larger than the context array */
-	if(cid > comp->medium.max_cid)
+	struct rohc_comp_ctxt *context;
+
+	/* the CID must not be larger than the table of contexts, and it shall be
+	 * one of the CIDs of the compressor if it is one shard of a sharded
+	 * compressor */
+	if(cid > comp->medium.max_cid ||
+	   (cid % comp->ctxts_cid_step) != comp->ctxts_cid_first)
 	{
 		goto not_found;
 	}
 
 	/* the context with the given CID must be in use */
-	if(comp->contexts[cid].used == 0)
+	context = c_get_ctxt_slot(comp, cid);
+	if(context == NULL || context->used == 0)
 	{
 		goto not_found;
 	}
 
-	return &(comp->contexts[cid]);
+	return context;
 
 not_found:
 	return NULL;
@@ -3805,39 +5771,360 @@ not_found:
 
 
 /**
- * @brief Create the array of compression contexts
+ * @brief Get the compression context with the given CID
+ *
+ * This is the callback that the hash tables of contexts use to access the
+ * contexts from their CIDs.
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context
+ * @return      The compression context
+ */
+static void * c_get_ctxt_by_cid(const void *const comp, const uint32_t cid)
+{
+	return c_get_ctxt_slot(comp, cid);
+}
+
+
+/**
+ * @brief Get the slot of the compression context with the given CID
+ *
+ * The contexts are stored in pages of contexts indexed by the slot of their
+ * CID among the CIDs of the compressor, so that one shard of a sharded
+ * compressor does not reserve memory for the CIDs of the other shards.
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context, one of the CIDs of the compressor
+ * @return      The slot of the context, used or not, NULL if the page of the
+ *              CID was never allocated
+ */
+static inline struct rohc_comp_ctxt *
+	c_get_ctxt_slot(const struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	const size_t slot = c_get_cid_slot(comp, cid);
+	struct rohc_comp_ctxt *const page =
+		comp->ctxt_pages[slot / ROHC_COMP_CTXT_PAGE_LEN];
+
+	if(page == NULL)
+	{
+		return NULL;
+	}
+	return &(page[slot % ROHC_COMP_CTXT_PAGE_LEN]);
+}
+
+
+/**
+ * @brief Get the slot of the next CID that the compressor never used
+ *
+ * The page of the CID is allocated if needed.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The unused slot of the context, NULL if all the CIDs were
+ *              already used or if no memory is available for the page
+ */
+static struct rohc_comp_ctxt * c_new_ctxt_slot(struct rohc_comp *const comp)
+{
+	const size_t slot = comp->ctxts_next_slot;
+	const size_t page_idx = slot / ROHC_COMP_CTXT_PAGE_LEN;
+
+	if(slot >= comp->ctxts_nr)
+	{
+		goto error;
+	}
+
+	if(comp->ctxt_pages[page_idx] == NULL)
+	{
+		const size_t page_len = c_get_ctxt_page_len(comp, page_idx);
+		struct rohc_comp_ctxt *page;
+		size_t i;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "allocate page #%zu of %zu contexts", page_idx, page_len);
+		page = calloc(page_len, sizeof(struct rohc_comp_ctxt));
+		if(page == NULL)
+		{
+			goto error;
+		}
+		for(i = 0; i < page_len; i++)
+		{
+			page[i].cid = comp->ctxts_cid_first +
+				(page_idx * ROHC_COMP_CTXT_PAGE_LEN + i) * comp->ctxts_cid_step;
+		}
+		comp->ctxt_pages[page_idx] = page;
+	}
+	comp->ctxts_next_slot++;
+
+	return &(comp->ctxt_pages[page_idx][slot % ROHC_COMP_CTXT_PAGE_LEN]);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the number of contexts in the given page of contexts
+ *
+ * All the pages hold \ref ROHC_COMP_CTXT_PAGE_LEN contexts, except the last
+ * one that holds only the remaining CIDs of the compressor.
+ *
+ * @param comp      The ROHC compressor
+ * @param page_idx  The index of the page
+ * @return          The number of contexts in the page
+ */
+static inline size_t c_get_ctxt_page_len(const struct rohc_comp *const comp,
+                                         const size_t page_idx)
+{
+	assert((page_idx * ROHC_COMP_CTXT_PAGE_LEN) < comp->ctxts_nr);
+	return rohc_min(ROHC_COMP_CTXT_PAGE_LEN,
+	                comp->ctxts_nr - page_idx * ROHC_COMP_CTXT_PAGE_LEN);
+}
+
+
+/**
+ * @brief Get the slot of the given CID among the CIDs of the compressor
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID, one of the CIDs of the compressor
+ * @return      The slot of the CID
+ */
+static inline size_t c_get_cid_slot(const struct rohc_comp *const comp,
+                                    const rohc_cid_t cid)
+{
+	assert((cid % comp->ctxts_cid_step) == comp->ctxts_cid_first);
+	return (comp->ctxts_cid_step == 1 ? cid : cid / comp->ctxts_cid_step);
+}
+
+
+/**
+ * @brief Mark the given slot of context as released
+ *
+ * @param comp  The ROHC compressor
+ * @param slot  The slot of the released context
+ */
+static void c_push_free_slot(struct rohc_comp *const comp, const size_t slot)
+{
+	const size_t word_idx = slot / 64;
+
+	assert(slot < comp->ctxts_next_slot);
+	assert((comp->ctxts_free_map[word_idx] & (1ULL << (slot % 64))) == 0);
+
+	comp->ctxts_free_map[word_idx] |= 1ULL << (slot % 64);
+	comp->ctxts_free_words[word_idx / 64] |= 1ULL << (word_idx % 64);
+	comp->ctxts_free_nr++;
+}
+
+
+/**
+ * @brief Take the released slot of context with the lowest CID
+ *
+ * The summary of the map of released slots tells which word of the map holds
+ * the lowest released slot, so the slot is found in constant time.
+ *
+ * @param comp  The ROHC compressor, with at least one released slot
+ * @return      The slot of the released context with the lowest CID
+ */
+static size_t c_pop_free_slot(struct rohc_comp *const comp)
+{
+	size_t word_idx;
+	size_t i;
+
+	assert(comp->ctxts_free_nr > 0);
+
+	for(i = 0; comp->ctxts_free_words[i] == 0; i++)
+	{
+		assert((i + 1) < ROHC_COMP_CTXT_FREE_WORDS_NR);
+	}
+	word_idx = i * 64 + __builtin_ctzll(comp->ctxts_free_words[i]);
+	i = __builtin_ctzll(comp->ctxts_free_map[word_idx]);
+
+	comp->ctxts_free_map[word_idx] &= comp->ctxts_free_map[word_idx] - 1;
+	if(comp->ctxts_free_map[word_idx] == 0)
+	{
+		comp->ctxts_free_words[word_idx / 64] &= ~(1ULL << (word_idx % 64));
+	}
+	comp->ctxts_free_nr--;
+
+	return word_idx * 64 + i;
+}
+
+
+/**
+ * @brief Release a compression context, so that it may be used again later
+ *
+ * The context is removed from the hash tables and from the list of
+ * recently-used contexts, its profile-specific part is destroyed, then it is
+ * marked as released.
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to release
+ */
+static void c_release_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const ctxt)
+{
+	assert(ctxt->used);
+
+	if(ctxt->profile->id == ROHCv1_PROFILE_UNCOMPRESSED)
+	{
+		comp->uncompressed_ctxt = NULL;
+	}
+	else
+	{
+		hashtable_del(&comp->contexts_by_fingerprint, ctxt->fingerprint_hash,
+		              ctxt->cid);
+		/* TODO: replace TCP by CR capacity */
+		if(ctxt->profile->id == ROHCv1_PROFILE_IP_TCP)
+		{
+			hashtable_cr_del(&comp->contexts_cr, ctxt->fingerprint_hash_cr, ctxt->cid);
+		}
+	}
+	ctxt->profile->destroy(ctxt);
+	ctxt->used = 0;
+	assert(comp->num_contexts_used > 0);
+	comp->num_contexts_used--;
+
+	c_lru_unlink(comp, ctxt);
+	c_push_free_slot(comp, c_get_cid_slot(comp, ctxt->cid));
+}
+
+
+/**
+ * @brief Append a compression context at the most recent end of the LRU list
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to append, shall not be in the list
+ */
+static void c_lru_append(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+{
+	ctxt->lru_prev = comp->ctxts_lru_newest;
+	ctxt->lru_next = NULL;
+	if(comp->ctxts_lru_newest == NULL)
+	{
+		comp->ctxts_lru_oldest = ctxt;
+	}
+	else
+	{
+		comp->ctxts_lru_newest->lru_next = ctxt;
+	}
+	comp->ctxts_lru_newest = ctxt;
+}
+
+
+/**
+ * @brief Remove a compression context from the LRU list
+ *
+ * @param comp  The ROHC compressor
+ * @param ctxt  The compression context to remove, shall be in the list
+ */
+static void c_lru_unlink(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const ctxt)
+{
+	if(ctxt->lru_prev == NULL)
+	{
+		assert(comp->ctxts_lru_oldest == ctxt);
+		comp->ctxts_lru_oldest = ctxt->lru_next;
+	}
+	else
+	{
+		ctxt->lru_prev->lru_next = ctxt->lru_next;
+	}
+	if(ctxt->lru_next == NULL)
+	{
+		assert(comp->ctxts_lru_newest == ctxt);
+		comp->ctxts_lru_newest = ctxt->lru_prev;
+	}
+	else
+	{
+		ctxt->lru_next->lru_prev = ctxt->lru_prev;
+	}
+	ctxt->lru_prev = NULL;
+	ctxt->lru_next = NULL;
+}
+
+
+/**
+ * @brief Create the table of compression contexts
+ *
+ * Only the table of pages is allocated: the pages of contexts are allocated
+ * when the compressor needs them, so that a compressor with large CIDs but
+ * only a few flows does not reserve memory for all its CIDs. The table is
+ * sized for all the CIDs, the shards of a sharded compressor use only its
+ * first entries.
  *
  * @param comp The ROHC compressor
  * @return     true if the creation is successful, false otherwise
  */
 static bool c_create_contexts(struct rohc_comp *const comp)
 {
-	assert(comp->contexts == NULL);
+	const size_t pages_nr =
+		(comp->medium.max_cid + ROHC_COMP_CTXT_PAGE_LEN) / ROHC_COMP_CTXT_PAGE_LEN;
+
+	assert(comp->ctxt_pages == NULL);
 
 	comp->num_contexts_used = 0;
 
 	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "create enough room for %u contexts (MAX_CID = %u)",
-	          comp->medium.max_cid + 1, comp->medium.max_cid);
+	          "create enough room for %u contexts (MAX_CID = %u) in %zu pages",
+	          comp->medium.max_cid + 1, comp->medium.max_cid, pages_nr);
 
-	comp->contexts = calloc(comp->medium.max_cid + 1,
-	                        sizeof(struct rohc_comp_ctxt));
-	if(comp->contexts == NULL)
+	comp->ctxt_pages = calloc(pages_nr, sizeof(struct rohc_comp_ctxt *));
+	if(comp->ctxt_pages == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "cannot allocate memory for contexts");
 		goto error;
 	}
+	comp->ctxts_free_map = calloc((comp->medium.max_cid + 64U) / 64U, sizeof(uint64_t));
+	if(comp->ctxts_free_map == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the map of released contexts");
+		goto free_pages;
+	}
+
+	/* all contexts are unused at startup */
+	comp->ctxts_lru_oldest = NULL;
+	comp->ctxts_lru_newest = NULL;
+	c_init_free_contexts(comp, 0, 1);
 
 	return true;
 
+free_pages:
+	zfree(comp->ctxt_pages);
 error:
 	return false;
 }
 
 
 /**
- * @brief Destroy all the compression contexts in the context array
+ * @brief Select the unused contexts that the compressor may use
+ *
+ * The compressor may use the contexts whose CID equals \e shard_idx modulo
+ * \e shards_nr. They are given in increasing CID order. All the contexts
+ * shall be unused.
+ *
+ * @param comp       The ROHC compressor
+ * @param shard_idx  The index of the compressor among the shards
+ * @param shards_nr  The number of shards, 1 if the compressor is not sharded
+ */
+static void c_init_free_contexts(struct rohc_comp *const comp,
+                                 const size_t shard_idx,
+                                 const size_t shards_nr)
+{
+	assert(comp->num_contexts_used == 0);
+	assert(shard_idx < shards_nr);
+	assert(shard_idx <= comp->medium.max_cid);
+
+	assert(comp->ctxts_free_nr == 0);
+	comp->ctxts_next_slot = 0;
+	comp->ctxts_cid_first = shard_idx;
+	comp->ctxts_cid_step = shards_nr;
+	comp->ctxts_nr = (comp->medium.max_cid + shards_nr - shard_idx) / shards_nr;
+}
+
+
+/**
+ * @brief Destroy all the compression contexts in the table of contexts
  *
  * The profile-specific contexts are also destroyed.
  *
@@ -3845,28 +6132,49 @@ error:
  */
 static void c_destroy_contexts(struct rohc_comp *const comp)
 {
-	rohc_cid_t i;
+	const size_t pages_nr =
+		(comp->medium.max_cid + ROHC_COMP_CTXT_PAGE_LEN) / ROHC_COMP_CTXT_PAGE_LEN;
+	size_t page_idx;
 
-	assert(comp->contexts != NULL);
+	assert(comp->ctxt_pages != NULL);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	for(page_idx = 0; page_idx < pages_nr; page_idx++)
 	{
-		if(comp->contexts[i].used && comp->contexts[i].profile != NULL)
+		struct rohc_comp_ctxt *const page = comp->ctxt_pages[page_idx];
+		size_t page_len;
+		size_t i;
+
+		if(page == NULL)
 		{
-			comp->contexts[i].profile->destroy(&comp->contexts[i]);
+			continue;
 		}
 
-		if(comp->contexts[i].used)
+		page_len = c_get_ctxt_page_len(comp, page_idx);
+		for(i = 0; i < page_len; i++)
 		{
-			comp->contexts[i].used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			if(page[i].used && page[i].profile != NULL)
+			{
+				page[i].profile->destroy(&page[i]);
+			}
+
+			if(page[i].used)
+			{
+				page[i].used = 0;
+				assert(comp->num_contexts_used > 0);
+				comp->num_contexts_used--;
+			}
 		}
+		free(page);
 	}
 	assert(comp->num_contexts_used == 0);
 
-	free(comp->contexts);
-	comp->contexts = NULL;
+	free(comp->ctxt_pages);
+	comp->ctxt_pages = NULL;
+	zfree(comp->ctxts_free_map);
+	comp->ctxts_free_nr = 0;
+	memset(comp->ctxts_free_words, 0, sizeof(comp->ctxts_free_words));
+	comp->ctxts_lru_oldest = NULL;
+	comp->ctxts_lru_newest = NULL;
 }
 
 
@@ -3915,15 +6223,19 @@ void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_debug(context, "CR: context CID %u is considered as "
 				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
+				if(!hashtable_cr_add(&context->compressor->contexts_cr,
+				                     context->fingerprint_hash_cr, context->cid))
+				{
+					rohc_comp_warn(context, "CR: failed to record context CID %u "
+					               "as a base context", context->cid);
+				}
 			}
 			else
 			{
 				rohc_comp_debug(context, "CR: context CID %u is not considered as "
 				                "established", context->cid);
 				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
+				                 context->fingerprint_hash_cr, context->cid);
 			}
 		}
 	}
@@ -3964,15 +6276,19 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 			{
 				rohc_comp_debug(context, "CR: context CID %u is considered as "
 				                "established", context->cid);
-				hashtable_cr_add(&context->compressor->contexts_cr,
-				                 &context->fingerprint, context);
+				if(!hashtable_cr_add(&context->compressor->contexts_cr,
+				                     context->fingerprint_hash_cr, context->cid))
+				{
+					rohc_comp_warn(context, "CR: failed to record context CID %u "
+					               "as a base context", context->cid);
+				}
 			}
 			else
 			{
 				rohc_comp_debug(context, "CR: context CID %u is not considered as "
 				                "established", context->cid);
 				hashtable_cr_del(&context->compressor->contexts_cr,
-				                 &context->fingerprint);
+				                 context->fingerprint_hash_cr, context->cid);
 			}
 		}
 	}
@@ -4134,6 +6450,168 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Copy the cached static chain of the given context in a ROHC packet
+ *
+ * @param context         The compression context
+ * @param static_chain    The static chain cached by the context
+ * @param[out] rohc_data  The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        0 if no static chain is cached yet,
+ *                        -1 in case of error
+ */
+int rohc_comp_copy_static_chain(const struct rohc_comp_ctxt *const context,
+                                const struct rohc_comp_static_chain *const static_chain,
+                                uint8_t *const rohc_data,
+                                const size_t rohc_max_len)
+{
+	if(static_chain->len == 0)
+	{
+		return 0;
+	}
+
+	if(rohc_max_len < static_chain->len)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the static chain: "
+		               "%u bytes required, but only %zu bytes available",
+		               static_chain->len, rohc_max_len);
+		return -1;
+	}
+
+	memcpy(rohc_data, static_chain->data, static_chain->len);
+	rohc_comp_debug(context, "copy the %u-byte static chain cached in context",
+	                static_chain->len);
+
+	return static_chain->len;
+}
+
+
+/**
+ * @brief Cache the static chain of the given context for its next IR packets
+ *
+ * Static chains longer than \ref ROHC_COMP_STATIC_CHAIN_MAX_LEN bytes are not
+ * cached: they will be encoded again for every IR packet.
+ *
+ * @param context           The compression context
+ * @param static_chain      The static chain cached by the context
+ * @param rohc_data         The static chain encoded in the ROHC packet
+ * @param static_chain_len  The length of the encoded static chain
+ */
+void rohc_comp_cache_static_chain(const struct rohc_comp_ctxt *const context,
+                                  struct rohc_comp_static_chain *const static_chain,
+                                  const uint8_t *const rohc_data,
+                                  const size_t static_chain_len)
+{
+	if(static_chain_len > ROHC_COMP_STATIC_CHAIN_MAX_LEN)
+	{
+		rohc_comp_debug(context, "do not cache the %zu-byte static chain in "
+		                "context, %u bytes max", static_chain_len,
+		                ROHC_COMP_STATIC_CHAIN_MAX_LEN);
+		static_chain->len = 0;
+		return;
+	}
+
+	memcpy(static_chain->data, rohc_data, static_chain_len);
+	static_chain->len = static_chain_len;
+}
+
+
+/**
+ * @brief Allocate memory for the profile-specific part of a context
+ *
+ * The memory is taken from the slab of the compressor for the objects of
+ * the given length. The slab is created the first time that such an object
+ * is required, it holds at most one object per context of the compressor.
+ * The memory is zeroed.
+ *
+ * @param context  The compression context that requires the memory
+ * @param len      The length of the memory to allocate (in bytes)
+ * @return         The allocated memory, NULL if no memory is available
+ */
+void * rohc_comp_ctxt_zalloc(struct rohc_comp_ctxt *const context,
+                             const size_t len)
+{
+	struct rohc_comp *const comp = context->compressor;
+	size_t i;
+
+	/* search for the slab of the objects of the given length */
+	for(i = 0; i < comp->ctxt_slabs_nr && comp->ctxt_slabs[i].obj_len != len; i++)
+	{
+	}
+	if(i == comp->ctxt_slabs_nr)
+	{
+		if(comp->ctxt_slabs_nr >= ROHC_COMP_CTXT_SLABS_NR)
+		{
+			rohc_comp_warn(context, "no slab left for %zu-byte objects", len);
+			goto error;
+		}
+		slab_new(&comp->ctxt_slabs[i], len, comp->ctxts_nr,
+		         comp->alloc_cb, comp->free_cb, comp->alloc_priv);
+		comp->ctxt_slabs_nr++;
+		rohc_comp_debug(context, "create slab #%zu for %zu-byte objects, "
+		                "%zu objects max", i + 1, len, comp->ctxts_nr);
+	}
+
+	return slab_alloc(&comp->ctxt_slabs[i]);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Release the memory of the profile-specific part of a context
+ *
+ * The memory is given back to its slab, not to the system allocator.
+ *
+ * @param ptr  The memory allocated by \ref rohc_comp_ctxt_zalloc,
+ *             NULL to do nothing
+ */
+void rohc_comp_ctxt_free(void *const ptr)
+{
+	slab_release(ptr);
+}
+
+
+/**
+ * @brief Deliver the feedback queued by other threads to the compressor
+ *
+ * At most one queue's worth of feedback is delivered, so that a producer
+ * that keeps pushing feedback cannot hold the compressor forever.
+ *
+ * @param comp  The ROHC compressor
+ */
+static void rohc_comp_drain_feedbacks(struct rohc_comp *const comp)
+{
+	const uint8_t *feedback_data;
+	size_t feedback_len;
+	size_t drained_len = 0;
+
+	if(comp->feedbacks.data == NULL)
+	{
+		return;
+	}
+
+	while(drained_len < comp->feedbacks.size &&
+	      (feedback_data = ring_peek(&comp->feedbacks, &feedback_len)) != NULL)
+	{
+		const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf feedback =
+			rohc_buf_init_full((uint8_t *) feedback_data, feedback_len, time);
+
+		if(!rohc_comp_deliver_feedback2(comp, feedback))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver %zu bytes of queued feedback",
+			             feedback_len);
+		}
+		ring_pop(&comp->feedbacks, feedback_len);
+		drained_len += RING_REC_HDR_LEN + feedback_len;
+	}
+}
+
+
 /**
  * @brief Parse ROHC feedback CID
  *
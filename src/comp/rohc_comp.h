@@ -55,11 +55,12 @@ extern "C"
 
 
 /*
- * Declare the private ROHC compressor structure that is defined inside the
+ * Declare the private ROHC compressor structures that are defined inside the
  * library.
  */
 
 struct rohc_comp;
+struct rohc_comp_sharded;
 
 
 /*
@@ -190,6 +191,8 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, uncomp_bytes_nr, and comp_bytes_nr.
+ *  - major 0 and minor = 1 added: flow_cache_lookups_nr and
+ *    flow_cache_hits_nr.
  *
  * @ingroup rohc_comp
  *
@@ -209,6 +212,11 @@ typedef struct
 	unsigned long uncomp_bytes_nr;
 	/** The number of compressed bytes produced by the compressor */
 	unsigned long comp_bytes_nr;
+	/** The number of contexts searched for in the cache of the latest flows */
+	unsigned long flow_cache_lookups_nr;
+	/** The number of contexts found in the cache of the latest flows, the hit
+	 *  rate is flow_cache_hits_nr / flow_cache_lookups_nr */
+	unsigned long flow_cache_hits_nr;
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
@@ -235,10 +243,53 @@ typedef enum
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
 	/** Allow periodic refreshes based on inter-packet time */
 	ROHC_COMP_FEATURE_TIME_BASED_REFRESHES = (1 << 4),
+	/** Find contexts with a fast non-cryptographic hash instead of SipHash
+	 *  (beware: only for trusted traffic, cannot be changed once packets
+	 *  were compressed) */
+	ROHC_COMP_FEATURE_FAST_HASH = (1 << 5),
 
 } rohc_comp_features_t;
 
 
+/** The maximum number of IP headers described by \ref rohc_comp_pkt_meta_t */
+#define ROHC_COMP_META_MAX_IP_HDRS  2U
+
+
+/**
+ * @brief The metadata of one uncompressed packet classified by the caller
+ *
+ * The structure is given to \ref rohc_compress_meta by applications that
+ * already parsed the packet headers, for example with the help of the NIC
+ * or of a virtual switch. The library then skips the parsing of the IP
+ * headers and the validation of IPv4 checksums.
+ *
+ * All offsets are given in bytes from the beginning of the uncompressed
+ * packet. The first IP header shall start the packet.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_meta
+ */
+typedef struct
+{
+	/** The number of IP headers (1 or 2) */
+	uint8_t ip_hdrs_nr;
+	/** The versions of the IP headers (4 or 6), outermost first */
+	uint8_t ip_versions[ROHC_COMP_META_MAX_IP_HDRS];
+	/** The offsets of the IP headers, outermost first */
+	uint16_t ip_offsets[ROHC_COMP_META_MAX_IP_HDRS];
+	/** The offset of the layer-4 header, after the IPv6 extension headers */
+	uint16_t l4_offset;
+	/** The IP protocol of the layer-4 header */
+	uint8_t l4_proto;
+	/** Whether \e flow_hash is set or not */
+	bool has_flow_hash;
+	/** The hash of the flow, the same for all the packets of the flow, only
+	 *  used as a hint to find the context of the flow faster */
+	uint32_t flow_hash;
+} rohc_comp_pkt_meta_t;
+
+
 /**
  * @brief The prototype of the RTP detection callback
  *
@@ -308,11 +359,35 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_traces_level(struct rohc_comp *const comp,
+                                            const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_compress_hdr(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_hdr,
+                                            size_t *const payload_offset,
+                                            size_t *const payload_len)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_meta(struct rohc_comp *const comp,
+                                             const struct rohc_buf uncomp_packet,
+                                             const rohc_comp_pkt_meta_t *const meta,
+                                             struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_compress_burst(struct rohc_comp *const comp,
+                                       const struct rohc_buf *const uncomp_packets,
+                                       struct rohc_buf *const rohc_packets,
+                                       rohc_status_t *const statuses,
+                                       const size_t packets_nr)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_comp_pad(struct rohc_comp *const comp,
                                         struct rohc_buf *const rohc_packet,
                                         const size_t min_pkt_len)
@@ -368,6 +443,12 @@ bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_allocator(struct rohc_comp *const comp,
+                                         rohc_alloc_cb_t alloc_cb,
+                                         rohc_free_cb_t free_cb,
+                                         void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
 	__attribute__((warn_unused_result));
@@ -376,6 +457,14 @@ bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_feedback_queue(struct rohc_comp *const comp,
+                                              const size_t queue_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_push_feedback(struct rohc_comp *const comp,
+                                         const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -427,6 +516,40 @@ const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state
 	__attribute__((warn_unused_result, const));
 
 
+/*
+ * Prototypes of public functions related to sharded compression
+ */
+
+struct rohc_comp_sharded * ROHC_EXPORT
+	rohc_comp_sharded_new(const rohc_cid_type_t cid_type,
+	                      const rohc_cid_t max_cid,
+	                      const size_t shards_nr,
+	                      const rohc_comp_random_cb_t rand_cb,
+	                      void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_sharded_free(struct rohc_comp_sharded *const sc);
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_sharded_get_shard(const struct rohc_comp_sharded *const sc,
+	                            const size_t shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_sharded_select(const struct rohc_comp_sharded *const sc,
+                                          const struct rohc_buf uncomp_packet,
+                                          size_t *const shard_idx)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_sharded_split_feedback(const struct rohc_comp_sharded *const sc,
+                                                  const struct rohc_buf feedback,
+                                                  struct rohc_buf *const shard_feedbacks)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_sharded_get_general_info(const struct rohc_comp_sharded *const sc,
+                                                    rohc_comp_general_info_t *const info)
+	__attribute__((warn_unused_result));
+
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -36,6 +36,8 @@
 #include "protocols/uncomp_pkt_hdrs.h"
 #include "feedback.h"
 #include "hashtable.h"
+#include "ring.h"
+#include "slab.h"
 
 #include <stdbool.h>
 
@@ -63,6 +65,33 @@
  *  before changing back the state to FO (periodic refreshes) */
 #define CHANGE_TO_FO_TIME  500U
 
+/** The maximum length of the static chain that a context caches for its IR
+ *  packets: every cached static chain takes 128 bytes with its length */
+#define ROHC_COMP_STATIC_CHAIN_MAX_LEN  127U
+
+/** The maximum length of the temporary variables that one profile uses while
+ *  encoding one single packet */
+#define ROHC_COMP_TMP_VARS_MAX_LEN  128U
+
+/** The max number of lengths of objects that one profile allocates with
+ *  \ref rohc_comp_ctxt_zalloc for the profile-specific part of a context:
+ *  the RFC3095 part and the UDP or RTP part */
+#define ROHC_COMP_CTXT_SLABS_PER_PROFILE  2U
+
+/** The max number of slabs for the profile-specific parts of the contexts,
+ *  one per length of object: enough for all the profiles of the library */
+#define ROHC_COMP_CTXT_SLABS_NR \
+	((ROHC_PROFILE_ID_MAJOR_MAX + 1U) * (ROHC_PROFILE_ID_MINOR_MAX + 1U) * \
+	 ROHC_COMP_CTXT_SLABS_PER_PROFILE)
+
+/** The number of compression contexts in one page of the table of contexts,
+ *  shall be a power of 2 */
+#define ROHC_COMP_CTXT_PAGE_LEN  64U
+
+/** The number of words of the summary of the released contexts: one bit per
+ *  64-bit word of the map of released contexts */
+#define ROHC_COMP_CTXT_FREE_WORDS_NR  (((ROHC_LARGE_CID_MAX + 1U) + 4095U) / 4096U)
+
 
 /** Print a warning trace for the given compression context */
 #define rohc_comp_warn(context, format, ...) \
@@ -79,7 +108,8 @@
 /** Dump a buffer for the given compression context */
 #define rohc_comp_dump_buf(context, descr, buf, buf_len) \
 	do { \
-		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
+		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0 && \
+		   rohc_trace_is_enabled((context)->compressor, ROHC_TRACE_DEBUG)) { \
 			rohc_dump_buf((context)->compressor->trace_callback, \
 			              (context)->compressor->trace_callback_priv, \
 			              ROHC_TRACE_COMP, ROHC_TRACE_DEBUG, \
@@ -101,6 +131,64 @@ struct rohc_comp_ctxt;
  */
 
 
+/**
+ * @brief The static chain of a compression context
+ *
+ * The static fields do not change for the whole life of a context, so the
+ * static chain is encoded once and copied into every following IR packet.
+ */
+struct rohc_comp_static_chain
+{
+	/** The encoded static chain */
+	uint8_t data[ROHC_COMP_STATIC_CHAIN_MAX_LEN];
+	/** The length of the encoded static chain, 0 if not cached yet */
+	uint8_t len;
+};
+
+
+/** The information collected about one uncompressed packet */
+struct rohc_comp_pkt
+{
+	/** The best compression profile for the packet */
+	const struct rohc_comp_profile *profile;
+	/** The fingerprint of the packet */
+	struct rohc_fingerprint fingerprint;
+	/** The hash of the fingerprint, 0 for the Uncompressed profile */
+	uint64_t fingerprint_hash;
+	/** The key of the flow of the packet, computed from the raw packet bytes
+	 *  before the headers are parsed */
+	uint32_t flow_key;
+	/** Whether the headers of the packet were classified already */
+	bool is_classified;
+	/** The information collected about the packet headers */
+	struct rohc_pkt_hdrs pkt_hdrs;
+};
+
+
+/** One entry of the flow cache of the compressor */
+struct rohc_comp_flow_cache_entry
+{
+	/** The key of the flow that the context compressed */
+	uint32_t flow_key;
+	/** The context that compressed the latest packet of the flow */
+	struct rohc_comp_ctxt *ctxt;
+	/** The layout of the headers of the latest packet of the flow, so that
+	 *  the next packets are checked against the context without being
+	 *  classified again */
+	rohc_comp_pkt_meta_t layout;
+};
+
+
+/** The number of packets of one burst that are handled at the same time:
+ *  packet i is compressed while the headers of packet i+2 are parsed and the
+ *  hash table slots of its context are prefetched */
+#define ROHC_COMP_BURST_STAGES  3U
+
+/** The number of entries of the flow cache in front of the hash table of
+ *  contexts, shall be a power of 2 */
+#define ROHC_COMP_FLOW_CACHE_SIZE  64U
+
+
 /**
  * @brief The ROHC compressor
  */
@@ -112,13 +200,45 @@ struct rohc_comp
 	/** Enabled/disabled features for the compressor */
 	rohc_comp_features_t features;
 
-	/** The array of compression contexts that use the compressor */
-	struct rohc_comp_ctxt *contexts;
-	/** The number of compression contexts in use in the array */
+	/** The pages of compression contexts, indexed by the slot of the CID
+	 *  among the CIDs of the compressor: one page is allocated only when one
+	 *  of its CIDs is used for the first time */
+	struct rohc_comp_ctxt **ctxt_pages;
+	/** The number of compression contexts in use */
 	uint16_t num_contexts_used;
+	/** The number of compression contexts that the compressor may use: all
+	 *  the CIDs up to MAX_CID, or only the ones of its shard if the
+	 *  compressor is one shard of a sharded compressor */
+	size_t ctxts_nr;
+	/** The slots of the released compression contexts, one bit per slot */
+	uint64_t *ctxts_free_map;
+	/** The words of ctxts_free_map that hold at least one released slot,
+	 *  one bit per word, so that the lowest released slot is found at once */
+	uint64_t ctxts_free_words[ROHC_COMP_CTXT_FREE_WORDS_NR];
+	/** The number of released compression contexts */
+	size_t ctxts_free_nr;
+	/** The slot of the next CID that the compressor never used, ctxts_nr if
+	 *  all the CIDs were used at least once */
+	size_t ctxts_next_slot;
+	/** The first CID that the compressor may use, the one of slot 0 */
+	size_t ctxts_cid_first;
+	/** The gap between two CIDs that the compressor may use */
+	size_t ctxts_cid_step;
+	/** The least recently used compression context, the next one to recycle */
+	struct rohc_comp_ctxt *ctxts_lru_oldest;
+	/** The most recently used compression context */
+	struct rohc_comp_ctxt *ctxts_lru_newest;
 	struct hashtable contexts_by_fingerprint;
 	struct hashtable contexts_cr;
 	struct rohc_comp_ctxt *uncompressed_ctxt;
+	/** The contexts that compressed the latest packets of the flows, indexed
+	 *  by the key of the flow computed before the headers are parsed */
+	struct rohc_comp_flow_cache_entry flow_cache[ROHC_COMP_FLOW_CACHE_SIZE];
+	/** The slabs of the profile-specific parts of the contexts, so that
+	 *  contexts are created and destroyed without the system allocator */
+	struct slab ctxt_slabs[ROHC_COMP_CTXT_SLABS_NR];
+	/** The number of slabs in use in the ctxt_slabs array */
+	size_t ctxt_slabs_nr;
 
 	/** Which profiles are enabled and with one are not? */
 	bool enabled_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
@@ -157,6 +277,22 @@ struct rohc_comp
 	/** The last context used by the compressor */
 	struct rohc_comp_ctxt *last_context;
 
+	/** The number of contexts searched for in the flow cache */
+	unsigned long flow_cache_lookups_nr;
+	/** The number of contexts found in the flow cache */
+	unsigned long flow_cache_hits_nr;
+
+	/** The feedback pushed by other threads, see rohc_comp_push_feedback() */
+	struct ring feedbacks;
+
+	/** The packets of the burst being compressed, see rohc_compress_burst() */
+	struct rohc_comp_pkt burst_pkts[ROHC_COMP_BURST_STAGES];
+
+	/** The temporary variables of the profile that encodes the current packet:
+	 *  they are valid during one single encoding, so all the contexts share
+	 *  them instead of embedding their own */
+	uint64_t tmp_vars[ROHC_COMP_TMP_VARS_MAX_LEN / sizeof(uint64_t)];
+
 
 	/* random callback */
 
@@ -166,6 +302,18 @@ struct rohc_comp
 	void *random_cb_ctxt;
 
 
+	/* memory callbacks */
+
+	/** The user-defined callback that reserves the memory of the slabs,
+	 *  NULL to use malloc() */
+	rohc_alloc_cb_t alloc_cb;
+	/** The user-defined callback that releases the memory of the slabs,
+	 *  NULL to use free() */
+	rohc_free_cb_t free_cb;
+	/** Private data that will be given to the memory callbacks */
+	void *alloc_priv;
+
+
 	/* user interaction variables: */
 
 	/** The nr of Optimistic Approach repetitions to gain transmission confidence */
@@ -192,6 +340,26 @@ struct rohc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
+};
+
+
+/**
+ * @brief The sharded ROHC compressor
+ *
+ * Every shard is a complete ROHC compressor that owns the CIDs equal to its
+ * index modulo the number of shards, so that the shards never share any
+ * context and may run on different cores without locking.
+ */
+struct rohc_comp_sharded
+{
+	/** The number of shards */
+	size_t shards_nr;
+	/** The shards, one ROHC compressor each */
+	struct rohc_comp **shards;
+	/** The seed of the keys of flows that select the shards */
+	uint32_t flow_key_seed;
 };
 
 
@@ -245,6 +413,9 @@ struct rohc_comp_profile
 	 *
 	 * @param context            The compression context
 	 * @param uncomp_pkt_hdrs    The uncompressed headers to encode
+	 * @param tmp_vars           The room for the temporary variables of the
+	 *                           profile, at most \ref ROHC_COMP_TMP_VARS_MAX_LEN
+	 *                           bytes valid for the current packet only
 	 * @param rohc_pkt           OUT: The ROHC packet
 	 * @param rohc_pkt_max_len   The maximum length of the ROHC packet
 	 * @param packet_type        OUT: The type of ROHC packet that is created
@@ -253,10 +424,11 @@ struct rohc_comp_profile
 	 */
 	int (*encode)(struct rohc_comp_ctxt *const context,
 	              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+	              void *const tmp_vars,
 	              uint8_t *const rohc_pkt,
 	              const size_t rohc_pkt_max_len,
 	              rohc_packet_t *const packet_type)
-		__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+		__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 	/**
 	 * @brief The handler used to warn the profile-specific part of the
@@ -277,10 +449,10 @@ struct rohc_comp_profile
  */
 struct rohc_comp_ctxt
 {
-	struct rohc_comp_ctxt *prev;
-	struct rohc_comp_ctxt *next;
-	struct rohc_comp_ctxt *prev_cr;
-	struct rohc_comp_ctxt *next_cr;
+	/** The cached hash of the fingerprint */
+	uint64_t fingerprint_hash;
+	/** The cached hash of the base fingerprint for Context Replication */
+	uint64_t fingerprint_hash_cr;
 
 	/** The fingerprint of the context */
 	struct rohc_fingerprint fingerprint;
@@ -289,6 +461,10 @@ struct rohc_comp_ctxt
 	int used;
 	/** The time when the context was last used (in seconds) */
 	uint64_t latest_used;
+	/** The previous (older) context in the LRU list */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The next (newer) context in the LRU list */
+	struct rohc_comp_ctxt *lru_next;
 
 	/** The context unique ID (CID) */
 	rohc_cid_t cid;
@@ -379,6 +555,24 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+int rohc_comp_copy_static_chain(const struct rohc_comp_ctxt *const context,
+                                const struct rohc_comp_static_chain *const static_chain,
+                                uint8_t *const rohc_data,
+                                const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+void rohc_comp_cache_static_chain(const struct rohc_comp_ctxt *const context,
+                                  struct rohc_comp_static_chain *const static_chain,
+                                  const uint8_t *const rohc_data,
+                                  const size_t static_chain_len)
+	__attribute__((nonnull(1, 2, 3)));
+
+void * rohc_comp_ctxt_zalloc(struct rohc_comp_ctxt *const context,
+                             const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_comp_ctxt_free(void *const ptr);
+
 bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    const uint8_t *const packet,
                                    const size_t packet_len,
@@ -58,7 +58,8 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const size_t oa_repetitions_nr,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void ip_header_info_free(struct ip_header_info *const header_info)
 	__attribute__((nonnull(1)));
@@ -384,6 +385,7 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
  * @param profile_id         The ID of the associated compression profile
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The minimum level of the traces to emit
  * @return                   true if successful, false otherwise
  */
 static bool ip_header_info_new(struct ip_header_info *const header_info,
@@ -391,7 +393,8 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
                                const size_t oa_repetitions_nr,
                                const int profile_id,
                                rohc_trace_callback2_t trace_cb,
-                               void *const trace_cb_priv)
+                               void *const trace_cb_priv,
+                               const rohc_trace_level_t trace_level)
 {
 	bool is_ok;
 
@@ -432,7 +435,8 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 
 		/* init the compression context for IPv6 extension header list */
 		rohc_comp_list_ipv6_new(&header_info->info.v6.ext_comp, oa_repetitions_nr,
-		                        profile_id, trace_cb, trace_cb_priv);
+		                        profile_id, trace_cb, trace_cb_priv,
+		                        trace_level);
 	}
 
 	return true;
@@ -534,7 +538,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
 	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = calloc(1, sizeof(struct rohc_comp_rfc3095_ctxt));
+	rfc3095_ctxt =
+		rohc_comp_ctxt_zalloc(context, sizeof(struct rohc_comp_rfc3095_ctxt));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -572,7 +577,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 		                       context->compressor->oa_repetitions_nr,
 		                       context->profile->id,
 		                       context->compressor->trace_callback,
-		                       context->compressor->trace_callback_priv))
+		                       context->compressor->trace_callback_priv,
+		                       context->compressor->trace_level))
 		{
 			goto free_header_info;
 		}
@@ -632,7 +638,7 @@ free_header_info:
 free_sn_window:
 	wlsb_free(&rfc3095_ctxt->sn_window);
 free_generic_context:
-	free(rfc3095_ctxt);
+	rohc_comp_ctxt_free(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -659,8 +665,8 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	wlsb_free(&rfc3095_ctxt->msn_non_acked);
 	wlsb_free(&rfc3095_ctxt->sn_window);
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+	rohc_comp_ctxt_free(rfc3095_ctxt->specific);
+	rohc_comp_ctxt_free(rfc3095_ctxt);
 }
 
 
@@ -682,6 +688,7 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
  *
  * @param context           The compression context
  * @param uncomp_pkt_hdrs   The uncompressed headers to encode
+ * @param tmp_vars          The temporary variables for the current packet
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
  * @param packet_type       OUT: The type of ROHC packet that is created
@@ -690,6 +697,7 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
  */
 int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                             void *const tmp_vars __attribute__((unused)),
                              uint8_t *const rohc_pkt,
                              const size_t rohc_pkt_max_len,
                              rohc_packet_t *const packet_type)
@@ -1544,13 +1552,28 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_pkt[counter] = 0;
 	counter++;
 
-	/* part 6: static part */
-	ret = rohc_code_static_part(context, uncomp_pkt_hdrs, rohc_pkt, counter);
+	/* part 6: static part, encoded once for all the IR packets of the context */
+	ret = rohc_comp_copy_static_chain(context, &rfc3095_ctxt->static_chain,
+	                                  rohc_pkt + counter, rohc_pkt_max_len - counter);
 	if(ret < 0)
 	{
 		goto error;
 	}
-	counter = ret;
+	else if(ret > 0)
+	{
+		counter += ret;
+	}
+	else
+	{
+		ret = rohc_code_static_part(context, uncomp_pkt_hdrs, rohc_pkt, counter);
+		if(ret < 0)
+		{
+			goto error;
+		}
+		rohc_comp_cache_static_chain(context, &rfc3095_ctxt->static_chain,
+		                             rohc_pkt + counter, ret - counter);
+		counter = ret;
+	}
 
 	/* part 7: if we do not want dynamic part in IR packet, we should not
 	 * send the following */
@@ -6112,62 +6135,58 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 
 	/* always update the info related to the SN */
 	{
+		struct c_wlsb_offsets sn_offsets;
 
 		rohc_comp_debug(context, "new SN = %u / 0x%x", rfc3095_ctxt->sn,
 		                rfc3095_ctxt->sn);
+
+		/* scan the W-LSB window only once, then check every number of bits */
+		wlsb_get_offsets_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+		                        &sn_offsets);
 		if(context->profile->id == ROHC_PROFILE_RTP)
 		{
 			rfc3095_ctxt->tmp.sn_4bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           4, rohc_interval_compute_p_rtp_sn(4));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 4, rohc_interval_compute_p_rtp_sn(4));
 			rfc3095_ctxt->tmp.sn_7bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           7, rohc_interval_compute_p_rtp_sn(7));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 7, rohc_interval_compute_p_rtp_sn(7));
 			rfc3095_ctxt->tmp.sn_12bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           12, rohc_interval_compute_p_rtp_sn(12));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 12, rohc_interval_compute_p_rtp_sn(12));
 
 			rfc3095_ctxt->tmp.sn_6bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           6, rohc_interval_compute_p_rtp_sn(6));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 6, rohc_interval_compute_p_rtp_sn(6));
 			rfc3095_ctxt->tmp.sn_9bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           9, rohc_interval_compute_p_rtp_sn(9));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 9, rohc_interval_compute_p_rtp_sn(9));
 			rfc3095_ctxt->tmp.sn_14bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           14, rohc_interval_compute_p_rtp_sn(14));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 14, rohc_interval_compute_p_rtp_sn(14));
 		}
 		else if(context->profile->id == ROHC_PROFILE_ESP)
 		{
+			struct c_wlsb_offsets sn32_offsets;
+
 			rfc3095_ctxt->tmp.sn_4bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           4, rohc_interval_compute_p_esp_sn(4));
+				wlsb_is_kp_possible_offsets(&sn_offsets, 4, rohc_interval_compute_p_esp_sn(4));
 
+			/* ESP SN is 32-bit long */
+			wlsb_get_offsets_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
+			                        &sn32_offsets);
 			rfc3095_ctxt->tmp.sn_5bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           5, rohc_interval_compute_p_esp_sn(5));
+				wlsb_is_kp_possible_offsets(&sn32_offsets, 5, rohc_interval_compute_p_esp_sn(5));
 			rfc3095_ctxt->tmp.sn_8bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           8, rohc_interval_compute_p_esp_sn(8));
+				wlsb_is_kp_possible_offsets(&sn32_offsets, 8, rohc_interval_compute_p_esp_sn(8));
 			rfc3095_ctxt->tmp.sn_13bits_possible =
-				wlsb_is_kp_possible_32bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           13, rohc_interval_compute_p_esp_sn(13));
+				wlsb_is_kp_possible_offsets(&sn32_offsets, 13, rohc_interval_compute_p_esp_sn(13));
 		}
 		else
 		{
 			rfc3095_ctxt->tmp.sn_4bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           4, ROHC_LSB_SHIFT_SN);
+				wlsb_is_kp_possible_offsets(&sn_offsets, 4, ROHC_LSB_SHIFT_SN);
 
 			rfc3095_ctxt->tmp.sn_5bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           5, ROHC_LSB_SHIFT_SN);
+				wlsb_is_kp_possible_offsets(&sn_offsets, 5, ROHC_LSB_SHIFT_SN);
 			rfc3095_ctxt->tmp.sn_8bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           8, ROHC_LSB_SHIFT_SN);
+				wlsb_is_kp_possible_offsets(&sn_offsets, 8, ROHC_LSB_SHIFT_SN);
 			rfc3095_ctxt->tmp.sn_13bits_possible =
-				wlsb_is_kp_possible_16bits(&rfc3095_ctxt->sn_window, rfc3095_ctxt->sn,
-				                           13, ROHC_LSB_SHIFT_SN);
+				wlsb_is_kp_possible_offsets(&sn_offsets, 13, ROHC_LSB_SHIFT_SN);
 		}
 		if(rfc3095_ctxt->tmp.sn_4bits_possible)
 		{
@@ -6257,31 +6276,23 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 			}
 			else
 			{
+				struct c_wlsb_offsets ip_id_offsets;
+
 				/* send only required bits in FO or SO states */
+				wlsb_get_offsets_16bits(&ip_ctxt->info.v4.ip_id_window,
+				                        ip_ctxt->info.v4.id_delta, &ip_id_offsets);
 				ip_changes->ip_id_changed =
-					!wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                            ip_ctxt->info.v4.id_delta,
-					                            0, ROHC_LSB_SHIFT_IP_ID);
+					!wlsb_is_kp_possible_offsets(&ip_id_offsets, 0, ROHC_LSB_SHIFT_IP_ID);
 				ip_changes->ip_id_3bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           3, ROHC_LSB_SHIFT_IP_ID);
+					wlsb_is_kp_possible_offsets(&ip_id_offsets, 3, ROHC_LSB_SHIFT_IP_ID);
 				ip_changes->ip_id_5bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           5, ROHC_LSB_SHIFT_IP_ID);
+					wlsb_is_kp_possible_offsets(&ip_id_offsets, 5, ROHC_LSB_SHIFT_IP_ID);
 				ip_changes->ip_id_6bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           6, ROHC_LSB_SHIFT_IP_ID);
+					wlsb_is_kp_possible_offsets(&ip_id_offsets, 6, ROHC_LSB_SHIFT_IP_ID);
 				ip_changes->ip_id_8bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           8, ROHC_LSB_SHIFT_IP_ID);
+					wlsb_is_kp_possible_offsets(&ip_id_offsets, 8, ROHC_LSB_SHIFT_IP_ID);
 				ip_changes->ip_id_11bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_ctxt->info.v4.id_delta,
-					                           11, ROHC_LSB_SHIFT_IP_ID);
+					wlsb_is_kp_possible_offsets(&ip_id_offsets, 11, ROHC_LSB_SHIFT_IP_ID);
 			}
 			rohc_comp_debug(context, "  %s bits are required to encode new IP-ID delta",
 			                ip_changes->ip_id_changed ? "some" : "no");
@@ -234,6 +234,9 @@ struct rohc_comp_rfc3095_ctxt
 	/** The cache for the CRC-7 value on CRC-STATIC fields */
 	uint8_t crc_static_7_cached;
 
+	/** The static chain encoded once for all the IR packets */
+	struct rohc_comp_static_chain static_chain;
+
 	/// Temporary variables that are used during one single compression of packet
 	struct generic_tmp_vars tmp;
 
@@ -332,10 +335,11 @@ rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context,
 
 int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                             void *const tmp_vars,
                              uint8_t *const rohc_pkt,
                              const size_t rohc_pkt_max_len,
                              rohc_packet_t *const packet_type)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 bool rohc_comp_rfc3095_feedback(struct rohc_comp_ctxt *const context,
                                 const enum rohc_feedback_type feedback_type,
@@ -47,12 +47,14 @@ static bool cmp_ipv6_ext(const struct rohc_list_item *const item,
  * @param profile_id         The ID of the associated decompression profile
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The minimum level of the traces to emit
  */
 void rohc_comp_list_ipv6_new(struct list_comp *const comp,
                              const size_t oa_repetitions_nr,
                              const int profile_id,
                              rohc_trace_callback2_t trace_cb,
-                             void *const trace_cb_priv)
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level)
 {
 	size_t i;
 
@@ -82,6 +84,7 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
 	/* traces */
 	comp->trace_callback = trace_cb;
 	comp->trace_callback_priv = trace_cb_priv;
+	comp->trace_level = trace_level;
 	comp->profile_id = profile_id;
 }
 
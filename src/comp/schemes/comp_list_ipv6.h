@@ -33,7 +33,8 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
                              const size_t oa_repetitions_nr,
                              const int profile_id,
                              rohc_trace_callback2_t trace_cb,
-                             void *const trace_cb_priv)
+                             void *const trace_cb_priv,
+                             const rohc_trace_level_t trace_level)
 	__attribute__((nonnull(1)));
 
 void rohc_comp_list_ipv6_free(struct list_comp *const comp)
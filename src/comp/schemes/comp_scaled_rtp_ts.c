@@ -38,6 +38,10 @@
 	           format, ##__VA_ARGS__)
 
 
+static size_t rohc_ts_sc_round_nr_bits(const size_t min_k)
+	__attribute__((warn_unused_result, const));
+
+
 /**
  * @brief Create the ts_sc_comp object
  *
@@ -47,12 +51,14 @@
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
+ * @param trace_level        The minimum level of the traces to emit
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
 {
 	bool is_ok;
 
@@ -73,6 +79,7 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
+	ts_sc->trace_level = trace_level;
 
 	/* W-LSB context for TS_SCALED */
 	is_ok = wlsb_new(&ts_sc->ts_scaled_wlsb, wlsb_window_width);
@@ -374,100 +381,11 @@ size_t nb_bits_unscaled(const struct ts_sc_comp *const ts_sc)
 {
 	size_t nr_ts_bits;
 
-	if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                              0, rohc_interval_compute_p_rtp_ts(0)))
-	{
-		nr_ts_bits = 0;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   5, rohc_interval_compute_p_rtp_ts(5)))
-	{
-		nr_ts_bits = 5;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   6, rohc_interval_compute_p_rtp_ts(6)))
-	{
-		nr_ts_bits = 6;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   7, rohc_interval_compute_p_rtp_ts(7)))
-	{
-		nr_ts_bits = 7;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   8, rohc_interval_compute_p_rtp_ts(8)))
-	{
-		nr_ts_bits = 8;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   9, rohc_interval_compute_p_rtp_ts(9)))
-	{
-		nr_ts_bits = 9;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   12, rohc_interval_compute_p_rtp_ts(12)))
-	{
-		nr_ts_bits = 12;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   13, rohc_interval_compute_p_rtp_ts(13)))
-	{
-		nr_ts_bits = 13;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   14, rohc_interval_compute_p_rtp_ts(14)))
-	{
-		nr_ts_bits = 14;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   16, rohc_interval_compute_p_rtp_ts(16)))
-	{
-		nr_ts_bits = 16;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   17, rohc_interval_compute_p_rtp_ts(17)))
-	{
-		nr_ts_bits = 17;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   19, rohc_interval_compute_p_rtp_ts(19)))
-	{
-		nr_ts_bits = 19;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   20, rohc_interval_compute_p_rtp_ts(20)))
-	{
-		nr_ts_bits = 20;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   21, rohc_interval_compute_p_rtp_ts(21)))
-	{
-		nr_ts_bits = 21;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   25, rohc_interval_compute_p_rtp_ts(25)))
-	{
-		nr_ts_bits = 25;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   26, rohc_interval_compute_p_rtp_ts(26)))
-	{
-		nr_ts_bits = 26;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   27, rohc_interval_compute_p_rtp_ts(27)))
-	{
-		nr_ts_bits = 27;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts,
-	                                   29, rohc_interval_compute_p_rtp_ts(29)))
-	{
-		nr_ts_bits = 29;
-	}
-	else
-	{
-		nr_ts_bits = 32;
-	}
+	/* the intervals of RTP TS grow with k, so the minimal k only needs to be
+	 * rounded up to the next number of bits that packets may transmit */
+	nr_ts_bits =
+		wlsb_get_minkp_32bits(&ts_sc->ts_unscaled_wlsb, ts_sc->ts, ROHC_LSB_SHIFT_RTP_TS);
+	nr_ts_bits = rohc_ts_sc_round_nr_bits(nr_ts_bits);
 
 	return nr_ts_bits;
 }
@@ -495,100 +413,11 @@ size_t nb_bits_scaled(const struct ts_sc_comp *const ts_sc)
 {
 	size_t nr_ts_bits;
 
-	if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                              0, rohc_interval_compute_p_rtp_ts(0)))
-	{
-		nr_ts_bits = 0;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   5, rohc_interval_compute_p_rtp_ts(5)))
-	{
-		nr_ts_bits = 5;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   6, rohc_interval_compute_p_rtp_ts(6)))
-	{
-		nr_ts_bits = 6;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   7, rohc_interval_compute_p_rtp_ts(7)))
-	{
-		nr_ts_bits = 7;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   8, rohc_interval_compute_p_rtp_ts(8)))
-	{
-		nr_ts_bits = 8;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   9, rohc_interval_compute_p_rtp_ts(9)))
-	{
-		nr_ts_bits = 9;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   12, rohc_interval_compute_p_rtp_ts(12)))
-	{
-		nr_ts_bits = 12;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   13, rohc_interval_compute_p_rtp_ts(13)))
-	{
-		nr_ts_bits = 13;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   14, rohc_interval_compute_p_rtp_ts(14)))
-	{
-		nr_ts_bits = 14;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   16, rohc_interval_compute_p_rtp_ts(16)))
-	{
-		nr_ts_bits = 16;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   17, rohc_interval_compute_p_rtp_ts(17)))
-	{
-		nr_ts_bits = 17;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   19, rohc_interval_compute_p_rtp_ts(19)))
-	{
-		nr_ts_bits = 19;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   20, rohc_interval_compute_p_rtp_ts(20)))
-	{
-		nr_ts_bits = 20;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   21, rohc_interval_compute_p_rtp_ts(21)))
-	{
-		nr_ts_bits = 21;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   25, rohc_interval_compute_p_rtp_ts(25)))
-	{
-		nr_ts_bits = 25;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   26, rohc_interval_compute_p_rtp_ts(26)))
-	{
-		nr_ts_bits = 26;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   27, rohc_interval_compute_p_rtp_ts(27)))
-	{
-		nr_ts_bits = 27;
-	}
-	else if(wlsb_is_kp_possible_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled,
-	                                   29, rohc_interval_compute_p_rtp_ts(29)))
-	{
-		nr_ts_bits = 29;
-	}
-	else
-	{
-		nr_ts_bits = 32;
-	}
+	/* the intervals of RTP TS grow with k, so the minimal k only needs to be
+	 * rounded up to the next number of bits that packets may transmit */
+	nr_ts_bits =
+		wlsb_get_minkp_32bits(&ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled, ROHC_LSB_SHIFT_RTP_TS);
+	nr_ts_bits = rohc_ts_sc_round_nr_bits(nr_ts_bits);
 
 	/* do not send 0 bit of TS if TS is not deducible, because decompressor
 	 * will interprets a 0-bit value as deducible */
@@ -661,3 +490,28 @@ bool rohc_ts_sc_is_deducible(const struct ts_sc_comp *const ts_sc)
 	return ts_sc->is_deducible;
 }
 
+
+/**
+ * @brief Round up a number of TS bits to one that packets may transmit
+ *
+ * @param min_k  The minimal number of TS bits required
+ * @return       The smallest number of TS bits that packets may transmit
+ *               and that is greater than or equal to \e min_k
+ */
+static size_t rohc_ts_sc_round_nr_bits(const size_t min_k)
+{
+	const size_t nr_bits[] =
+		{ 0, 5, 6, 7, 8, 9, 12, 13, 14, 16, 17, 19, 20, 21, 25, 26, 27, 29 };
+	size_t i;
+
+	for(i = 0; i < (sizeof(nr_bits) / sizeof(nr_bits[0])); i++)
+	{
+		if(nr_bits[i] >= min_k)
+		{
+			return nr_bits[i];
+		}
+	}
+
+	return 32;
+}
+
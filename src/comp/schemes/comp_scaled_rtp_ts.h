@@ -102,6 +102,8 @@ struct ts_sc_comp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -113,7 +115,8 @@ struct ts_sc_comp
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
                  const size_t wlsb_window_width,
                  rohc_trace_callback2_t trace_cb,
-                 void *const trace_cb_priv)
+                 void *const trace_cb_priv,
+                 const rohc_trace_level_t trace_level)
 	__attribute__((warn_unused_result, nonnull(1)));
 void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1)));
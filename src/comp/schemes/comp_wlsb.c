@@ -36,6 +36,36 @@
  * Private function prototypes:
  */
 
+static inline struct c_window * wlsb_get_entries(struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline const struct c_window *
+	wlsb_get_const_entries(const struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void wlsb_extend_refs(struct c_wlsb *const wlsb, const uint32_t value)
+	__attribute__((nonnull(1)));
+static void wlsb_update_refs(struct c_wlsb *const wlsb)
+	__attribute__((nonnull(1)));
+
+static bool wlsb_get_offsets_from_refs(const struct c_wlsb *const wlsb,
+                                       const uint32_t value,
+                                       const uint8_t bits_nr,
+                                       struct c_wlsb_offsets *const offsets)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static void wlsb_scan_offsets_8bits(const struct c_wlsb *const wlsb,
+                                    const uint8_t value,
+                                    struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+static void wlsb_scan_offsets_16bits(const struct c_wlsb *const wlsb,
+                                     const uint16_t value,
+                                     struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+static void wlsb_scan_offsets_32bits(const struct c_wlsb *const wlsb,
+                                     const uint32_t value,
+                                     struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+
 static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 	__attribute__((warn_unused_result, const));
 
@@ -48,6 +78,9 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
  * @brief Create a new Window-based Least Significant Bits (W-LSB) encoding
  *        object
  *
+ * Windows that are not wider than \ref ROHC_WLSB_WIDTH_INLINE entries are
+ * stored inline in the W-LSB object, wider windows are allocated.
+ *
  * @param[in,out] wlsb The W-LSB encoding object to create
  * @param window_width The number of entries in the window (power of 2)
  * @return             true if the W-LSB encoding object was created,
@@ -59,12 +92,17 @@ bool wlsb_new(struct c_wlsb *const wlsb,
 	assert(window_width > 0);
 	assert(window_width <= ROHC_WLSB_WIDTH_MAX);
 
-	wlsb->window = malloc(sizeof(struct c_window) * window_width);
-	if(wlsb->window == NULL)
+	if(window_width > ROHC_WLSB_WIDTH_INLINE)
 	{
-		goto error;
+		wlsb->window.heap = malloc(sizeof(struct c_window) * window_width);
+		if(wlsb->window.heap == NULL)
+		{
+			goto error;
+		}
 	}
 
+	wlsb->ref_min = 0;
+	wlsb->ref_max = 0;
 	wlsb->next = 0;
 	wlsb->count = 0;
 	wlsb->window_width = window_width;
@@ -88,18 +126,23 @@ error:
 bool wlsb_copy(struct c_wlsb *const dst,
                const struct c_wlsb *const src)
 {
-	const size_t window_mem_size = sizeof(struct c_window) * dst->window_width;
+	const size_t window_mem_size = sizeof(struct c_window) * src->window_width;
 
+	dst->ref_min = src->ref_min;
+	dst->ref_max = src->ref_max;
 	dst->next = src->next;
 	dst->count = src->count;
 	dst->window_width = src->window_width;
 
-	dst->window = malloc(window_mem_size);
-	if(dst->window == NULL)
+	if(dst->window_width > ROHC_WLSB_WIDTH_INLINE)
 	{
-		goto error;
+		dst->window.heap = malloc(window_mem_size);
+		if(dst->window.heap == NULL)
+		{
+			goto error;
+		}
 	}
-	memcpy(dst->window, src->window, window_mem_size);
+	memcpy(wlsb_get_entries(dst), wlsb_get_const_entries(src), window_mem_size);
 
 	return true;
 
@@ -115,13 +158,20 @@ error:
  */
 void wlsb_free(struct c_wlsb *const wlsb)
 {
-	free(wlsb->window);
+	if(wlsb->window_width > ROHC_WLSB_WIDTH_INLINE)
+	{
+		free(wlsb->window.heap);
+	}
 }
 
 
 /**
  * @brief Add a value into a W-LSB encoding object
  *
+ * The smallest and largest reference values of the window are updated
+ * incrementally. The window is scanned again only if the value that leaves
+ * the window was one of them.
+ *
  * @param wlsb  The W-LSB object
  * @param sn    The Sequence Number (SN) for the new entry
  * @param value The value to base the LSB coding on
@@ -130,22 +180,37 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value)
 {
+	struct c_window *const entries = wlsb_get_entries(wlsb);
+
 	if(wlsb->count == 0)
 	{
 		uint8_t i;
 		for(i = 0; i < wlsb->window_width; i++)
 		{
-			wlsb->window[i].sn = sn;
-			wlsb->window[i].value = value;
-			wlsb->next = 1;
+			entries[i].sn = sn;
+			entries[i].value = value;
 		}
+		wlsb->next = 1 % wlsb->window_width;
 		wlsb->count = wlsb->window_width;
+		wlsb->ref_min = value;
+		wlsb->ref_max = value;
 	}
 	else
 	{
-		wlsb->window[wlsb->next].sn = sn;
-		wlsb->window[wlsb->next].value = value;
+		const uint32_t old_value = entries[wlsb->next].value;
+
+		entries[wlsb->next].sn = sn;
+		entries[wlsb->next].value = value;
 		wlsb->next = (wlsb->next + 1) % wlsb->window_width;
+
+		if(old_value == wlsb->ref_min || old_value == wlsb->ref_max)
+		{
+			wlsb_update_refs(wlsb);
+		}
+		else
+		{
+			wlsb_extend_refs(wlsb, value);
+		}
 	}
 }
 
@@ -166,63 +231,11 @@ bool wlsb_is_kp_possible_8bits(const struct c_wlsb *const wlsb,
                                const size_t k,
                                const rohc_lsb_shift_t p)
 {
-	const uint8_t max_bits_nr = 8;
-	bool enc_possible = false;
+	struct c_wlsb_offsets offsets;
 
-	assert(k <= max_bits_nr);
+	wlsb_get_offsets_8bits(wlsb, value, &offsets);
 
-	if(k == max_bits_nr)
-	{
-		enc_possible = true;
-	}
-	/* use all bits if the window contains no value */
-	else if(wlsb->count == 0)
-	{
-		enc_possible = !!(k == max_bits_nr);
-	}
-	else
-	{
-		const uint8_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
-		size_t i;
-
-		enc_possible = true;
-
-		/* find the minimal number of bits of the value required to be able
-		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
-		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint8_t v_ref = entry->value;
-
-			/* compute the minimal and maximal values of the interval:
-			 *   min = v_ref - p
-			 *   max = v_ref + interval_with - p
-			 *
-			 * Straddling the lower and upper wraparound boundaries
-			 * is handled without additional operation */
-			const uint8_t min = v_ref - p;
-			const uint8_t max = min + interval_width;
-
-			if(min <= max)
-			{
-				/* interpretation interval does not straddle field boundaries,
-				 * check if value is in [min, max] */
-				if(value < min || value > max)
-				{
-					enc_possible = false;
-				}
-			}
-			else
-			{
-				if(value < min && value > max)
-				{
-					enc_possible = false;
-				}
-			}
-		}
-	}
-
-	return enc_possible;
+	return wlsb_is_kp_possible_offsets(&offsets, k, p);
 }
 
 
@@ -242,65 +255,11 @@ bool wlsb_is_kp_possible_16bits(const struct c_wlsb *const wlsb,
                                 const size_t k,
                                 const rohc_lsb_shift_t p)
 {
-	const uint8_t max_bits_nr = 16;
-	bool enc_possible = false;
+	struct c_wlsb_offsets offsets;
 
-	assert(k <= max_bits_nr);
+	wlsb_get_offsets_16bits(wlsb, value, &offsets);
 
-	if(k == max_bits_nr)
-	{
-		enc_possible = true;
-	}
-	/* use all bits if the window contains no value */
-	else if(wlsb->count == 0)
-	{
-		enc_possible = !!(k == max_bits_nr);
-	}
-	else
-	{
-		const uint16_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
-		size_t i;
-
-		enc_possible = true;
-
-		/* find the minimal number of bits of the value required to be able
-		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
-		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint16_t v_ref = entry->value;
-
-			/* compute the minimal and maximal values of the interval:
-			 *   min = v_ref - p
-			 *   max = v_ref + interval_with - p
-			 *
-			 * Straddling the lower and upper wraparound boundaries
-			 * is handled without additional operation */
-			const uint16_t min = v_ref - p;
-			const uint16_t max = min + interval_width;
-
-			if(min <= max)
-			{
-				/* interpretation interval does not straddle field boundaries,
-				 * check if value is in [min, max] */
-				if(value < min || value > max)
-				{
-					enc_possible = false;
-				}
-			}
-			else
-			{
-				/* the interpretation interval does straddle the field boundaries,
-				 * check if value is in [min, 0xffff] or [0, max] */
-				if(value < min && value > max)
-				{
-					enc_possible = false;
-				}
-			}
-		}
-	}
-
-	return enc_possible;
+	return wlsb_is_kp_possible_offsets(&offsets, k, p);
 }
 
 
@@ -320,63 +279,190 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
                                 const size_t k,
                                 const rohc_lsb_shift_t p)
 {
-	const uint8_t max_bits_nr = 32;
-	bool enc_possible = false;
+	struct c_wlsb_offsets offsets;
 
-	assert(k <= max_bits_nr);
+	wlsb_get_offsets_32bits(wlsb, value, &offsets);
 
-	if(k == max_bits_nr)
+	return wlsb_is_kp_possible_offsets(&offsets, k, p);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 8-bit fields.
+ *
+ * The offsets are computed from the smallest and largest reference values
+ * of the window. The window is scanned only if they are too far apart. The
+ * offsets may then be used to find out whether several numbers of bits k
+ * and shift parameters p may encode the value, see
+ * \ref wlsb_is_kp_possible_offsets.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+void wlsb_get_offsets_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            struct c_wlsb_offsets *const offsets)
+{
+	if(!wlsb_get_offsets_from_refs(wlsb, value, 8, offsets))
 	{
-		enc_possible = true;
+		wlsb_scan_offsets_8bits(wlsb, value, offsets);
 	}
-	/* use all bits if the window contains no value */
-	else if(wlsb->count == 0)
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 16-bit fields.
+ *
+ * The offsets are computed from the smallest and largest reference values
+ * of the window. The window is scanned only if they are too far apart. The
+ * offsets may then be used to find out whether several numbers of bits k
+ * and shift parameters p may encode the value, see
+ * \ref wlsb_is_kp_possible_offsets.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+void wlsb_get_offsets_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             struct c_wlsb_offsets *const offsets)
+{
+	if(!wlsb_get_offsets_from_refs(wlsb, value, 16, offsets))
 	{
-		enc_possible = !!(k == max_bits_nr);
+		wlsb_scan_offsets_16bits(wlsb, value, offsets);
 	}
-	else
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 32-bit fields.
+ *
+ * The offsets are computed from the smallest and largest reference values
+ * of the window. The window is scanned only if they are too far apart. The
+ * offsets may then be used to find out whether several numbers of bits k
+ * and shift parameters p may encode the value, see
+ * \ref wlsb_is_kp_possible_offsets.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+void wlsb_get_offsets_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             struct c_wlsb_offsets *const offsets)
+{
+	if(!wlsb_get_offsets_from_refs(wlsb, value, 32, offsets))
 	{
-		const uint32_t interval_width = (1U << k) - 1; /* interval width = 2^k - 1 */
-		size_t i;
+		wlsb_scan_offsets_32bits(wlsb, value, offsets);
+	}
+}
 
-		enc_possible = true;
 
-		/* find the minimal number of bits of the value required to be able
-		 * to recreate it thanks to ANY value in the window */
-		for(i = 0; i < wlsb->window_width; i++)
+/**
+ * @brief Get the minimal number of bits required to encode value
+ *
+ * The function is dedicated to 8-bit fields.
+ *
+ * The window is scanned at most once, whatever the number of bits required.
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p, may be one of the special
+ *               ROHC_LSB_SHIFT_RTP_* values that depend on k
+ * @return       The smallest number of bits k that is enough for encoding
+ */
+size_t wlsb_get_minkp_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            const rohc_lsb_shift_t p)
+{
+	struct c_wlsb_offsets offsets;
+
+	wlsb_get_offsets_8bits(wlsb, value, &offsets);
+
+	return wlsb_get_minkp_offsets(&offsets, p);
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode value
+ *
+ * The function is dedicated to 16-bit fields.
+ *
+ * The window is scanned at most once, whatever the number of bits required.
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p, may be one of the special
+ *               ROHC_LSB_SHIFT_RTP_* values that depend on k
+ * @return       The smallest number of bits k that is enough for encoding
+ */
+size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             const rohc_lsb_shift_t p)
+{
+	struct c_wlsb_offsets offsets;
+
+	wlsb_get_offsets_16bits(wlsb, value, &offsets);
+
+	return wlsb_get_minkp_offsets(&offsets, p);
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode value
+ *
+ * The function is dedicated to 32-bit fields.
+ *
+ * The window is scanned at most once, whatever the number of bits required.
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The value to encode using the LSB algorithm
+ * @param p      The shift parameter p, may be one of the special
+ *               ROHC_LSB_SHIFT_RTP_* values that depend on k
+ * @return       The smallest number of bits k that is enough for encoding
+ */
+size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p)
+{
+	struct c_wlsb_offsets offsets;
+
+	wlsb_get_offsets_32bits(wlsb, value, &offsets);
+
+	return wlsb_get_minkp_offsets(&offsets, p);
+}
+
+
+/**
+ * @brief Get the minimal number of bits required to encode value
+ *
+ * @param offsets  The offsets between the value and the W-LSB window
+ * @param p        The shift parameter p, may be one of the special
+ *                 ROHC_LSB_SHIFT_RTP_* values that depend on k
+ * @return         The smallest number of bits k that is enough for encoding
+ */
+size_t wlsb_get_minkp_offsets(const struct c_wlsb_offsets *const offsets,
+                              const rohc_lsb_shift_t p)
+{
+	size_t k;
+
+	/* the window is not scanned anymore, so testing every k is cheap */
+	for(k = 0; k < offsets->bits_nr; k++)
+	{
+		if(wlsb_is_kp_possible_offsets(offsets, k, rohc_interval_compute_p(k, p)))
 		{
-			const struct c_window *const entry = wlsb->window + i;
-			const uint32_t v_ref = entry->value;
-
-			/* compute the minimal and maximal values of the interval:
-			 *   min = v_ref - p
-			 *   max = v_ref + interval_with - p
-			 *
-			 * Straddling the lower and upper wraparound boundaries
-			 * is handled without additional operation */
-			const uint32_t min = v_ref - p;
-			const uint32_t max = min + interval_width;
-
-			if(min <= max)
-			{
-				/* interpretation interval does not straddle field boundaries,
-				 * check if value is in [min, max] */
-				if(value < min || value > max)
-				{
-					enc_possible = false;
-				}
-			}
-			else
-			{
-				if(value < min && value > max)
-				{
-					enc_possible = false;
-				}
-			}
+			break;
 		}
 	}
 
-	return enc_possible;
+	return k;
 }
 
 
@@ -395,11 +481,12 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
 {
+	struct c_window *const entries = wlsb_get_entries(wlsb);
 	size_t entry = wlsb->next;
 	uint32_t sn_mask;
 	bool do_remove = false;
-	uint32_t sn = wlsb->window[entry].sn;
-	uint32_t value = wlsb->window[entry].value;
+	uint32_t sn = entries[entry].sn;
+	uint32_t value = entries[entry].value;
 	uint8_t i;
 	size_t acked_nr = 0;
 
@@ -419,19 +506,26 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
 		if(do_remove)
 		{
-			wlsb->window[entry].sn = sn;
-			wlsb->window[entry].value = value;
+			entries[entry].sn = sn;
+			entries[entry].value = value;
 			acked_nr++;
 		}
-		else if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+		else if((entries[entry].sn & sn_mask) == sn_bits)
 		{
 			/* remove all the older window entries */
 			do_remove = true;
-			sn = wlsb->window[entry].sn;
-			value = wlsb->window[entry].value;
+			sn = entries[entry].sn;
+			value = entries[entry].value;
 		}
 	}
 
+	/* the removed entries might have been the smallest or the largest
+	 * reference values of the window */
+	if(acked_nr > 0)
+	{
+		wlsb_update_refs(wlsb);
+	}
+
 	return acked_nr;
 }
 
@@ -445,6 +539,7 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
  */
 bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
 {
+	const struct c_window *const entries = wlsb_get_const_entries(wlsb);
 	size_t entry = wlsb->next;
 	size_t i;
 
@@ -453,11 +548,11 @@ bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
 	for(i = 0; i < wlsb->count; i++)
 	{
 		entry = wlsb_get_next_older(entry, wlsb->window_width - 1);
-		if(sn == wlsb->window[entry].sn)
+		if(sn == entries[entry].sn)
 		{
 			return true;
 		}
-		else if(sn > wlsb->window[entry].sn)
+		else if(sn > entries[entry].sn)
 		{
 			return false;
 		}
@@ -472,6 +567,289 @@ bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
  */
 
 
+/**
+ * @brief Get the entries of the window, whether they are inline or not
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The entries of the window
+ */
+static inline struct c_window * wlsb_get_entries(struct c_wlsb *const wlsb)
+{
+	return (wlsb->window_width > ROHC_WLSB_WIDTH_INLINE ?
+	        wlsb->window.heap : wlsb->window.entries);
+}
+
+
+/**
+ * @brief Get the entries of the window, whether they are inline or not
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The entries of the window
+ */
+static inline const struct c_window *
+	wlsb_get_const_entries(const struct c_wlsb *const wlsb)
+{
+	return (wlsb->window_width > ROHC_WLSB_WIDTH_INLINE ?
+	        wlsb->window.heap : wlsb->window.entries);
+}
+
+
+/**
+ * @brief Extend the reference values of the window with one new value
+ *
+ * The range [ref_min ; ref_max] is extended on the side that keeps it the
+ * smallest. The range bounds remain values of the window.
+ *
+ * @param wlsb   The W-LSB object
+ * @param value  The new value of the window
+ */
+static void wlsb_extend_refs(struct c_wlsb *const wlsb, const uint32_t value)
+{
+	const uint32_t spread = wlsb->ref_max - wlsb->ref_min;
+	const uint32_t offset = value - wlsb->ref_min;
+
+	if(offset > spread)
+	{
+		/* value is outside of the range: extend the range up to the value,
+		 * or down to the value, whichever is the shortest */
+		if((offset - spread) <= (wlsb->ref_min - value))
+		{
+			wlsb->ref_max = value;
+		}
+		else
+		{
+			wlsb->ref_min = value;
+		}
+	}
+}
+
+
+/**
+ * @brief Compute the reference values of the window again
+ *
+ * The values of the window are compared with the most recent one, so the
+ * range [ref_min ; ref_max] is the smallest one as long as the values of
+ * the window are less than 2^31 away from the most recent one.
+ *
+ * @param wlsb  The W-LSB object
+ */
+static void wlsb_update_refs(struct c_wlsb *const wlsb)
+{
+	const struct c_window *const entries = wlsb_get_const_entries(wlsb);
+	const size_t newest = wlsb_get_next_older(wlsb->next, wlsb->window_width - 1);
+	const uint32_t newest_value = entries[newest].value;
+	int32_t delta_min = 0;
+	int32_t delta_max = 0;
+	size_t i;
+
+	for(i = 0; i < wlsb->window_width; i++)
+	{
+		const int32_t delta = (int32_t) (entries[i].value - newest_value);
+
+		delta_min = (delta < delta_min ? delta : delta_min);
+		delta_max = (delta > delta_max ? delta : delta_max);
+	}
+
+	wlsb->ref_min = newest_value + ((uint32_t) delta_min);
+	wlsb->ref_max = newest_value + ((uint32_t) delta_max);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the reference values
+ *
+ * The offsets between the value and the values of the window are all in
+ * the range [value - ref_max ; value - ref_min] modulo 2^bits_nr, and both
+ * range bounds are offsets of actual window values. If the range is shorter
+ * than half the field length, checking it against an interpretation interval
+ * gives the same result as checking every value of the window, even if the
+ * range straddles one of the wraparound boundaries: the interpretation
+ * interval cannot contain both range bounds without containing the whole
+ * range.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param bits_nr       The length (in bits) of the encoded field
+ * @param[out] offsets  The offsets between the value and the window
+ * @return              true if the offsets were computed,
+ *                      false if the window shall be scanned instead
+ */
+static bool wlsb_get_offsets_from_refs(const struct c_wlsb *const wlsb,
+                                       const uint32_t value,
+                                       const uint8_t bits_nr,
+                                       struct c_wlsb_offsets *const offsets)
+{
+	const uint64_t field_max = (((uint64_t) 1) << bits_nr) - 1;
+	const uint64_t field_half = ((uint64_t) 1) << (bits_nr - 1);
+	const uint32_t spread = wlsb->ref_max - wlsb->ref_min;
+	uint64_t umin;
+	uint64_t umin_shifted;
+
+	if(spread >= field_half)
+	{
+		return false;
+	}
+
+	/* offsets seen as unsigned numbers */
+	umin = ((uint64_t) (value - wlsb->ref_max)) & field_max;
+	if((umin + spread) <= field_max)
+	{
+		offsets->umin = umin;
+		offsets->umax = umin + spread;
+	}
+	else
+	{
+		/* the range straddles the unsigned wraparound boundary, the smallest
+		 * and largest unsigned offsets are not known, but no interpretation
+		 * interval that does not straddle the boundary may contain them */
+		offsets->umin = 0;
+		offsets->umax = field_max;
+	}
+
+	/* offsets seen as signed numbers */
+	umin_shifted = (umin + field_half) & field_max;
+	if((umin_shifted + spread) <= field_max)
+	{
+		offsets->smin = ((int64_t) umin_shifted) - ((int64_t) field_half);
+		offsets->smax = offsets->smin + ((int64_t) spread);
+	}
+	else
+	{
+		/* same as above with the signed wraparound boundary */
+		offsets->smin = -((int64_t) field_half);
+		offsets->smax = field_half - 1;
+	}
+
+	offsets->bits_nr = bits_nr;
+	offsets->is_empty = !!(wlsb->count == 0);
+
+	return true;
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 8-bit fields. The window is scanned once.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+static void wlsb_scan_offsets_8bits(const struct c_wlsb *const wlsb,
+                                    const uint8_t value,
+                                    struct c_wlsb_offsets *const offsets)
+{
+	const struct c_window *const entries = wlsb_get_const_entries(wlsb);
+	uint8_t umin = UINT8_MAX;
+	uint8_t umax = 0;
+	int8_t smin = INT8_MAX;
+	int8_t smax = INT8_MIN;
+	size_t i;
+
+	/* branch-free min/max reduction over the window entries */
+	for(i = 0; i < wlsb->window_width; i++)
+	{
+		const uint8_t offset = value - ((uint8_t) entries[i].value);
+		const int8_t soffset = (int8_t) offset;
+
+		umin = (offset < umin ? offset : umin);
+		umax = (offset > umax ? offset : umax);
+		smin = (soffset < smin ? soffset : smin);
+		smax = (soffset > smax ? soffset : smax);
+	}
+
+	offsets->umin = umin;
+	offsets->umax = umax;
+	offsets->smin = smin;
+	offsets->smax = smax;
+	offsets->bits_nr = 8;
+	offsets->is_empty = !!(wlsb->count == 0);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 16-bit fields. The window is scanned once.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+static void wlsb_scan_offsets_16bits(const struct c_wlsb *const wlsb,
+                                     const uint16_t value,
+                                     struct c_wlsb_offsets *const offsets)
+{
+	const struct c_window *const entries = wlsb_get_const_entries(wlsb);
+	uint16_t umin = UINT16_MAX;
+	uint16_t umax = 0;
+	int16_t smin = INT16_MAX;
+	int16_t smax = INT16_MIN;
+	size_t i;
+
+	/* branch-free min/max reduction over the window entries */
+	for(i = 0; i < wlsb->window_width; i++)
+	{
+		const uint16_t offset = value - ((uint16_t) entries[i].value);
+		const int16_t soffset = (int16_t) offset;
+
+		umin = (offset < umin ? offset : umin);
+		umax = (offset > umax ? offset : umax);
+		smin = (soffset < smin ? soffset : smin);
+		smax = (soffset > smax ? soffset : smax);
+	}
+
+	offsets->umin = umin;
+	offsets->umax = umax;
+	offsets->smin = smin;
+	offsets->smax = smax;
+	offsets->bits_nr = 16;
+	offsets->is_empty = !!(wlsb->count == 0);
+}
+
+
+/**
+ * @brief Compute the offsets between one value and the values of a window
+ *
+ * The function is dedicated to 32-bit fields. The window is scanned once.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param[out] offsets  The offsets between the value and the window
+ */
+static void wlsb_scan_offsets_32bits(const struct c_wlsb *const wlsb,
+                                     const uint32_t value,
+                                     struct c_wlsb_offsets *const offsets)
+{
+	const struct c_window *const entries = wlsb_get_const_entries(wlsb);
+	uint32_t umin = UINT32_MAX;
+	uint32_t umax = 0;
+	int32_t smin = INT32_MAX;
+	int32_t smax = INT32_MIN;
+	size_t i;
+
+	/* branch-free min/max reduction over the window entries */
+	for(i = 0; i < wlsb->window_width; i++)
+	{
+		const uint32_t offset = value - ((uint32_t) entries[i].value);
+		const int32_t soffset = (int32_t) offset;
+
+		umin = (offset < umin ? offset : umin);
+		umax = (offset > umax ? offset : umax);
+		smin = (soffset < smin ? soffset : smin);
+		smax = (soffset > smax ? soffset : smax);
+	}
+
+	offsets->umin = umin;
+	offsets->umax = umax;
+	offsets->smin = smin;
+	offsets->smax = smax;
+	offsets->bits_nr = 32;
+	offsets->is_empty = !!(wlsb->count == 0);
+}
+
+
 /**
  * @brief Get the next older entry
  *
@@ -483,4 +861,3 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 {
 	return ((entry == 0) ? max : (entry - 1));
 }
-
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <assert.h>
 
 
 /*
@@ -62,13 +63,33 @@ _Static_assert((sizeof(struct c_window) % 8) == 0,
 #endif
 
 
+/**
+ * @brief The largest window width that is stored inline in the W-LSB object
+ *
+ * Wider windows are allocated separately.
+ */
+#define ROHC_WLSB_WIDTH_INLINE  8U
+
+
 /**
  * @brief One W-LSB encoding object
  */
 struct c_wlsb
 {
 	/** The window in which previous values of the encoded value are stored */
-	struct c_window *window;
+	union
+	{
+		/** The entries of the window, if not wider than ROHC_WLSB_WIDTH_INLINE */
+		struct c_window entries[ROHC_WLSB_WIDTH_INLINE];
+		/** The entries of the window, if wider than ROHC_WLSB_WIDTH_INLINE */
+		struct c_window *heap;
+	} window;
+
+	/** The smallest reference value of the window, the window values are all
+	 *  in the range [ref_min ; ref_max] modulo 2^32 */
+	uint32_t ref_min;
+	/** The largest reference value of the window */
+	uint32_t ref_max;
 
 	/** The width of the window */
 	uint8_t window_width; /* TODO: R-mode needs a non-fixed window width */
@@ -87,11 +108,38 @@ struct c_wlsb
       (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
 _Static_assert((offsetof(struct c_wlsb, window) % 8) == 0,
                "window in c_wlsb should be aligned on 8 bytes");
+_Static_assert((offsetof(struct c_wlsb, ref_min) % 8) == 0,
+               "ref_min in c_wlsb should be aligned on 8 bytes");
 _Static_assert((sizeof(struct c_wlsb) % 8) == 0,
                "c_wlsb length should be multiple of 8 bytes");
 #endif
 
 
+/**
+ * @brief The offsets between one value and the values of a W-LSB window
+ *
+ * The offsets are computed from the smallest and largest reference values
+ * of the window, or in one single pass over the window if the reference
+ * values are too far apart. They are then enough to find out whether any
+ * number of bits k with any shift parameter p may encode the value.
+ *
+ * The offsets are the differences between the value and every value of the
+ * window, modulo the field length. Their bounds are kept twice, once with the
+ * offsets seen as unsigned numbers, once with the offsets seen as signed
+ * numbers, because the interpretation interval of every k < bits_nr
+ * straddles at most one of the two wraparound boundaries.
+ */
+struct c_wlsb_offsets
+{
+	uint32_t umin;    /**< The smallest offset, offsets seen as unsigned */
+	uint32_t umax;    /**< The largest offset, offsets seen as unsigned */
+	int32_t smin;     /**< The smallest offset, offsets seen as signed */
+	int32_t smax;     /**< The largest offset, offsets seen as signed */
+	uint8_t bits_nr;  /**< The length (in bits) of the encoded field */
+	bool is_empty;    /**< Whether the window contained no value */
+};
+
+
 
 /*
  * Public function prototypes:
@@ -129,6 +177,45 @@ bool wlsb_is_kp_possible_32bits(const struct c_wlsb *const wlsb,
                                 const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+void wlsb_get_offsets_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+
+void wlsb_get_offsets_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+
+void wlsb_get_offsets_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             struct c_wlsb_offsets *const offsets)
+	__attribute__((nonnull(1, 3)));
+
+size_t wlsb_get_minkp_8bits(const struct c_wlsb *const wlsb,
+                            const uint8_t value,
+                            const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
+                             const uint16_t value,
+                             const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
+                             const uint32_t value,
+                             const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+size_t wlsb_get_minkp_offsets(const struct c_wlsb_offsets *const offsets,
+                              const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static inline bool wlsb_is_kp_possible_offsets(const struct c_wlsb_offsets *const offsets,
+                                               const size_t k,
+                                               const int32_t p)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
 size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
@@ -137,5 +224,63 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 bool wlsb_is_sn_present(struct c_wlsb *const wlsb, const uint32_t sn)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+
+/**
+ * @brief Find out whether the given number of bits is enough to encode value
+ *
+ * The function is equivalent to the wlsb_is_kp_possible_*bits() functions,
+ * but it does not scan the W-LSB window: it works on the offsets computed
+ * by the wlsb_get_offsets_*bits() functions.
+ *
+ * @param offsets  The offsets between the value and the W-LSB window
+ * @param k        The number of bits for encoding
+ * @param p        The shift parameter p (the real value, not the special
+ *                 ROHC_LSB_SHIFT_RTP_* ones)
+ * @return         true if the number of bits is enough for encoding or not
+ */
+static inline bool wlsb_is_kp_possible_offsets(const struct c_wlsb_offsets *const offsets,
+                                               const size_t k,
+                                               const int32_t p)
+{
+	const uint64_t field_max = (((uint64_t) 1) << offsets->bits_nr) - 1;
+	bool enc_possible;
+
+	assert(k <= offsets->bits_nr);
+
+	if(k == offsets->bits_nr)
+	{
+		enc_possible = true;
+	}
+	/* use all bits if the window contains no value */
+	else if(offsets->is_empty)
+	{
+		enc_possible = false;
+	}
+	else
+	{
+		/* the interpretation interval of the offsets is [-p, 2^k - 1 - p]
+		 * modulo the field length */
+		const uint64_t min = ((uint64_t) -((int64_t) p)) & field_max;
+		const uint64_t max = min + (((uint64_t) 1) << k) - 1;
+
+		if(max <= field_max)
+		{
+			/* the interval does not straddle the wraparound boundary of the
+			 * unsigned offsets */
+			enc_possible = (offsets->umin >= min && offsets->umax <= max);
+		}
+		else
+		{
+			/* the interval straddles the wraparound boundary of the unsigned
+			 * offsets, so it does not straddle the one of the signed offsets */
+			enc_possible =
+				(offsets->smin >= (((int64_t) min) - ((int64_t) field_max) - 1) &&
+				 offsets->smax <= (((int64_t) max) - ((int64_t) field_max) - 1));
+		}
+	}
+
+	return enc_possible;
+}
+
 #endif
 
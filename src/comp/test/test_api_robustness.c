@@ -26,6 +26,7 @@
 #include "rohc_comp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -52,6 +53,11 @@ static int random_cb(const struct rohc_comp *const comp,
                      void *const user_context)
 	__attribute__((warn_unused_result));
 
+static void * test_alloc(void *const priv_ctxt, const size_t size)
+	__attribute__((warn_unused_result));
+
+static void test_free(void *const priv_ctxt, void *const ptr);
+
 
 /**
  * @brief Test the robustness of the compression API
@@ -63,6 +69,7 @@ static int random_cb(const struct rohc_comp *const comp,
 int main(int argc, char *argv[])
 {
 	struct rohc_comp *comp;
+	size_t chunks_nr = 0; /* the chunks reserved by the compressor */
 	bool verbose; /* whether to run in verbose mode or not */
 	int is_failure = 1; /* test fails by default */
 
@@ -121,6 +128,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_traces_level() */
+	CHECK(rohc_comp_set_traces_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_comp_set_traces_level(comp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_comp_set_traces_level(comp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_comp_set_traces_level(comp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -262,6 +275,13 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_set_allocator() */
+	CHECK(rohc_comp_set_allocator(NULL, test_alloc, test_free, &chunks_nr) == false);
+	CHECK(rohc_comp_set_allocator(comp, test_alloc, NULL, &chunks_nr) == false);
+	CHECK(rohc_comp_set_allocator(comp, NULL, test_free, &chunks_nr) == false);
+	CHECK(rohc_comp_set_allocator(comp, NULL, NULL, NULL) == true);
+	CHECK(rohc_comp_set_allocator(comp, test_alloc, test_free, &chunks_nr) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -353,6 +373,54 @@ int main(int argc, char *argv[])
 		pkt2.offset = 0;
 		pkt2.len = 0;
 		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+
+		/* rohc_compress_hdr() */
+		{
+			uint8_t hdr_buf[100];
+			struct rohc_buf hdr = rohc_buf_init_empty(hdr_buf, 100);
+			size_t payload_offset;
+			size_t payload_len;
+
+			CHECK(rohc_compress_hdr(NULL, pkt, &hdr, &payload_offset,
+			                        &payload_len) == ROHC_STATUS_ERROR);
+			pkt1.len = 0;
+			CHECK(rohc_compress_hdr(comp, pkt1, &hdr, &payload_offset,
+			                        &payload_len) == ROHC_STATUS_ERROR);
+			pkt1.len = 1;
+			CHECK(rohc_compress_hdr(comp, pkt, NULL, &payload_offset,
+			                        &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_hdr(comp, pkt, &hdr, NULL,
+			                        &payload_len) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_hdr(comp, pkt, &hdr, &payload_offset,
+			                        NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_hdr(comp, pkt, &hdr, &payload_offset,
+			                        &payload_len) == ROHC_STATUS_OK);
+			CHECK(hdr.len > 0);
+			CHECK(payload_offset == 20);
+			CHECK(payload_len == (pkt.len - 20));
+		}
+
+		/* rohc_compress_meta() */
+		{
+			rohc_comp_pkt_meta_t meta;
+
+			memset(&meta, 0, sizeof(rohc_comp_pkt_meta_t));
+			meta.ip_hdrs_nr = 1;
+			meta.ip_versions[0] = 4;
+			meta.l4_offset = 20;
+			meta.l4_proto = 1; /* ICMP */
+
+			pkt2.max_len = pkt.len + 1;
+			pkt2.offset = 0;
+			pkt2.len = 0;
+			CHECK(rohc_compress_meta(NULL, pkt, &meta, &pkt2) == ROHC_STATUS_ERROR);
+			pkt1.len = 0;
+			CHECK(rohc_compress_meta(comp, pkt1, &meta, &pkt2) == ROHC_STATUS_ERROR);
+			pkt1.len = 1;
+			CHECK(rohc_compress_meta(comp, pkt, NULL, &pkt2) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_meta(comp, pkt, &meta, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_compress_meta(comp, pkt, &meta, &pkt2) == ROHC_STATUS_OK);
+		}
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -383,6 +451,9 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == false);
 		info.version_minor = 0;
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.flow_cache_hits_nr <= info.flow_cache_lookups_nr);
 	}
 
 	/* rohc_comp_get_state_descr() */
@@ -400,6 +471,7 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_DUMP_PACKETS) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_FAST_HASH) == false);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
 
 	/* rohc_comp_deliver_feedback2() */
@@ -417,19 +489,102 @@ int main(int argc, char *argv[])
 		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
 	}
 
+	/* rohc_comp_set_feedback_queue() and rohc_comp_push_feedback() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 5, ts);
+
+		CHECK(rohc_comp_push_feedback(comp, pkt) == false);
+		CHECK(rohc_comp_set_feedback_queue(NULL, 16) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 0) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 24) == false);
+		CHECK(rohc_comp_set_feedback_queue(comp, 16) == true);
+		CHECK(rohc_comp_set_feedback_queue(comp, 16) == false);
+		CHECK(rohc_comp_push_feedback(NULL, pkt) == false);
+		pkt.len = 0; CHECK(rohc_comp_push_feedback(comp, pkt) == true);
+		pkt.len = 5; CHECK(rohc_comp_push_feedback(comp, pkt) == true);
+		pkt.len = 5; CHECK(rohc_comp_push_feedback(comp, pkt) == true);
+		pkt.len = 5; CHECK(rohc_comp_push_feedback(comp, pkt) == false);
+	}
+
 	/* several functions with some packets already compressed */
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
+		CHECK(rohc_comp_set_traces_level(comp, ROHC_TRACE_DEBUG) == false);
 
 		CHECK(rohc_comp_set_optimistic_approach(comp, 16) == false);
 
 		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
+
+		CHECK(chunks_nr > 0);
+		CHECK(rohc_comp_set_allocator(comp, NULL, NULL, NULL) == false);
 	}
 
 	/* rohc_comp_free() */
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
+	CHECK(chunks_nr == 0);
+
+	/* contexts of a compressor with large CIDs beyond the first ones */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const size_t flows_nr = 300;
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x00, 0x00,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x00, 0x00,  0x08, 0x00, 0xf7, 0xff,
+			0x00, 0x00, 0x00, 0x00
+		};
+		uint8_t buf2[100];
+		rohc_comp_general_info_t info;
+
+		comp = rohc_comp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
+		                      random_cb, NULL);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+		CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+		for(size_t i = 0; i < flows_nr; i++)
+		{
+			struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			struct rohc_buf pkt2 = rohc_buf_init_empty(buf2, sizeof(buf2));
+
+			buf[18] = (i >> 8) & 0xff;
+			buf[19] = i & 0xff;
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+		}
+		/* the context of the last flow is found in the flow cache */
+		{
+			struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			struct rohc_buf pkt2 = rohc_buf_init_empty(buf2, sizeof(buf2));
+
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+		}
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == flows_nr);
+		CHECK(info.flow_cache_lookups_nr == (flows_nr + 1));
+		CHECK(info.flow_cache_hits_nr == 1);
+		/* the flow cache is flushed when the enabled profiles change */
+		CHECK(rohc_comp_disable_profile(comp, ROHC_PROFILE_UDP) == true);
+		{
+			struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			struct rohc_buf pkt2 = rohc_buf_init_empty(buf2, sizeof(buf2));
+
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+		}
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr == flows_nr);
+		CHECK(info.flow_cache_lookups_nr == (flows_nr + 2));
+		CHECK(info.flow_cache_hits_nr == 1);
+		CHECK(rohc_comp_force_contexts_reinit(comp) == true);
+		rohc_comp_free(comp);
+	}
 
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
@@ -453,3 +608,38 @@ static int random_cb(const struct rohc_comp *const comp __attribute__((unused)),
 	return 0; /* fake */
 }
 
+
+/**
+ * @brief Reserve memory and count the reserved chunks
+ *
+ * @param priv_ctxt  The number of reserved chunks
+ * @param size       The number of bytes to reserve
+ * @return           The reserved memory
+ */
+static void * test_alloc(void *const priv_ctxt, const size_t size)
+{
+	size_t *const chunks_nr = priv_ctxt;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		(*chunks_nr)++;
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Release memory and count the reserved chunks
+ *
+ * @param priv_ctxt  The number of reserved chunks
+ * @param ptr        The memory to release
+ */
+static void test_free(void *const priv_ctxt, void *const ptr)
+{
+	size_t *const chunks_nr = priv_ctxt;
+
+	assert(*chunks_nr > 0);
+	(*chunks_nr)--;
+	free(ptr);
+}
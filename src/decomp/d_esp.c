@@ -60,13 +60,11 @@ struct d_esp_context
  */
 
 static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static int esp_parse_static_esp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -107,13 +105,11 @@ static void esp_update_context(struct rohc_decomp_ctxt *const context,
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the ESP context was successfully created,
  *                           false if a problem occurred
  */
 static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_esp_context *esp_context;
@@ -122,9 +118,10 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, persist_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
+	                               context->decompressor->trace_level,
 	                               context->profile->id))
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -134,7 +131,7 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the ESP-specific part of the context */
-	esp_context = calloc(1, sizeof(struct d_esp_context));
+	esp_context = rohc_decomp_ctxt_zalloc(context, sizeof(struct d_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -160,17 +157,19 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the ESP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, sizeof(struct esphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct esphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 		           "cannot allocate memory for the ESP-specific part of the "
 		           "outer IP header changes");
-		goto free_esp_context;
+		goto destroy_context;
 	}
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, sizeof(struct esphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct esphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -185,11 +184,10 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_esp_context:
-	zfree(esp_context);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	/* the ESP-specific part of the context is destroyed with the generic one */
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -202,19 +200,17 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean ESP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -413,6 +409,13 @@ const struct rohc_decomp_profile d_esp_profile =
 {
 	.id              = ROHC_PROFILE_ESP, /* profile ID (RFC 3095, §8) */
 	.msn_max_bits    = 32,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_size    = sizeof(struct rohc_decoded_values),
+	.ctxt_objs       = {
+		ROHC_DECOMP_RFC3095_CTXT_OBJS,
+		{ .len = sizeof(struct d_esp_context), .nr = 1 },
+		{ .len = sizeof(struct esphdr), .nr = 2 },
+	},
 	.new_context     = (rohc_decomp_new_context_t) d_esp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_esp_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -41,13 +41,11 @@
  */
 
 static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
-                        struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                        struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                        struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 
 /**
@@ -58,13 +56,11 @@ static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the UDP context was successfully created,
  *                           false if a problem occurred
  */
 static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
-                        struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                        struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                        struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
@@ -72,9 +68,10 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, persist_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
+	                               context->decompressor->trace_level,
 	                               context->profile->id))
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -105,12 +102,10 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -521,6 +516,9 @@ const struct rohc_decomp_profile d_ip_profile =
 {
 	.id              = ROHC_PROFILE_IP, /* profile ID (see 5 in RFC 3843) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_size    = sizeof(struct rohc_decoded_values),
+	.ctxt_objs       = { ROHC_DECOMP_RFC3095_CTXT_OBJS },
 	.new_context     = (rohc_decomp_new_context_t) d_ip_create,
 	.free_context    = (rohc_decomp_free_context_t) d_ip_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -68,13 +68,11 @@ struct d_rtp_context
  */
 
 static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -170,13 +168,11 @@ static inline bool is_inner_ipv4_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the RTP context was successfully created,
  *                           false if a problem occurred
  */
 static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_rtp_context *rtp_context;
@@ -186,9 +182,10 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, persist_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
+	                               context->decompressor->trace_level,
 	                               context->profile->id))
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -198,7 +195,7 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the RTP-specific part of the context */
-	rtp_context = calloc(1, sizeof(struct d_rtp_context));
+	rtp_context = rohc_decomp_ctxt_zalloc(context, sizeof(struct d_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -228,17 +225,19 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the UDP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, nh_len);
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, nh_len);
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 		           "cannot allocate memory for the RTP-specific part of the "
 		           "outer IP header changes");
-		goto free_rtp_context;
+		goto destroy_context;
 	}
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, nh_len);
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, nh_len);
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -252,16 +251,16 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the scaled RTP Timestamp decoding context */
 	d_init_sc(&rtp_context->ts_scaled_ctxt, context->decompressor->trace_callback,
-	          context->decompressor->trace_callback_priv);
+	          context->decompressor->trace_callback_priv,
+	          context->decompressor->trace_level);
 
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_rtp_context:
-	zfree(rtp_context);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	/* the RTP-specific part of the context is destroyed with the generic one */
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -274,19 +273,17 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -1917,6 +1914,13 @@ const struct rohc_decomp_profile d_rtp_profile =
 {
 	.id              = ROHC_PROFILE_RTP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_size    = sizeof(struct rohc_decoded_values),
+	.ctxt_objs       = {
+		ROHC_DECOMP_RFC3095_CTXT_OBJS,
+		{ .len = sizeof(struct d_rtp_context), .nr = 1 },
+		{ .len = sizeof(struct udphdr) + sizeof(struct rtphdr), .nr = 2 },
+	},
 	.new_context     = (rohc_decomp_new_context_t) d_rtp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_rtp_destroy,
 	.detect_pkt_type = rtp_detect_packet_type,
@@ -61,17 +61,15 @@
  */
 
 static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
-                                  struct d_tcp_context **const persist_ctxt,
-                                  struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                  struct d_tcp_context **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
                                    const struct rohc_tcp_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_tcp_destroy(struct d_tcp_context *const tcp_context)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -463,17 +461,15 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
  *
  * @param context            The main decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if creation succeeded, false in case of problem
  */
 static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
-                                  struct d_tcp_context **const persist_ctxt,
-                                  struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                  struct d_tcp_context **const persist_ctxt)
 {
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_decomp_ctxt_zalloc(context, sizeof(struct d_tcp_context));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -511,30 +507,8 @@ static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
 	 * reply */
 	rohc_lsb_init(&tcp_context->opt_ts_rep_lsb_ctxt, 32);
 
-	/* volatile part of the decompression context */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(tcp_context);
 quit:
 	return false;
 }
@@ -547,17 +521,11 @@ quit:
  * framework to work.
  *
  * @param tcp_context  The persistent decompression context for the TCP profile
- * @param volat_ctxt   The volatile decompression context
  */
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_tcp_destroy(struct d_tcp_context *const tcp_context)
 {
 	/* free the TCP decompression context itself */
-	free(tcp_context);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_decomp_ctxt_free(tcp_context);
 }
 
 
@@ -794,6 +762,7 @@ static bool d_tcp_parse_ir(const struct rohc_decomp_ctxt *const context,
                            struct rohc_tcp_extr_bits *const bits,
                            size_t *const rohc_hdr_len)
 {
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	const uint8_t *remain_data;
 	size_t remain_len;
 	size_t static_chain_len;
@@ -822,12 +791,22 @@ static bool d_tcp_parse_ir(const struct rohc_decomp_ctxt *const context,
 	remain_data++;
 	remain_len--;
 
-	/* parse static chain */
-	if(!tcp_parse_static_chain(context, remain_data, remain_len,
-	                           bits, &static_chain_len))
+	/* parse static chain, unless it is the one of the previous IR packet */
+	if(rohc_decomp_is_static_chain_unchanged(context, &tcp_context->static_chain,
+	                                         remain_data, remain_len))
 	{
-		rohc_decomp_warn(context, "failed to parse the static chain");
-		goto error;
+		static_chain_len = tcp_context->static_chain.len;
+	}
+	else
+	{
+		if(!tcp_parse_static_chain(context, remain_data, remain_len,
+		                           bits, &static_chain_len))
+		{
+			rohc_decomp_warn(context, "failed to parse the static chain");
+			goto error;
+		}
+		bits->static_chain = remain_data;
+		bits->static_chain_len = static_chain_len;
 	}
 	remain_data += static_chain_len;
 	remain_len -= static_chain_len;
@@ -2648,6 +2627,10 @@ static void d_tcp_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
 	/* Context Replication is off by default */
 	bits->do_ctxt_replication = false;
 
+	/* static chain is not parsed by default */
+	bits->static_chain = NULL;
+	bits->static_chain_len = 0;
+
 	/* set every bits and sizes to 0 */
 	for(i = 0; i < ROHC_MAX_IP_HDRS; i++)
 	{
@@ -2772,6 +2755,8 @@ static rohc_status_t d_tcp_decode_bits(const struct rohc_decomp_ctxt *const cont
 	tcp_context = ref_ctxt->persist_ctxt;
 	decoded->do_ctxt_replication = bits->do_ctxt_replication;
 	decoded->cr_base_cid = bits->cr_base_cid;
+	decoded->static_chain = bits->static_chain;
+	decoded->static_chain_len = bits->static_chain_len;
 
 	/* decode MSN */
 	if(bits->msn.bits_nr == 16)
@@ -4252,8 +4237,10 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->uncomp.type != ROHC_CRC_TYPE_NONE)
 	{
+		struct d_tcp_context *const tcp_context = context->persist_ctxt;
 		const bool crc_ok =
-			rohc_decomp_check_uncomp_crc(context, uncomp_hdrs, &extr_crc->uncomp);
+			rohc_decomp_check_uncomp_crc(context, &tcp_context->crc_cache,
+			                             uncomp_hdrs, &extr_crc->uncomp);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -4261,7 +4248,8 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_packet_descr(packet_type),
 			                 rohc_decomp_get_state_descr(context->state),
 			                 rohc_get_mode_descr(context->mode));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+			   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -4272,7 +4260,8 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 		}
 	}
 
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+	   rohc_trace_is_enabled(decomp, ROHC_TRACE_DEBUG))
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
@@ -4532,6 +4521,33 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 			       sizeof(struct d_tcp_opt_sack));
 		}
 	}
+
+	/* keep the static chain of IR packets for the next IR packets, unless it
+	 * contains IPv6 extension headers that are not all stored in context;
+	 * forget it after Context Replication */
+	if(decoded->static_chain != NULL || decoded->do_ctxt_replication)
+	{
+		bool has_ext_hdrs = false;
+
+		for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+		{
+			if(tcp_context->ip_contexts[i].opts_nr > 0)
+			{
+				has_ext_hdrs = true;
+			}
+		}
+		if(decoded->static_chain != NULL && !has_ext_hdrs)
+		{
+			rohc_decomp_keep_static_chain(context, &tcp_context->static_chain,
+			                              decoded->static_chain,
+			                              decoded->static_chain_len);
+		}
+		else
+		{
+			rohc_decomp_keep_static_chain(context, &tcp_context->static_chain,
+			                              NULL, 0);
+		}
+	}
 }
 
 
@@ -4561,6 +4577,9 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_tcp_extr_bits),
+	.decoded_size    = sizeof(struct rohc_tcp_decoded_values),
+	.ctxt_objs       = { { .len = sizeof(struct d_tcp_context), .nr = 1 } },
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create_from_pkt,
 	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
 	.detect_pkt_type = tcp_detect_packet_type,
@@ -31,6 +31,7 @@
 
 #include "ip.h"
 #include "interval.h"
+#include "crc.h"
 #include "protocols/ip.h"
 #include "protocols/tcp.h"
 #include "protocols/rfc6846.h"
@@ -198,6 +199,11 @@ struct d_tcp_context
 	/* TCP SACK option */
 	struct d_tcp_opt_sack opt_sack_blocks;  /**< The TCP SACK blocks */
 
+	/** The CRCs over the last uncompressed headers */
+	struct crc_hdrs_cache crc_cache;
+
+	/** The static chain of the last IR packet */
+	struct rohc_decomp_static_chain static_chain;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -346,6 +352,10 @@ struct rohc_tcp_extr_bits
 	bool ttl_irreg_chain_flag;
 
 	uint8_t unused2;
+
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -477,6 +487,10 @@ struct rohc_tcp_decoded_values
 	struct rohc_tcp_decoded_ip_values ip[ROHC_MAX_IP_HDRS];
 	uint8_t ip_nr;  /**< The number of the decoded IP headers */
 	uint8_t unused[7];
+
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
@@ -59,13 +59,11 @@ struct d_udp_context
  */
 
 static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static int udp_parse_dynamic_udp(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *packet,
@@ -103,13 +101,11 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
  *
  * @param context            The main decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the UDP context was successfully created,
  *                           false if a problem occurred
  */
 static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
-                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_udp_context *udp_context;
@@ -118,9 +114,10 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, persist_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
+	                               context->decompressor->trace_level,
 	                               context->profile->id))
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -130,7 +127,7 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the UDP-specific part of the context */
-	udp_context = calloc(1, sizeof(struct d_udp_context));
+	udp_context = rohc_decomp_ctxt_zalloc(context, sizeof(struct d_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -160,17 +157,19 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the UDP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct udphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 		           "cannot allocate memory for the UDP-specific part of the "
 		           "outer IP header changes");
-		goto free_udp_context;
+		goto destroy_context;
 	}
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = calloc(1, sizeof(struct udphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct udphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -185,11 +184,10 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
-free_udp_context:
-	zfree(udp_context);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	/* the UDP-specific part of the context is destroyed with the generic one */
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -202,19 +200,17 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -575,6 +571,13 @@ const struct rohc_decomp_profile d_udp_profile =
 {
 	.id              = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.extr_bits_size  = sizeof(struct rohc_extr_bits),
+	.decoded_size    = sizeof(struct rohc_decoded_values),
+	.ctxt_objs       = {
+		ROHC_DECOMP_RFC3095_CTXT_OBJS,
+		{ .len = sizeof(struct d_udp_context), .nr = 1 },
+		{ .len = sizeof(struct udphdr), .nr = 2 },
+	},
 	.new_context     = (rohc_decomp_new_context_t) d_udp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_udp_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
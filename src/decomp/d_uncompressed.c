@@ -59,13 +59,10 @@ struct rohc_uncomp_decoded
  */
 
 static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
-                               void **const persist_ctxt,
-                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                               void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+static void uncomp_free_context(void *const persist_ctxt);
 
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -135,50 +132,25 @@ static uint32_t uncomp_get_sn(const struct rohc_decomp_ctxt *const context)
  */
 
 /**
- * @brief Create the Uncompressed volatile and persistent parts of the context
+ * @brief Create the Uncompressed persistent part of the context
  *
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the Uncompressed context was successfully
  *                           created, false if a problem occurred
  */
 static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
-                               void **const persist_ctxt,
-                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                               void **const persist_ctxt)
 {
 	assert(context->profile->id == ROHC_PROFILE_UNCOMPRESSED);
 
 	/* persistent part */
 	*persist_ctxt = NULL;
 
-	/* volatile part */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto error;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto free_extr_bits;
-	}
-
 	return true;
-
-free_extr_bits:
-	free(volat_ctxt->extr_bits);
-error:
-	return false;
 }
 
 
@@ -190,14 +162,10 @@ error:
  * framework to work.
  *
  * @param persist_ctxt  The persistent part of the decompression context
- * @param volat_ctxt    The volatile part of the decompression context
  */
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void uncomp_free_context(void *const persist_ctxt)
 {
 	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
 }
 
 
@@ -548,6 +516,8 @@ const struct rohc_decomp_profile d_uncomp_profile =
 {
 	.id              = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095 §8) */
 	.msn_max_bits    = 0, /* no MSN */
+	.extr_bits_size  = sizeof(struct rohc_uncomp_extr_bits),
+	.decoded_size    = sizeof(struct rohc_uncomp_decoded),
 	.new_context     = uncomp_new_context,
 	.free_context    = uncomp_free_context,
 	.detect_pkt_type = uncomp_detect_pkt_type,
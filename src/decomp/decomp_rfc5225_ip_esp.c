@@ -60,6 +60,12 @@ struct rohc_decomp_rfc5225_ip_esp_ctxt
 
 	/** The ESP Security Parameters Index (SPI) */
 	uint32_t esp_spi;
+
+	/** The CRCs over the last uncompressed headers */
+	struct crc_hdrs_cache crc_cache;
+
+	/** The static chain of the last IR packet */
+	struct rohc_decomp_static_chain static_chain;
 };
 
 
@@ -119,6 +125,10 @@ struct rohc_rfc5225_bits
 
 	uint32_t esp_spi;  /**< The ESP SPI bits */
 	size_t esp_spi_nr; /**< The number of ESP SPI bits */
+
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 
@@ -153,6 +163,10 @@ struct rohc_rfc5225_decoded
 	rohc_reordering_offset_t reorder_ratio; /**< The reorder ratio decoded */
 
 	uint32_t esp_spi; /**< The ESP SPI decoded */
+
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 
@@ -161,13 +175,11 @@ struct rohc_rfc5225_decoded
  */
 
 static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                              void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t decomp_rfc5225_ip_esp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                                            const uint8_t *const rohc_packet,
@@ -397,18 +409,17 @@ static size_t sdvl_sn_lsb_decode(const uint8_t *const data,
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @return                   true if the ROHCv2 IP/ESP context was successfully
  *                           created, false if a problem occurred
  */
 static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *const context,
-                                              void **const persist_ctxt,
-                                              struct rohc_decomp_volat_ctxt *const volat_ctxt)
+                                              void **const persist_ctxt)
 {
 	struct rohc_decomp_rfc5225_ip_esp_ctxt *rfc5225_ctxt;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc5225_ip_esp_ctxt));
+	*persist_ctxt =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct rohc_decomp_rfc5225_ip_esp_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -425,30 +436,8 @@ static bool decomp_rfc5225_ip_esp_new_context(const struct rohc_decomp_ctxt *con
 	/* by default, no reordering accepted on the channel */
 	rfc5225_ctxt->reorder_ratio = ROHC_REORDERING_NONE;
 
-	/* volatile part */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_rfc5225_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/ESP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_rfc5225_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/ESP decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(rfc5225_ctxt);
 error:
 	return false;
 }
@@ -462,17 +451,11 @@ error:
  * framework to work.
  *
  * @param rfc5225_ctxt  The persistent decompression context for the IP/ESP profile
- * @param volat_ctxt    The volatile part of the decompression context
  */
-static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void decomp_rfc5225_ip_esp_free_context(struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt)
 {
 	/* free the ROHCv2 IP/ESP decompression context itself */
-	free(rfc5225_ctxt);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_decomp_ctxt_free(rfc5225_ctxt);
 }
 
 
@@ -634,6 +617,9 @@ static void decomp_rfc5225_ip_esp_reset_extr_bits(const struct rohc_decomp_ctxt
 	bits->reorder_ratio_nr = 0;
 	bits->outer_ip_flag_nr = 0;
 	bits->ctrl_crc.type = ROHC_CRC_TYPE_NONE;
+	bits->esp_spi_nr = 0;
+	bits->static_chain = NULL;
+	bits->static_chain_len = 0;
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(ctxt->num_recv_packets >= 1)
@@ -669,6 +655,8 @@ static bool decomp_rfc5225_ip_esp_parse_ir(const struct rohc_decomp_ctxt *const
                                            struct rohc_rfc5225_bits *const bits,
                                            size_t *const rohc_hdr_len)
 {
+	const struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt =
+		ctxt->persist_ctxt;
 	const uint8_t *remain_data = rohc_buf_data(rohc_pkt);
 	size_t remain_len = rohc_pkt.len;
 	size_t static_chain_len;
@@ -694,12 +682,22 @@ static bool decomp_rfc5225_ip_esp_parse_ir(const struct rohc_decomp_ctxt *const
 	remain_data++;
 	remain_len--;
 
-	/* parse static chain */
-	if(!decomp_rfc5225_ip_esp_parse_static_chain(ctxt, remain_data, remain_len,
-	                                             bits, &static_chain_len))
+	/* parse static chain, unless it is the one of the previous IR packet */
+	if(rohc_decomp_is_static_chain_unchanged(ctxt, &rfc5225_ctxt->static_chain,
+	                                         remain_data, remain_len))
 	{
-		rohc_decomp_warn(ctxt, "failed to parse the static chain");
-		goto error;
+		static_chain_len = rfc5225_ctxt->static_chain.len;
+	}
+	else
+	{
+		if(!decomp_rfc5225_ip_esp_parse_static_chain(ctxt, remain_data, remain_len,
+		                                             bits, &static_chain_len))
+		{
+			rohc_decomp_warn(ctxt, "failed to parse the static chain");
+			goto error;
+		}
+		bits->static_chain = remain_data;
+		bits->static_chain_len = static_chain_len;
 	}
 	remain_data += static_chain_len;
 	remain_len -= static_chain_len;
@@ -2177,7 +2175,7 @@ static rohc_status_t decomp_rfc5225_ip_esp_decode_bits(const struct rohc_decomp_
 			 * https://www.rfc-editor.org/errata_search.php?rfc=5225&eid=2703 */
 			if(rfc5225_ctxt->ip_contexts[ip_hdr_pos].version == IPV4)
 			{
-				ip_id_behaviors[ip_id_behaviors_nr] = bits->ip[ip_hdr_pos].id_behavior;
+				ip_id_behaviors[ip_id_behaviors_nr] = decoded->ip[ip_hdr_pos].id_behavior;
 				rohc_decomp_debug(ctxt, "IP-ID behavior #%zu of IPv4 header #%zu "
 				                  "= 0x%02x", ip_id_behaviors_nr + 1, ip_hdr_pos + 1,
 				                  ip_id_behaviors[ip_id_behaviors_nr]);
@@ -2201,6 +2199,10 @@ static rohc_status_t decomp_rfc5225_ip_esp_decode_bits(const struct rohc_decomp_
 		}
 	}
 
+	/* static chain of IR packets */
+	decoded->static_chain = bits->static_chain;
+	decoded->static_chain_len = bits->static_chain_len;
+
 	return ROHC_STATUS_OK;
 
 error_crc:
@@ -2635,8 +2637,11 @@ static rohc_status_t decomp_rfc5225_ip_esp_build_hdrs(const struct rohc_decomp *
 	/* compute CRC on uncompressed headers if asked */
 	if(extr_crc->uncomp.type != ROHC_CRC_TYPE_NONE)
 	{
+		struct rohc_decomp_rfc5225_ip_esp_ctxt *const rfc5225_ctxt =
+			context->persist_ctxt;
 		const bool crc_ok =
-			rohc_decomp_check_uncomp_crc(context, uncomp_hdrs, &extr_crc->uncomp);
+			rohc_decomp_check_uncomp_crc(context, &rfc5225_ctxt->crc_cache,
+			                             uncomp_hdrs, &extr_crc->uncomp);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -2644,7 +2649,8 @@ static rohc_status_t decomp_rfc5225_ip_esp_build_hdrs(const struct rohc_decomp *
 			                 rohc_get_packet_descr(packet_type),
 			                 rohc_decomp_get_state_descr(context->state),
 			                 rohc_get_mode_descr(context->mode));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+			   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -2654,7 +2660,8 @@ static rohc_status_t decomp_rfc5225_ip_esp_build_hdrs(const struct rohc_decomp *
 		}
 	}
 
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+	   rohc_trace_is_enabled(decomp, ROHC_TRACE_DEBUG))
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
@@ -3028,6 +3035,17 @@ static void decomp_rfc5225_ip_esp_update_ctxt(struct rohc_decomp_ctxt *const con
 		}
 	}
 	rfc5225_ctxt->ip_contexts_nr = decoded->ip_nr;
+
+	/* update context for the ESP header */
+	rfc5225_ctxt->esp_spi = decoded->esp_spi;
+
+	/* keep the static chain of IR packets for the next IR packets */
+	if(decoded->static_chain != NULL)
+	{
+		rohc_decomp_keep_static_chain(context, &rfc5225_ctxt->static_chain,
+		                              decoded->static_chain,
+		                              decoded->static_chain_len);
+	}
 }
 
 
@@ -3183,6 +3201,9 @@ const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_esp_profile =
 {
 	.id              = ROHCv2_PROFILE_IP_ESP, /* profile ID (RFC5225, ROHCv2 IP/ESP) */
 	.msn_max_bits    = 32,
+	.extr_bits_size  = sizeof(struct rohc_rfc5225_bits),
+	.decoded_size    = sizeof(struct rohc_rfc5225_decoded),
+	.ctxt_objs       = { { .len = sizeof(struct rohc_decomp_rfc5225_ip_esp_ctxt), .nr = 1 } },
 	.new_context     = decomp_rfc5225_ip_esp_new_context,
 	.free_context    = (rohc_decomp_free_context_t) decomp_rfc5225_ip_esp_free_context,
 	.detect_pkt_type = decomp_rfc5225_ip_esp_detect_pkt_type,
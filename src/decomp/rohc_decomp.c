@@ -156,6 +156,16 @@ static bool rohc_decomp_profile_enabled_nocheck(const struct rohc_decomp *const
                                                 const rohc_profile_t profile)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static bool rohc_decomp_grow_volat_ctxt(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct slab * rohc_decomp_get_ctxt_slab(struct rohc_decomp *const decomp,
+                                               const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_decomp_reserve_profile(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const rohc_cid_t cid,
                                                 const struct rohc_decomp_profile *const profile)
@@ -166,12 +176,34 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static bool rohc_decomp_check_bufs(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf *const rohc_packet,
+                                   const struct rohc_buf *const uncomp_packet)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static bool rohc_decomp_check_feedback_bufs(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf *const rcvd_feedback,
+                                            const struct rohc_buf *const feedback_send)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet)
+	__attribute__((nonnull(1)));
+
+static rohc_status_t rohc_decomp_decode(struct rohc_decomp *const decomp,
+                                        const struct rohc_buf rohc_packet,
+                                        struct rohc_buf *const uncomp_packet,
+                                        const bool in_place,
+                                        struct rohc_buf *const rcvd_feedback,
+                                        struct rohc_buf *const feedback_send)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     const bool in_place,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
+	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
                                    const uint8_t *packet,
@@ -201,9 +233,10 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool payload_in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9)));
 
 static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const decomp,
                                                 const struct rohc_decomp_ctxt *const context,
@@ -299,12 +332,12 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 
 	assert(cid <= ROHC_LARGE_CID_MAX);
 
-	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+	/* take the decompression context from the pool of contexts */
+	context = slab_alloc(&decomp->ctxts_pool);
 	if(context == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "cannot allocate memory for the contexts");
+		             "no context left in the pool of contexts");
 		goto error;
 	}
 
@@ -359,7 +392,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 
 	/* create the profile-specific parts of the decompression context (performed
 	 * at the every end so that everything is initialized in context first) */
-	if(!profile->new_context(context, &context->persist_ctxt, &context->volat_ctxt))
+	if(!profile->new_context(context, &context->persist_ctxt))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "failed to initialize the profile-specific parts of the "
@@ -375,7 +408,7 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	return context;
 
 destroy_context:
-	zfree(context);
+	slab_release(context);
 error:
 	return NULL;
 }
@@ -396,14 +429,14 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	           "free context with CID %u", context->cid);
 
 	/* destroy the profile-specific data */
-	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
+	context->profile->free_context(context->persist_ctxt);
 
 	/* decompressor got one more context */
 	assert(context->decompressor->num_contexts_used > 0);
 	context->decompressor->num_contexts_used--;
 
-	/* destroy the context itself */
-	free(context);
+	/* give the context itself back to the pool of contexts */
+	slab_release(context);
 }
 
 
@@ -516,6 +549,7 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	/* no trace callback during decompressor creation */
 	decomp->trace_callback = NULL;
 	decomp->trace_callback_priv = NULL;
+	decomp->trace_level = ROHC_TRACE_DEBUG;
 
 	/* default feature set (empty for the moment) */
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
@@ -548,6 +582,15 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	}
 	decomp->last_context = NULL;
 
+	/* the volatile buffers shared by all the contexts grow with the profiles
+	 * that are enabled */
+	decomp->volat_ctxt.crc.comp.type = ROHC_CRC_TYPE_NONE;
+	decomp->volat_ctxt.crc.uncomp.type = ROHC_CRC_TYPE_NONE;
+	decomp->volat_ctxt.extr_bits = NULL;
+	decomp->volat_ctxt.extr_bits_size = 0;
+	decomp->volat_ctxt.decoded_values = NULL;
+	decomp->volat_ctxt.decoded_values_size = 0;
+
 	/* counters and thresholds for feedbacks and downward state transitions */
 	{
 		const size_t rtt = 1000U; /* conservative 1-second RTT */
@@ -632,6 +675,11 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 	}
 	zfree(decomp->contexts);
 	assert(decomp->num_contexts_used == 0);
+	slab_free(&decomp->ctxts_pool);
+	for(i = 0; i < decomp->ctxt_slabs_nr; i++)
+	{
+		slab_free(&decomp->ctxt_slabs[i]);
+	}
 
 	/* free RRU buffer */
 	if(decomp->rru != NULL)
@@ -639,6 +687,10 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 		zfree(decomp->rru);
 	}
 
+	/* free the volatile buffers shared by all the contexts */
+	zfree(decomp->volat_ctxt.decoded_values);
+	zfree(decomp->volat_ctxt.extr_bits);
+
 	/* destroy the decompressor itself */
 	free(decomp);
 
@@ -720,21 +772,275 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_bufs(decomp, &rohc_packet, uncomp_packet) ||
+	   !rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	return rohc_decomp_decode(decomp, rohc_packet, uncomp_packet, false,
+	                          rcvd_feedback, feedback_send);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in its own buffer
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 would do, but
+ * build the uncompressed packet in the same buffer: the uncompressed headers
+ * are rebuilt in the headroom of the buffer, then moved just before the
+ * payload. The payload of the packet never moves, only the headers are
+ * written.
+ *
+ * The headroom of the buffer is given by the \e packet.offset field: the
+ * uncompressed headers shall fit in it, otherwise the decompression fails.
+ *
+ * On success, \e packet is updated to describe the uncompressed packet: its
+ * offset is moved back to the first byte of the uncompressed headers and its
+ * length is updated. The packet is empty if the ROHC packet contained only
+ * feedback data or if the ROHC packet was not a final segment. If the ROHC
+ * packet was the final segment of a ROHC packet, the payload cannot stay in
+ * place: the uncompressed packet is built in the whole buffer.
+ *
+ * On failure, \e packet is emptied, as the uncompressed packet of
+ * \ref rohc_decompress3 is.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] packet      IN:  The compressed packet to decompress
+ *                            OUT: The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel:
+ *                            \li If NULL, the decompression won't generate
+ *                                feedback information for its compressor
+ *                            \li If not NULL, may store the generated
+ *                                feedback at the given address
+ * @return                    The same values as \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                      struct rohc_buf *const packet,
+                                      struct rohc_buf *const rcvd_feedback,
+                                      struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf uncomp_packet;
+	rohc_status_t status;
 
 	/* check inputs validity */
 	if(decomp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(rohc_packet))
+	if(packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(*packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is empty");
+		goto error;
+	}
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	/* the uncompressed headers are built in the headroom of the buffer, the
+	 * headroom may be empty if no uncompressed header is expected */
+	uncomp_packet.time = packet->time;
+	uncomp_packet.data = packet->data;
+	uncomp_packet.max_len = packet->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	status = rohc_decomp_decode(decomp, *packet, &uncomp_packet, true,
+	                            rcvd_feedback, feedback_send);
+	if(status == ROHC_STATUS_OK)
+	{
+		assert(uncomp_packet.data == packet->data);
+		packet->offset = uncomp_packet.offset;
+		packet->len = uncomp_packet.len;
+	}
+	else
+	{
+		packet->len = 0;
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets
+ *
+ * Decompress the given ROHC packets one after the other, as
+ * \ref rohc_decompress3 would do, but share the validation of parameters
+ * among the packets of the burst. While one packet is being decompressed, the
+ * context of the next packet is prefetched.
+ *
+ * The decompression status of every packet is returned in \e statuses, with
+ * the same values as \ref rohc_decompress3.
+ *
+ * The feedback received for the same-side associated ROHC compressor and the
+ * feedback generated for the remote compressor are aggregated for the whole
+ * burst: the feedback items of all the packets are appended one after the
+ * other in \e rcvd_feedback and \e feedback_send. If one buffer becomes too
+ * small, the feedback items that do not fit are dropped, as
+ * \ref rohc_decompress3 does.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param rohc_packets         The compressed packets to decompress
+ * @param[out] uncomp_packets  The resulting uncompressed packets
+ * @param[out] statuses        The decompression status of every packet
+ * @param packets_nr           The number of packets in the burst
+ * @param[out] rcvd_feedback   The feedback received from the remote peer for
+ *                             the same-side associated ROHC compressor, for
+ *                             all the packets of the burst:
+ *                             \li If NULL, ignore the received feedback data
+ *                             \li If not NULL, store the received feedback in
+ *                                 at the given address
+ * @param[out] feedback_send   The feedback to be transmitted to the remote
+ *                             compressor, for all the packets of the burst:
+ *                             \li If NULL, the decompression won't generate
+ *                                 feedback information for its compressor
+ *                             \li If not NULL, may store the generated
+ *                                 feedback at the given address
+ * @return                     The number of packets handled, their status is
+ *                             set in \e statuses ; 0 if one parameter is
+ *                             invalid, an empty burst being invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+size_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                             const struct rohc_buf *const rohc_packets,
+                             struct rohc_buf *const uncomp_packets,
+                             rohc_status_t *const statuses,
+                             const size_t packets_nr,
+                             struct rohc_buf *const rcvd_feedback,
+                             struct rohc_buf *const feedback_send)
+{
+	size_t i;
+
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_packets == NULL || uncomp_packets == NULL || statuses == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packets, uncomp_packets or statuses is NULL");
+		goto error;
+	}
+	if(packets_nr == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given burst is empty");
+		goto error;
+	}
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < packets_nr; i++)
+	{
+		const size_t rcvd_feedback_len = (rcvd_feedback != NULL ? rcvd_feedback->len : 0);
+		const size_t feedback_send_len = (feedback_send != NULL ? feedback_send->len : 0);
+
+		/* prefetch the context of the next packet while this one is decoded */
+		if((i + 1) < packets_nr)
+		{
+			rohc_decomp_prefetch_ctxt(decomp, rohc_packets[i + 1]);
+		}
+
+		if(!rohc_decomp_check_bufs(decomp, &rohc_packets[i], &uncomp_packets[i]))
+		{
+			statuses[i] = ROHC_STATUS_ERROR;
+			continue;
+		}
+
+		/* hide the feedback of the previous packets, so that the feedback of
+		 * the packet is appended to them */
+		if(rcvd_feedback != NULL)
+		{
+			rohc_buf_pull(rcvd_feedback, rcvd_feedback_len);
+		}
+		if(feedback_send != NULL)
+		{
+			rohc_buf_pull(feedback_send, feedback_send_len);
+		}
+
+		statuses[i] = rohc_decomp_decode(decomp, rohc_packets[i], &uncomp_packets[i],
+		                                 false, rcvd_feedback, feedback_send);
+
+		/* unhide the feedback of the previous packets */
+		if(rcvd_feedback != NULL)
+		{
+			rohc_buf_push(rcvd_feedback, rcvd_feedback_len);
+		}
+		if(feedback_send != NULL)
+		{
+			rohc_buf_push(feedback_send, feedback_send_len);
+		}
+	}
+
+	return i;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Check the validity of the buffers given for one packet to decompress
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rohc_packet    The compressed packet to decompress
+ * @param uncomp_packet  The buffer for the uncompressed packet
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_decomp_check_bufs(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf *const rohc_packet,
+                                   const struct rohc_buf *const uncomp_packet)
+{
+	if(rohc_buf_is_malformed(*rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "given rohc_packet is malformed");
 		goto error;
 	}
-	if(rohc_buf_is_empty(rohc_packet))
+	if(rohc_buf_is_empty(*rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "given rohc_packet is empty");
@@ -758,6 +1064,26 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		             "given uncomp_packet is not empty");
 		goto error;
 	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check the validity of the optional buffers given for feedback
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rcvd_feedback  The buffer for the received feedback, may be NULL
+ * @param feedback_send  The buffer for the feedback to send, may be NULL
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_decomp_check_feedback_bufs(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf *const rcvd_feedback,
+                                            const struct rohc_buf *const feedback_send)
+{
 	if(rcvd_feedback != NULL)
 	{
 		if(rohc_buf_is_malformed(*rcvd_feedback))
@@ -789,13 +1115,135 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		}
 	}
 
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Prefetch the context that is likely to decompress the given packet
+ *
+ * Skip the padding and the feedback items at the beginning of the packet,
+ * then peek the CID to prefetch its context. Nothing is prefetched for ROHC
+ * segments, nor for malformed packets: they are detected later by
+ * \ref d_decode_header.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet that will be decompressed soon
+ */
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet)
+{
+	struct rohc_buf remain_data = rohc_packet;
+	const struct rohc_decomp_ctxt *ctxt;
+	rohc_cid_t cid;
+
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		return;
+	}
+
+	/* skip padding and feedback items */
+	while(remain_data.len > 0 &&
+	      rohc_decomp_packet_is_padding(rohc_buf_data(remain_data)))
+	{
+		rohc_buf_pull(&remain_data, 1);
+	}
+	while(remain_data.len > 0 && rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			return;
+		}
+		rohc_buf_pull(&remain_data, feedback_hdr_len + feedback_data_len);
+	}
+	if(remain_data.len == 0 ||
+	   rohc_decomp_packet_is_segment(rohc_buf_data(remain_data)))
+	{
+		return;
+	}
+
+	/* peek the CID */
+	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	{
+		const uint8_t add_cid =
+			rohc_add_cid_decode(rohc_buf_data(remain_data), remain_data.len);
+		cid = (add_cid == UINT8_MAX ? 0 : add_cid);
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+		size_t large_cid_len;
+
+		if(remain_data.len < 2)
+		{
+			return;
+		}
+		large_cid_len = sdvl_decode(rohc_buf_data_at(remain_data, 1),
+		                            remain_data.len - 1, &large_cid,
+		                            &large_cid_bits_nr);
+		if(large_cid_len != 1 && large_cid_len != 2)
+		{
+			return;
+		}
+		cid = large_cid & 0xffff;
+	}
+	if(cid > decomp->medium.max_cid)
+	{
+		return;
+	}
+
+	ctxt = decomp->contexts[cid];
+	if(ctxt != NULL)
+	{
+		__builtin_prefetch(ctxt, 1);
+		__builtin_prefetch(ctxt->persist_ctxt, 1);
+	}
+}
+
+
+/**
+ * @brief Decompress one ROHC packet once the parameters were checked
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param in_place            Whether \e uncomp_packet is the headroom of
+ *                            the buffer of \e rohc_packet, see
+ *                            \ref rohc_decompress_inplace
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor,
+ *                            may be NULL
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, may be NULL
+ * @return                    The same values as \ref rohc_decompress3
+ */
+static rohc_status_t rohc_decomp_decode(struct rohc_decomp *const decomp,
+                                        const struct rohc_buf rohc_packet,
+                                        struct rohc_buf *const uncomp_packet,
+                                        const bool in_place,
+                                        struct rohc_buf *const rcvd_feedback,
+                                        struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status;
+	struct rohc_decomp_stream stream;
+
 	decomp->stats.received++;
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
 	           decomp->stats.received);
 
 	/* print compressed bytes */
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+	   rohc_trace_is_enabled(decomp, ROHC_TRACE_DEBUG))
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
@@ -803,8 +1251,8 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 	}
 
 	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
+	status = d_decode_header(decomp, rohc_packet, uncomp_packet, in_place,
+	                         rcvd_feedback, &stream);
 	assert(status != ROHC_STATUS_SEGMENT);
 
 	/* handle mode transitions if context was found and it is still valid */
@@ -953,6 +1401,9 @@ error:
  * @param decomp              The ROHC decompressor
  * @param rohc_packet         The ROHC packet to decode
  * @param[out] uncomp_packet  The uncompressed packet
+ * @param in_place            Whether \e uncomp_packet is the headroom of
+ *                            the buffer of \e rohc_packet, see
+ *                            \ref rohc_decompress_inplace
  * @param[out] rcvd_feedback  The feedback received from the remote peer for
  *                            the same-side associated ROHC compressor through
  *                            the feedback channel:
@@ -975,10 +1426,12 @@ error:
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     const bool in_place,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
 {
 	const struct rohc_decomp_profile *profile;
+	bool payload_in_place = in_place;
 	bool is_new_context = false;
 	size_t sn_feedback_min_bits;
 	size_t add_cid_len;
@@ -1136,6 +1589,15 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 
 		/* reset context for next RRU */
 		decomp->rru_len = 0;
+
+		/* the payload is in the RRU, not in the buffer of the final segment:
+		 * the segment was copied in the RRU, so the whole buffer may be used
+		 * for the uncompressed packet */
+		if(payload_in_place)
+		{
+			uncomp_packet->max_len = rohc_packet.max_len;
+			payload_in_place = false;
+		}
 	}
 
 	/* decode small or large CID */
@@ -1264,7 +1726,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	 * (may change the initial assumption about the packet type) */
 	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
 	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
+	                                payload_in_place, &stream->packet_type,
+	                                &stream->do_change_mode);
 	if(status != ROHC_STATUS_OK)
 	{
 		/* decompression failed, free resources if necessary */
@@ -1330,7 +1793,8 @@ error_no_context:
  *  \li C. Decode extracted bits
  *  \li D. Build uncompressed headers (and check for correct decompression
  *         for UO* packets)
- *  \li E. Copy the payload (if any)
+ *  \li E. Copy the payload (if any), or move the uncompressed headers in
+ *         front of the payload if it stays in place
  *  \li F. Update the compression context
  *
  * Steps C and D may be repeated if packet or context repair is attempted
@@ -1342,6 +1806,9 @@ error_no_context:
  * @param add_cid_len          The length of the optional Add-CID field
  * @param large_cid_len        The length of the optional large CID field
  * @param[out] uncomp_packet   The uncompressed packet
+ * @param payload_in_place     Whether the payload shall stay in the buffer of
+ *                             the ROHC packet, \e uncomp_packet being the
+ *                             headroom of that buffer
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
  * @param[out] do_change_mode  Whether the profile context wants to change
@@ -1357,13 +1824,14 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            const bool payload_in_place,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
 {
 	const struct rohc_decomp_profile *const profile = context->profile;
-	struct rohc_decomp_crc *const extr_crc_bits = &context->volat_ctxt.crc;
-	void *const extr_bits = context->volat_ctxt.extr_bits;
-	void *const decoded_values = context->volat_ctxt.decoded_values;
+	struct rohc_decomp_crc *const extr_crc_bits = &decomp->volat_ctxt.crc;
+	void *const extr_bits = decomp->volat_ctxt.extr_bits;
+	void *const decoded_values = decomp->volat_ctxt.decoded_values;
 
 	/* length of the parsed ROHC header and of the uncompressed headers */
 	size_t rohc_hdr_len;
@@ -1383,6 +1851,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	assert(add_cid_len == 0 || add_cid_len == 1);
 	assert(large_cid_len <= 2);
 	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
+	assert(decomp->volat_ctxt.extr_bits_size >= profile->extr_bits_size);
+	assert(decomp->volat_ctxt.decoded_values_size >= profile->decoded_size);
 
 	/* A. Parse the ROHC header */
 
@@ -1427,7 +1897,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		{
 			rohc_decomp_warn(context, "CRC detected a transmission failure for "
 			                 "%s packet", rohc_get_packet_descr(*packet_type));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+			   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 			{
 				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
 				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
@@ -1508,7 +1979,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 				 * was disabled or attempted without any success, so give up */
 				rohc_decomp_warn(context, "CID %u: failed to build uncompressed "
 				                 "headers (CRC failure)", context->cid);
-				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+				   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 				{
 					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -1520,7 +1992,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		}
 		else if(decode_ret != ROHC_STATUS_OK)
 		{
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+			   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -1581,7 +2054,6 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		}
 	}
 	uncomp_hdr_len = uncomp_packet->len;
-	rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
 
 
 	/* E. Copy the payload (if any) */
@@ -1595,23 +2067,44 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		status = ROHC_STATUS_ERROR;
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+	if(payload_in_place)
 	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
-		goto error;
+		/* the payload stays where it is: move the uncompressed headers from
+		 * the headroom of the buffer to the bytes just before the payload,
+		 * the ROHC header they overwrite is not needed anymore */
+		const size_t payload_offset = payload_data - uncomp_packet->data;
+
+		assert(uncomp_packet->data == rohc_packet.data);
+		assert(payload_offset >= (uncomp_packet->offset + uncomp_hdr_len));
+		memmove(uncomp_packet->data + payload_offset - uncomp_hdr_len,
+		        rohc_buf_data(*uncomp_packet), uncomp_hdr_len);
+		uncomp_packet->offset = payload_offset - uncomp_hdr_len;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
+		uncomp_packet->max_len = rohc_packet.max_len;
+		rohc_decomp_debug(context, "uncompressed packet length = %zu bytes, "
+		                  "payload left in place", uncomp_packet->len);
 	}
-	if(payload_len != 0)
+	else
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error;
+		}
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
+		rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
+		                  uncomp_packet->len);
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
-	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
-	                  uncomp_packet->len);
 
 
 	/* F. Update the compression context
@@ -1815,6 +2308,114 @@ static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Is the static chain of an IR packet the one kept in context?
+ *
+ * The static chain is parsed byte after byte, so the IR packet carries the
+ * static chain kept in context if its first bytes are the very same.
+ *
+ * @param context        The decompression context
+ * @param static_chain   The static chain kept in context
+ * @param rohc_data      The static chain of the IR packet and the remaining
+ *                       part of the ROHC packet
+ * @param rohc_len       The remaining length (in bytes) of the ROHC packet
+ * @return               true if the static chain of the IR packet is the one
+ *                       kept in context, false otherwise
+ */
+bool rohc_decomp_is_static_chain_unchanged(const struct rohc_decomp_ctxt *const context,
+                                           const struct rohc_decomp_static_chain *const static_chain,
+                                           const uint8_t *const rohc_data,
+                                           const size_t rohc_len)
+{
+	if(context->num_recv_packets == 0 ||
+	   static_chain->len == 0 ||
+	   rohc_len < static_chain->len ||
+	   memcmp(rohc_data, static_chain->data, static_chain->len) != 0)
+	{
+		return false;
+	}
+
+	rohc_decomp_debug(context, "%u-byte static chain is unchanged, skip it",
+	                  static_chain->len);
+
+	return true;
+}
+
+
+/**
+ * @brief Keep the static chain of the IR packet applied to the context
+ *
+ * Static chains longer than \ref ROHC_DECOMP_STATIC_CHAIN_MAX_LEN bytes are
+ * not kept: they will be parsed again with every IR packet.
+ *
+ * @param context            The decompression context
+ * @param static_chain       The static chain kept in context
+ * @param static_chain_data  The static chain to keep, NULL to forget the one
+ *                           kept in context
+ * @param static_chain_len   The length (in bytes) of the static chain to keep
+ */
+void rohc_decomp_keep_static_chain(const struct rohc_decomp_ctxt *const context,
+                                   struct rohc_decomp_static_chain *const static_chain,
+                                   const uint8_t *const static_chain_data,
+                                   const size_t static_chain_len)
+{
+	if(static_chain_data == NULL || static_chain_len > ROHC_DECOMP_STATIC_CHAIN_MAX_LEN)
+	{
+		static_chain->len = 0;
+		return;
+	}
+
+	memcpy(static_chain->data, static_chain_data, static_chain_len);
+	static_chain->len = static_chain_len;
+	rohc_decomp_debug(context, "keep the %zu-byte static chain in context",
+	                  static_chain_len);
+}
+
+
+/**
+ * @brief Allocate memory for the profile-specific parts of a context
+ *
+ * The memory is taken from the slab of the decompressor for the objects of
+ * the given length. The slab is created the first time that such an object
+ * is required, it grows with the number of contexts and its memory is
+ * recycled when contexts are destroyed. The memory is zeroed.
+ *
+ * @param context  The decompression context that requires the memory
+ * @param len      The length of the memory to allocate (in bytes)
+ * @return         The allocated memory, NULL if no memory is available
+ */
+void * rohc_decomp_ctxt_zalloc(const struct rohc_decomp_ctxt *const context,
+                               const size_t len)
+{
+	struct slab *const slab = rohc_decomp_get_ctxt_slab(context->decompressor, len);
+
+	if(slab == NULL)
+	{
+		rohc_decomp_warn(context, "no slab left for %zu-byte objects", len);
+		goto error;
+	}
+
+	return slab_alloc(slab);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Release the memory of the profile-specific parts of a context
+ *
+ * The memory is given back to its slab, not to the system allocator.
+ *
+ * @param ptr  The memory allocated by \ref rohc_decomp_ctxt_zalloc,
+ *             NULL to do nothing
+ */
+void rohc_decomp_ctxt_free(void *const ptr)
+{
+	slab_release(ptr);
+}
+
+
 /**
  * @brief Build a positive ACK feedback
  *
@@ -3377,6 +3978,70 @@ error:
 	return false;
 }
 
+/**
+ * @brief Reserve the memory of all the decompression contexts at once
+ *
+ * By default, the memory of the decompression contexts is reserved by
+ * chunks as new contexts are created. Once the function is called, the
+ * memory of MAX_CID + 2 contexts is reserved in one contiguous block, so
+ * that the creation of the generic part of a context never calls the system
+ * allocator. The memory is given back when the decompressor is destroyed.
+ *
+ * The profile-specific parts of MAX_CID + 2 contexts are reserved too for
+ * every enabled profile, and for every profile enabled later on. The memory
+ * of one profile-specific part is shared by the profiles that use objects of
+ * the same length, so the memory reserved for the contexts grows with
+ * MAX_CID and with the largest enabled profiles.
+ *
+ * The function is usually called before the first packet is decompressed.
+ * If called later, the memory of the contexts that were not reserved yet is
+ * reserved in one block.
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        true if the contexts were reserved,
+ *                false if no memory is available
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_reserve_contexts(struct rohc_decomp *const decomp)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	if(!slab_reserve(&decomp->ctxts_pool))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot allocate memory for the pool of contexts");
+		goto error;
+	}
+
+	for(size_t major = 0; major <= ROHC_PROFILE_ID_MAJOR_MAX; major++)
+	{
+		for(size_t minor = 0; minor <= ROHC_PROFILE_ID_MINOR_MAX; minor++)
+		{
+			if(decomp->enabled_profiles[major][minor] &&
+			   !rohc_decomp_reserve_profile(decomp, rohc_decomp_profiles[major][minor]))
+			{
+				goto error;
+			}
+		}
+	}
+	decomp->ctxts_reserved = true;
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "memory of %zu decompression contexts reserved",
+	          decomp->ctxts_pool.objs_max);
+
+	return true;
+
+error:
+	return false;
+}
+
 
 /**
  * @brief Is the given decompression profile enabled for a decompressor?
@@ -3523,6 +4188,27 @@ bool rohc_decomp_enable_profile(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
+	/* the volatile buffers shared by all the contexts shall be large enough
+	 * for the new profile */
+	if(!rohc_decomp_grow_volat_ctxt(decomp, rohc_decomp_profiles[profile_major][profile_minor]))
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "failed to enable ROHC decompression profile 0x%04x: not "
+		           "enough memory for its volatile data", profile);
+		goto error;
+	}
+
+	/* the contexts of the new profile shall be reserved too if the
+	 * application reserved the contexts already */
+	if(decomp->ctxts_reserved &&
+	   !rohc_decomp_reserve_profile(decomp, rohc_decomp_profiles[profile_major][profile_minor]))
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "failed to enable ROHC decompression profile 0x%04x: not "
+		           "enough memory for its contexts", profile);
+		goto error;
+	}
+
 	/* mark the profile as enabled */
 	decomp->enabled_profiles[profile_major][profile_minor] = true;
 	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -3768,6 +4454,61 @@ error:
 }
 
 
+/**
+ * @brief Set the minimum level of the traces in decompressor
+ *
+ * Traces with a level lower than the given one are not passed to the
+ * callback function defined with \ref rohc_decomp_set_traces_cb2. They are
+ * discarded before being formatted, so that a decompressor with a callback
+ * that is only interested in warnings and errors does not spend time on the
+ * many debug traces emitted for every packet.
+ *
+ * The default level is \ref ROHC_TRACE_DEBUG, ie. all the traces are passed
+ * to the callback function.
+ *
+ * @warning The level can not be modified after library initialization
+ *
+ * @param decomp  The ROHC decompressor
+ * @param level   The minimum level of the traces to pass to the callback
+ * @return        true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_traces_level(struct rohc_decomp *const decomp,
+                                  const rohc_trace_level_t level)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* refuse to set a new trace level if decompressor is in use */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace level after initialization");
+		goto error;
+	}
+
+	/* check the trace level */
+	if(level >= ROHC_TRACE_LEVEL_MAX)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unknown trace "
+		           "level %d", level);
+		goto error;
+	}
+
+	decomp->trace_level = level;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /*
  * Private functions
  */
@@ -4265,10 +5006,15 @@ error:
 
 
 /**
- * @brief Create the array of decompression contexts
+ * @brief Create the array and the pool of decompression contexts
  *
  * The maximum size of the array is \ref ROHC_LARGE_CID_MAX + 1.
  *
+ * The pool holds MAX_CID + 2 contexts, since a new context for one CID is
+ * created before the former context for the same CID is destroyed. The pool
+ * grows by chunks of memory as contexts are created, unless all the
+ * contexts are reserved at once with \ref rohc_decomp_reserve_contexts.
+ *
  * @param decomp   The ROHC decompressor
  * @param max_cid  The MAX_CID value to used
  * @return         true if the contexts were created, false otherwise
@@ -4289,6 +5035,161 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "room for %u decompression contexts created", max_cid + 1);
 
+	/* create the pool of contexts, its memory is reserved on demand */
+	slab_new(&decomp->ctxts_pool, sizeof(struct rohc_decomp_ctxt), max_cid + 2,
+	         NULL, NULL, NULL);
+	decomp->ctxt_slabs_nr = 0;
+	decomp->ctxts_reserved = false;
+
+	return true;
+}
+
+
+/**
+ * @brief Grow the volatile buffers shared by all the decompression contexts
+ *
+ * The volatile part of the decompression contexts lasts one single packet,
+ * so all the contexts of one decompressor share the same buffers for the
+ * extracted bits and the decoded values. The buffers are grown to the needs
+ * of the given profile, they never shrink.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The decompression profile that shall fit in the buffers
+ * @return         true if the buffers are large enough for the profile,
+ *                 false if memory is missing
+ */
+static bool rohc_decomp_grow_volat_ctxt(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_profile *const profile)
+{
+	struct rohc_decomp_volat_ctxt *const volat_ctxt = &decomp->volat_ctxt;
+
+	if(volat_ctxt->extr_bits_size < profile->extr_bits_size)
+	{
+		void *const extr_bits = malloc(profile->extr_bits_size);
+		if(extr_bits == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "cannot allocate memory for the extracted bits");
+			goto error;
+		}
+		free(volat_ctxt->extr_bits);
+		volat_ctxt->extr_bits = extr_bits;
+		volat_ctxt->extr_bits_size = profile->extr_bits_size;
+	}
+
+	if(volat_ctxt->decoded_values_size < profile->decoded_size)
+	{
+		void *const decoded_values = malloc(profile->decoded_size);
+		if(decoded_values == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "cannot allocate memory for the decoded values");
+			goto error;
+		}
+		free(volat_ctxt->decoded_values);
+		volat_ctxt->decoded_values = decoded_values;
+		volat_ctxt->decoded_values_size = profile->decoded_size;
+	}
+
 	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the slab for the profile-specific objects of the given length
+ *
+ * The slab is created the first time that such objects are required. One
+ * context may use several objects of the same length, so the number of
+ * objects of one slab is only bounded by the number of contexts.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param len     The length of the objects (in bytes)
+ * @return        The slab for the objects, NULL if no slab is left
+ */
+static struct slab * rohc_decomp_get_ctxt_slab(struct rohc_decomp *const decomp,
+                                               const size_t len)
+{
+	size_t i;
+
+	/* search for the slab of the objects of the given length */
+	for(i = 0; i < decomp->ctxt_slabs_nr && decomp->ctxt_slabs[i].obj_len != len; i++)
+	{
+	}
+	if(i == decomp->ctxt_slabs_nr)
+	{
+		if(decomp->ctxt_slabs_nr >= ROHC_DECOMP_CTXT_SLABS_NR)
+		{
+			goto error;
+		}
+		slab_new(&decomp->ctxt_slabs[i], len, SIZE_MAX, NULL, NULL, NULL);
+		decomp->ctxt_slabs_nr++;
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "create slab #%zu for %zu-byte objects", i + 1, len);
+	}
+
+	return &decomp->ctxt_slabs[i];
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Reserve the profile-specific parts of all the contexts at once
+ *
+ * The objects that the profile allocates for every context are reserved for
+ * the max number of contexts. The objects of the same length share the same
+ * slab, so the slab is reserved for all the objects of that length that one
+ * context of the profile uses.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The decompression profile to reserve the contexts for
+ * @return         true if the contexts were reserved,
+ *                 false if no memory is available
+ */
+static bool rohc_decomp_reserve_profile(struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_profile *const profile)
+{
+	for(size_t i = 0; i < ROHC_DECOMP_CTXT_SLABS_PER_PROFILE; i++)
+	{
+		const size_t len = profile->ctxt_objs[i].len;
+		size_t objs_nr = 0;
+		struct slab *slab;
+
+		if(len == 0)
+		{
+			continue;
+		}
+		for(size_t j = 0; j < ROHC_DECOMP_CTXT_SLABS_PER_PROFILE; j++)
+		{
+			if(profile->ctxt_objs[j].len == len)
+			{
+				objs_nr += profile->ctxt_objs[j].nr;
+			}
+		}
+
+		slab = rohc_decomp_get_ctxt_slab(decomp, len);
+		if(slab == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "no slab left for %zu-byte objects", len);
+			goto error;
+		}
+		if(!slab_reserve_nr(slab, objs_nr * decomp->ctxts_pool.objs_max))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "cannot allocate memory for %zu %zu-byte objects",
+			             objs_nr * decomp->ctxts_pool.objs_max, len);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
@@ -326,6 +326,21 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                                  struct rohc_buf *const packet,
+                                                  struct rohc_buf *const rcvd_feedback,
+                                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                         const struct rohc_buf *const rohc_packets,
+                                         struct rohc_buf *const uncomp_packets,
+                                         rohc_status_t *const statuses,
+                                         const size_t packets_nr,
+                                         struct rohc_buf *const rcvd_feedback,
+                                         struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
 
 
 /*
@@ -403,6 +418,11 @@ bool ROHC_EXPORT rohc_decomp_set_features(struct rohc_decomp *const decomp,
                                           const rohc_decomp_features_t features)
 	__attribute__((warn_unused_result));
 
+/* memory of the decompression contexts */
+
+bool ROHC_EXPORT rohc_decomp_reserve_contexts(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to decompression profiles
@@ -438,6 +458,10 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_traces_level(struct rohc_decomp *const decomp,
+                                              const rohc_trace_level_t level)
+	__attribute__((warn_unused_result));
+
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
@@ -32,12 +32,25 @@
 #include "rohc_traces_internal.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "slab.h"
 
 
 /*
  * Constants and macros
  */
 
+/** The max number of lengths of objects that one profile allocates with
+ *  \ref rohc_decomp_ctxt_zalloc for the profile-specific part of a context:
+ *  the RFC3095 part, the header changes, the profile part and the next
+ *  header of the header changes */
+#define ROHC_DECOMP_CTXT_SLABS_PER_PROFILE  5U
+
+/** The max number of slabs for the profile-specific parts of the contexts,
+ *  one per length of object: enough for all the profiles of the library */
+#define ROHC_DECOMP_CTXT_SLABS_NR \
+	((ROHC_PROFILE_ID_MAJOR_MAX + 1U) * (ROHC_PROFILE_ID_MINOR_MAX + 1U) * \
+	 ROHC_DECOMP_CTXT_SLABS_PER_PROFILE)
+
 
 /** Print a warning trace for the given decompression context */
 #define rohc_decomp_warn(context, format, ...) \
@@ -132,6 +145,51 @@ struct rohc_ack_stats
 };
 
 
+/** The information related to the CRC of a ROHC packet */
+struct rohc_decomp_crc_one
+{
+	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
+	uint8_t bits;          /**< The CRC bits found in ROHC header */
+};
+
+
+/** The information related to the CRC(s) of a ROHC packet */
+struct rohc_decomp_crc
+{
+	/** The CRC over the compressed header extracted from the ROHC packet */
+	struct rohc_decomp_crc_one comp;
+	/** The CRC over the uncompressed header extracted from the ROHC packet */
+	struct rohc_decomp_crc_one uncomp;
+};
+
+
+/**
+ * @brief The volatile part of the ROHC decompression context
+ *
+ * The volatile part of the ROHC decompression context lasts only one single
+ * packet. Between two ROHC packets, the volatile part of the context is
+ * erased. It is thus shared by all the contexts of one decompressor: its
+ * buffers are sized for the largest of the enabled profiles.
+ */
+struct rohc_decomp_volat_ctxt
+{
+	/** The CRC(s) information extracted from the ROHC packet */
+	struct rohc_decomp_crc crc;
+
+	/** The profile-specific data for bits extracted from the ROHC packet,
+	 * defined by the profiles */
+	void *extr_bits;
+	/** The length (in bytes) of the buffer for the extracted bits */
+	size_t extr_bits_size;
+
+	/** The profile-specific data for values decoded from persistent context
+	 * and bits extracted from the ROHC packet, defined by the profiles */
+	void *decoded_values;
+	/** The length (in bytes) of the buffer for the decoded values */
+	size_t decoded_values_size;
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
@@ -153,8 +211,21 @@ struct rohc_decomp
 	struct rohc_decomp_ctxt **contexts;
 	/** The number of decompression contexts in use */
 	uint16_t num_contexts_used;
+	/** The pool of the decompression contexts, reserved by chunks or at
+	 *  once with \ref rohc_decomp_reserve_contexts */
+	struct slab ctxts_pool;
+	/** The slabs of the profile-specific parts of the contexts */
+	struct slab ctxt_slabs[ROHC_DECOMP_CTXT_SLABS_NR];
+	/** The number of slabs in use in the ctxt_slabs array */
+	size_t ctxt_slabs_nr;
+	/** Whether the contexts were reserved with
+	 *  \ref rohc_decomp_reserve_contexts, the contexts of the profiles
+	 *  enabled later are then reserved too */
+	bool ctxts_reserved;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The volatile data shared by all the decompression contexts */
+	struct rohc_decomp_volat_ctxt volat_ctxt;
 
 
 	/* feedback-related variables */
@@ -188,6 +259,8 @@ struct rohc_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 };
 
 
@@ -221,43 +294,22 @@ struct rohc_decomp_crc_corr_ctxt
 };
 
 
-/** The information related to the CRC of a ROHC packet */
-struct rohc_decomp_crc_one
-{
-	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
-	uint8_t bits;          /**< The CRC bits found in ROHC header */
-};
-
-
-/** The information related to the CRC(s) of a ROHC packet */
-struct rohc_decomp_crc
-{
-	/** The CRC over the compressed header extracted from the ROHC packet */
-	struct rohc_decomp_crc_one comp;
-	/** The CRC over the uncompressed header extracted from the ROHC packet */
-	struct rohc_decomp_crc_one uncomp;
-};
-
+/** The maximum length of the static chain that a context keeps from its last
+ *  IR packet: every kept static chain takes 128 bytes with its length */
+#define ROHC_DECOMP_STATIC_CHAIN_MAX_LEN  127U
 
 /**
- * @brief The volatile part of the ROHC decompression context
+ * @brief The raw static chain of the last IR packet applied to a context
  *
- * The volatile part of the ROHC decompression context lasts only one single
- * packet. Between two ROHC packets, the volatile part of the context is
- * erased.
+ * IR refreshes nearly always carry the very same static chain: comparing it
+ * with the static chain kept in context avoids parsing it again.
  */
-struct rohc_decomp_volat_ctxt
+struct rohc_decomp_static_chain
 {
-	/** The CRC(s) information extracted from the ROHC packet */
-	struct rohc_decomp_crc crc;
-
-	/** The profile-specific data for bits extracted from the ROHC packet,
-	 * defined by the profiles */
-	void *extr_bits;
-
-	/** The profile-specific data for values decoded from persistent context
-	 * and bits extracted from the ROHC packet, defined by the profiles */
-	void *decoded_values;
+	/** The raw static chain */
+	uint8_t data[ROHC_DECOMP_STATIC_CHAIN_MAX_LEN];
+	/** The length of the raw static chain, 0 if none is kept */
+	uint8_t len;
 };
 
 
@@ -276,8 +328,6 @@ struct rohc_decomp_ctxt
 	const struct rohc_decomp_profile *profile;
 	/** The persistent profile-specific data, defined by the profiles */
 	void *persist_ctxt;
-	/** The volatile data, erased between two ROHC packets */
-	struct rohc_decomp_volat_ctxt volat_ctxt;
 
 	/** The operation mode in which the context operates */
 	rohc_mode_t mode;
@@ -335,13 +385,10 @@ struct rohc_decomp_ctxt
 
 
 typedef bool (*rohc_decomp_new_context_t)(const struct rohc_decomp_ctxt *const context,
-                                          void **const persist_ctxt,
-                                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                          void **const persist_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
-                                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt);
 
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
@@ -391,6 +438,15 @@ typedef uint32_t (*rohc_decomp_get_sn_t)(const struct rohc_decomp_ctxt *const co
 	__attribute__((warn_unused_result, nonnull(1)));
 
 
+/** One kind of objects that a profile allocates with
+ *  \ref rohc_decomp_ctxt_zalloc for every context */
+struct rohc_decomp_ctxt_obj
+{
+	size_t len;  /**< The length (in bytes) of the objects, 0 if unused */
+	size_t nr;   /**< The number of such objects per context */
+};
+
+
 /**
  * @brief The ROHC decompression profile.
  *
@@ -405,6 +461,14 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
+	/** The length (in bytes) of the bits extracted by the profile */
+	const size_t extr_bits_size;
+	/** The length (in bytes) of the values decoded by the profile */
+	const size_t decoded_size;
+	/** The objects allocated by the profile for every context, so that they
+	 *  may be reserved with \ref rohc_decomp_reserve_contexts */
+	const struct rohc_decomp_ctxt_obj ctxt_objs[ROHC_DECOMP_CTXT_SLABS_PER_PROFILE];
+
 	/** @brief The handler used to create the profile-specific part of the
 	 *         decompression context */
 	rohc_decomp_new_context_t new_context;
@@ -435,5 +499,24 @@ struct rohc_decomp_profile
 	rohc_decomp_get_sn_t get_sn;
 };
 
+
+bool rohc_decomp_is_static_chain_unchanged(const struct rohc_decomp_ctxt *const context,
+                                           const struct rohc_decomp_static_chain *const static_chain,
+                                           const uint8_t *const rohc_data,
+                                           const size_t rohc_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+void rohc_decomp_keep_static_chain(const struct rohc_decomp_ctxt *const context,
+                                   struct rohc_decomp_static_chain *const static_chain,
+                                   const uint8_t *const static_chain_data,
+                                   const size_t static_chain_len)
+	__attribute__((nonnull(1, 2)));
+
+void * rohc_decomp_ctxt_zalloc(const struct rohc_decomp_ctxt *const context,
+                               const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_decomp_ctxt_free(void *const ptr);
+
 #endif
 
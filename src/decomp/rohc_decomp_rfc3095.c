@@ -52,6 +52,11 @@
  * of the IR and IR-DYN headers
  */
 
+static int parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const packet,
+                              const size_t length,
+                              struct rohc_extr_bits *const bits)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 static int parse_static_part_ip(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *const packet,
                                 const size_t length,
@@ -348,24 +353,25 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
  *
  * @param context            The decompression context
  * @param[out] persist_ctxt  The persistent part of the decompression context
- * @param[out] volat_ctxt    The volatile part of the decompression context
  * @param trace_cb           The function to call for printing traces
  * @param trace_cb_priv      An optional private context, may be NULL
+ * @param trace_level        The minimum level of the traces to emit
  * @param profile_id         The ID of the associated decompression profile
  * @return                   true if the Uncompressed context was successfully
  *                           created, false if a problem occurred
  */
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                                struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_level,
                                 const int profile_id)
 {
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* allocate memory for the generic context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc3095_ctxt));
+	*persist_ctxt =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct rohc_decomp_rfc3095_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -379,7 +385,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* create the Offset IP-ID decoding context for inner IP header */
 	ip_id_offset_init(&rfc3095_ctxt->inner_ip_id_offset_ctxt);
 
-	rfc3095_ctxt->outer_ip_changes = calloc(2, sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->outer_ip_changes =
+		rohc_decomp_ctxt_zalloc(context, 2 * sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->outer_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -387,7 +394,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 		goto free_context;
 	}
 
-	rfc3095_ctxt->inner_ip_changes = calloc(1, sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->inner_ip_changes =
+		rohc_decomp_ctxt_zalloc(context, sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->inner_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -398,9 +406,11 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp1,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           trace_cb, trace_cb_priv, trace_level,
+	                           profile_id);
 	rohc_decomp_list_ipv6_init(&rfc3095_ctxt->list_decomp2,
-	                           trace_cb, trace_cb_priv, profile_id);
+	                           trace_cb, trace_cb_priv, trace_level,
+	                           profile_id);
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
@@ -411,34 +421,12 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt->is_crc_static_3_cached_valid = false;
 	rfc3095_ctxt->is_crc_static_7_cached_valid = false;
 
-	/* volatile part of the decompression context */
-	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_inner_ip_changes;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_extr_bits;
-	}
-
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
 free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes);
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_decomp_ctxt_free(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -451,24 +439,18 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The generic decompression context
- * @param volat_ctxt    The volatile part of the decompression context
  */
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-
 	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->outer_ip_changes);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->inner_ip_changes);
 
 	/* destroy profile-specific part */
-	zfree(rfc3095_ctxt->specific);
+	rohc_decomp_ctxt_free(rfc3095_ctxt->specific);
 
 	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	rohc_decomp_ctxt_free(rfc3095_ctxt);
 }
 
 
@@ -706,17 +688,133 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	rohc_remain_len--;
 	(*rohc_hdr_len)++;
 
+	/* skip the static chain if it is the one of the previous IR packet,
+	 * parse it otherwise */
+	if(rohc_decomp_is_static_chain_unchanged(context, &rfc3095_ctxt->static_chain,
+	                                         rohc_remain_data, rohc_remain_len))
+	{
+		size = rfc3095_ctxt->static_chain.len;
+	}
+	else
+	{
+		size = parse_static_chain(context, rohc_remain_data, rohc_remain_len, bits);
+		if(size == -1)
+		{
+			rohc_decomp_warn(context, "cannot parse the static chain");
+			goto error;
+		}
+		bits->static_chain = rohc_remain_data;
+		bits->static_chain_len = size;
+	}
+	rohc_remain_data += size;
+	rohc_remain_len -= size;
+	*rohc_hdr_len += size;
+
+	/* decode the dynamic part of the ROHC packet */
+	if(dynamic_present)
+	{
+		/* decode the dynamic part of the outer IP header */
+		size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
+		                             &bits->outer_ip, &rfc3095_ctxt->list_decomp1);
+		if(size == -1)
+		{
+			rohc_decomp_warn(context, "cannot parse outer IP dynamic part");
+			goto error;
+		}
+		rohc_remain_data += size;
+		rohc_remain_len -= size;
+		*rohc_hdr_len += size;
+
+		/* decode the dynamic part of the inner IP header */
+		if(bits->multiple_ip)
+		{
+			size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
+			                             &bits->inner_ip, &rfc3095_ctxt->list_decomp2);
+			if(size == -1)
+			{
+				rohc_decomp_warn(context, "cannot parse inner IP dynamic part");
+				goto error;
+			}
+			rohc_remain_data += size;
+			rohc_remain_len -= size;
+			*rohc_hdr_len += size;
+		}
+
+		/* parse the dynamic part of the next header header if necessary */
+		if(rfc3095_ctxt->parse_dyn_next_hdr != NULL)
+		{
+			size = rfc3095_ctxt->parse_dyn_next_hdr(context, rohc_remain_data,
+			                                        rohc_remain_len, bits);
+			if(size == -1)
+			{
+				rohc_decomp_warn(context, "cannot parse next header dynamic part");
+				goto error;
+			}
+#ifndef __clang_analyzer__ /* silent warning about dead increment */
+			rohc_remain_data += size;
+			rohc_remain_len -= size;
+#endif
+			*rohc_hdr_len += size;
+		}
+	}
+	else if(context->state != ROHC_DECOMP_STATE_FC)
+	{
+		/* in 'Static Context' or 'No Context' state and the packet does not
+		 * contain a dynamic part */
+		rohc_decomp_warn(context, "receive IR packet without a dynamic part, "
+		                 "but not in Full Context state");
+		goto error;
+	}
+
+	/* sanity checks */
+	assert((*rohc_hdr_len) <= rohc_length);
+
+	/* invalid CRC-STATIC cache since some STATIC fields may have changed */
+	rfc3095_ctxt->is_crc_static_3_cached_valid = false;
+	rfc3095_ctxt->is_crc_static_7_cached_valid = false;
+
+	/* IR packet was successfully parsed */
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the static chain of one IR packet
+ *
+ * The static chain is made of the static parts of the outer IP header, of
+ * the inner IP header if any, and of the next header if any.
+ *
+ * @param context     The decompression context
+ * @param packet      The ROHC packet to parse
+ * @param length      The length of the ROHC packet
+ * @param bits        OUT: The bits extracted from the static chain
+ * @return            The number of bytes read in the ROHC packet,
+ *                    -1 in case of failure
+ */
+static int parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const packet,
+                              const size_t length,
+                              struct rohc_extr_bits *const bits)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const uint8_t *remain_data = packet;
+	size_t remain_len = length;
+	int size;
+
 	/* decode the static part of the outer header */
-	size = parse_static_part_ip(context, rohc_remain_data, rohc_remain_len,
+	size = parse_static_part_ip(context, remain_data, remain_len,
 	                            &bits->outer_ip);
 	if(size == -1)
 	{
 		rohc_decomp_warn(context, "cannot parse the outer IP static part");
 		goto error;
 	}
-	rohc_remain_data += size;
-	rohc_remain_len -= size;
-	*rohc_hdr_len += size;
+	remain_data += size;
+	remain_len -= size;
 
 	/* check for IP version switch during context re-use */
 	if(context->num_recv_packets >= 1 &&
@@ -762,16 +860,15 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	 * if multiple IP headers */
 	if(bits->multiple_ip)
 	{
-		size = parse_static_part_ip(context, rohc_remain_data, rohc_remain_len,
+		size = parse_static_part_ip(context, remain_data, remain_len,
 		                            &bits->inner_ip);
 		if(size == -1)
 		{
 			rohc_decomp_warn(context, "cannot parse inner IP static part");
 			goto error;
 		}
-		rohc_remain_data += size;
-		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
+		remain_data += size;
+		remain_len -= size;
 
 		/* check for IP version switch during context re-use */
 		if(context->num_recv_packets >= 1 &&
@@ -788,86 +885,23 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	/* parse the static part of the next header header if necessary */
 	if(rfc3095_ctxt->parse_static_next_hdr != NULL)
 	{
-		size = rfc3095_ctxt->parse_static_next_hdr(context, rohc_remain_data,
-		                                           rohc_remain_len, bits);
+		size = rfc3095_ctxt->parse_static_next_hdr(context, remain_data,
+		                                           remain_len, bits);
 		if(size == -1)
 		{
 			rohc_decomp_warn(context, "cannot parse next header static part");
 			goto error;
 		}
-		rohc_remain_data += size;
-		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
-	}
-
-	/* decode the dynamic part of the ROHC packet */
-	if(dynamic_present)
-	{
-		/* decode the dynamic part of the outer IP header */
-		size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
-		                             &bits->outer_ip, &rfc3095_ctxt->list_decomp1);
-		if(size == -1)
-		{
-			rohc_decomp_warn(context, "cannot parse outer IP dynamic part");
-			goto error;
-		}
-		rohc_remain_data += size;
-		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
-
-		/* decode the dynamic part of the inner IP header */
-		if(bits->multiple_ip)
-		{
-			size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
-			                             &bits->inner_ip, &rfc3095_ctxt->list_decomp2);
-			if(size == -1)
-			{
-				rohc_decomp_warn(context, "cannot parse inner IP dynamic part");
-				goto error;
-			}
-			rohc_remain_data += size;
-			rohc_remain_len -= size;
-			*rohc_hdr_len += size;
-		}
-
-		/* parse the dynamic part of the next header header if necessary */
-		if(rfc3095_ctxt->parse_dyn_next_hdr != NULL)
-		{
-			size = rfc3095_ctxt->parse_dyn_next_hdr(context, rohc_remain_data,
-			                                        rohc_remain_len, bits);
-			if(size == -1)
-			{
-				rohc_decomp_warn(context, "cannot parse next header dynamic part");
-				goto error;
-			}
-#ifndef __clang_analyzer__ /* silent warning about dead increment */
-			rohc_remain_data += size;
-			rohc_remain_len -= size;
+		remain_data += size;
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+		remain_len -= size;
 #endif
-			*rohc_hdr_len += size;
-		}
-	}
-	else if(context->state != ROHC_DECOMP_STATE_FC)
-	{
-		/* in 'Static Context' or 'No Context' state and the packet does not
-		 * contain a dynamic part */
-		rohc_decomp_warn(context, "receive IR packet without a dynamic part, "
-		                 "but not in Full Context state");
-		goto error;
 	}
 
-	/* sanity checks */
-	assert((*rohc_hdr_len) <= rohc_length);
-
-	/* invalid CRC-STATIC cache since some STATIC fields may have changed */
-	rfc3095_ctxt->is_crc_static_3_cached_valid = false;
-	rfc3095_ctxt->is_crc_static_7_cached_valid = false;
-
-	/* IR packet was successfully parsed */
-	return true;
+	return (remain_data - packet);
 
 error:
-	return false;
+	return -1;
 }
 
 
@@ -5422,7 +5456,8 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_packet_descr(packet_type),
 			                 rohc_decomp_get_state_descr(context->state),
 			                 rohc_get_mode_descr(context->mode));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0 &&
+			   rohc_trace_is_enabled(decomp, ROHC_TRACE_WARNING))
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -5958,6 +5993,10 @@ rohc_status_t rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const co
 
 	decoded->is_context_reused = bits->is_context_reused;
 
+	/* static chain of IR packets */
+	decoded->static_chain = bits->static_chain;
+	decoded->static_chain_len = bits->static_chain_len;
+
 	/* decode context mode */
 	if(bits->mode_nr > 0 && bits->mode != 0)
 	{
@@ -6578,6 +6617,21 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 		context->is_duplicated = false;
 	}
 
+	/* keep the static chain of IR packets for the next IR packets, forget it
+	 * if Extension 3 changed one of the IP protocols it contains */
+	if(decoded->static_chain != NULL)
+	{
+		rohc_decomp_keep_static_chain(context, &rfc3095_ctxt->static_chain,
+		                              decoded->static_chain,
+		                              decoded->static_chain_len);
+	}
+	else if(decoded->outer_ip.proto != ip_get_protocol(&rfc3095_ctxt->outer_ip_changes->ip) ||
+	        (rfc3095_ctxt->multiple_ip &&
+	         decoded->inner_ip.proto != ip_get_protocol(&rfc3095_ctxt->inner_ip_changes->ip)))
+	{
+		rohc_decomp_keep_static_chain(context, &rfc3095_ctxt->static_chain, NULL, 0);
+	}
+
 	/* update SN */
 	rohc_lsb_set_ref(&rfc3095_ctxt->sn_lsb_ctxt, decoded->sn, keep_ref_minus_1);
 
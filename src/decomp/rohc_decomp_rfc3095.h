@@ -211,6 +211,11 @@ struct rohc_extr_bits
 	uint32_t esp_spi;      /**< The SPI bits found in static chain of
 	                             IR header */
 	size_t esp_spi_nr;     /**< The number of SPI bits found in header */
+
+
+	/** The static chain of the IR header, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 
@@ -275,6 +280,10 @@ struct rohc_decoded_values
 	/* bits below are for ESP profile only
 	   @todo TODO should be moved in d_esp.c */
 	uint32_t esp_spi;       /**< The decoded ESP SPI */
+
+	/** The static chain of the IR header, NULL if not parsed */
+	const uint8_t *static_chain;
+	size_t static_chain_len; /**< The length of the static chain */
 };
 
 
@@ -305,6 +314,14 @@ struct rohc_decomp_rfc3095_changes
 };
 
 
+/** The objects allocated for the RFC3095 part of every context: the part
+ *  itself, the changes of the outer IP headers and of the inner IP header */
+#define ROHC_DECOMP_RFC3095_CTXT_OBJS \
+	{ .len = sizeof(struct rohc_decomp_rfc3095_ctxt), .nr = 1 }, \
+	{ .len = 2 * sizeof(struct rohc_decomp_rfc3095_changes), .nr = 1 }, \
+	{ .len = sizeof(struct rohc_decomp_rfc3095_changes), .nr = 1 }
+
+
 /**
  * @brief The generic decompression context for RFC3095-based profiles
  *
@@ -343,6 +360,9 @@ struct rohc_decomp_rfc3095_ctxt
 	/** The cache for the CRC-7 value on CRC-STATIC fields */
 	uint8_t crc_static_7_cached;
 
+	/** The static chain of the last IR packet */
+	struct rohc_decomp_static_chain static_chain;
+
 	/* below are some information and handlers to manage the next header
 	 * (if any) located just after the IP headers (1 or 2 IP headers) */
 
@@ -432,15 +452,14 @@ struct rohc_decomp_rfc3095_ctxt
 
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
-                                struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_level,
                                 const int profile_id)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
@@ -32,25 +32,27 @@
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
+ * The CRC is computed from the bytes that changed since the headers of the
+ * previous CRC of the same type, see \ref crc_calc_hdrs
+ *
  * @param context      The decompression context
+ * @param crc_cache    The CRCs over the previous uncompressed headers
  * @param uncomp_hdrs  The uncompressed headers
  * @param crc_pkt      The CRC over uncompressed headers extracted from packet
  * @return             true if the CRC is correct, false otherwise
  */
 bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
+                                  struct crc_hdrs_cache *const crc_cache,
                                   struct rohc_buf *const uncomp_hdrs,
                                   const struct rohc_decomp_crc_one *const crc_pkt)
 {
 	uint8_t crc_computed;
 
-	/* determine the initial value and the pre-computed table for the CRC */
+	/* only CRC-3 and CRC-7 protect uncompressed headers */
 	switch(crc_pkt->type)
 	{
 		case ROHC_CRC_TYPE_3:
-			crc_computed = CRC_INIT_3;
-			break;
 		case ROHC_CRC_TYPE_7:
-			crc_computed = CRC_INIT_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			rohc_decomp_warn(context, "unexpected CRC type %d", crc_pkt->type);
@@ -64,9 +66,8 @@ bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* compute the CRC from built uncompressed headers */
-	crc_computed =
-		crc_calculate(crc_pkt->type, rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len,
-		              crc_computed);
+	crc_computed = crc_calc_hdrs(crc_cache, crc_pkt->type,
+	                             rohc_buf_data(*uncomp_hdrs), uncomp_hdrs->len);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_pkt->type, crc_computed);
 
@@ -35,9 +35,10 @@
 
 
 bool rohc_decomp_check_uncomp_crc(const struct rohc_decomp_ctxt *const context,
+                                  struct crc_hdrs_cache *const crc_cache,
                                   struct rohc_buf *const uncomp_hdrs,
                                   const struct rohc_decomp_crc_one *const crc_pkt)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 #endif
 
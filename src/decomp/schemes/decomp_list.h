@@ -90,6 +90,8 @@ struct list_decomp
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
 	void *trace_callback_priv;
+	/** The minimum level of the traces passed to the callback function */
+	rohc_trace_level_t trace_level;
 	/** The profile ID the decompression list was created for */
 	int profile_id;
 };
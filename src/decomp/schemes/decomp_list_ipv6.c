@@ -63,11 +63,13 @@ static size_t rohc_build_ip6_extension(const struct list_decomp *const decomp,
  * @param decomp         The context to create
  * @param trace_cb       The function to call for printing traces
  * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_level    The minimum level of the traces to emit
  * @param profile_id     The ID of the associated decompression profile
  */
 void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
+                                const rohc_trace_level_t trace_level,
                                 const int profile_id)
 {
 	/* specific callbacks for IPv6 extension headers */
@@ -80,6 +82,7 @@ void rohc_decomp_list_ipv6_init(struct list_decomp *const decomp,
 	/* traces */
 	decomp->trace_callback = trace_cb;
 	decomp->trace_callback_priv = trace_cb_priv;
+	decomp->trace_level = trace_level;
 	decomp->profile_id = profile_id;
 }
 
@@ -48,10 +48,12 @@
  * @param[in,out] ts_scaled  The scaled RTP Timestamp decoding context to init
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
+ * @param trace_level        The minimum level of the traces to emit
  */
 void d_init_sc(struct ts_sc_decomp *const ts_scaled,
                rohc_trace_callback2_t trace_cb,
-               void *const trace_cb_priv)
+               void *const trace_cb_priv,
+               const rohc_trace_level_t trace_level)
 {
 	ts_scaled->ts_stride = 0;
 	ts_scaled->ts_scaled = 0;
@@ -71,6 +73,7 @@ void d_init_sc(struct ts_sc_decomp *const ts_scaled,
 
 	ts_scaled->trace_callback = trace_cb;
 	ts_scaled->trace_callback_priv = trace_cb_priv;
+	ts_scaled->trace_level = trace_level;
 }
 
 
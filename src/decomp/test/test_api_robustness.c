@@ -111,6 +111,12 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_traces_level() */
+	CHECK(rohc_decomp_set_traces_level(NULL, ROHC_TRACE_WARNING) == false);
+	CHECK(rohc_decomp_set_traces_level(decomp, ROHC_TRACE_LEVEL_MAX) == false);
+	CHECK(rohc_decomp_set_traces_level(decomp, ROHC_TRACE_WARNING) == true);
+	CHECK(rohc_decomp_set_traces_level(decomp, ROHC_TRACE_DEBUG) == true);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -285,6 +291,14 @@ int main(int argc, char *argv[])
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR) == true);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
 
+	/* rohc_decomp_reserve_contexts */
+	CHECK(rohc_decomp_reserve_contexts(NULL) == false);
+	CHECK(rohc_decomp_reserve_contexts(decomp) == true);
+	CHECK(rohc_decomp_reserve_contexts(decomp) == true);
+	/* the contexts of the profiles enabled later on are reserved too */
+	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_TCP) == true);
+	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_TCP) == true);
+
 	/* rohc_decompress3() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -338,6 +352,36 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
 		CHECK(pkt2.len > 0);
 
+		/* rohc_decompress_inplace() */
+		{
+			uint8_t buf_inplace[100 + sizeof(buf)];
+			struct rohc_buf pkt_inplace = rohc_buf_init_empty(buf_inplace, sizeof(buf_inplace));
+			uint8_t buf_malformed[100];
+			struct rohc_buf pkt_malformed = rohc_buf_init_full(buf_malformed, 0, ts);
+
+			CHECK(rohc_decompress_inplace(NULL, &pkt_inplace, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_inplace(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_inplace(decomp, &pkt_inplace, NULL, NULL) == ROHC_STATUS_ERROR);
+
+			/* no headroom for the uncompressed headers */
+			rohc_buf_append(&pkt_inplace, buf, sizeof(buf));
+			CHECK(rohc_decompress_inplace(decomp, &pkt_inplace, &pkt_malformed, NULL) == ROHC_STATUS_ERROR);
+			CHECK(pkt_inplace.len == sizeof(buf));
+			CHECK(rohc_decompress_inplace(decomp, &pkt_inplace, NULL, &pkt_malformed) == ROHC_STATUS_ERROR);
+			CHECK(pkt_inplace.len == sizeof(buf));
+			CHECK(rohc_decompress_inplace(decomp, &pkt_inplace, NULL, NULL) != ROHC_STATUS_OK);
+			CHECK(pkt_inplace.len == 0);
+
+			/* enough headroom for the uncompressed headers */
+			pkt_inplace.offset = 100;
+			pkt_inplace.len = 0;
+			rohc_buf_append(&pkt_inplace, buf, sizeof(buf));
+			CHECK(rohc_decompress_inplace(decomp, &pkt_inplace, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt_inplace.len == pkt2.len);
+			CHECK((pkt_inplace.offset + pkt_inplace.len) == sizeof(buf_inplace));
+			CHECK(memcmp(rohc_buf_data(pkt_inplace), rohc_buf_data(pkt2), pkt2.len) == 0);
+		}
+
 		{
 			uint8_t buf_full[100];
 			struct rohc_buf pkt_full = rohc_buf_init_full(buf_full, 100, ts);
@@ -402,6 +446,7 @@ int main(int argc, char *argv[])
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
+		CHECK(rohc_decomp_set_traces_level(decomp, ROHC_TRACE_DEBUG) == false);
 	}
 
 	/* rohc_decomp_free() */
@@ -0,0 +1,1022 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_bench_schemes.c
+ * @brief  Microbenchmark of the encoding schemes
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The program measures the encoding schemes one by one, outside of any
+ * compressor or decompressor, with synthetic inputs:
+ *  \li W-LSB encoding (\ref c_add_wlsb, wlsb_is_kp_possible_* and
+ *      wlsb_get_minkp_*) for several window widths and several
+ *      distributions of values,
+ *  \li LSB decoding (\ref rohc_lsb_decode) for several numbers of bits,
+ *  \li SDVL encoding and decoding for every encoded length,
+ *  \li CRC-3/7/8 (\ref crc_calculate) and FCS-32 (\ref crc_calc_fcs32)
+ *      for several lengths of data,
+ *  \li list compression of IPv6 extension headers (\ref rohc_list_encode),
+ *  \li compression of the TCP options (c_tcp_code_tcp_opts_*).
+ *
+ * The inputs are generated before the measures start. The values are taken
+ * from a pool of values in a loop, so that the measures do not depend on
+ * the number of operations.
+ *
+ * The program outputs one JSON object on stdout with the number of
+ * nanoseconds and of CPU cycles per operation for every case. CPU cycles
+ * are read from the Time Stamp Counter on x86 processors only, so the
+ * number of cycles per operation is \e null on other processors.
+ */
+
+#include "schemes/comp_wlsb.h"
+#include "schemes/decomp_wlsb.h"
+#include "schemes/comp_list.h"
+#include "schemes/comp_list_ipv6.h"
+#include "c_tcp_opts_list.h"
+#include "rohc_comp_internals.h"
+#include "sdvl.h"
+#include "crc.h"
+#include "protocols/tcp.h"
+#include "protocols/ip_numbers.h"
+#include "bench_timing.h"
+
+#include <rohc/rohc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <assert.h>
+
+
+/** The default number of operations measured for every case */
+#define BENCH_OPS_DEFAULT  1000000U
+
+/** The number of values in the pools of inputs (power of 2) */
+#define BENCH_POOL_NR  4096U
+
+/** The number of synthetic packets for list and TCP options compression */
+#define BENCH_PKTS_NR  64U
+
+/** The number of repetitions for the Optimistic Approach */
+#define BENCH_OA_REPETITIONS_NR  4U
+
+
+/** The distributions of the values encoded with W-LSB */
+typedef enum
+{
+	BENCH_VALUES_SEQ    = 0, /**< Values increase by one (SN, IP-ID) */
+	BENCH_VALUES_JITTER = 1, /**< Values increase with jitter (RTP TS) */
+	BENCH_VALUES_RANDOM = 2, /**< Random values */
+	BENCH_VALUES_MAX
+} bench_values_t;
+
+/** The names of the distributions of values */
+static const char *const bench_values_descr[BENCH_VALUES_MAX] =
+{
+	[BENCH_VALUES_SEQ]    = "sequential",
+	[BENCH_VALUES_JITTER] = "jitter",
+	[BENCH_VALUES_RANDOM] = "random",
+};
+
+/** The parameters shared by all the cases */
+struct bench_ctxt
+{
+	size_t ops_nr;      /**< The number of operations for every case */
+	size_t results_nr;  /**< The number of results printed so far */
+	uint32_t rand_state; /**< The state of the pseudo-random generator */
+};
+
+
+/** The sink that keeps the compiler from removing the measured code */
+static volatile uint32_t bench_sink;
+
+
+/* prototypes of private functions */
+static void usage(void);
+
+static bool bench_wlsb(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_lsb_decode(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_sdvl(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_crc(struct bench_ctxt *const bench)
+	__attribute__((nonnull(1)));
+static bool bench_list(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_tcp_opts(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint32_t * bench_gen_values(struct bench_ctxt *const bench,
+                                   const bench_values_t distribution)
+	__attribute__((warn_unused_result, nonnull(1)));
+static uint32_t bench_rand(struct bench_ctxt *const bench)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void bench_stop(const struct bench_measure *const measure,
+                       struct bench_ctxt *const bench,
+                       const char *const kernel,
+                       const char *const params)
+	__attribute__((nonnull(1, 2, 3, 4)));
+
+
+/**
+ * @brief Main function for the microbenchmark of the encoding schemes
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_ctxt bench = {
+		.ops_nr = BENCH_OPS_DEFAULT,
+		.results_nr = 0,
+		.rand_state = 0x2545f491,
+	};
+	const char *label = NULL;
+	int ops_nr = BENCH_OPS_DEFAULT;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v"))
+		{
+			/* print version */
+			printf("ROHC encoding schemes benchmark, version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--iterations"))
+		{
+			/* get the number of operations for every case */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --iterations takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			ops_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--label"))
+		{
+			/* get the label to identify the results */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --label takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			label = argv[1];
+			args_used++;
+		}
+		else
+		{
+			fprintf(stderr, "unexpected argument '%s'\n\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+	if(ops_nr <= 0)
+	{
+		fprintf(stderr, "invalid number of iterations %d\n", ops_nr);
+		goto error;
+	}
+	bench.ops_nr = ops_nr;
+
+	printf("{\n");
+	if(label != NULL)
+	{
+		printf("\t\"label\": \"%s\",\n", label);
+	}
+	printf("\t\"library_version\": \"%s\",\n", rohc_version());
+	printf("\t\"iterations\": %zu,\n", bench.ops_nr);
+	printf("\t\"results\": [");
+
+	if(!bench_wlsb(&bench))
+	{
+		fprintf(stderr, "failed to run the W-LSB encoding cases\n");
+		goto error;
+	}
+	if(!bench_lsb_decode(&bench))
+	{
+		fprintf(stderr, "failed to run the LSB decoding cases\n");
+		goto error;
+	}
+	if(!bench_sdvl(&bench))
+	{
+		fprintf(stderr, "failed to run the SDVL cases\n");
+		goto error;
+	}
+	bench_crc(&bench);
+	if(!bench_list(&bench))
+	{
+		fprintf(stderr, "failed to run the list compression cases\n");
+		goto error;
+	}
+	if(!bench_tcp_opts(&bench))
+	{
+		fprintf(stderr, "failed to run the TCP options cases\n");
+		goto error;
+	}
+
+	printf("\n\t]\n");
+	printf("}\n");
+
+	status = 0;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the microbenchmark of the encoding schemes
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "ROHC encoding schemes benchmark: measure the speed of the encoding\n"
+	        "                                 schemes of the ROHC library\n"
+	        "\n"
+	        "usage: test_bench_schemes [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --iterations NUM        The number of operations measured for\n"
+	        "                          every case (default: %u)\n"
+	        "  --label LABEL           The label that identifies the results\n"
+	        "\n"
+	        "The results are printed on stdout in the JSON format.\n",
+	        BENCH_OPS_DEFAULT);
+}
+
+
+/**
+ * @brief Measure the W-LSB encoding
+ *
+ * For every window width and every distribution of values, measure:
+ *  \li the addition of values in the window,
+ *  \li the check of the k bits required to encode values in a window full
+ *      of the values that precede them, for the 8-bit, 16-bit and 32-bit
+ *      variants.
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       true if the cases were measured, false otherwise
+ */
+static bool bench_wlsb(struct bench_ctxt *const bench)
+{
+	const size_t widths[] = { 4, 16, 64 };
+
+	for(size_t i = 0; i < (sizeof(widths) / sizeof(widths[0])); i++)
+	{
+		const size_t width = widths[i];
+
+		for(bench_values_t distrib = 0; distrib < BENCH_VALUES_MAX; distrib++)
+		{
+			struct bench_measure measure;
+			struct c_wlsb wlsb;
+			uint32_t *values;
+			char params[64];
+			uint32_t sink = 0;
+
+			snprintf(params, sizeof(params), "width=%zu values=%s", width,
+			         bench_values_descr[distrib]);
+
+			values = bench_gen_values(bench, distrib);
+			if(values == NULL)
+			{
+				goto error;
+			}
+			if(!wlsb_new(&wlsb, width))
+			{
+				free(values);
+				goto error;
+			}
+
+			/* add values in the window */
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				c_add_wlsb(&wlsb, n, values[n & (BENCH_POOL_NR - 1)]);
+			}
+			bench_stop(&measure, bench, "c_add_wlsb", params);
+
+			/* check whether values may be encoded with k bits, the window is
+			 * filled with the values that precede the checked ones */
+			for(size_t n = 0; n < width; n++)
+			{
+				c_add_wlsb(&wlsb, n, values[n]);
+			}
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const uint32_t value = values[width + (n & (BENCH_PKTS_NR - 1))];
+				sink += wlsb_is_kp_possible_8bits(&wlsb, value, 4, ROHC_LSB_SHIFT_SN);
+			}
+			bench_stop(&measure, bench, "wlsb_is_kp_possible_8bits", params);
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const uint32_t value = values[width + (n & (BENCH_PKTS_NR - 1))];
+				sink += wlsb_is_kp_possible_16bits(&wlsb, value, 8, ROHC_LSB_SHIFT_SN);
+			}
+			bench_stop(&measure, bench, "wlsb_is_kp_possible_16bits", params);
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const uint32_t value = values[width + (n & (BENCH_PKTS_NR - 1))];
+				sink += wlsb_is_kp_possible_32bits(&wlsb, value, 16, ROHC_LSB_SHIFT_SN);
+			}
+			bench_stop(&measure, bench, "wlsb_is_kp_possible_32bits", params);
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const uint32_t value = values[width + (n & (BENCH_PKTS_NR - 1))];
+				sink += wlsb_get_minkp_16bits(&wlsb, value, ROHC_LSB_SHIFT_SN);
+			}
+			bench_stop(&measure, bench, "wlsb_get_minkp_16bits", params);
+
+			bench_sink = sink;
+			wlsb_free(&wlsb);
+			free(values);
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Measure the LSB decoding
+ *
+ * For every distribution of values and several numbers of transmitted bits,
+ * measure the decoding of the value then the update of the reference value.
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       true if the cases were measured, false otherwise
+ */
+static bool bench_lsb_decode(struct bench_ctxt *const bench)
+{
+	const size_t bits_nrs[] = { 4, 8, 16 };
+
+	for(bench_values_t distrib = 0; distrib < BENCH_VALUES_MAX; distrib++)
+	{
+		uint32_t *values;
+
+		values = bench_gen_values(bench, distrib);
+		if(values == NULL)
+		{
+			goto error;
+		}
+
+		for(size_t i = 0; i < (sizeof(bits_nrs) / sizeof(bits_nrs[0])); i++)
+		{
+			const size_t k = bits_nrs[i];
+			const uint32_t mask = (1U << k) - 1;
+			struct rohc_lsb_decode lsb;
+			struct bench_measure measure;
+			char params[64];
+			uint32_t sink = 0;
+
+			snprintf(params, sizeof(params), "k=%zu values=%s", k,
+			         bench_values_descr[distrib]);
+
+			rohc_lsb_init(&lsb, 32);
+			rohc_lsb_set_ref(&lsb, values[0], false);
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const uint32_t m = values[(n + 1) & (BENCH_POOL_NR - 1)] & mask;
+				uint32_t decoded;
+
+				sink += rohc_lsb_decode(&lsb, ROHC_LSB_REF_0, 0, m, k,
+				                        ROHC_LSB_SHIFT_SN, &decoded);
+				rohc_lsb_set_ref(&lsb, decoded, false);
+			}
+			bench_stop(&measure, bench, "rohc_lsb_decode", params);
+
+			bench_sink = sink;
+		}
+
+		free(values);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Measure the SDVL encoding and decoding
+ *
+ * Measure the encoding and the decoding of random values for every length
+ * of SDVL-encoded values (1 to 4 bytes).
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       true if the cases were measured, false otherwise
+ */
+static bool bench_sdvl(struct bench_ctxt *const bench)
+{
+	const size_t bits_nrs[] = { 7, 14, 21, 29 };
+
+	for(size_t i = 0; i < (sizeof(bits_nrs) / sizeof(bits_nrs[0])); i++)
+	{
+		const size_t bits_nr = bits_nrs[i];
+		const uint32_t mask = (1U << bits_nr) - 1;
+		uint8_t encoded[BENCH_PKTS_NR][4];
+		uint32_t values[BENCH_PKTS_NR];
+		struct bench_measure measure;
+		char params[64];
+		uint32_t sink = 0;
+
+		snprintf(params, sizeof(params), "bits=%zu", bits_nr);
+
+		for(size_t n = 0; n < BENCH_PKTS_NR; n++)
+		{
+			size_t encoded_len;
+
+			values[n] = bench_rand(bench) & mask;
+			if(!sdvl_encode(encoded[n], 4, &encoded_len, values[n], bits_nr))
+			{
+				goto error;
+			}
+		}
+
+		bench_measure_start(&measure);
+		for(size_t n = 0; n < bench->ops_nr; n++)
+		{
+			uint8_t buf[4];
+			size_t encoded_len;
+
+			sink += sdvl_encode(buf, 4, &encoded_len,
+			                    values[n & (BENCH_PKTS_NR - 1)], bits_nr);
+			sink += buf[0];
+		}
+		bench_stop(&measure, bench, "sdvl_encode", params);
+
+		bench_measure_start(&measure);
+		for(size_t n = 0; n < bench->ops_nr; n++)
+		{
+			size_t decoded_bits_nr;
+			uint32_t decoded;
+
+			sink += sdvl_decode(encoded[n & (BENCH_PKTS_NR - 1)], 4, &decoded,
+			                    &decoded_bits_nr);
+			sink += decoded;
+		}
+		bench_stop(&measure, bench, "sdvl_decode", params);
+
+		bench_sink = sink;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Measure the CRC computations
+ *
+ * Measure the CRC-3, CRC-7 and CRC-8 computations on lengths of data that
+ * are typical for the ROHC headers, then the FCS-32 computation on the
+ * lengths of data that are typical for the ROHC segments.
+ *
+ * @param bench  The parameters of the benchmark
+ */
+static void bench_crc(struct bench_ctxt *const bench)
+{
+	const rohc_crc_type_t crc_types[] =
+		{ ROHC_CRC_TYPE_3, ROHC_CRC_TYPE_7, ROHC_CRC_TYPE_8 };
+	const uint8_t crc_inits[] = { CRC_INIT_3, CRC_INIT_7, CRC_INIT_8 };
+	const size_t crc_lens[] = { 8, 40, 120 };
+	const size_t fcs32_lens[] = { 40, 120, 1500 };
+	uint8_t data[1500 + BENCH_PKTS_NR];
+
+	for(size_t n = 0; n < sizeof(data); n++)
+	{
+		data[n] = bench_rand(bench) & 0xff;
+	}
+
+	for(size_t i = 0; i < (sizeof(crc_types) / sizeof(crc_types[0])); i++)
+	{
+		for(size_t j = 0; j < (sizeof(crc_lens) / sizeof(crc_lens[0])); j++)
+		{
+			const size_t len = crc_lens[j];
+			struct bench_measure measure;
+			char params[64];
+			uint32_t sink = 0;
+
+			snprintf(params, sizeof(params), "crc=%d bytes=%zu", crc_types[i], len);
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				sink += crc_calculate(crc_types[i], data + (n & (BENCH_PKTS_NR - 1)),
+				                      len, crc_inits[i]);
+			}
+			bench_stop(&measure, bench, "crc_calculate", params);
+
+			bench_sink = sink;
+		}
+	}
+
+	for(size_t j = 0; j < (sizeof(fcs32_lens) / sizeof(fcs32_lens[0])); j++)
+	{
+		const size_t len = fcs32_lens[j];
+		struct bench_measure measure;
+		char params[64];
+		uint32_t sink = 0;
+
+		snprintf(params, sizeof(params), "bytes=%zu", len);
+
+		bench_measure_start(&measure);
+		for(size_t n = 0; n < bench->ops_nr; n++)
+		{
+			sink += crc_calc_fcs32(data + (n & (BENCH_PKTS_NR - 1)), len,
+			                       CRC_INIT_FCS32);
+		}
+		bench_stop(&measure, bench, "crc_calc_fcs32", params);
+
+		bench_sink = sink;
+	}
+}
+
+
+/**
+ * @brief Measure the list compression of IPv6 extension headers
+ *
+ * Every operation detects the changes in the list of the packet, encodes
+ * the list, then updates the context, as the IP-based profiles do.
+ *
+ * The cases are:
+ *  \li one extension header that never changes,
+ *  \li three extension headers that never change,
+ *  \li three extension headers, the content of one of them changes in every
+ *      packet,
+ *  \li two or three extension headers, the structure of the list changes
+ *      every 8 packets.
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       true if the cases were measured, false otherwise
+ */
+static bool bench_list(struct bench_ctxt *const bench)
+{
+	/** The extension headers of the cases */
+	const struct
+	{
+		const char *descr;
+		uint8_t exts_nr;
+		uint8_t types[ROHC_MAX_IP_EXT_HDRS];
+		uint8_t lens[ROHC_MAX_IP_EXT_HDRS];
+		bool is_content_changing;
+		bool is_struct_changing;
+	} cases[] = {
+		{ "1ext_stable", 1, { ROHC_IPPROTO_HOPOPTS }, { 8 }, false, false },
+		{ "3exts_stable", 3,
+		  { ROHC_IPPROTO_HOPOPTS, ROHC_IPPROTO_ROUTING, ROHC_IPPROTO_DSTOPTS },
+		  { 8, 24, 16 }, false, false },
+		{ "3exts_content_changing", 3,
+		  { ROHC_IPPROTO_HOPOPTS, ROHC_IPPROTO_ROUTING, ROHC_IPPROTO_DSTOPTS },
+		  { 8, 24, 16 }, true, false },
+		{ "3exts_struct_changing", 3,
+		  { ROHC_IPPROTO_HOPOPTS, ROHC_IPPROTO_ROUTING, ROHC_IPPROTO_DSTOPTS },
+		  { 8, 24, 8 }, false, true },
+	};
+	struct rohc_pkt_ip_hdr *ips;
+	uint8_t *exts_data;
+
+	ips = calloc(BENCH_PKTS_NR, sizeof(struct rohc_pkt_ip_hdr));
+	exts_data = calloc(BENCH_PKTS_NR, ROHC_MAX_IP_EXT_HDRS * 24);
+	if(ips == NULL || exts_data == NULL)
+	{
+		goto error;
+	}
+
+	for(size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+	{
+		struct list_comp *list_comp;
+		struct bench_measure measure;
+		char params[64];
+		uint32_t sink = 0;
+
+		snprintf(params, sizeof(params), "list=%s", cases[i].descr);
+
+		/* build the extension headers of the synthetic packets */
+		for(size_t n = 0; n < BENCH_PKTS_NR; n++)
+		{
+			uint8_t *ext_data = exts_data + n * ROHC_MAX_IP_EXT_HDRS * 24;
+
+			ips[n].version = IPV6;
+			ips[n].exts_nr = cases[i].exts_nr;
+			if(cases[i].is_struct_changing && ((n / 8) % 2) == 1)
+			{
+				ips[n].exts_nr--;
+			}
+			ips[n].exts_len = 0;
+			for(size_t e = 0; e < ips[n].exts_nr; e++)
+			{
+				const uint8_t ext_len = cases[i].lens[e];
+
+				memset(ext_data, 0, ext_len);
+				ext_data[0] = (e + 1) < ips[n].exts_nr ?
+				              cases[i].types[e + 1] : ROHC_IPPROTO_UDP;
+				ext_data[1] = ext_len / 8 - 1;
+				if(cases[i].is_content_changing && (e + 1) == ips[n].exts_nr)
+				{
+					ext_data[ext_len - 1] = n;
+				}
+				ips[n].exts[e].data = ext_data;
+				ips[n].exts[e].type = cases[i].types[e];
+				ips[n].exts[e].len = ext_len;
+				ips[n].exts_len += ext_len;
+				ext_data += ext_len;
+			}
+		}
+
+		list_comp = malloc(sizeof(struct list_comp));
+		if(list_comp == NULL)
+		{
+			goto error;
+		}
+		rohc_comp_list_ipv6_new(list_comp, BENCH_OA_REPETITIONS_NR,
+		                        ROHCv1_PROFILE_IP, NULL, NULL, ROHC_TRACE_DEBUG);
+
+		bench_measure_start(&measure);
+		for(size_t n = 0; n < bench->ops_nr; n++)
+		{
+			uint8_t dest[ROHC_MAX_IP_EXT_HDRS * 24 + 16];
+			bool struct_changed;
+			bool content_changed;
+			int ret;
+
+			detect_ipv6_ext_changes(list_comp, &ips[n & (BENCH_PKTS_NR - 1)],
+			                        &struct_changed, &content_changed);
+			ret = rohc_list_encode(list_comp, dest, 0);
+			assert(ret > 0);
+			rohc_list_update_context(list_comp);
+			sink += ret + dest[0];
+		}
+		bench_stop(&measure, bench, "rohc_list_encode", params);
+
+		bench_sink = sink;
+		rohc_comp_list_ipv6_free(list_comp);
+		free(list_comp);
+	}
+
+	free(exts_data);
+	free(ips);
+	return true;
+
+error:
+	free(exts_data);
+	free(ips);
+	return false;
+}
+
+
+/**
+ * @brief Measure the compression of the TCP options
+ *
+ * Every operation detects the changes in the TCP options of the packet,
+ * then encodes them, then records the TCP Timestamp values in the W-LSB
+ * windows, as the TCP profile does. Two encodings are measured:
+ *  \li the compressed list of TCP options (in the CO chain),
+ *  \li the irregular chain, preceded by the compressed list of TCP options
+ *      only when the TCP profile would transmit it.
+ *
+ * The cases are:
+ *  \li NOP, NOP and Timestamp options, as in the packets of established
+ *      TCP connections,
+ *  \li MSS, SACK Permitted, Timestamp, NOP and Window Scale options, as in
+ *      the SYN packets,
+ *  \li NOP, NOP, Timestamp, NOP, NOP and SACK options with 2 blocks that
+ *      change in every packet.
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       true if the cases were measured, false otherwise
+ */
+static bool bench_tcp_opts(struct bench_ctxt *const bench)
+{
+	const char *const cases[] = { "nop_nop_ts", "syn", "nop_nop_ts_sack" };
+	const char *const kernels[] = { "tcp_opts_list_item", "tcp_opts_irreg" };
+	const size_t pkt_max_len = sizeof(struct tcphdr) + 40;
+	struct rohc_pkt_hdrs *hdrs;
+	struct rohc_comp *comp;
+	struct rohc_comp_ctxt *context;
+	uint8_t *pkts;
+
+	hdrs = calloc(BENCH_PKTS_NR, sizeof(struct rohc_pkt_hdrs));
+	pkts = calloc(BENCH_PKTS_NR, pkt_max_len);
+	comp = calloc(1, sizeof(struct rohc_comp));
+	context = calloc(1, sizeof(struct rohc_comp_ctxt));
+	if(hdrs == NULL || pkts == NULL || comp == NULL || context == NULL)
+	{
+		goto error;
+	}
+	comp->oa_repetitions_nr = BENCH_OA_REPETITIONS_NR;
+	context->compressor = comp;
+
+	for(size_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+	{
+		/* build the TCP headers of the synthetic packets */
+		for(size_t n = 0; n < BENCH_PKTS_NR; n++)
+		{
+			uint8_t *const pkt = pkts + n * pkt_max_len;
+			struct tcphdr *const tcp = (struct tcphdr *) pkt;
+			const uint32_t ack_num = 0x10000000 + n * 1448;
+			const uint32_t ts_req = 0x01000000 + n;
+			const uint32_t ts_reply = 0x02000000 + n / 8;
+			uint8_t *opts = pkt + sizeof(struct tcphdr);
+			size_t opts_len = 0;
+
+			memset(pkt, 0, pkt_max_len);
+			tcp->ack_num = rohc_hton32(ack_num);
+
+			if(i == 1)
+			{
+				/* MSS, SACK Permitted */
+				opts[opts_len++] = TCP_OPT_MSS;
+				opts[opts_len++] = TCP_OLEN_MSS;
+				opts[opts_len++] = 0x05;
+				opts[opts_len++] = 0xb4;
+				opts[opts_len++] = TCP_OPT_SACK_PERM;
+				opts[opts_len++] = TCP_OLEN_SACK_PERM;
+			}
+			else
+			{
+				opts[opts_len++] = TCP_OPT_NOP;
+				opts[opts_len++] = TCP_OPT_NOP;
+			}
+			opts[opts_len++] = TCP_OPT_TS;
+			opts[opts_len++] = TCP_OLEN_TS;
+			opts[opts_len++] = (ts_req >> 24) & 0xff;
+			opts[opts_len++] = (ts_req >> 16) & 0xff;
+			opts[opts_len++] = (ts_req >> 8) & 0xff;
+			opts[opts_len++] = ts_req & 0xff;
+			opts[opts_len++] = (ts_reply >> 24) & 0xff;
+			opts[opts_len++] = (ts_reply >> 16) & 0xff;
+			opts[opts_len++] = (ts_reply >> 8) & 0xff;
+			opts[opts_len++] = ts_reply & 0xff;
+			if(i == 1)
+			{
+				/* NOP, Window Scale */
+				opts[opts_len++] = TCP_OPT_NOP;
+				opts[opts_len++] = TCP_OPT_WS;
+				opts[opts_len++] = TCP_OLEN_WS;
+				opts[opts_len++] = 7;
+			}
+			else if(i == 2)
+			{
+				/* NOP, NOP, SACK with 2 blocks above the ACK number */
+				opts[opts_len++] = TCP_OPT_NOP;
+				opts[opts_len++] = TCP_OPT_NOP;
+				opts[opts_len++] = TCP_OPT_SACK;
+				opts[opts_len++] = 2 + 2 * sizeof(sack_block_t);
+				for(size_t b = 0; b < 2; b++)
+				{
+					sack_block_t block;
+
+					block.block_start = rohc_hton32(ack_num + (2 * b + 1) * 1448);
+					block.block_end = rohc_hton32(ack_num + (2 * b + 2) * 1448);
+					memcpy(opts + opts_len, &block, sizeof(sack_block_t));
+					opts_len += sizeof(sack_block_t);
+				}
+			}
+			assert((opts_len % sizeof(uint32_t)) == 0);
+			tcp->data_offset = (sizeof(struct tcphdr) + opts_len) / sizeof(uint32_t);
+
+			hdrs[n].tcp = tcp;
+			if(!rohc_comp_tcp_are_options_acceptable(comp, tcp->options,
+			                                         tcp->data_offset, &hdrs[n]))
+			{
+				fprintf(stderr, "TCP options of case '%s' are not acceptable\n",
+				        cases[i]);
+				goto error;
+			}
+		}
+
+		for(size_t j = 0; j < (sizeof(kernels) / sizeof(kernels[0])); j++)
+		{
+			struct c_tcp_opts_ctxt opts_ctxt;
+			struct bench_measure measure;
+			char params[64];
+			uint32_t sink = 0;
+
+			snprintf(params, sizeof(params), "opts=%s", cases[i]);
+
+			memset(&opts_ctxt, 0, sizeof(struct c_tcp_opts_ctxt));
+			if(!wlsb_new(&opts_ctxt.ts_req_wlsb, BENCH_OA_REPETITIONS_NR))
+			{
+				goto error;
+			}
+			if(!wlsb_new(&opts_ctxt.ts_reply_wlsb, BENCH_OA_REPETITIONS_NR))
+			{
+				wlsb_free(&opts_ctxt.ts_req_wlsb);
+				goto error;
+			}
+
+			bench_measure_start(&measure);
+			for(size_t n = 0; n < bench->ops_nr; n++)
+			{
+				const struct rohc_pkt_hdrs *const pkt_hdrs =
+					&hdrs[n & (BENCH_PKTS_NR - 1)];
+				struct c_tcp_opts_ctxt_tmp tmp;
+				uint8_t comp_opts[64];
+				bool no_item_needed = true;
+				int ret;
+
+				tcp_detect_options_changes(context, pkt_hdrs, &opts_ctxt, &tmp, true);
+				if(j == 0 ||
+				   tmp.do_list_struct_changed ||
+				   tmp.do_list_static_changed ||
+				   tmp.opt_ts_do_transmit_item)
+				{
+					ret = c_tcp_code_tcp_opts_list_item(context, pkt_hdrs,
+					                                    ROHC_CHAIN_CO, &opts_ctxt,
+					                                    &tmp, comp_opts,
+					                                    sizeof(comp_opts),
+					                                    &no_item_needed);
+					assert(ret > 0);
+					sink += ret;
+				}
+				if(j == 1)
+				{
+					ret = c_tcp_code_tcp_opts_irreg(context, pkt_hdrs, &opts_ctxt,
+					                                &tmp, comp_opts,
+					                                sizeof(comp_opts));
+					assert(ret >= 0);
+					sink += ret;
+				}
+				if(tmp.opt_ts_present)
+				{
+					c_add_wlsb(&opts_ctxt.ts_req_wlsb, n, tmp.ts_req);
+					c_add_wlsb(&opts_ctxt.ts_reply_wlsb, n, tmp.ts_reply);
+				}
+				sink += no_item_needed;
+			}
+			bench_stop(&measure, bench, kernels[j], params);
+
+			bench_sink = sink;
+			wlsb_free(&opts_ctxt.ts_reply_wlsb);
+			wlsb_free(&opts_ctxt.ts_req_wlsb);
+		}
+	}
+
+	free(context);
+	free(comp);
+	free(pkts);
+	free(hdrs);
+	return true;
+
+error:
+	free(context);
+	free(comp);
+	free(pkts);
+	free(hdrs);
+	return false;
+}
+
+
+/**
+ * @brief Generate a pool of values with the given distribution
+ *
+ * @param bench         The parameters of the benchmark
+ * @param distribution  The distribution of the values
+ * @return              The pool of \ref BENCH_POOL_NR values,
+ *                      NULL in case of failure
+ */
+static uint32_t * bench_gen_values(struct bench_ctxt *const bench,
+                                   const bench_values_t distribution)
+{
+	uint32_t *values;
+	uint32_t value = 0xfffff000;
+
+	values = malloc(BENCH_POOL_NR * sizeof(uint32_t));
+	if(values == NULL)
+	{
+		goto error;
+	}
+
+	for(size_t n = 0; n < BENCH_POOL_NR; n++)
+	{
+		switch(distribution)
+		{
+			case BENCH_VALUES_SEQ:
+				value++;
+				break;
+			case BENCH_VALUES_JITTER:
+				/* 160 TS units per packet, up to 7 units of jitter */
+				value += 160;
+				values[n] = value + (bench_rand(bench) & 0x7);
+				continue;
+			case BENCH_VALUES_RANDOM:
+			default:
+				value = bench_rand(bench);
+				break;
+		}
+		values[n] = value;
+	}
+
+error:
+	return values;
+}
+
+
+/**
+ * @brief Get the next pseudo-random number
+ *
+ * The xorshift32 generator gives the very same inputs from one run to
+ * another.
+ *
+ * @param bench  The parameters of the benchmark
+ * @return       The next pseudo-random number
+ */
+static uint32_t bench_rand(struct bench_ctxt *const bench)
+{
+	uint32_t x = bench->rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	bench->rand_state = x;
+
+	return x;
+}
+
+
+/**
+ * @brief Stop the measure of one case and print its result
+ *
+ * @param measure  The measure to stop
+ * @param bench    The parameters of the benchmark
+ * @param kernel   The name of the measured function
+ * @param params   The description of the case
+ */
+static void bench_stop(const struct bench_measure *const measure,
+                       struct bench_ctxt *const bench,
+                       const char *const kernel,
+                       const char *const params)
+{
+	uint64_t ticks;
+	uint64_t ns;
+
+	bench_measure_stop(measure, &ticks, &ns);
+
+	printf("%s\n\t\t{\n", (bench->results_nr == 0 ? "" : ","));
+	printf("\t\t\t\"kernel\": \"%s\",\n", kernel);
+	printf("\t\t\t\"params\": \"%s\",\n", params);
+	printf("\t\t\t\"ns_per_op\": %.2f,\n", ((double) ns) / bench->ops_nr);
+#ifdef BENCH_HAVE_TSC
+	printf("\t\t\t\"cycles_per_op\": %.2f\n", ((double) ticks) / bench->ops_nr);
+#else
+	(void) ticks;
+	printf("\t\t\t\"cycles_per_op\": null\n");
+#endif
+	printf("\t\t}");
+	fflush(stdout);
+
+	bench->results_nr++;
+}
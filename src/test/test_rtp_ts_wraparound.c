@@ -143,7 +143,8 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	uint64_t i;
 
 	/* create the RTP TS encoding context */
-	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL);
+	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL,
+	                  ROHC_TRACE_DEBUG);
 	if(ret != 1)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS encoding context\n");
@@ -151,7 +152,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	}
 
 	/* create the RTP TS decoding context */
-	d_init_sc(&ts_sc_decomp, NULL, NULL);
+	d_init_sc(&ts_sc_decomp, NULL, NULL, ROHC_TRACE_DEBUG);
 
 	/* compute the initial value to encode */
 	if(incr == 0)
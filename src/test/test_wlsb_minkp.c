@@ -0,0 +1,406 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_wlsb_minkp.c
+ * @brief   Test the W-LSB queries against a scan of every window value
+ * @author  Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The wlsb_is_kp_possible_*bits() functions, the offsets computed by the
+ * wlsb_get_offsets_*bits() functions and the minimal numbers of bits
+ * computed by the wlsb_get_minkp_*bits() functions shall give the very same
+ * answers as checking the interpretation interval of every value of the
+ * window, for every number of bits k and every shift parameter p, and after
+ * the window was acknowledged.
+ */
+
+#include "schemes/comp_wlsb.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+/** The number of random windows tested for every window width */
+#define WINDOWS_NR  2000U
+
+
+static bool test_window(const struct c_wlsb *const wlsb,
+                        const uint32_t *const window_values,
+                        const size_t window_width,
+                        const uint32_t value,
+                        const bool verbose)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool test_is_kp_possible(const uint32_t *const window_values,
+                                const size_t window_width,
+                                const uint32_t value,
+                                const size_t bits_nr,
+                                const size_t k,
+                                const int32_t p)
+	__attribute__((warn_unused_result));
+
+static uint32_t test_rand(void)
+	__attribute__((warn_unused_result));
+
+
+/** The shift parameters p that are tested */
+static const int32_t test_shifts[] =
+{
+	ROHC_LSB_SHIFT_SN, ROHC_LSB_SHIFT_IP_ID, 1, ROHC_LSB_SHIFT_TCP_TTL,
+	ROHC_LSB_SHIFT_TCP_SN, ROHC_LSB_SHIFT_TCP_SEQ_SCALED, 63, 127, 8191,
+	16383, 32767, 65535, ROHC_LSB_SHIFT_TCP_TS_3B, ROHC_LSB_SHIFT_TCP_TS_4B,
+};
+
+/** The special shift parameters p that depend on k */
+static const rohc_lsb_shift_t test_special_shifts[] =
+{
+	ROHC_LSB_SHIFT_RTP_TS, ROHC_LSB_SHIFT_RTP_SN,
+};
+
+
+/**
+ * @brief Test the single-pass W-LSB queries against the window scans
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const size_t widths[] = { 1, 4, 16, 64 };
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the W-LSB queries against a scan of every window value\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(size_t i = 0; i < (sizeof(widths) / sizeof(widths[0])); i++)
+	{
+		uint32_t window_values[64];
+		struct c_wlsb wlsb;
+
+		trace(verbose, "test windows of %zu entries\n", widths[i]);
+
+		if(!wlsb_new(&wlsb, widths[i]))
+		{
+			trace(verbose, "failed to create the W-LSB window\n");
+			goto error;
+		}
+
+		/* empty window */
+		if(!test_window(&wlsb, NULL, 0, test_rand(), verbose))
+		{
+			goto free_wlsb;
+		}
+
+		for(size_t j = 0; j < WINDOWS_NR; j++)
+		{
+			const uint32_t ref = test_rand();
+			uint32_t value;
+
+			/* values of the window are close to each other, around the
+			 * wraparound boundaries from time to time, or random */
+			for(size_t n = 0; n < widths[i]; n++)
+			{
+				uint32_t window_value;
+
+				switch(j % 4)
+				{
+					case 0:
+						window_value = ref + (test_rand() % 64) - 32;
+						break;
+					case 1:
+						window_value = (test_rand() % 64) - 32;
+						break;
+					case 2:
+						window_value = ref + n;
+						break;
+					default:
+						window_value = test_rand();
+						break;
+				}
+				c_add_wlsb(&wlsb, n, window_value);
+				window_values[n] = window_value;
+			}
+
+			/* the value is close to the window, or random */
+			switch(j % 3)
+			{
+				case 0:
+					value = ref + (test_rand() % 256) - 128;
+					break;
+				case 1:
+					value = ref + (1U << (test_rand() % 32));
+					break;
+				default:
+					value = test_rand();
+					break;
+			}
+
+			if(!test_window(&wlsb, window_values, widths[i], value, verbose))
+			{
+				goto free_wlsb;
+			}
+
+			/* acknowledge one entry from time to time: all the older entries
+			 * take the value of the acknowledged one */
+			if((j % 5) == 0)
+			{
+				const size_t acked_sn = test_rand() % widths[i];
+
+				if(wlsb_ack(&wlsb, acked_sn, 32) != acked_sn)
+				{
+					trace(verbose, "wrong number of acknowledged entries\n");
+					goto free_wlsb;
+				}
+				for(size_t n = 0; n < acked_sn; n++)
+				{
+					window_values[n] = window_values[acked_sn];
+				}
+				if(!test_window(&wlsb, window_values, widths[i], value, verbose))
+				{
+					goto free_wlsb;
+				}
+			}
+		}
+
+		wlsb_free(&wlsb);
+		continue;
+
+free_wlsb:
+		wlsb_free(&wlsb);
+		goto error;
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compare the W-LSB queries with a scan of the window for one value
+ *
+ * @param wlsb           The W-LSB window
+ * @param window_values  The values of the W-LSB window, NULL if empty
+ * @param window_width   The number of values in the W-LSB window
+ * @param value          The value to encode
+ * @param verbose        Whether to print traces or not
+ * @return               true if all the answers are the same, false otherwise
+ */
+static bool test_window(const struct c_wlsb *const wlsb,
+                        const uint32_t *const window_values,
+                        const size_t window_width,
+                        const uint32_t value,
+                        const bool verbose)
+{
+	const size_t bits_nrs[] = { 8, 16, 32 };
+
+	for(size_t b = 0; b < (sizeof(bits_nrs) / sizeof(bits_nrs[0])); b++)
+	{
+		const size_t bits_nr = bits_nrs[b];
+		struct c_wlsb_offsets offsets;
+
+		switch(bits_nr)
+		{
+			case 8:
+				wlsb_get_offsets_8bits(wlsb, value, &offsets);
+				break;
+			case 16:
+				wlsb_get_offsets_16bits(wlsb, value, &offsets);
+				break;
+			default:
+				wlsb_get_offsets_32bits(wlsb, value, &offsets);
+				break;
+		}
+
+		/* every k with fixed shift parameters */
+		for(size_t i = 0; i < (sizeof(test_shifts) / sizeof(test_shifts[0])); i++)
+		{
+			const int32_t p = test_shifts[i];
+			size_t expected_minkp = bits_nr;
+			size_t minkp;
+
+			for(size_t k = 0; k <= bits_nr; k++)
+			{
+				const bool expected =
+					test_is_kp_possible(window_values, window_width, value, bits_nr, k, p);
+				bool is_kp_possible;
+
+				switch(bits_nr)
+				{
+					case 8:
+						is_kp_possible = wlsb_is_kp_possible_8bits(wlsb, value, k, p);
+						break;
+					case 16:
+						is_kp_possible = wlsb_is_kp_possible_16bits(wlsb, value, k, p);
+						break;
+					default:
+						is_kp_possible = wlsb_is_kp_possible_32bits(wlsb, value, k, p);
+						break;
+				}
+				if(is_kp_possible != expected ||
+				   wlsb_is_kp_possible_offsets(&offsets, k, p) != expected)
+				{
+					trace(verbose, "%zu-bit value 0x%08x: wrong answer for k = %zu "
+					      "and p = %d\n", bits_nr, value, k, p);
+					goto error;
+				}
+				if(expected && expected_minkp == bits_nr)
+				{
+					expected_minkp = k;
+				}
+			}
+
+			switch(bits_nr)
+			{
+				case 8:
+					minkp = wlsb_get_minkp_8bits(wlsb, value, p);
+					break;
+				case 16:
+					minkp = wlsb_get_minkp_16bits(wlsb, value, p);
+					break;
+				default:
+					minkp = wlsb_get_minkp_32bits(wlsb, value, p);
+					break;
+			}
+			if(minkp != expected_minkp)
+			{
+				trace(verbose, "%zu-bit value 0x%08x: wrong minimal k for p = %d\n",
+				      bits_nr, value, p);
+				goto error;
+			}
+		}
+	}
+
+	/* minimal k with the shift parameters that depend on k */
+	for(size_t i = 0; i < (sizeof(test_special_shifts) / sizeof(test_special_shifts[0])); i++)
+	{
+		const rohc_lsb_shift_t p = test_special_shifts[i];
+		size_t minkp = 0;
+
+		while(minkp < 32 &&
+		      !test_is_kp_possible(window_values, window_width, value, 32, minkp,
+		                           rohc_interval_compute_p(minkp, p)))
+		{
+			minkp++;
+		}
+		if(wlsb_get_minkp_32bits(wlsb, value, p) != minkp)
+		{
+			trace(verbose, "value 0x%08x: wrong minimal k for p = %d\n", value, p);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check the interpretation interval of every value of a window
+ *
+ * @param window_values  The values of the W-LSB window, NULL if empty
+ * @param window_width   The number of values in the W-LSB window
+ * @param value          The value to encode
+ * @param bits_nr        The length (in bits) of the encoded field
+ * @param k              The number of bits for encoding
+ * @param p              The shift parameter p
+ * @return               true if the number of bits is enough for encoding
+ */
+static bool test_is_kp_possible(const uint32_t *const window_values,
+                                const size_t window_width,
+                                const uint32_t value,
+                                const size_t bits_nr,
+                                const size_t k,
+                                const int32_t p)
+{
+	const uint64_t field_mask = (((uint64_t) 1) << bits_nr) - 1;
+
+	if(k == bits_nr)
+	{
+		return true;
+	}
+	if(window_width == 0)
+	{
+		return false;
+	}
+
+	for(size_t i = 0; i < window_width; i++)
+	{
+		/* value shall be in [v_ref - p, v_ref - p + 2^k - 1] */
+		const uint64_t min = (((uint64_t) window_values[i]) - p) & field_mask;
+		const uint64_t offset = (((uint64_t) value) - min) & field_mask;
+
+		if(offset > ((((uint64_t) 1) << k) - 1))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Get the next pseudo-random number
+ *
+ * @return  The next pseudo-random number
+ */
+static uint32_t test_rand(void)
+{
+	static uint32_t state = 0x2545f491;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return state;
+}
@@ -0,0 +1,1098 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_bench.c
+ * @brief  ROHC throughput benchmark
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * Introduction
+ * ------------
+ *
+ * The program takes one or several flows of IP packets as input (in the PCAP
+ * format), loads all of them in memory, then replays them several times
+ * through one ROHC compressor and one ROHC decompressor. The time spent in
+ * \ref rohc_compress4 and \ref rohc_decompress3 is measured for every packet.
+ *
+ * Every flow is replayed with a new compressor/decompressor pair, so that
+ * every iteration exercises the same sequence of packet types. The creation
+ * and destruction of the pairs, the feedback delivery and the collection of
+ * the packet information are not measured.
+ *
+ * Output
+ * ------
+ *
+ * The program outputs one JSON object on stdout with the number of
+ * nanoseconds per packet, the number of packets per second and the number of
+ * CPU cycles per uncompressed byte for compression and decompression. The
+ * results are given for all packets, then broken down by profile and by
+ * packet type.
+ *
+ * CPU cycles are read from the Time Stamp Counter on x86 processors only, so
+ * the number of cycles per byte is \e null on other processors.
+ */
+
+#include "test.h"
+#include "bench_timing.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for ntohs() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for ntohs() on Linux */
+#endif
+#include <assert.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-rohc-tests \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The default number of times the flows are replayed */
+#define BENCH_ITERATIONS_DEFAULT  10U
+
+/** The Ethertype for the 802.1q protocol (VLAN) */
+#define ETHERTYPE_8021Q   0x8100U
+/** The Ethertype for the 802.1ad protocol */
+#define ETHERTYPE_8021AD  0x88a8U
+
+
+/** One IP packet loaded in memory */
+struct bench_pkt
+{
+	struct rohc_ts arrival_time;  /**< The arrival time of the packet */
+	size_t offset;                /**< The offset of the packet in flow data */
+	size_t len;                   /**< The length (in bytes) of the packet */
+};
+
+/** One flow of IP packets loaded in memory */
+struct bench_flow
+{
+	const char *filename;     /**< The name of the PCAP file */
+	uint8_t *data;            /**< The bytes of all the IP packets */
+	struct bench_pkt *pkts;   /**< The IP packets of the flow */
+	size_t pkts_nr;           /**< The number of IP packets in the flow */
+};
+
+/** Time and volume measured for a group of packets */
+struct bench_counter
+{
+	uint64_t pkts_nr;  /**< The number of packets */
+	uint64_t bytes;    /**< The number of uncompressed bytes */
+	uint64_t ticks;    /**< The number of ticks spent in the library */
+};
+
+/** Time and volume measured for compression or decompression */
+struct bench_stats
+{
+	/** The number of packets the library failed to handle */
+	uint64_t errors_nr;
+	/** The measures for all packets */
+	struct bench_counter total;
+	/** The measures broken down by profile */
+	struct bench_counter profiles[ROHC_PROFILE_MAX];
+	/** The measures broken down by packet type */
+	struct bench_counter pkt_types[ROHC_PACKET_MAX];
+};
+
+/** The VLAN header */
+struct vlan_hdr
+{
+	uint16_t vid;  /**< The PCP, DEI and VID fields */
+	uint16_t type; /**< The Ethertype of the next header */
+} __attribute__((packed));
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool bench_load_flow(struct bench_flow *const flow,
+                            const char *const filename)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static void bench_free_flow(struct bench_flow *const flow)
+	__attribute__((nonnull(1)));
+static bool bench_run_flow(const struct bench_flow *const flow,
+                           const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           const size_t oa_repetitions,
+                           const size_t proto_version,
+                           struct bench_stats *const comp_stats,
+                           struct bench_stats *const decomp_stats)
+	__attribute__((nonnull(1, 6, 7), warn_unused_result));
+static void bench_count(struct bench_stats *const stats,
+                        const int profile_id,
+                        const rohc_packet_t packet_type,
+                        const size_t bytes,
+                        const uint64_t ticks)
+	__attribute__((nonnull(1)));
+static void bench_print_stats(const char *const name,
+                              const struct bench_stats *const stats,
+                              const double ns_per_tick,
+                              const bool is_last)
+	__attribute__((nonnull(1, 2)));
+static void bench_print_counter(const struct bench_counter *const counter,
+                                const double ns_per_tick)
+	__attribute__((nonnull(1)));
+
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const size_t max_contexts,
+                                            const size_t oa_repetitions,
+                                            const size_t proto_version)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decompressor(const rohc_cid_type_t cid_type,
+                                                const size_t max_contexts,
+                                                const size_t proto_version)
+	__attribute__((warn_unused_result));
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Main function for the ROHC throughput benchmark
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	const char *cid_type_name = NULL;
+	const char *label = NULL;
+	char **src_filenames = NULL;
+	size_t src_filenames_nr = 0;
+	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int oa_repetitions = 4;
+	int proto_version = 1; /* ROHC protocol version, v1 by default */
+	int iterations = BENCH_ITERATIONS_DEFAULT;
+	rohc_cid_type_t cid_type;
+	struct bench_flow *flows = NULL;
+	size_t flows_nr = 0;
+	size_t pkts_nr = 0;
+	struct bench_stats *comp_stats = NULL;
+	struct bench_stats *decomp_stats = NULL;
+	struct bench_measure measure;
+	uint64_t ticks;
+	uint64_t ns;
+	double ns_per_tick;
+	int status = 1;
+	int args_used;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v"))
+		{
+			/* print version */
+			printf("ROHC throughput benchmark, version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts the benchmark should use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --max-contexts takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			max_contexts = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--optimistic-approach"))
+		{
+			/* get the number of repetitions for the Optimistic Approach */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --optimistic-approach takes one "
+				        "argument\n\n");
+				usage();
+				goto error;
+			}
+			oa_repetitions = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--rohc-version"))
+		{
+			/* get the ROHC version to use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --rohc-version takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			proto_version = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--iterations"))
+		{
+			/* get the number of times the flows shall be replayed */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --iterations takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			iterations = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--label"))
+		{
+			/* get the label to identify the results */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --label takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			label = argv[1];
+			args_used++;
+		}
+		else if(cid_type_name == NULL)
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[0];
+		}
+		else
+		{
+			/* get the names of the files that contain the flows: all the
+			 * remaining arguments */
+			src_filenames = argv;
+			src_filenames_nr = argc;
+			args_used = argc;
+		}
+	}
+
+	/* check CID type */
+	if(cid_type_name == NULL)
+	{
+		fprintf(stderr, "CID_TYPE not specified\n\n");
+		usage();
+		goto error;
+	}
+	if(!strcmp(cid_type_name, "smallcid"))
+	{
+		cid_type = ROHC_SMALL_CID;
+	}
+	else if(!strcmp(cid_type_name, "largecid"))
+	{
+		cid_type = ROHC_LARGE_CID;
+	}
+	else
+	{
+		fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
+		        "'largecid' expected\n", cid_type_name);
+		goto error;
+	}
+
+	/* check the other parameters */
+	if(src_filenames_nr == 0)
+	{
+		fprintf(stderr, "FLOW not specified\n\n");
+		usage();
+		goto error;
+	}
+	if(max_contexts <= 0 ||
+	   (cid_type == ROHC_SMALL_CID && ((size_t) max_contexts) > (ROHC_SMALL_CID_MAX + 1)) ||
+	   (cid_type == ROHC_LARGE_CID && ((size_t) max_contexts) > (ROHC_LARGE_CID_MAX + 1)))
+	{
+		fprintf(stderr, "invalid maximum number of contexts %d\n", max_contexts);
+		goto error;
+	}
+	if(oa_repetitions <= 0)
+	{
+		fprintf(stderr, "invalid number of Optimistic Approach repetitions %d\n",
+		        oa_repetitions);
+		goto error;
+	}
+	if(proto_version != 1 && proto_version != 2)
+	{
+		fprintf(stderr, "invalid ROHC version %d, only 1 and 2 expected\n",
+		        proto_version);
+		goto error;
+	}
+	if(iterations <= 0)
+	{
+		fprintf(stderr, "invalid number of iterations %d\n", iterations);
+		goto error;
+	}
+
+	/* preload all the flows in memory */
+	flows = calloc(src_filenames_nr, sizeof(struct bench_flow));
+	if(flows == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu flows\n",
+		        src_filenames_nr);
+		goto error;
+	}
+	for(flows_nr = 0; flows_nr < src_filenames_nr; flows_nr++)
+	{
+		if(!bench_load_flow(&flows[flows_nr], src_filenames[flows_nr]))
+		{
+			fprintf(stderr, "failed to load flow '%s'\n", src_filenames[flows_nr]);
+			goto free_flows;
+		}
+		pkts_nr += flows[flows_nr].pkts_nr;
+	}
+
+	comp_stats = calloc(1, sizeof(struct bench_stats));
+	decomp_stats = calloc(1, sizeof(struct bench_stats));
+	if(comp_stats == NULL || decomp_stats == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for statistics\n");
+		goto free_stats;
+	}
+
+	/* replay all the flows several times */
+	bench_measure_start(&measure);
+	for(int i = 0; i < iterations; i++)
+	{
+		for(size_t j = 0; j < flows_nr; j++)
+		{
+			if(!bench_run_flow(&flows[j], cid_type, max_contexts, oa_repetitions,
+			                   proto_version, comp_stats, decomp_stats))
+			{
+				fprintf(stderr, "failed to replay flow '%s'\n", flows[j].filename);
+				goto free_stats;
+			}
+		}
+	}
+	bench_measure_stop(&measure, &ticks, &ns);
+	ns_per_tick = bench_ns_per_tick(ticks, ns);
+
+	/* print results */
+	printf("{\n");
+	if(label != NULL)
+	{
+		printf("\t\"label\": \"%s\",\n", label);
+	}
+	printf("\t\"library_version\": \"%s\",\n", rohc_version());
+	printf("\t\"rohc_version\": %d,\n", proto_version);
+	printf("\t\"cid_type\": \"%s\",\n", cid_type_name);
+	printf("\t\"max_contexts\": %d,\n", max_contexts);
+	printf("\t\"optimistic_approach\": %d,\n", oa_repetitions);
+	printf("\t\"iterations\": %d,\n", iterations);
+	printf("\t\"flows_nr\": %zu,\n", flows_nr);
+	printf("\t\"packets_nr\": %zu,\n", pkts_nr);
+	bench_print_stats("compression", comp_stats, ns_per_tick, false);
+	bench_print_stats("decompression", decomp_stats, ns_per_tick, true);
+	printf("}\n");
+
+	status = 0;
+
+free_stats:
+	free(decomp_stats);
+	free(comp_stats);
+free_flows:
+	for(size_t j = 0; j < flows_nr; j++)
+	{
+		bench_free_flow(&flows[j]);
+	}
+	free(flows);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the throughput benchmark
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "ROHC throughput benchmark: measure the speed of the ROHC library\n"
+	        "                           with flows of IP packets\n"
+	        "\n"
+	        "usage: test_bench [OPTIONS] CID_TYPE FLOW [FLOW ...]\n"
+	        "\n"
+	        "with:\n"
+	        "  CID_TYPE                The type of CID to use among 'smallcid'\n"
+	        "                          and 'largecid'\n"
+	        "  FLOW                    The flow of Ethernet frames to compress\n"
+	        "                          (in PCAP format)\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                         Print version information and exit\n"
+	        "  -h                         Print this usage and exit\n"
+	        "  --max-contexts NUM         The maximum number of ROHC contexts to\n"
+	        "                             simultaneously use during the benchmark\n"
+	        "  --optimistic-approach NUM  The nr of Optimistic Approach repetitions\n"
+	        "  --rohc-version NUM         The ROHC version to use: 1 for ROHCv1\n"
+	        "                             and 2 for ROHCv2\n"
+	        "  --iterations NUM           The number of times the flows are\n"
+	        "                             replayed (default: %u)\n"
+	        "  --label NAME               The label to identify the results\n",
+	        BENCH_ITERATIONS_DEFAULT);
+}
+
+
+/**
+ * @brief Load all the IP packets of one PCAP file in memory
+ *
+ * The link layer headers are removed, as well as the Ethernet padding.
+ * Truncated frames are ignored.
+ *
+ * @param[out] flow  The flow to load
+ * @param filename   The name of the PCAP file
+ * @return           true if the flow was successfully loaded, false otherwise
+ */
+static bool bench_load_flow(struct bench_flow *const flow,
+                            const char *const filename)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const uint8_t *packet;
+	size_t data_len = 0;
+	size_t pkts_max = 0;
+	size_t link_len;
+	int link_layer_type;
+	pcap_t *handle;
+
+	memset(flow, 0, sizeof(struct bench_flow));
+	flow->filename = filename;
+
+	/* open the source dump file */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source dump must be supported */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_NULL)
+	{
+		link_len = BSD_LOOPBACK_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %d not supported\n", link_layer_type);
+		goto close_input;
+	}
+
+	while((packet = pcap_next(handle, &header)) != NULL)
+	{
+		size_t pkt_link_len = link_len;
+		size_t pkt_len;
+
+		/* ignore truncated frames */
+		if(header.len <= link_len || header.len != header.caplen)
+		{
+			continue;
+		}
+
+		/* skip all 802.1q or 802.1ad headers */
+		if(link_len == ETHER_HDR_LEN)
+		{
+			const struct ether_header *const eth_header =
+				(const struct ether_header *) packet;
+			uint16_t proto_type = ntohs(eth_header->ether_type);
+
+			while((proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD) &&
+			      header.len > (pkt_link_len + sizeof(struct vlan_hdr)))
+			{
+				const struct vlan_hdr *const vlan_hdr =
+					(const struct vlan_hdr *) (packet + pkt_link_len);
+				proto_type = ntohs(vlan_hdr->type);
+				pkt_link_len += sizeof(struct vlan_hdr);
+			}
+		}
+		pkt_len = header.len - pkt_link_len;
+
+		/* remove the padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+		{
+			const uint8_t *const ip_data = packet + pkt_link_len;
+			size_t tot_len = pkt_len;
+
+			if(((ip_data[0] >> 4) & 0x0f) == 4 &&
+			   pkt_len >= sizeof(struct ipv4_hdr))
+			{
+				const struct ipv4_hdr *const ip = (const struct ipv4_hdr *) ip_data;
+				tot_len = ntohs(ip->tot_len);
+			}
+			else if(((ip_data[0] >> 4) & 0x0f) == 6 &&
+			        pkt_len >= sizeof(struct ipv6_hdr))
+			{
+				const struct ipv6_hdr *const ip = (const struct ipv6_hdr *) ip_data;
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+			}
+			if(tot_len < pkt_len)
+			{
+				pkt_len = tot_len;
+			}
+		}
+
+		/* enlarge the arrays of packets and bytes if needed */
+		if(flow->pkts_nr >= pkts_max)
+		{
+			struct bench_pkt *const pkts =
+				realloc(flow->pkts, (pkts_max + 64) * sizeof(struct bench_pkt));
+			if(pkts == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for packets\n");
+				goto free_flow;
+			}
+			flow->pkts = pkts;
+			pkts_max += 64;
+		}
+		{
+			uint8_t *const data = realloc(flow->data, data_len + pkt_len);
+			if(data == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for packets\n");
+				goto free_flow;
+			}
+			flow->data = data;
+		}
+
+		/* store the packet */
+		memcpy(flow->data + data_len, packet + pkt_link_len, pkt_len);
+		flow->pkts[flow->pkts_nr].arrival_time.sec = header.ts.tv_sec;
+		flow->pkts[flow->pkts_nr].arrival_time.nsec = header.ts.tv_usec * 1000;
+		flow->pkts[flow->pkts_nr].offset = data_len;
+		flow->pkts[flow->pkts_nr].len = pkt_len;
+		flow->pkts_nr++;
+		data_len += pkt_len;
+	}
+
+	pcap_close(handle);
+	return true;
+
+free_flow:
+	bench_free_flow(flow);
+close_input:
+	pcap_close(handle);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Free the IP packets of one flow
+ *
+ * @param flow  The flow to free
+ */
+static void bench_free_flow(struct bench_flow *const flow)
+{
+	free(flow->pkts);
+	flow->pkts = NULL;
+	free(flow->data);
+	flow->data = NULL;
+	flow->pkts_nr = 0;
+}
+
+
+/**
+ * @brief Replay one flow through a new compressor/decompressor pair
+ *
+ * @param flow                The flow to replay
+ * @param cid_type            The type of CIDs the compressor shall use
+ * @param max_contexts        The maximum number of ROHC contexts to use
+ * @param oa_repetitions      The number of Optimistic Approach repetitions
+ * @param proto_version       The version of the ROHC protocol to use
+ * @param[in,out] comp_stats  The measures for compression
+ * @param[in,out] decomp_stats The measures for decompression
+ * @return                    true if the compressor and decompressor were
+ *                            created, false otherwise
+ */
+static bool bench_run_flow(const struct bench_flow *const flow,
+                           const rohc_cid_type_t cid_type,
+                           const size_t max_contexts,
+                           const size_t oa_repetitions,
+                           const size_t proto_version,
+                           struct bench_stats *const comp_stats,
+                           struct bench_stats *const decomp_stats)
+{
+	static uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	static uint8_t decomp_buffer[MAX_ROHC_SIZE];
+	static uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	bool is_ok = false;
+
+	comp = create_compressor(cid_type, max_contexts, oa_repetitions,
+	                         proto_version);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	decomp = create_decompressor(cid_type, max_contexts, proto_version);
+	if(decomp == NULL)
+	{
+		goto free_comp;
+	}
+
+	for(size_t i = 0; i < flow->pkts_nr; i++)
+	{
+		const struct bench_pkt *const pkt = &(flow->pkts[i]);
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(flow->data + pkt->offset, pkt->len,
+			                   pkt->arrival_time);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+		rohc_comp_last_packet_info2_t comp_info;
+		rohc_decomp_last_packet_info_t decomp_info;
+		rohc_status_t status;
+		uint64_t ticks;
+
+		/* compress the IP packet */
+		ticks = bench_get_ticks();
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		ticks = bench_get_ticks() - ticks;
+		if(status != ROHC_STATUS_OK)
+		{
+			comp_stats->errors_nr++;
+			continue;
+		}
+		comp_info.version_major = 0;
+		comp_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &comp_info))
+		{
+			comp_stats->errors_nr++;
+			continue;
+		}
+		bench_count(comp_stats, comp_info.profile_id, comp_info.packet_type,
+		            ip_packet.len, ticks);
+
+		/* decompress the ROHC packet */
+		ticks = bench_get_ticks();
+		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                          &feedback_send);
+		ticks = bench_get_ticks() - ticks;
+		if(status != ROHC_STATUS_OK)
+		{
+			decomp_stats->errors_nr++;
+			continue;
+		}
+		decomp_info.version_major = 0;
+		decomp_info.version_minor = 2;
+		if(!rohc_decomp_get_last_packet_info(decomp, &decomp_info))
+		{
+			decomp_stats->errors_nr++;
+			continue;
+		}
+		bench_count(decomp_stats, decomp_info.profile_id, decomp_info.packet_type,
+		            decomp_packet.len, ticks);
+
+		/* give the feedback generated by the decompressor to the compressor */
+		if(!rohc_buf_is_empty(feedback_send) &&
+		   !rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			comp_stats->errors_nr++;
+		}
+	}
+	is_ok = true;
+
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return is_ok;
+}
+
+
+/**
+ * @brief Record the time spent on one packet
+ *
+ * @param[in,out] stats  The measures to update
+ * @param profile_id     The profile used for the packet
+ * @param packet_type    The type of the ROHC packet
+ * @param bytes          The uncompressed length (in bytes) of the packet
+ * @param ticks          The number of ticks spent in the library
+ */
+static void bench_count(struct bench_stats *const stats,
+                        const int profile_id,
+                        const rohc_packet_t packet_type,
+                        const size_t bytes,
+                        const uint64_t ticks)
+{
+	struct bench_counter *counters[3] = { &stats->total, NULL, NULL };
+
+	if(profile_id >= 0 && profile_id < ROHC_PROFILE_MAX)
+	{
+		counters[1] = &(stats->profiles[profile_id]);
+	}
+	if(packet_type < ROHC_PACKET_MAX)
+	{
+		counters[2] = &(stats->pkt_types[packet_type]);
+	}
+
+	for(size_t i = 0; i < 3; i++)
+	{
+		if(counters[i] != NULL)
+		{
+			counters[i]->pkts_nr++;
+			counters[i]->bytes += bytes;
+			counters[i]->ticks += ticks;
+		}
+	}
+}
+
+
+/**
+ * @brief Print the measures for compression or decompression in JSON
+ *
+ * @param name         The name of the JSON member
+ * @param stats        The measures to print
+ * @param ns_per_tick  The number of nanoseconds in one tick
+ * @param is_last      Whether the JSON member is the last one or not
+ */
+static void bench_print_stats(const char *const name,
+                              const struct bench_stats *const stats,
+                              const double ns_per_tick,
+                              const bool is_last)
+{
+	bool is_first;
+
+	printf("\t\"%s\": {\n", name);
+	printf("\t\t\"errors_nr\": %" PRIu64 ",\n", stats->errors_nr);
+	printf("\t\t\"total\": ");
+	bench_print_counter(&stats->total, ns_per_tick);
+	printf(",\n");
+
+	printf("\t\t\"profiles\": [");
+	is_first = true;
+	for(int i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->profiles[i].pkts_nr > 0)
+		{
+			printf("%s\n\t\t\t{ \"id\": %d, \"name\": \"%s\", \"stats\": ",
+			       is_first ? "" : ",", i, rohc_get_profile_descr(i));
+			bench_print_counter(&stats->profiles[i], ns_per_tick);
+			printf(" }");
+			is_first = false;
+		}
+	}
+	printf("\n\t\t],\n");
+
+	printf("\t\t\"packet_types\": [");
+	is_first = true;
+	for(int i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->pkt_types[i].pkts_nr > 0)
+		{
+			printf("%s\n\t\t\t{ \"id\": %d, \"name\": \"%s\", \"stats\": ",
+			       is_first ? "" : ",", i, rohc_get_packet_descr(i));
+			bench_print_counter(&stats->pkt_types[i], ns_per_tick);
+			printf(" }");
+			is_first = false;
+		}
+	}
+	printf("\n\t\t]\n");
+
+	printf("\t}%s\n", is_last ? "" : ",");
+}
+
+
+/**
+ * @brief Print the measures for a group of packets in JSON
+ *
+ * @param counter      The measures to print
+ * @param ns_per_tick  The number of nanoseconds in one tick
+ */
+static void bench_print_counter(const struct bench_counter *const counter,
+                                const double ns_per_tick)
+{
+	const double ns = ((double) counter->ticks) * ns_per_tick;
+	const double ns_per_pkt =
+		(counter->pkts_nr == 0 ? 0.0 : ns / ((double) counter->pkts_nr));
+	const double pkts_per_sec = (ns <= 0.0 ? 0.0 :
+	                             ((double) counter->pkts_nr) * 1e9 / ns);
+
+	printf("{ \"packets\": %" PRIu64 ", \"bytes\": %" PRIu64 ", "
+	       "\"ns_per_packet\": %.1f, \"packets_per_second\": %.0f, "
+	       "\"cycles_per_byte\": ", counter->pkts_nr, counter->bytes,
+	       ns_per_pkt, pkts_per_sec);
+#ifdef BENCH_HAVE_TSC
+	printf("%.2f }", (counter->bytes == 0 ? 0.0 :
+	                  ((double) counter->ticks) / ((double) counter->bytes)));
+#else
+	printf("null }");
+#endif
+}
+
+
+/**
+ * @brief Create and configure a ROHC compressor
+ *
+ * @param cid_type        The type of CIDs the compressor shall use
+ * @param max_contexts    The maximum number of ROHC contexts to use
+ * @param oa_repetitions  The number of Optimistic Approach repetitions
+ * @param proto_version   The version of the ROHC protocol to use: v1 or v2
+ * @return                The new ROHC compressor
+ */
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const size_t max_contexts,
+                                            const size_t oa_repetitions,
+                                            const size_t proto_version)
+{
+	struct rohc_comp *comp;
+
+	/* create the compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1,
+	                      gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create compressor\n");
+		goto error;
+	}
+
+	/* enable profiles */
+	if(proto_version == 1)
+	{
+		/* enable ROHCv1 profiles */
+		if(!rohc_comp_enable_profiles(comp,
+		                              ROHCv1_PROFILE_UNCOMPRESSED,
+		                              ROHCv1_PROFILE_IP_UDP_RTP,
+		                              ROHCv1_PROFILE_IP_UDP,
+		                              ROHCv1_PROFILE_IP_ESP,
+		                              ROHCv1_PROFILE_IP,
+		                              ROHCv1_PROFILE_IP_TCP,
+		                              -1))
+		{
+			fprintf(stderr, "failed to enable the compression profiles\n");
+			goto destroy_comp;
+		}
+	}
+	else
+	{
+		/* enable ROHCv2 profiles */
+		if(!rohc_comp_enable_profiles(comp,
+		                              ROHCv1_PROFILE_UNCOMPRESSED,
+		                              ROHCv1_PROFILE_IP_TCP,
+		                              ROHCv2_PROFILE_IP_UDP_RTP,
+		                              ROHCv2_PROFILE_IP_UDP,
+		                              ROHCv2_PROFILE_IP_ESP,
+		                              ROHCv2_PROFILE_IP,
+		                              -1))
+		{
+			fprintf(stderr, "failed to enable the compression profiles\n");
+			goto destroy_comp;
+		}
+	}
+
+	/* set the number of repetitions for Optimistic Approach */
+	if(!rohc_comp_set_optimistic_approach(comp, oa_repetitions))
+	{
+		fprintf(stderr, "failed to set the Optimistic Approach repetitions\n");
+		goto destroy_comp;
+	}
+
+	/* set UDP ports dedicated to RTP traffic */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the callback RTP detection\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create and configure a ROHC decompressor
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param proto_version The version of the ROHC protocol to use: v1 or v2
+ * @return              The new ROHC decompressor
+ */
+static struct rohc_decomp * create_decompressor(const rohc_cid_type_t cid_type,
+                                                const size_t max_contexts,
+                                                const size_t proto_version)
+{
+	struct rohc_decomp *decomp;
+
+	/* create the decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create decompressor\n");
+		goto error;
+	}
+
+	/* enable decompression profiles */
+	if(proto_version == 1)
+	{
+		/* enable ROHCv1 profiles */
+		if(!rohc_decomp_enable_profiles(decomp,
+		                                ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_UDP_RTP,
+		                                ROHCv1_PROFILE_IP_UDP,
+		                                ROHCv1_PROFILE_IP_ESP,
+		                                ROHCv1_PROFILE_IP,
+		                                ROHCv1_PROFILE_IP_TCP,
+		                                -1))
+		{
+			fprintf(stderr, "failed to enable the decompression profiles\n");
+			goto destroy_decomp;
+		}
+	}
+	else
+	{
+		/* enable ROHCv2 profiles */
+		if(!rohc_decomp_enable_profiles(decomp,
+		                                ROHCv1_PROFILE_UNCOMPRESSED,
+		                                ROHCv1_PROFILE_IP_TCP,
+		                                ROHCv2_PROFILE_IP_UDP_RTP,
+		                                ROHCv2_PROFILE_IP_UDP,
+		                                ROHCv2_PROFILE_IP_ESP,
+		                                ROHCv2_PROFILE_IP,
+		                                -1))
+		{
+			fprintf(stderr, "failed to enable the decompression profiles\n");
+			goto destroy_decomp;
+		}
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Generate a false random number for the benchmark
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * Same UDP ports as the non-regression tests, so that the flows of the
+ * non-regression tests are compressed with the same profiles.
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 6;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002, 5006 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
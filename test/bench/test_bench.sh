@@ -0,0 +1,80 @@
+#!/bin/sh
+#
+# Copyright 2018 Viveris Technologies
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        test_bench.sh
+# description: Measure the throughput of the ROHC library with the captures
+#              of the non-regression tests
+# author:      Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+#
+# The captures of every RFC directory of the non-regression tests are
+# replayed with both small and large CIDs: RFC3095 and RFC6846 captures with
+# ROHCv1 profiles, RFC5225 captures with ROHCv2 profiles. The results are
+# written on stdout as an array of JSON objects, one per replay.
+#
+# Script arguments:
+#    test_bench.sh [RFC...]
+# where:
+#   RFC              the RFC directories to replay among rfc3095, rfc5225
+#                    and rfc6846 (all of them by default)
+#
+# Environment variables:
+#    BENCH_ITERATIONS=NUM  the number of times the captures are replayed
+#
+
+test -z "${BENCH_ITERATIONS}" && BENCH_ITERATIONS=10
+
+# parse arguments
+SCRIPT="$0"
+if [ "x$MAKELEVEL" != "x" ] ; then
+	BASEDIR="${srcdir}"
+	APP="./test_bench${CROSS_COMPILATION_EXEEXT}"
+else
+	BASEDIR=$( dirname "${SCRIPT}" )
+	APP="${BASEDIR}/test_bench${CROSS_COMPILATION_EXEEXT}"
+fi
+RFCS="$@"
+test -z "${RFCS}" && RFCS="rfc3095 rfc5225 rfc6846"
+
+SEP=""
+echo "["
+for RFC in ${RFCS} ; do
+	if [ "${RFC}" = "rfc5225" ] ; then
+		ROHC_VERSION=2
+	else
+		ROHC_VERSION=1
+	fi
+	FLOWS=$( find -L "${BASEDIR}/../non_regression/${RFC}/inputs" \
+	              -name source.pcap | sort )
+	if [ -z "${FLOWS}" ] ; then
+		echo "no capture found for ${RFC}" >&2
+		exit 1
+	fi
+	for CID_TYPE in smallcid largecid ; do
+		echo "benchmark ${RFC} with ${CID_TYPE}..." >&2
+		echo "${SEP}"
+		${CROSS_COMPILATION_EMULATOR} ${APP} \
+			--rohc-version ${ROHC_VERSION} \
+			--iterations ${BENCH_ITERATIONS} \
+			--label ${RFC} \
+			${CID_TYPE} ${FLOWS} || exit $?
+		SEP=","
+	done
+done
+echo "]"
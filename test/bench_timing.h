@@ -0,0 +1,121 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   bench_timing.h
+ * @brief  Timing functions shared by the benchmarks
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * Ticks are read from the Time Stamp Counter on x86 processors, the
+ * \e BENCH_HAVE_TSC macro is then defined. On other processors, ticks are
+ * nanoseconds of the monotonic clock.
+ */
+
+#ifndef ROHC_TEST_BENCH_TIMING__H
+#define ROHC_TEST_BENCH_TIMING__H
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h> /* for __rdtsc() */
+#  define BENCH_HAVE_TSC 1
+#endif
+
+
+/** One measure in progress */
+struct bench_measure
+{
+	uint64_t start_ticks;  /**< The number of ticks when the measure started */
+	uint64_t start_ns;     /**< The time (in ns) when the measure started */
+};
+
+
+/**
+ * @brief Get the current time of the monotonic clock in nanoseconds
+ *
+ * @return  The current time in nanoseconds
+ */
+static inline uint64_t bench_get_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t) ts.tv_sec) * 1000000000U + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current number of ticks
+ *
+ * Ticks are read from the Time Stamp Counter if available, from the
+ * monotonic clock (in nanoseconds) otherwise.
+ *
+ * @return  The current number of ticks
+ */
+static inline uint64_t bench_get_ticks(void)
+{
+#ifdef BENCH_HAVE_TSC
+	return __rdtsc();
+#else
+	return bench_get_ns();
+#endif
+}
+
+
+/**
+ * @brief Start one measure
+ *
+ * @param[out] measure  The measure to start
+ */
+static inline void bench_measure_start(struct bench_measure *const measure)
+{
+	measure->start_ns = bench_get_ns();
+	measure->start_ticks = bench_get_ticks();
+}
+
+
+/**
+ * @brief Stop one measure
+ *
+ * @param measure     The measure to stop
+ * @param[out] ticks  The number of ticks elapsed since the measure started
+ * @param[out] ns     The number of ns elapsed since the measure started
+ */
+static inline void bench_measure_stop(const struct bench_measure *const measure,
+                                      uint64_t *const ticks,
+                                      uint64_t *const ns)
+{
+	*ticks = bench_get_ticks() - measure->start_ticks;
+	*ns = bench_get_ns() - measure->start_ns;
+}
+
+
+/**
+ * @brief Calibrate the ticks against the monotonic clock
+ *
+ * @param ticks  The number of ticks elapsed during one measure
+ * @param ns     The number of ns elapsed during the same measure
+ * @return       The number of nanoseconds in one tick
+ */
+static inline double bench_ns_per_tick(const uint64_t ticks, const uint64_t ns)
+{
+	return (ticks == 0 ? 0.0 : ((double) ns) / ((double) ticks));
+}
+
+#endif
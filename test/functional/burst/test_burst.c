@@ -0,0 +1,627 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_burst.c
+ * @brief  Check that bursts of packets are handled as single packets are
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses the same packets one by one and by bursts with
+ * two different compressors, then checks that the ROHC packets are the same.
+ * It then decompresses the ROHC packets one by one and by bursts with two
+ * different decompressors, then checks that the decompressed packets and the
+ * feedback are the same.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for htons() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for htons() on Linux */
+#endif
+#include <assert.h>
+#include <stdarg.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/udp.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets to compress */
+#define TEST_PKTS_NR  200U
+
+/** The number of packets per burst */
+#define TEST_BURST_LEN  32U
+
+/** The number of UDP flows */
+#define TEST_FLOWS_NR  5U
+
+/** The max size of packets */
+#define TEST_MAX_PKT_SIZE  200U
+
+/** The max size of the feedback for all the packets */
+#define TEST_MAX_FEEDBACK_SIZE  (TEST_PKTS_NR * 10U)
+
+
+/* prototypes of private functions */
+static void usage(void);
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decomp(void)
+	__attribute__((warn_unused_result));
+static bool check_decomp_burst(const struct rohc_buf *const ip_packets,
+                               const struct rohc_buf *const rohc_packets)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+	__attribute__((nonnull(1), warn_unused_result));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that bursts of packets are compressed as single packets are
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t ip_buffers[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffers1[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffers2[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	struct rohc_buf ip_packets[TEST_PKTS_NR];
+	struct rohc_buf rohc_packets1[TEST_PKTS_NR];
+	struct rohc_buf rohc_packets2[TEST_PKTS_NR];
+	rohc_status_t statuses1[TEST_PKTS_NR];
+	rohc_status_t statuses2[TEST_PKTS_NR];
+	struct rohc_comp *comp1;
+	struct rohc_comp *comp2;
+	size_t pkts_nr;
+	int is_failure = 1;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	/* create the same ROHC compressor twice */
+	comp1 = create_comp();
+	if(comp1 == NULL)
+	{
+		goto error;
+	}
+	comp2 = create_comp();
+	if(comp2 == NULL)
+	{
+		goto destroy_comp1;
+	}
+
+	/* generate the IP packets */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		const struct rohc_ts ts = { .sec = i / 10, .nsec = 0 };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffers[i], build_packet(ip_buffers[i], i), ts);
+		const struct rohc_buf rohc_packet1 =
+			rohc_buf_init_empty(rohc_buffers1[i], TEST_MAX_PKT_SIZE);
+		const struct rohc_buf rohc_packet2 =
+			rohc_buf_init_empty(rohc_buffers2[i], TEST_MAX_PKT_SIZE);
+		ip_packets[i] = ip_packet;
+		rohc_packets1[i] = rohc_packet1;
+		rohc_packets2[i] = rohc_packet2;
+	}
+	/* one malformed packet and one too large packet in the middle of a burst */
+	ip_packets[TEST_BURST_LEN + 3].len = 0;
+	rohc_packets1[TEST_BURST_LEN + 7].max_len = 10;
+	rohc_packets2[TEST_BURST_LEN + 7].max_len = 10;
+
+	/* compress packets one by one */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		statuses1[i] = rohc_compress4(comp1, ip_packets[i], &rohc_packets1[i]);
+	}
+
+	/* compress packets by bursts */
+	for(i = 0; i < TEST_PKTS_NR; i += pkts_nr)
+	{
+		const size_t burst_len =
+			(TEST_PKTS_NR - i) < TEST_BURST_LEN ? (TEST_PKTS_NR - i) : TEST_BURST_LEN;
+		pkts_nr = rohc_compress_burst(comp2, ip_packets + i, rohc_packets2 + i,
+		                              statuses2 + i, burst_len);
+		if(pkts_nr != burst_len)
+		{
+			fprintf(stderr, "burst #%zu: only %zu packets out of %zu handled\n",
+			        i / TEST_BURST_LEN, pkts_nr, burst_len);
+			goto destroy_comp2;
+		}
+	}
+
+	/* check that the ROHC packets are the same */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		if(statuses1[i] != statuses2[i])
+		{
+			fprintf(stderr, "packet #%zu: status %d for single packet, status %d "
+			        "for burst\n", i + 1, statuses1[i], statuses2[i]);
+			goto destroy_comp2;
+		}
+		if(rohc_packets1[i].len != rohc_packets2[i].len ||
+		   memcmp(rohc_buf_data(rohc_packets1[i]), rohc_buf_data(rohc_packets2[i]),
+		          rohc_packets1[i].len) != 0)
+		{
+			fprintf(stderr, "packet #%zu: ROHC packets differ\n", i + 1);
+			goto destroy_comp2;
+		}
+	}
+	if(statuses1[TEST_BURST_LEN + 3] != ROHC_STATUS_ERROR ||
+	   statuses1[TEST_BURST_LEN + 7] != ROHC_STATUS_ERROR)
+	{
+		fprintf(stderr, "invalid packets were unexpectedly compressed\n");
+		goto destroy_comp2;
+	}
+	fprintf(stderr, "%u packets compressed the same way one by one and by "
+	        "bursts\n", TEST_PKTS_NR);
+
+	/* the contexts of the flows shall be found in the flow cache the same way */
+	{
+		rohc_comp_general_info_t info1;
+		rohc_comp_general_info_t info2;
+
+		memset(&info1, 0, sizeof(rohc_comp_general_info_t));
+		info1.version_major = 0;
+		info1.version_minor = 1;
+		info2 = info1;
+		if(!rohc_comp_get_general_info(comp1, &info1) ||
+		   !rohc_comp_get_general_info(comp2, &info2))
+		{
+			fprintf(stderr, "failed to get general information on compressors\n");
+			goto destroy_comp2;
+		}
+		if(info1.flow_cache_hits_nr == 0 ||
+		   info1.flow_cache_hits_nr > info1.flow_cache_lookups_nr ||
+		   info1.flow_cache_lookups_nr != info2.flow_cache_lookups_nr ||
+		   info1.flow_cache_hits_nr != info2.flow_cache_hits_nr)
+		{
+			fprintf(stderr, "flow cache: %lu hits out of %lu lookups for single "
+			        "packets, %lu hits out of %lu lookups for bursts\n",
+			        info1.flow_cache_hits_nr, info1.flow_cache_lookups_nr,
+			        info2.flow_cache_hits_nr, info2.flow_cache_lookups_nr);
+			goto destroy_comp2;
+		}
+		fprintf(stderr, "%lu contexts found in the flow cache out of %lu\n",
+		        info1.flow_cache_hits_nr, info1.flow_cache_lookups_nr);
+	}
+
+	/* decompress the ROHC packets one by one and by bursts */
+	if(!check_decomp_burst(ip_packets, rohc_packets1))
+	{
+		goto destroy_comp2;
+	}
+
+	/* invalid parameters */
+	if(rohc_compress_burst(NULL, ip_packets, rohc_packets2, statuses2, 1) != 0 ||
+	   rohc_compress_burst(comp2, NULL, rohc_packets2, statuses2, 1) != 0 ||
+	   rohc_compress_burst(comp2, ip_packets, NULL, statuses2, 1) != 0 ||
+	   rohc_compress_burst(comp2, ip_packets, rohc_packets2, NULL, 1) != 0 ||
+	   rohc_compress_burst(comp2, ip_packets, rohc_packets2, statuses2, 0) != 0)
+	{
+		fprintf(stderr, "invalid parameters were unexpectedly accepted\n");
+		goto destroy_comp2;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp2:
+	rohc_comp_free(comp2);
+destroy_comp1:
+	rohc_comp_free(comp1);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that bursts of packets are handled as single packets are\n"
+	        "\n"
+	        "usage: test_burst [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the test
+ *
+ * @return  The ROHC compressor if successful, NULL otherwise
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create one ROHC decompressor for the test
+ *
+ * @return  The ROHC decompressor if successful, NULL otherwise
+ */
+static struct rohc_decomp * create_decomp(void)
+{
+	struct rohc_decomp *decomp;
+
+	/* O-mode, so that the decompressor sends feedback */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Check that bursts of ROHC packets are decompressed as single ones are
+ *
+ * @param ip_packets    The IP packets that were compressed
+ * @param rohc_packets  The ROHC packets to decompress
+ * @return              true if the check succeeds, false otherwise
+ */
+static bool check_decomp_burst(const struct rohc_buf *const ip_packets,
+                               const struct rohc_buf *const rohc_packets)
+{
+	static uint8_t uncomp_buffers1[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	static uint8_t uncomp_buffers2[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	static struct rohc_buf uncomp_packets1[TEST_PKTS_NR];
+	static struct rohc_buf uncomp_packets2[TEST_PKTS_NR];
+	static uint8_t feedback_buffer1[TEST_MAX_FEEDBACK_SIZE];
+	static uint8_t feedback_buffer2[TEST_MAX_FEEDBACK_SIZE];
+	static uint8_t rcvd_feedback_buffer[TEST_MAX_FEEDBACK_SIZE];
+	struct rohc_buf feedback_send1 =
+		rohc_buf_init_empty(feedback_buffer1, TEST_MAX_FEEDBACK_SIZE);
+	struct rohc_buf feedback_send2 =
+		rohc_buf_init_empty(feedback_buffer2, TEST_MAX_FEEDBACK_SIZE);
+	struct rohc_buf rcvd_feedback =
+		rohc_buf_init_empty(rcvd_feedback_buffer, TEST_MAX_FEEDBACK_SIZE);
+	rohc_status_t statuses1[TEST_PKTS_NR];
+	rohc_status_t statuses2[TEST_PKTS_NR];
+	struct rohc_decomp *decomp1;
+	struct rohc_decomp *decomp2;
+	bool is_success = false;
+	size_t pkts_nr;
+	size_t i;
+
+	/* create the same ROHC decompressor twice */
+	decomp1 = create_decomp();
+	if(decomp1 == NULL)
+	{
+		goto error;
+	}
+	decomp2 = create_decomp();
+	if(decomp2 == NULL)
+	{
+		goto destroy_decomp1;
+	}
+
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		const struct rohc_buf uncomp_packet1 =
+			rohc_buf_init_empty(uncomp_buffers1[i], TEST_MAX_PKT_SIZE);
+		const struct rohc_buf uncomp_packet2 =
+			rohc_buf_init_empty(uncomp_buffers2[i], TEST_MAX_PKT_SIZE);
+		uncomp_packets1[i] = uncomp_packet1;
+		uncomp_packets2[i] = uncomp_packet2;
+	}
+
+	/* decompress packets one by one, concatenate their feedback */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		uint8_t feedback_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, TEST_MAX_PKT_SIZE);
+
+		statuses1[i] = rohc_decompress3(decomp1, rohc_packets[i], &uncomp_packets1[i],
+		                                NULL, &feedback_send);
+		rohc_buf_append_buf(&feedback_send1, feedback_send);
+	}
+
+	/* decompress packets by bursts, feedback is aggregated by the library */
+	for(i = 0; i < TEST_PKTS_NR; i += pkts_nr)
+	{
+		const size_t burst_len =
+			(TEST_PKTS_NR - i) < TEST_BURST_LEN ? (TEST_PKTS_NR - i) : TEST_BURST_LEN;
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer2 + feedback_send2.len,
+			                    TEST_MAX_FEEDBACK_SIZE - feedback_send2.len);
+
+		pkts_nr = rohc_decompress_burst(decomp2, rohc_packets + i,
+		                                uncomp_packets2 + i, statuses2 + i,
+		                                burst_len, &rcvd_feedback, &feedback_send);
+		if(pkts_nr != burst_len)
+		{
+			fprintf(stderr, "burst #%zu: only %zu ROHC packets out of %zu "
+			        "handled\n", i / TEST_BURST_LEN, pkts_nr, burst_len);
+			goto destroy_decomp2;
+		}
+		feedback_send2.len += feedback_send.len;
+	}
+
+	/* check that the decompressed packets are the same and that they match
+	 * the original packets */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		if(statuses1[i] != statuses2[i])
+		{
+			fprintf(stderr, "ROHC packet #%zu: status %d for single packet, "
+			        "status %d for burst\n", i + 1, statuses1[i], statuses2[i]);
+			goto destroy_decomp2;
+		}
+		if(statuses1[i] != ROHC_STATUS_OK)
+		{
+			if(rohc_packets[i].len > 0)
+			{
+				fprintf(stderr, "ROHC packet #%zu: unexpected status %d\n", i + 1,
+				        statuses1[i]);
+				goto destroy_decomp2;
+			}
+			continue;
+		}
+		if(uncomp_packets1[i].len != ip_packets[i].len ||
+		   uncomp_packets2[i].len != ip_packets[i].len ||
+		   memcmp(rohc_buf_data(uncomp_packets1[i]), rohc_buf_data(ip_packets[i]),
+		          ip_packets[i].len) != 0 ||
+		   memcmp(rohc_buf_data(uncomp_packets2[i]), rohc_buf_data(ip_packets[i]),
+		          ip_packets[i].len) != 0)
+		{
+			fprintf(stderr, "ROHC packet #%zu: decompressed packets differ\n",
+			        i + 1);
+			goto destroy_decomp2;
+		}
+	}
+	if(feedback_send1.len == 0 ||
+	   feedback_send1.len != feedback_send2.len ||
+	   memcmp(feedback_buffer1, feedback_buffer2, feedback_send1.len) != 0)
+	{
+		fprintf(stderr, "feedback differ: %zu bytes for single packets, %zu bytes "
+		        "for bursts\n", feedback_send1.len, feedback_send2.len);
+		goto destroy_decomp2;
+	}
+	if(rcvd_feedback.len != 0)
+	{
+		fprintf(stderr, "unexpected %zu bytes of received feedback\n",
+		        rcvd_feedback.len);
+		goto destroy_decomp2;
+	}
+	fprintf(stderr, "%u ROHC packets decompressed the same way one by one and "
+	        "by bursts\n", TEST_PKTS_NR);
+
+	/* invalid parameters */
+	if(rohc_decompress_burst(NULL, rohc_packets, uncomp_packets2, statuses2, 1,
+	                         NULL, NULL) != 0 ||
+	   rohc_decompress_burst(decomp2, NULL, uncomp_packets2, statuses2, 1,
+	                         NULL, NULL) != 0 ||
+	   rohc_decompress_burst(decomp2, rohc_packets, NULL, statuses2, 1,
+	                         NULL, NULL) != 0 ||
+	   rohc_decompress_burst(decomp2, rohc_packets, uncomp_packets2, NULL, 1,
+	                         NULL, NULL) != 0 ||
+	   rohc_decompress_burst(decomp2, rohc_packets, uncomp_packets2, statuses2, 1,
+	                         NULL, &feedback_send2) != 0 ||
+	   rohc_decompress_burst(decomp2, rohc_packets, uncomp_packets2, statuses2, 0,
+	                         NULL, NULL) != 0)
+	{
+		fprintf(stderr, "invalid parameters were unexpectedly accepted\n");
+		goto destroy_decomp2;
+	}
+
+	is_success = true;
+
+destroy_decomp2:
+	rohc_decomp_free(decomp2);
+destroy_decomp1:
+	rohc_decomp_free(decomp1);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Build one IPv4/UDP packet of the test
+ *
+ * Packets of the same flow come in short rows, flows are interleaved.
+ *
+ * @param buf      The buffer for the packet
+ * @param pkt_idx  The index of the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+{
+	const size_t flow = (pkt_idx / 3 + pkt_idx % 2) % TEST_FLOWS_NR;
+	const size_t payload_len = 20 + flow;
+	const size_t pkt_len =
+		sizeof(struct ipv4_hdr) + sizeof(struct udphdr) + payload_len;
+	struct ipv4_hdr *const ip_hdr = (struct ipv4_hdr *) buf;
+	struct udphdr *const udp_hdr = (struct udphdr *) (ip_hdr + 1);
+	uint8_t *const payload = (uint8_t *) (udp_hdr + 1);
+	uint32_t csum = 0;
+	size_t i;
+
+	assert(pkt_len <= TEST_MAX_PKT_SIZE);
+
+	ip_hdr->version = 4;
+	ip_hdr->ihl = 5;
+	ip_hdr->tos = 0;
+	ip_hdr->tot_len = htons(pkt_len);
+	ip_hdr->id = htons(pkt_idx);
+	ip_hdr->frag_off = 0;
+	ip_hdr->ttl = 64;
+	ip_hdr->protocol = 17; /* UDP */
+	ip_hdr->check = 0;
+	ip_hdr->saddr = htonl(0xc0a80001);
+	ip_hdr->daddr = htonl(0xc0a80100 + flow);
+	for(i = 0; i < sizeof(struct ipv4_hdr); i += 2)
+	{
+		csum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((csum >> 16) != 0)
+	{
+		csum = (csum & 0xffff) + (csum >> 16);
+	}
+	ip_hdr->check = htons(~csum & 0xffff);
+
+	udp_hdr->source = htons(1024 + flow);
+	udp_hdr->dest = htons(5000 + flow);
+	udp_hdr->len = htons(sizeof(struct udphdr) + payload_len);
+	udp_hdr->check = 0;
+
+	for(i = 0; i < payload_len; i++)
+	{
+		payload[i] = (pkt_idx + i) & 0xff;
+	}
+
+	return pkt_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * The same number is always returned, so that several compressors behave
+ * the same way.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 4; /* chosen by fair dice roll, guaranteed to be random */
+}
@@ -0,0 +1,599 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_pkt_meta.c
+ * @brief  Check that packets classified by the application are compressed right
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses the same packets with \ref rohc_compress4 and
+ * with \ref rohc_compress_meta with two different compressors, then checks
+ * that the ROHC packets are the same. The packets are IPv4/UDP, IPv6/UDP,
+ * IPv6/UDP with one IPv6 extension header and IPv4/IPv6/UDP packets.
+ *
+ * The application then checks that the packets compressed with
+ * \ref rohc_compress4 find the contexts created by \ref rohc_compress_meta.
+ *
+ * The application then checks that metadata that does not match the packet
+ * is rejected, and that the IPv4 checksum is not verified.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+
+
+/** The number of packets to compress */
+#define TEST_PKTS_NR  100U
+
+/** The number of flows, one per kind of packet */
+#define TEST_FLOWS_NR  4U
+
+/** The max size of packets */
+#define TEST_MAX_PKT_SIZE  500U
+
+
+/* prototypes of private functions */
+static void usage(void);
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+static bool check_bad_meta(struct rohc_comp *const comp,
+                           const struct rohc_buf ip_packet,
+                           const rohc_comp_pkt_meta_t *const meta,
+                           const char *const descr)
+	__attribute__((nonnull(1, 3, 4), warn_unused_result));
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx,
+                           rohc_comp_pkt_meta_t *const meta)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static void build_ipv4_hdr(uint8_t *const buf,
+                           const size_t tot_len,
+                           const uint8_t protocol,
+                           const size_t pkt_idx,
+                           const size_t flow)
+	__attribute__((nonnull(1)));
+static void build_ipv6_hdr(uint8_t *const buf,
+                           const size_t plen,
+                           const uint8_t nh,
+                           const size_t flow)
+	__attribute__((nonnull(1)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that packets classified by the application are compressed right
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffer1[TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffer2[TEST_MAX_PKT_SIZE];
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	struct rohc_comp *comp1;
+	struct rohc_comp *comp2;
+	int is_failure = 1;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	/* create the same ROHC compressor twice */
+	comp1 = create_comp();
+	if(comp1 == NULL)
+	{
+		goto error;
+	}
+	comp2 = create_comp();
+	if(comp2 == NULL)
+	{
+		goto destroy_comp1;
+	}
+
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		rohc_comp_pkt_meta_t meta;
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, i, &meta), ts);
+		struct rohc_buf rohc_packet1 =
+			rohc_buf_init_empty(rohc_buffer1, TEST_MAX_PKT_SIZE);
+		struct rohc_buf rohc_packet2 =
+			rohc_buf_init_empty(rohc_buffer2, TEST_MAX_PKT_SIZE);
+		rohc_status_t status;
+
+		/* compress the packet after parsing its headers */
+		status = rohc_compress4(comp1, ip_packet, &rohc_packet1);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress packet (%d)\n",
+			        i + 1, status);
+			goto destroy_comp2;
+		}
+
+		/* compress the packet with its metadata */
+		status = rohc_compress_meta(comp2, ip_packet, &meta, &rohc_packet2);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress packet with its "
+			        "metadata (%d)\n", i + 1, status);
+			goto destroy_comp2;
+		}
+
+		/* both ROHC packets shall be the same */
+		if(rohc_packet1.len != rohc_packet2.len ||
+		   memcmp(rohc_buf_data(rohc_packet1), rohc_buf_data(rohc_packet2),
+		          rohc_packet1.len) != 0)
+		{
+			fprintf(stderr, "packet #%zu: %zu-byte ROHC packet compressed with "
+			        "metadata differs from %zu-byte ROHC packet\n", i + 1,
+			        rohc_packet2.len, rohc_packet1.len);
+			goto destroy_comp2;
+		}
+	}
+	fprintf(stderr, "%u packets compressed the same way with and without their "
+	        "metadata\n", TEST_PKTS_NR);
+
+	/* the contexts created with metadata shall be found without metadata */
+	for(i = TEST_PKTS_NR; i < (TEST_PKTS_NR + TEST_FLOWS_NR); i++)
+	{
+		rohc_comp_pkt_meta_t meta;
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, i, &meta), ts);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer2, TEST_MAX_PKT_SIZE);
+		rohc_comp_general_info_t info;
+		rohc_status_t status;
+
+		status = rohc_compress4(comp2, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress packet without its "
+			        "metadata (%d)\n", i + 1, status);
+			goto destroy_comp2;
+		}
+
+		info.version_major = 0;
+		info.version_minor = 0;
+		if(!rohc_comp_get_general_info(comp2, &info))
+		{
+			fprintf(stderr, "failed to get general information on compressor\n");
+			goto destroy_comp2;
+		}
+		if(info.contexts_nr != TEST_FLOWS_NR)
+		{
+			fprintf(stderr, "packet #%zu: %zu contexts used instead of %u\n",
+			        i + 1, info.contexts_nr, TEST_FLOWS_NR);
+			goto destroy_comp2;
+		}
+	}
+	fprintf(stderr, "contexts created with metadata are found without "
+	        "metadata\n");
+
+	/* metadata that does not match the packet shall be rejected */
+	{
+		rohc_comp_pkt_meta_t meta;
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, 2, &meta), ts);
+		rohc_comp_pkt_meta_t bad_meta;
+
+		bad_meta = meta;
+		bad_meta.l4_offset = meta.ip_offsets[0] + 40;
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "missing IPv6 extension"))
+		{
+			goto destroy_comp2;
+		}
+		bad_meta = meta;
+		bad_meta.l4_proto = 6; /* TCP */
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "wrong layer-4 protocol"))
+		{
+			goto destroy_comp2;
+		}
+		bad_meta = meta;
+		bad_meta.l4_offset = ip_packet.len + 1;
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "layer-4 offset too large"))
+		{
+			goto destroy_comp2;
+		}
+		bad_meta = meta;
+		bad_meta.ip_offsets[0] = 4;
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "wrong IP offset"))
+		{
+			goto destroy_comp2;
+		}
+		bad_meta = meta;
+		bad_meta.ip_versions[0] = 4;
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "wrong IP version"))
+		{
+			goto destroy_comp2;
+		}
+		bad_meta = meta;
+		bad_meta.ip_hdrs_nr = 0;
+		if(!check_bad_meta(comp2, ip_packet, &bad_meta, "no IP header"))
+		{
+			goto destroy_comp2;
+		}
+	}
+	fprintf(stderr, "metadata that does not match packets is rejected\n");
+
+	/* the IPv4 checksum is not verified with metadata */
+	{
+		rohc_comp_pkt_meta_t meta;
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, 0, &meta), ts);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer1, TEST_MAX_PKT_SIZE);
+		rohc_status_t status;
+
+		ip_buffer[10] ^= 0xff;
+		status = rohc_compress4(comp1, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_ERROR)
+		{
+			fprintf(stderr, "packet with wrong IPv4 checksum was not rejected "
+			        "(%d)\n", status);
+			goto destroy_comp2;
+		}
+		status = rohc_compress_meta(comp2, ip_packet, &meta, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet with wrong IPv4 checksum was not compressed "
+			        "with its metadata (%d)\n", status);
+			goto destroy_comp2;
+		}
+	}
+	fprintf(stderr, "IPv4 checksum is not verified with metadata\n");
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp2:
+	rohc_comp_free(comp2);
+destroy_comp1:
+	rohc_comp_free(comp1);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that packets classified by the application are compressed right\n"
+	        "\n"
+	        "usage: test_pkt_meta [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the test
+ *
+ * The Uncompressed profile is not enabled, so that packets that cannot be
+ * compressed are rejected.
+ *
+ * @return  The ROHC compressor if successful, NULL otherwise
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Check that the given metadata is rejected for the given packet
+ *
+ * @param comp       The ROHC compressor
+ * @param ip_packet  The packet to compress
+ * @param meta       The metadata that does not match the packet
+ * @param descr      The description of the mismatch
+ * @return           true if the metadata is rejected, false otherwise
+ */
+static bool check_bad_meta(struct rohc_comp *const comp,
+                           const struct rohc_buf ip_packet,
+                           const rohc_comp_pkt_meta_t *const meta,
+                           const char *const descr)
+{
+	static uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+	rohc_status_t status;
+
+	status = rohc_compress_meta(comp, ip_packet, meta, &rohc_packet);
+	if(status != ROHC_STATUS_ERROR)
+	{
+		fprintf(stderr, "metadata with %s was not rejected (%d)\n", descr, status);
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Build one packet of the test and its metadata
+ *
+ * The kind of packet depends on its flow:
+ *  \li flow 0: IPv4/UDP
+ *  \li flow 1: IPv6/UDP
+ *  \li flow 2: IPv6/UDP with one Destination Options extension header
+ *  \li flow 3: IPv4/IPv6/UDP
+ *
+ * @param buf        The buffer for the packet
+ * @param pkt_idx    The index of the packet
+ * @param[out] meta  The metadata of the packet
+ * @return           The length of the packet
+ */
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx,
+                           rohc_comp_pkt_meta_t *const meta)
+{
+	const size_t flow = pkt_idx % TEST_FLOWS_NR;
+	const size_t payload_len = 20 + pkt_idx % 50;
+	const size_t udp_len = 8 + payload_len;
+	size_t pkt_len;
+	size_t i;
+
+	memset(meta, 0, sizeof(rohc_comp_pkt_meta_t));
+	meta->l4_proto = 17; /* UDP */
+	meta->has_flow_hash = true;
+	meta->flow_hash = 0x9e3779b9U * (flow + 1);
+
+	switch(flow)
+	{
+		case 0:
+			meta->ip_hdrs_nr = 1;
+			meta->ip_versions[0] = 4;
+			meta->l4_offset = 20;
+			build_ipv4_hdr(buf, 20 + udp_len, 17, pkt_idx, flow);
+			break;
+		case 1:
+			meta->ip_hdrs_nr = 1;
+			meta->ip_versions[0] = 6;
+			meta->l4_offset = 40;
+			build_ipv6_hdr(buf, udp_len, 17, flow);
+			break;
+		case 2:
+			meta->ip_hdrs_nr = 1;
+			meta->ip_versions[0] = 6;
+			meta->l4_offset = 48;
+			build_ipv6_hdr(buf, 8 + udp_len, 60, flow); /* Destination Options */
+			buf[40] = 17; /* UDP */
+			buf[41] = 0; /* 8 bytes */
+			buf[42] = 1; /* PadN option */
+			buf[43] = 4;
+			memset(buf + 44, 0, 4);
+			break;
+		default:
+			meta->ip_hdrs_nr = 2;
+			meta->ip_versions[0] = 4;
+			meta->ip_versions[1] = 6;
+			meta->ip_offsets[1] = 20;
+			meta->l4_offset = 60;
+			build_ipv4_hdr(buf, 60 + udp_len, 41, pkt_idx, flow); /* IPv6 */
+			build_ipv6_hdr(buf + 20, udp_len, 17, flow);
+			break;
+	}
+	pkt_len = meta->l4_offset + udp_len;
+	assert(pkt_len <= TEST_MAX_PKT_SIZE);
+
+	/* UDP header without checksum */
+	buf[meta->l4_offset] = 0x04;
+	buf[meta->l4_offset + 1] = flow;
+	buf[meta->l4_offset + 2] = 0x13;
+	buf[meta->l4_offset + 3] = 0x88 + flow;
+	buf[meta->l4_offset + 4] = (udp_len >> 8) & 0xff;
+	buf[meta->l4_offset + 5] = udp_len & 0xff;
+	buf[meta->l4_offset + 6] = 0;
+	buf[meta->l4_offset + 7] = 0;
+
+	for(i = meta->l4_offset + 8; i < pkt_len; i++)
+	{
+		buf[i] = (pkt_idx + i) & 0xff;
+	}
+
+	return pkt_len;
+}
+
+
+/**
+ * @brief Build one IPv4 header with a valid checksum
+ *
+ * @param buf       The buffer for the IPv4 header
+ * @param tot_len   The total length of the IPv4 packet
+ * @param protocol  The protocol of the IPv4 payload
+ * @param pkt_idx   The index of the packet
+ * @param flow      The flow of the packet
+ */
+static void build_ipv4_hdr(uint8_t *const buf,
+                           const size_t tot_len,
+                           const uint8_t protocol,
+                           const size_t pkt_idx,
+                           const size_t flow)
+{
+	uint32_t csum = 0;
+	size_t i;
+
+	buf[0] = 0x45;
+	buf[1] = 0;
+	buf[2] = (tot_len >> 8) & 0xff;
+	buf[3] = tot_len & 0xff;
+	buf[4] = (pkt_idx >> 8) & 0xff;
+	buf[5] = pkt_idx & 0xff;
+	buf[6] = 0;
+	buf[7] = 0;
+	buf[8] = 64;
+	buf[9] = protocol;
+	buf[10] = 0;
+	buf[11] = 0;
+	buf[12] = 192;
+	buf[13] = 168;
+	buf[14] = 0;
+	buf[15] = 1;
+	buf[16] = 192;
+	buf[17] = 168;
+	buf[18] = 1;
+	buf[19] = flow;
+
+	for(i = 0; i < 20; i += 2)
+	{
+		csum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((csum >> 16) != 0)
+	{
+		csum = (csum & 0xffff) + (csum >> 16);
+	}
+	buf[10] = (~csum >> 8) & 0xff;
+	buf[11] = ~csum & 0xff;
+}
+
+
+/**
+ * @brief Build one IPv6 header
+ *
+ * @param buf   The buffer for the IPv6 header
+ * @param plen  The length of the IPv6 payload
+ * @param nh    The protocol of the next header
+ * @param flow  The flow of the packet
+ */
+static void build_ipv6_hdr(uint8_t *const buf,
+                           const size_t plen,
+                           const uint8_t nh,
+                           const size_t flow)
+{
+	buf[0] = 0x60;
+	buf[1] = 0;
+	buf[2] = 0;
+	buf[3] = flow;
+	buf[4] = (plen >> 8) & 0xff;
+	buf[5] = plen & 0xff;
+	buf[6] = nh;
+	buf[7] = 64;
+	memset(buf + 8, 0, 32);
+	buf[8] = 0x20;
+	buf[9] = 0x01;
+	buf[23] = 1;
+	buf[24] = 0x20;
+	buf[25] = 0x01;
+	buf[39] = 0x10 + flow;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * The same number is always returned, so that several compressors behave
+ * the same way.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 4; /* chosen by fair dice roll, guaranteed to be random */
+}
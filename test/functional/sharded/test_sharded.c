@@ -0,0 +1,679 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_sharded.c
+ * @brief  Check that the shards of one sharded compressor share the CID space
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses the packets of several flows with a sharded
+ * compressor: every packet is compressed by the shard selected for it. The
+ * application checks that the packets of one flow are always given to the
+ * same shard, that every shard only uses its own CIDs, and that one single
+ * decompressor decompresses all the packets of all the shards.
+ *
+ * The feedback of the decompressor is dispatched to the shards, then either
+ * delivered to them directly or pushed into their queues of feedback. The
+ * statistics of the shards are checked to be aggregated.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for htons() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for htons() on Linux */
+#endif
+#include <assert.h>
+#include <stdarg.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/udp.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets to compress */
+#define TEST_PKTS_NR  200U
+
+/** The number of UDP flows */
+#define TEST_FLOWS_NR  10U
+
+/** The number of shards */
+#define TEST_SHARDS_NR  4U
+
+/** The MAX_CID of the compressor and of the decompressor */
+#define TEST_MAX_CID  15U
+
+/** The max size of packets */
+#define TEST_MAX_PKT_SIZE  500U
+
+/** The max size of feedback data */
+#define TEST_MAX_FEEDBACK_SIZE  500U
+
+/** The size of the queue of feedback of every shard */
+#define TEST_FEEDBACK_QUEUE_LEN  256U
+
+
+/* prototypes of private functions */
+static void usage(void);
+static struct rohc_comp_sharded * create_sharded_comp(void)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decomp(void)
+	__attribute__((warn_unused_result));
+static bool check_invalid_params(void)
+	__attribute__((warn_unused_result));
+static bool deliver_feedback(const struct rohc_comp_sharded *const sc,
+                             const struct rohc_buf feedback,
+                             const bool use_queues)
+	__attribute__((nonnull(1), warn_unused_result));
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+	__attribute__((nonnull(1), warn_unused_result));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the shards of one sharded compressor share the CID space
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+	static uint8_t decomp_buffer[TEST_MAX_PKT_SIZE];
+	static uint8_t feedback_buffer[TEST_MAX_FEEDBACK_SIZE];
+	size_t flow_shards[TEST_FLOWS_NR];
+	size_t shard_pkts_nr[TEST_SHARDS_NR] = { 0 };
+	size_t feedbacks_nr = 0;
+	struct rohc_comp_sharded *sc;
+	struct rohc_decomp *decomp;
+	rohc_comp_general_info_t info;
+	int is_failure = 1;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	if(!check_invalid_params())
+	{
+		goto error;
+	}
+
+	sc = create_sharded_comp();
+	if(sc == NULL)
+	{
+		goto error;
+	}
+	decomp = create_decomp();
+	if(decomp == NULL)
+	{
+		goto destroy_comp;
+	}
+
+	for(i = 0; i < TEST_FLOWS_NR; i++)
+	{
+		flow_shards[i] = TEST_SHARDS_NR;
+	}
+
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		const size_t flow = i % TEST_FLOWS_NR;
+		const struct rohc_ts ts = { .sec = i / 10, .nsec = 0 };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, i), ts);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+		struct rohc_buf decomp_packet =
+			rohc_buf_init_empty(decomp_buffer, TEST_MAX_PKT_SIZE);
+		struct rohc_buf feedback =
+			rohc_buf_init_empty(feedback_buffer, TEST_MAX_FEEDBACK_SIZE);
+		rohc_comp_last_packet_info2_t last_pkt_info;
+		struct rohc_comp *shard;
+		size_t shard_idx;
+		rohc_status_t status;
+
+		/* select the shard of the packet */
+		if(!rohc_comp_sharded_select(sc, ip_packet, &shard_idx))
+		{
+			fprintf(stderr, "packet #%zu: failed to select a shard\n", i + 1);
+			goto destroy_decomp;
+		}
+		if(shard_idx >= TEST_SHARDS_NR)
+		{
+			fprintf(stderr, "packet #%zu: invalid shard %zu selected\n", i + 1,
+			        shard_idx);
+			goto destroy_decomp;
+		}
+		if(flow_shards[flow] == TEST_SHARDS_NR)
+		{
+			flow_shards[flow] = shard_idx;
+		}
+		else if(flow_shards[flow] != shard_idx)
+		{
+			fprintf(stderr, "packet #%zu: shard %zu selected for flow #%zu "
+			        "instead of shard %zu\n", i + 1, shard_idx, flow + 1,
+			        flow_shards[flow]);
+			goto destroy_decomp;
+		}
+		shard = rohc_comp_sharded_get_shard(sc, shard_idx);
+		assert(shard != NULL);
+		shard_pkts_nr[shard_idx]++;
+
+		/* compress the packet with its shard */
+		status = rohc_compress4(shard, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress packet (%d)\n",
+			        i + 1, status);
+			goto destroy_decomp;
+		}
+
+		/* the shard shall only use its own CIDs */
+		last_pkt_info.version_major = 0;
+		last_pkt_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(shard, &last_pkt_info))
+		{
+			fprintf(stderr, "packet #%zu: failed to get information on the "
+			        "last compressed packet\n", i + 1);
+			goto destroy_decomp;
+		}
+		if((last_pkt_info.context_id % TEST_SHARDS_NR) != shard_idx)
+		{
+			fprintf(stderr, "packet #%zu: shard %zu used CID %u\n", i + 1,
+			        shard_idx, last_pkt_info.context_id);
+			goto destroy_decomp;
+		}
+
+		/* decompress the packet with the decompressor shared by all shards */
+		status = rohc_decompress3(decomp, rohc_packet, &decomp_packet, NULL,
+		                          &feedback);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to decompress packet (%d)\n",
+			        i + 1, status);
+			goto destroy_decomp;
+		}
+		if(decomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(decomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "packet #%zu: %zu-byte decompressed packet differs "
+			        "from the %zu-byte original packet\n", i + 1,
+			        decomp_packet.len, ip_packet.len);
+			goto destroy_decomp;
+		}
+
+		/* give the feedback of the decompressor back to the shards */
+		if(feedback.len > 0)
+		{
+			if(!deliver_feedback(sc, feedback, (feedbacks_nr % 2) == 1))
+			{
+				fprintf(stderr, "packet #%zu: failed to deliver feedback\n", i + 1);
+				goto destroy_decomp;
+			}
+			feedbacks_nr++;
+		}
+	}
+	fprintf(stderr, "%u packets of %u flows compressed by %u shards and "
+	        "decompressed, %zu feedbacks delivered\n", TEST_PKTS_NR,
+	        TEST_FLOWS_NR, TEST_SHARDS_NR, feedbacks_nr);
+	if(feedbacks_nr == 0)
+	{
+		fprintf(stderr, "no feedback was delivered to the shards\n");
+		goto destroy_decomp;
+	}
+
+	/* the statistics of the shards shall be aggregated */
+	info.version_major = 0;
+	info.version_minor = 0;
+	if(!rohc_comp_sharded_get_general_info(sc, &info))
+	{
+		fprintf(stderr, "failed to get general information\n");
+		goto destroy_decomp;
+	}
+	if(info.packets_nr != TEST_PKTS_NR)
+	{
+		fprintf(stderr, "%lu packets counted instead of %u\n", info.packets_nr,
+		        TEST_PKTS_NR);
+		goto destroy_decomp;
+	}
+	for(i = 0; i < TEST_SHARDS_NR; i++)
+	{
+		rohc_comp_general_info_t shard_info;
+
+		shard_info.version_major = 0;
+		shard_info.version_minor = 0;
+		if(!rohc_comp_get_general_info(rohc_comp_sharded_get_shard(sc, i),
+		                               &shard_info))
+		{
+			fprintf(stderr, "failed to get general information of shard %zu\n", i);
+			goto destroy_decomp;
+		}
+		if(shard_info.packets_nr != shard_pkts_nr[i])
+		{
+			fprintf(stderr, "shard %zu counted %lu packets instead of %zu\n", i,
+			        shard_info.packets_nr, shard_pkts_nr[i]);
+			goto destroy_decomp;
+		}
+		fprintf(stderr, "shard %zu: %lu packets, %zu contexts\n", i,
+		        shard_info.packets_nr, shard_info.contexts_nr);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_sharded_free(sc);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that the shards of one sharded compressor share the CID space\n"
+	        "\n"
+	        "usage: test_sharded [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Create the sharded ROHC compressor for the test
+ *
+ * @return  The sharded ROHC compressor if successful, NULL otherwise
+ */
+static struct rohc_comp_sharded * create_sharded_comp(void)
+{
+	struct rohc_comp_sharded *sc;
+	size_t i;
+
+	sc = rohc_comp_sharded_new(ROHC_SMALL_CID, TEST_MAX_CID, TEST_SHARDS_NR,
+	                           gen_random_num, NULL);
+	if(sc == NULL)
+	{
+		fprintf(stderr, "failed to create the sharded ROHC compressor\n");
+		goto error;
+	}
+
+	/* configure all the shards the same way */
+	for(i = 0; i < TEST_SHARDS_NR; i++)
+	{
+		struct rohc_comp *const shard = rohc_comp_sharded_get_shard(sc, i);
+
+		if(shard == NULL)
+		{
+			fprintf(stderr, "failed to get shard %zu\n", i);
+			goto destroy_comp;
+		}
+
+		if(!rohc_comp_set_traces_cb2(shard, print_rohc_traces, NULL))
+		{
+			fprintf(stderr, "failed to set the callback for traces on "
+			        "shard %zu\n", i);
+			goto destroy_comp;
+		}
+
+		if(!rohc_comp_enable_profiles(shard, ROHC_PROFILE_UNCOMPRESSED,
+		                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+		{
+			fprintf(stderr, "failed to enable the compression profiles on "
+			        "shard %zu\n", i);
+			goto destroy_comp;
+		}
+
+		if(!rohc_comp_set_feedback_queue(shard, TEST_FEEDBACK_QUEUE_LEN))
+		{
+			fprintf(stderr, "failed to create the queue of feedback of shard "
+			        "%zu\n", i);
+			goto destroy_comp;
+		}
+	}
+
+	return sc;
+
+destroy_comp:
+	rohc_comp_sharded_free(sc);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor for the test
+ *
+ * The decompressor runs in O-mode to send feedback to the shards.
+ *
+ * @return  The ROHC decompressor if successful, NULL otherwise
+ */
+static struct rohc_decomp * create_decomp(void)
+{
+	struct rohc_decomp *decomp;
+
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, TEST_MAX_CID, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Check that the sharded compressor rejects invalid parameters
+ *
+ * @return  true if all the invalid parameters are rejected, false otherwise
+ */
+static bool check_invalid_params(void)
+{
+	struct rohc_comp_sharded *sc;
+	rohc_comp_general_info_t info;
+	size_t shard_idx;
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	uint8_t buf[1] = { 0 };
+	const struct rohc_buf pkt = rohc_buf_init_full(buf, 1, ts);
+
+	/* every shard shall own at least one CID */
+	if(rohc_comp_sharded_new(ROHC_SMALL_CID, TEST_MAX_CID, 0,
+	                         gen_random_num, NULL) != NULL ||
+	   rohc_comp_sharded_new(ROHC_SMALL_CID, TEST_MAX_CID, TEST_MAX_CID + 2,
+	                         gen_random_num, NULL) != NULL ||
+	   rohc_comp_sharded_new(ROHC_SMALL_CID, TEST_MAX_CID, TEST_SHARDS_NR,
+	                         NULL, NULL) != NULL)
+	{
+		fprintf(stderr, "sharded compressor created with invalid parameters\n");
+		goto error;
+	}
+
+	/* one shard per CID is fine */
+	sc = rohc_comp_sharded_new(ROHC_SMALL_CID, TEST_MAX_CID, TEST_MAX_CID + 1,
+	                           gen_random_num, NULL);
+	if(sc == NULL)
+	{
+		fprintf(stderr, "failed to create one shard per CID\n");
+		goto error;
+	}
+	if(rohc_comp_sharded_get_shard(sc, TEST_MAX_CID) == NULL ||
+	   rohc_comp_sharded_get_shard(sc, TEST_MAX_CID + 1) != NULL ||
+	   rohc_comp_sharded_get_shard(NULL, 0) != NULL)
+	{
+		fprintf(stderr, "unexpected shards\n");
+		goto destroy_comp;
+	}
+	if(rohc_comp_sharded_select(NULL, pkt, &shard_idx) ||
+	   rohc_comp_sharded_select(sc, pkt, NULL))
+	{
+		fprintf(stderr, "shard selected with invalid parameters\n");
+		goto destroy_comp;
+	}
+	info.version_major = 1;
+	info.version_minor = 0;
+	if(rohc_comp_sharded_get_general_info(sc, &info) ||
+	   rohc_comp_sharded_get_general_info(NULL, &info) ||
+	   rohc_comp_sharded_get_general_info(sc, NULL))
+	{
+		fprintf(stderr, "general information got with invalid parameters\n");
+		goto destroy_comp;
+	}
+	if(rohc_comp_sharded_split_feedback(sc, pkt, NULL))
+	{
+		fprintf(stderr, "feedback dispatched with invalid parameters\n");
+		goto destroy_comp;
+	}
+	rohc_comp_sharded_free(sc);
+	rohc_comp_sharded_free(NULL);
+
+	return true;
+
+destroy_comp:
+	rohc_comp_sharded_free(sc);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Dispatch feedback data to the shards, then deliver it to them
+ *
+ * Every shard shall only receive feedback for its own contexts, so the
+ * direct delivery fails if one feedback item is given to the wrong shard.
+ * The feedback pushed into the queue of one shard is delivered when the
+ * shard compresses its next packet: the small queues overflow if the shards
+ * do not drain them.
+ *
+ * @param sc          The sharded ROHC compressor
+ * @param feedback    The feedback data
+ * @param use_queues  Whether to push the feedback into the queues of the
+ *                    shards or to deliver it directly
+ * @return            true if the feedback data was delivered or queued,
+ *                    false otherwise
+ */
+static bool deliver_feedback(const struct rohc_comp_sharded *const sc,
+                             const struct rohc_buf feedback,
+                             const bool use_queues)
+{
+	static uint8_t shard_buffers[TEST_SHARDS_NR][TEST_MAX_FEEDBACK_SIZE];
+	struct rohc_buf shard_feedbacks[TEST_SHARDS_NR];
+	size_t feedbacks_len = 0;
+	size_t i;
+
+	for(i = 0; i < TEST_SHARDS_NR; i++)
+	{
+		const struct rohc_buf shard_feedback =
+			rohc_buf_init_empty(shard_buffers[i], TEST_MAX_FEEDBACK_SIZE);
+		shard_feedbacks[i] = shard_feedback;
+	}
+
+	if(!rohc_comp_sharded_split_feedback(sc, feedback, shard_feedbacks))
+	{
+		fprintf(stderr, "failed to dispatch %zu bytes of feedback\n",
+		        feedback.len);
+		goto error;
+	}
+
+	for(i = 0; i < TEST_SHARDS_NR; i++)
+	{
+		struct rohc_comp *const shard = rohc_comp_sharded_get_shard(sc, i);
+
+		feedbacks_len += shard_feedbacks[i].len;
+		if(use_queues)
+		{
+			if(!rohc_comp_push_feedback(shard, shard_feedbacks[i]))
+			{
+				fprintf(stderr, "failed to push %zu bytes of feedback into the "
+				        "queue of shard %zu\n", shard_feedbacks[i].len, i);
+				goto error;
+			}
+		}
+		else if(!rohc_comp_deliver_feedback2(shard, shard_feedbacks[i]))
+		{
+			fprintf(stderr, "failed to deliver %zu bytes of feedback to shard "
+			        "%zu\n", shard_feedbacks[i].len, i);
+			goto error;
+		}
+	}
+	if(feedbacks_len != feedback.len)
+	{
+		fprintf(stderr, "%zu bytes of feedback dispatched instead of %zu\n",
+		        feedbacks_len, feedback.len);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one IPv4/UDP packet of the test
+ *
+ * @param buf      The buffer for the packet
+ * @param pkt_idx  The index of the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+{
+	const size_t flow = pkt_idx % TEST_FLOWS_NR;
+	const size_t payload_len = 20 + pkt_idx % 50;
+	const size_t pkt_len =
+		sizeof(struct ipv4_hdr) + sizeof(struct udphdr) + payload_len;
+	struct ipv4_hdr *const ip_hdr = (struct ipv4_hdr *) buf;
+	struct udphdr *const udp_hdr = (struct udphdr *) (ip_hdr + 1);
+	uint8_t *const payload = (uint8_t *) (udp_hdr + 1);
+	uint32_t csum = 0;
+	size_t i;
+
+	assert(pkt_len <= TEST_MAX_PKT_SIZE);
+
+	ip_hdr->version = 4;
+	ip_hdr->ihl = 5;
+	ip_hdr->tos = 0;
+	ip_hdr->tot_len = htons(pkt_len);
+	ip_hdr->id = htons(pkt_idx / TEST_FLOWS_NR);
+	ip_hdr->frag_off = 0;
+	ip_hdr->ttl = 64;
+	ip_hdr->protocol = 17; /* UDP */
+	ip_hdr->check = 0;
+	ip_hdr->saddr = htonl(0xc0a80001);
+	ip_hdr->daddr = htonl(0xc0a80100 + flow);
+	for(i = 0; i < sizeof(struct ipv4_hdr); i += 2)
+	{
+		csum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((csum >> 16) != 0)
+	{
+		csum = (csum & 0xffff) + (csum >> 16);
+	}
+	ip_hdr->check = htons(~csum & 0xffff);
+
+	udp_hdr->source = htons(1024 + flow);
+	udp_hdr->dest = htons(5000 + flow);
+	udp_hdr->len = htons(sizeof(struct udphdr) + payload_len);
+	udp_hdr->check = 0;
+
+	for(i = 0; i < payload_len; i++)
+	{
+		payload[i] = (pkt_idx + i) & 0xff;
+	}
+
+	return pkt_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
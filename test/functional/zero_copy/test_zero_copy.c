@@ -0,0 +1,562 @@
+/*
+ * Copyright 2018 Viveris Technologies
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_zero_copy.c
+ * @brief  Check that packets are (de)compressed right without payload copy
+ * @author Didier Barvaux <didier.barvaux@toulouse.viveris.com>
+ *
+ * The application compresses the same packets with \ref rohc_compress4 and
+ * with \ref rohc_compress_hdr with two different compressors, then checks
+ * that the ROHC header followed by the referenced payload is the same as the
+ * full ROHC packet.
+ *
+ * The ROHC packets are then decompressed in place with
+ * \ref rohc_decompress_inplace, one of them being segmented.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for htons() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for htons() on Linux */
+#endif
+#include <assert.h>
+#include <stdarg.h>
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/udp.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The number of packets to compress */
+#define TEST_PKTS_NR  100U
+
+/** The number of UDP flows */
+#define TEST_FLOWS_NR  3U
+
+/** The max size of packets */
+#define TEST_MAX_PKT_SIZE  1500U
+
+/** The max size of ROHC headers */
+#define TEST_MAX_HDR_SIZE  64U
+
+/** The headroom for the in-place decompression */
+#define TEST_HEADROOM  128U
+
+/** The max size of ROHC segments */
+#define TEST_MAX_SEGMENT_SIZE  500U
+
+/** The MRRU of the compressors and of the decompressor */
+#define TEST_MRRU  2000U
+
+
+/* prototypes of private functions */
+static void usage(void);
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * create_decomp(void)
+	__attribute__((warn_unused_result));
+static bool decomp_in_place(struct rohc_decomp *const decomp,
+                            const struct rohc_buf rohc_hdr,
+                            const uint8_t *const payload,
+                            const size_t payload_len,
+                            const struct rohc_buf *const ip_packet)
+	__attribute__((nonnull(1), warn_unused_result));
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+	__attribute__((nonnull(1), warn_unused_result));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that packets are (de)compressed right without payload copy
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+	static uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+	uint8_t hdr_buffer[TEST_MAX_HDR_SIZE];
+	struct rohc_comp *comp1;
+	struct rohc_comp *comp2;
+	struct rohc_decomp *decomp;
+	int is_failure = 1;
+	size_t i;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	/* create the same ROHC compressor twice */
+	comp1 = create_comp();
+	if(comp1 == NULL)
+	{
+		goto error;
+	}
+	comp2 = create_comp();
+	if(comp2 == NULL)
+	{
+		goto destroy_comp1;
+	}
+
+	/* create the ROHC decompressor for the packets of the second compressor */
+	decomp = create_decomp();
+	if(decomp == NULL)
+	{
+		goto destroy_comp2;
+	}
+
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		const struct rohc_ts ts = { .sec = i / 10, .nsec = 0 };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, i), ts);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+		struct rohc_buf rohc_hdr =
+			rohc_buf_init_empty(hdr_buffer, TEST_MAX_HDR_SIZE);
+		size_t payload_offset;
+		size_t payload_len;
+		rohc_status_t status;
+
+		/* compress the packet with its payload */
+		status = rohc_compress4(comp1, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress packet (%d)\n",
+			        i + 1, status);
+			goto destroy_decomp;
+		}
+
+		/* compress the headers of the packet only */
+		status = rohc_compress_hdr(comp2, ip_packet, &rohc_hdr, &payload_offset,
+		                           &payload_len);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet #%zu: failed to compress headers (%d)\n",
+			        i + 1, status);
+			goto destroy_decomp;
+		}
+
+		/* the ROHC header followed by the payload shall be the ROHC packet */
+		if((payload_offset + payload_len) != ip_packet.len ||
+		   (rohc_hdr.len + payload_len) != rohc_packet.len ||
+		   memcmp(rohc_buf_data(rohc_hdr), rohc_buf_data(rohc_packet),
+		          rohc_hdr.len) != 0 ||
+		   memcmp(rohc_buf_data_at(ip_packet, payload_offset),
+		          rohc_buf_data_at(rohc_packet, rohc_hdr.len), payload_len) != 0)
+		{
+			fprintf(stderr, "packet #%zu: %zu-byte ROHC header and %zu-byte "
+			        "payload at offset %zu differ from %zu-byte ROHC packet\n",
+			        i + 1, rohc_hdr.len, payload_len, payload_offset,
+			        rohc_packet.len);
+			goto destroy_decomp;
+		}
+
+		/* decompress the ROHC header and the payload in place */
+		if(!decomp_in_place(decomp, rohc_hdr,
+		                    rohc_buf_data_at(ip_packet, payload_offset),
+		                    payload_len, &ip_packet))
+		{
+			fprintf(stderr, "packet #%zu: failed to decompress in place\n", i + 1);
+			goto destroy_decomp;
+		}
+	}
+	fprintf(stderr, "%u packets compressed the same way with and without their "
+	        "payload, and decompressed in place\n", TEST_PKTS_NR);
+
+	/* segment one large packet, then decompress the segments in place */
+	{
+		const struct rohc_ts ts = { .sec = TEST_PKTS_NR / 10, .nsec = 0 };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_buffer, build_packet(ip_buffer, 4), ts);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, TEST_MAX_SEGMENT_SIZE);
+		size_t segments_nr = 0;
+		rohc_status_t status;
+
+		status = rohc_compress4(comp2, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_SEGMENT)
+		{
+			fprintf(stderr, "large packet was not segmented (%d)\n", status);
+			goto destroy_decomp;
+		}
+		while((status = rohc_comp_get_segment2(comp2, &rohc_packet)) == ROHC_STATUS_SEGMENT)
+		{
+			segments_nr++;
+			if(!decomp_in_place(decomp, rohc_packet, NULL, 0, NULL))
+			{
+				fprintf(stderr, "failed to decompress ROHC segment #%zu in place\n",
+				        segments_nr);
+				goto destroy_decomp;
+			}
+			rohc_packet.len = 0;
+		}
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to generate ROHC segment (%d)\n", status);
+			goto destroy_decomp;
+		}
+		segments_nr++;
+		if(!decomp_in_place(decomp, rohc_packet, NULL, 0, &ip_packet))
+		{
+			fprintf(stderr, "failed to decompress final ROHC segment #%zu in "
+			        "place\n", segments_nr);
+			goto destroy_decomp;
+		}
+		fprintf(stderr, "%zu ROHC segments decompressed in place\n", segments_nr);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp2:
+	rohc_comp_free(comp2);
+destroy_comp1:
+	rohc_comp_free(comp1);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that packets are (de)compressed right without payload copy\n"
+	        "\n"
+	        "usage: test_zero_copy [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Create one ROHC compressor for the test
+ *
+ * @return  The ROHC compressor if successful, NULL otherwise
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	if(!rohc_comp_set_mrru(comp, TEST_MRRU))
+	{
+		fprintf(stderr, "failed to set the MRRU at compressor\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor for the test
+ *
+ * @return  The ROHC decompressor if successful, NULL otherwise
+ */
+static struct rohc_decomp * create_decomp(void)
+{
+	struct rohc_decomp *decomp;
+
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	if(!rohc_decomp_set_mrru(decomp, TEST_MRRU))
+	{
+		fprintf(stderr, "failed to set the MRRU at decompressor\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Decompress one ROHC packet in place
+ *
+ * The ROHC header and the payload are copied after some headroom in one
+ * buffer, then the buffer is decompressed in place.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_hdr     The ROHC header
+ * @param payload      The payload that follows the ROHC header
+ * @param payload_len  The length of the payload
+ * @param ip_packet    The expected uncompressed packet,
+ *                     NULL if no uncompressed packet is expected
+ * @return             true if the decompression is successful,
+ *                     false otherwise
+ */
+static bool decomp_in_place(struct rohc_decomp *const decomp,
+                            const struct rohc_buf rohc_hdr,
+                            const uint8_t *const payload,
+                            const size_t payload_len,
+                            const struct rohc_buf *const ip_packet)
+{
+	static uint8_t rx_buffer[TEST_HEADROOM + TEST_MAX_PKT_SIZE];
+	struct rohc_buf rx_packet =
+		rohc_buf_init_empty(rx_buffer, TEST_HEADROOM + TEST_MAX_PKT_SIZE);
+	size_t rohc_pkt_end;
+	rohc_status_t status;
+
+	/* build the ROHC packet after some headroom */
+	rx_packet.offset = TEST_HEADROOM;
+	rohc_buf_append_buf(&rx_packet, rohc_hdr);
+	if(payload_len > 0)
+	{
+		rohc_buf_append(&rx_packet, payload, payload_len);
+	}
+	rohc_pkt_end = rx_packet.offset + rx_packet.len;
+
+	status = rohc_decompress_inplace(decomp, &rx_packet, NULL, NULL);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "failed to decompress ROHC packet in place (%d)\n",
+		        status);
+		goto error;
+	}
+
+	if(ip_packet == NULL)
+	{
+		if(rx_packet.len != 0)
+		{
+			fprintf(stderr, "unexpected %zu-byte decompressed packet\n",
+			        rx_packet.len);
+			goto error;
+		}
+	}
+	else if(rx_packet.len != ip_packet->len ||
+	        memcmp(rohc_buf_data(rx_packet), rohc_buf_data(*ip_packet),
+	               ip_packet->len) != 0)
+	{
+		fprintf(stderr, "%zu-byte decompressed packet differs from the %zu-byte "
+		        "original packet\n", rx_packet.len, ip_packet->len);
+		goto error;
+	}
+	else if(payload_len > 0 && (rx_packet.offset + rx_packet.len) != rohc_pkt_end)
+	{
+		fprintf(stderr, "payload was moved during decompression\n");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one packet of the test
+ *
+ * Most packets are IPv4/UDP packets with small or large payloads, one packet
+ * out of 7 is not an IP packet to use the Uncompressed profile.
+ *
+ * @param buf      The buffer for the packet
+ * @param pkt_idx  The index of the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(uint8_t *const buf,
+                           const size_t pkt_idx)
+{
+	const size_t flow = pkt_idx % TEST_FLOWS_NR;
+	const size_t payload_len = ((pkt_idx % 4) == 0 ? 1400 : 20 + pkt_idx % 50);
+	const size_t pkt_len =
+		sizeof(struct ipv4_hdr) + sizeof(struct udphdr) + payload_len;
+	struct ipv4_hdr *const ip_hdr = (struct ipv4_hdr *) buf;
+	struct udphdr *const udp_hdr = (struct udphdr *) (ip_hdr + 1);
+	uint8_t *const payload = (uint8_t *) (udp_hdr + 1);
+	uint32_t csum = 0;
+	size_t i;
+
+	assert(pkt_len <= TEST_MAX_PKT_SIZE);
+
+	if((pkt_idx % 7) == 0)
+	{
+		/* not an IP packet */
+		for(i = 0; i < payload_len; i++)
+		{
+			buf[i] = (pkt_idx + i) & 0x0f;
+		}
+		return payload_len;
+	}
+
+	ip_hdr->version = 4;
+	ip_hdr->ihl = 5;
+	ip_hdr->tos = 0;
+	ip_hdr->tot_len = htons(pkt_len);
+	ip_hdr->id = htons(pkt_idx);
+	ip_hdr->frag_off = 0;
+	ip_hdr->ttl = 64;
+	ip_hdr->protocol = 17; /* UDP */
+	ip_hdr->check = 0;
+	ip_hdr->saddr = htonl(0xc0a80001);
+	ip_hdr->daddr = htonl(0xc0a80100 + flow);
+	for(i = 0; i < sizeof(struct ipv4_hdr); i += 2)
+	{
+		csum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((csum >> 16) != 0)
+	{
+		csum = (csum & 0xffff) + (csum >> 16);
+	}
+	ip_hdr->check = htons(~csum & 0xffff);
+
+	udp_hdr->source = htons(1024 + flow);
+	udp_hdr->dest = htons(5000 + flow);
+	udp_hdr->len = htons(sizeof(struct udphdr) + payload_len);
+	udp_hdr->check = 0;
+
+	for(i = 0; i < payload_len; i++)
+	{
+		payload[i] = (pkt_idx + i) & 0xff;
+	}
+
+	return pkt_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * The same number is always returned, so that several compressors behave
+ * the same way.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 4; /* chosen by fair dice roll, guaranteed to be random */
+}